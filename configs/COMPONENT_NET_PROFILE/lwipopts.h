@@ -0,0 +1,111 @@
+/******************************************************************************
+* File Name:   lwipopts.h
+*
+* Description: This file applies the lwIP options of the selected network
+* tuning profile (configs/net_profile.h) on top of the lwIP configuration of
+* the wifi-core-freertos-lwip-mbedtls library. The directory is only part of
+* the build when NET_PROFILE is not default, and it must be searched before
+* the configs directory of the library: the lwipopts.h of the library is
+* included with #include_next, which requires a GNU compatible compiler.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef NET_PROFILE_LWIPOPTS_H_
+#define NET_PROFILE_LWIPOPTS_H_
+
+/* lwIP configuration of the wifi-core-freertos-lwip-mbedtls library. */
+#include_next <lwipopts.h>
+
+#include "net_profile.h"
+
+/*******************************************************************************
+* TCP
+*******************************************************************************/
+#if defined(NET_PROFILE_TCP_MSS)
+#undef TCP_MSS
+#define TCP_MSS                                 NET_PROFILE_TCP_MSS
+#endif /* NET_PROFILE_TCP_MSS */
+
+/* Receive window advertised to the server. */
+#if defined(NET_PROFILE_TCP_WND)
+#undef TCP_WND
+#define TCP_WND                                 NET_PROFILE_TCP_WND
+#endif /* NET_PROFILE_TCP_WND */
+
+/* Bytes that can be queued for sending, including the bytes in flight. A
+ * send blocks while the buffer is full.
+ */
+#if defined(NET_PROFILE_TCP_SND_BUF)
+#undef TCP_SND_BUF
+#define TCP_SND_BUF                             NET_PROFILE_TCP_SND_BUF
+#endif /* NET_PROFILE_TCP_SND_BUF */
+
+/* lwIP requires at least 2 * TCP_SND_BUF / TCP_MSS queued segments, and a
+ * segment descriptor for each of them.
+ */
+#if defined(NET_PROFILE_TCP_SND_QUEUELEN)
+#undef TCP_SND_QUEUELEN
+#define TCP_SND_QUEUELEN                        NET_PROFILE_TCP_SND_QUEUELEN
+#undef TCP_SNDQUEUELOWAT
+#define TCP_SNDQUEUELOWAT                       LWIP_MAX(((TCP_SND_QUEUELEN) / 2), 5)
+#undef TCP_SNDLOWAT
+#define TCP_SNDLOWAT                            LWIP_MIN(LWIP_MAX(((TCP_SND_BUF) / 2), (2 * TCP_MSS) + 1), \
+                                                         (TCP_SND_BUF) - 1)
+#endif /* NET_PROFILE_TCP_SND_QUEUELEN */
+
+#if defined(NET_PROFILE_MEMP_NUM_TCP_SEG)
+#undef MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG                        NET_PROFILE_MEMP_NUM_TCP_SEG
+#endif /* NET_PROFILE_MEMP_NUM_TCP_SEG */
+
+/* Segments received out of order are held in the pbuf pool until the
+ * missing segment arrives.
+ */
+#if defined(NET_PROFILE_TCP_QUEUE_OOSEQ)
+#undef TCP_QUEUE_OOSEQ
+#define TCP_QUEUE_OOSEQ                         NET_PROFILE_TCP_QUEUE_OOSEQ
+#endif /* NET_PROFILE_TCP_QUEUE_OOSEQ */
+
+/*******************************************************************************
+* Buffers
+*******************************************************************************/
+/* Received frames are stored in the pbuf pool, so it bounds the data that can
+ * be received ahead of the application.
+ */
+#if defined(NET_PROFILE_PBUF_POOL_SIZE)
+#undef PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE                          NET_PROFILE_PBUF_POOL_SIZE
+#endif /* NET_PROFILE_PBUF_POOL_SIZE */
+
+#endif /* NET_PROFILE_LWIPOPTS_H_ */
@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name:   mbedtls_app_config.h
+*
+* Description: This file contains the Mbed TLS configuration of the
+* application. The Makefile points MBEDTLS_USER_CONFIG_FILE to this file. It
+* includes the configuration of the selected build profile and applies the
+* TLS version, cipher suite and curve selections made in the Makefile.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MBEDTLS_APP_CONFIG_H_
+#define MBEDTLS_APP_CONFIG_H_
+
+/* Configuration of the selected build profile (BUILD_PROFILE). */
+#include MBEDTLS_PROFILE_CONFIG_FILE
+
+/* TLS 1.3 (TLS_VERSION=1.3). */
+#if defined(APP_TLS_VERSION_1_3)
+#include "mbedtls_tls13_config.h"
+#endif /* APP_TLS_VERSION_1_3 */
+
+/*******************************************************************************
+* Cipher suite pinning (TLS_CIPHERSUITES)
+*******************************************************************************/
+/* Only the listed suites are offered, in the order given. */
+#if defined(APP_TLS_CIPHERSUITES)
+#undef MBEDTLS_SSL_CIPHERSUITES
+#define MBEDTLS_SSL_CIPHERSUITES                APP_TLS_CIPHERSUITES
+#endif /* APP_TLS_CIPHERSUITES */
+
+/*******************************************************************************
+* Curve pinning (TLS_CURVES)
+*******************************************************************************/
+/* Only the listed curves are offered for the ECDHE key exchange. P-256 is
+ * always kept because the client identity and the server certificate use
+ * ECDSA P-256 keys. Mbed TLS offers the enabled curves in its own order of
+ * preference, with X25519 ahead of P-256.
+ */
+#if defined(APP_TLS_CURVES_PINNED)
+#undef MBEDTLS_ECP_DP_SECP192R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP224R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP384R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP521R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP192K1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP224K1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP256K1_ENABLED
+#undef MBEDTLS_ECP_DP_BP256R1_ENABLED
+#undef MBEDTLS_ECP_DP_BP384R1_ENABLED
+#undef MBEDTLS_ECP_DP_BP512R1_ENABLED
+#undef MBEDTLS_ECP_DP_CURVE25519_ENABLED
+#undef MBEDTLS_ECP_DP_CURVE448_ENABLED
+#define MBEDTLS_ECP_DP_SECP256R1_ENABLED
+
+#if defined(APP_TLS_CURVE_X25519)
+#define MBEDTLS_ECP_DP_CURVE25519_ENABLED
+#endif /* APP_TLS_CURVE_X25519 */
+
+#if defined(APP_TLS_CURVE_P384)
+#define MBEDTLS_ECP_DP_SECP384R1_ENABLED
+#endif /* APP_TLS_CURVE_P384 */
+#endif /* APP_TLS_CURVES_PINNED */
+
+#endif /* MBEDTLS_APP_CONFIG_H_ */
@@ -0,0 +1,80 @@
+/******************************************************************************
+* File Name:   mbedtls_tls13_config.h
+*
+* Description: This file enables TLS 1.3 on top of the Mbed TLS configuration
+* of the selected build profile. It is included by mbedtls_app_config.h when
+* TLS_VERSION is 1.3 in the Makefile. TLS 1.2 stays enabled so that the client
+* can still connect to servers that do not support TLS 1.3.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MBEDTLS_TLS13_CONFIG_H_
+#define MBEDTLS_TLS13_CONFIG_H_
+
+/*******************************************************************************
+* Protocol versions
+*******************************************************************************/
+#define MBEDTLS_SSL_PROTO_TLS1_2
+#define MBEDTLS_SSL_PROTO_TLS1_3
+#define MBEDTLS_SSL_TLS1_3_COMPATIBILITY_MODE
+
+/* Full (EC)DHE handshakes only. The secure sockets library does not expose
+ * the session to the application, so tickets could not be kept across
+ * connections and the PSK key exchange modes are left out.
+ */
+#define MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED
+#undef MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_PSK_ENABLED
+#undef MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_PSK_EPHEMERAL_ENABLED
+#undef MBEDTLS_SSL_SESSION_TICKETS
+
+/* Required by TLS 1.3. The TLS 1.3 key schedule uses PSA crypto, which the
+ * application initializes before the first handshake.
+ */
+#define MBEDTLS_SSL_KEEP_PEER_CERTIFICATE
+#define MBEDTLS_PSA_CRYPTO_C
+#define MBEDTLS_HKDF_C
+
+/*******************************************************************************
+* Cipher suites
+*******************************************************************************/
+/* Profiles that restrict the suites (minimal) list TLS 1.2 suites only. */
+#if defined(MBEDTLS_SSL_CIPHERSUITES)
+#undef MBEDTLS_SSL_CIPHERSUITES
+#define MBEDTLS_SSL_CIPHERSUITES                MBEDTLS_TLS1_3_AES_128_GCM_SHA256, \
+                                                MBEDTLS_TLS1_3_AES_256_GCM_SHA384, \
+                                                MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256, \
+                                                MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384
+#endif /* MBEDTLS_SSL_CIPHERSUITES */
+
+#endif /* MBEDTLS_TLS13_CONFIG_H_ */
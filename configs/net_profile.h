@@ -0,0 +1,110 @@
+/******************************************************************************
+* File Name:   net_profile.h
+*
+* Description: This file defines the network tuning profiles of the TCP
+* client: the lwIP TCP and buffer options and the socket options that are set
+* together for each profile. The profile is selected with NET_PROFILE in the
+* Makefile. The lwIP options are applied by COMPONENT_NET_PROFILE/lwipopts.h on
+* top of the lwIP configuration of the wifi-core-freertos-lwip-mbedtls library,
+* and the socket options by create_secure_tcp_client_socket(). The default
+* profile leaves both unchanged. tools/net_profile_benchmark.py reads this
+* file to compare the profiles on the host.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef NET_PROFILE_H_
+#define NET_PROFILE_H_
+
+/*******************************************************************************
+* Low latency (NET_PROFILE=low_latency)
+*******************************************************************************/
+/* Nagle's algorithm is disabled so that an acknowledgement is sent as soon
+ * as it is written, even while telemetry is in flight. The send buffer is
+ * kept small, so that little data can queue ahead of an acknowledgement.
+ */
+#if defined(NET_PROFILE_LOW_LATENCY)
+#define NET_PROFILE_NAME                        "low_latency"
+#define NET_PROFILE_TCP_MSS                     (1460)
+#define NET_PROFILE_TCP_WND                     (8 * NET_PROFILE_TCP_MSS)
+#define NET_PROFILE_TCP_SND_BUF                 (4 * NET_PROFILE_TCP_MSS)
+#define NET_PROFILE_TCP_SND_QUEUELEN            (16)
+#define NET_PROFILE_MEMP_NUM_TCP_SEG            (16)
+#define NET_PROFILE_PBUF_POOL_SIZE              (12)
+#define NET_PROFILE_TCP_QUEUE_OOSEQ             (1)
+#define NET_PROFILE_TCP_NODELAY                 (1)
+
+/*******************************************************************************
+* High throughput (NET_PROFILE=high_throughput)
+*******************************************************************************/
+/* The receive window covers the bandwidth-delay product of a Wi-Fi link to a
+ * server a few milliseconds away, and the send buffer holds a full TLS
+ * record. The pbuf pool must hold a full window of received segments.
+ */
+#elif defined(NET_PROFILE_HIGH_THROUGHPUT)
+#define NET_PROFILE_NAME                        "high_throughput"
+#define NET_PROFILE_TCP_MSS                     (1460)
+#define NET_PROFILE_TCP_WND                     (24 * NET_PROFILE_TCP_MSS)
+#define NET_PROFILE_TCP_SND_BUF                 (16 * NET_PROFILE_TCP_MSS)
+#define NET_PROFILE_TCP_SND_QUEUELEN            (64)
+#define NET_PROFILE_MEMP_NUM_TCP_SEG            (64)
+#define NET_PROFILE_PBUF_POOL_SIZE              (32)
+#define NET_PROFILE_TCP_QUEUE_OOSEQ             (1)
+#define NET_PROFILE_TCP_NODELAY                 (0)
+
+/*******************************************************************************
+* Minimal RAM (NET_PROFILE=minimal_ram)
+*******************************************************************************/
+/* Two segments in each direction. Out-of-order segments are dropped instead
+ * of being held in the pbuf pool, so a loss costs a retransmission of
+ * everything behind it.
+ */
+#elif defined(NET_PROFILE_MINIMAL_RAM)
+#define NET_PROFILE_NAME                        "minimal_ram"
+#define NET_PROFILE_TCP_MSS                     (1460)
+#define NET_PROFILE_TCP_WND                     (2 * NET_PROFILE_TCP_MSS)
+#define NET_PROFILE_TCP_SND_BUF                 (2 * NET_PROFILE_TCP_MSS)
+#define NET_PROFILE_TCP_SND_QUEUELEN            (8)
+#define NET_PROFILE_MEMP_NUM_TCP_SEG            (8)
+#define NET_PROFILE_PBUF_POOL_SIZE              (6)
+#define NET_PROFILE_TCP_QUEUE_OOSEQ             (0)
+#define NET_PROFILE_TCP_NODELAY                 (0)
+
+/*******************************************************************************
+* Default (NET_PROFILE=default)
+*******************************************************************************/
+#else
+#define NET_PROFILE_NAME                        "default"
+#endif
+
+#endif /* NET_PROFILE_H_ */
@@ -0,0 +1,268 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   compact_codec.py
+#
+# Description: Decoders for the compact binary encoding used by the secure TCP
+#              client (varints, zigzag, delta-encoded telemetry, bit-packed LED states).
+#              Run this file directly to print the bytes on air of each message in the
+#              ASCII/fixed encoding and in the compact encoding.
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import math
+import random
+import struct
+import sys
+
+# Telemetry sample fields in encoding order. The LED state is not part of the
+# delta encoding; it is sent as a bitmap after the samples.
+TELEMETRY_FIELDS = ('timestamp_ms', 'heap_in_use', 'heap_max_used', 'rssi_dbm',
+                    'task_count', 'stack_hwm_words', 'led_state')
+TELEMETRY_DELTA_FIELDS = TELEMETRY_FIELDS[:-1]
+TELEMETRY_FIXED_SAMPLE = struct.Struct('<IIIhHHB')
+TELEMETRY_FORMAT_FIXED = 1
+TELEMETRY_FORMAT_DELTA = 2
+
+# Metrics snapshot: names of the counters, gauges and histograms in the order
+# of their identifiers in metrics.h.
+METRICS_FORMAT_VERSION = 1
+METRICS_COUNTERS = ('bytes_in', 'bytes_out', 'records_in', 'records_out', 'handshakes',
+                    'handshake_failures', 'reconnects')
+METRICS_GAUGES = ('heap_in_use', 'heap_max_used', 'stack_free_network', 'stack_free_socket')
+METRICS_HISTOGRAMS = ('connect_us', 'ack_us')
+
+# Compact acknowledgement: 'A' | status.
+ACK_STATUS_LED_ON = 0x01
+ACK_STATUS_INVALID_CMD = 0x02
+ACK_MESSAGES = (b'LED ON ACK', b'LED OFF ACK', b'Invalid command')
+
+# Overhead added to every message: TLS 1.2 AES-GCM record (5-byte header,
+# 8-byte explicit nonce, 16-byte tag) and IPv4 + TCP headers without options.
+TLS_RECORD_OVERHEAD = 5 + 8 + 16
+TCP_IP_OVERHEAD = 20 + 20
+
+
+def put_varint(value):
+    out = bytearray()
+    value &= 0xFFFFFFFF
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def get_varint(data, offset):
+    """Returns (value, new offset)."""
+    value = 0
+    shift = 0
+    while True:
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return value, offset
+        shift += 7
+        if shift > 28:
+            raise ValueError("Varint too long")
+
+
+def zigzag(value):
+    return ((value << 1) ^ (value >> 31)) & 0xFFFFFFFF
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def to_signed(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+def decode_ack(status):
+    """Maps a compact acknowledgement status to the ASCII acknowledgement."""
+    if status & ACK_STATUS_INVALID_CMD:
+        return 'Invalid command'
+    return 'LED ON ACK' if status & ACK_STATUS_LED_ON else 'LED OFF ACK'
+
+
+def encode_ack(text):
+    status = {'LED ON ACK': ACK_STATUS_LED_ON, 'LED OFF ACK': 0,
+              'Invalid command': ACK_STATUS_INVALID_CMD}[text]
+    return b'A' + bytes([status])
+
+
+def decode_telemetry(payload):
+    """Decodes a telemetry batch payload into a list of sample dictionaries."""
+    sample_format, count = payload[0], payload[1]
+    samples = []
+    if sample_format == TELEMETRY_FORMAT_FIXED:
+        for index in range(count):
+            values = TELEMETRY_FIXED_SAMPLE.unpack_from(payload, 2 + index * TELEMETRY_FIXED_SAMPLE.size)
+            samples.append(dict(zip(TELEMETRY_FIELDS, values)))
+    elif sample_format == TELEMETRY_FORMAT_DELTA:
+        offset = 2
+        previous = [0] * len(TELEMETRY_DELTA_FIELDS)
+        for _ in range(count):
+            current = []
+            for last in previous:
+                delta, offset = get_varint(payload, offset)
+                current.append((last + unzigzag(delta)) & 0xFFFFFFFF)
+            previous = current
+            sample = dict(zip(TELEMETRY_DELTA_FIELDS, current))
+            sample['rssi_dbm'] = to_signed(sample['rssi_dbm'], 16)
+            samples.append(sample)
+        for index, sample in enumerate(samples):
+            sample['led_state'] = (payload[offset + index // 8] >> (index % 8)) & 1
+    else:
+        raise ValueError("Unknown telemetry format %d" % sample_format)
+    return samples
+
+
+def decode_metrics(payload):
+    """Decodes a metrics snapshot payload. Values the decoder has no name for,
+    sent by a newer client, are named by their index."""
+    if payload[0] != METRICS_FORMAT_VERSION:
+        raise ValueError("Unknown metrics format %d" % payload[0])
+    metrics = {}
+    metrics['uptime_ms'], offset = get_varint(payload, 1)
+
+    for group, names in (('counters', METRICS_COUNTERS), ('gauges', METRICS_GAUGES)):
+        count = payload[offset]
+        offset += 1
+        values = {}
+        for index in range(count):
+            name = names[index] if index < len(names) else '%s_%d' % (group, index)
+            values[name], offset = get_varint(payload, offset)
+        metrics[group] = values
+
+    count = payload[offset]
+    offset += 1
+    metrics['histograms'] = {}
+    for index in range(count):
+        name = METRICS_HISTOGRAMS[index] if index < len(METRICS_HISTOGRAMS) else 'histogram_%d' % index
+        bucket_count = payload[offset]
+        samples, offset = get_varint(payload, offset + 1)
+        maximum, offset = get_varint(payload, offset)
+        buckets = []
+        for _ in range(bucket_count):
+            value, offset = get_varint(payload, offset)
+            buckets.append(value)
+        metrics['histograms'][name] = {'count': samples, 'max': maximum, 'buckets': buckets}
+
+    count = payload[offset]
+    offset += 1
+    metrics['handshake_failures'] = {}
+    for _ in range(count):
+        code, offset = get_varint(payload, offset)
+        metrics['handshake_failures'][code], offset = get_varint(payload, offset)
+    return metrics
+
+
+def histogram_percentile(histogram, fraction):
+    """Upper bound of the log2 bucket holding the given fraction of the
+    samples, capped at the maximum. The last bucket has no upper bound."""
+    rank = max(1, math.ceil(fraction * histogram['count']))
+    seen = 0
+    for index, count in enumerate(histogram['buckets'][:-1]):
+        seen += count
+        if seen >= rank:
+            return min(histogram['max'], (1 << index) - 1 if index > 0 else 0)
+    return histogram['max']
+
+
+def encode_telemetry(samples, sample_format):
+    """Encodes a telemetry frame ('T' | length | payload) the way the TCP
+    client does."""
+    payload = bytearray([sample_format, len(samples)])
+    if sample_format == TELEMETRY_FORMAT_FIXED:
+        for sample in samples:
+            payload += TELEMETRY_FIXED_SAMPLE.pack(*(sample[field] for field in TELEMETRY_FIELDS))
+    else:
+        previous = [0] * len(TELEMETRY_DELTA_FIELDS)
+        for sample in samples:
+            current = [sample[field] for field in TELEMETRY_DELTA_FIELDS]
+            for value, last in zip(current, previous):
+                payload += put_varint(zigzag(to_signed(value - last, 32)))
+            previous = current
+        bitmap = bytearray((len(samples) + 7) // 8)
+        for index, sample in enumerate(samples):
+            if sample['led_state']:
+                bitmap[index // 8] |= 1 << (index % 8)
+        payload += bitmap
+    return struct.pack('<cH', b'T', len(payload)) + payload
+
+
+def example_samples(count, seed=1):
+    """Samples resembling those taken once per second by the TCP client."""
+    rng = random.Random(seed)
+    samples = []
+    heap = 61000
+    heap_max = 68500
+    for index in range(count):
+        heap += rng.randint(-300, 300)
+        heap_max = max(heap_max, heap)
+        samples.append({'timestamp_ms': 734000 + index * 1000 + rng.randint(0, 2),
+                        'heap_in_use': heap, 'heap_max_used': heap_max,
+                        'rssi_dbm': -55 + rng.randint(-3, 3), 'task_count': 9,
+                        'stack_hwm_words': 412, 'led_state': (index // 3) & 1})
+    return samples
+
+
+def print_size_report(batch_size):
+    rows = []
+    for ack in ACK_MESSAGES:
+        text = ack.decode('utf-8')
+        rows.append(("Acknowledgement '%s'" % text, len(ack), len(encode_ack(text))))
+    samples = example_samples(batch_size)
+    rows.append(("Telemetry batch (%d samples)" % batch_size,
+                 len(encode_telemetry(samples, TELEMETRY_FORMAT_FIXED)),
+                 len(encode_telemetry(samples, TELEMETRY_FORMAT_DELTA))))
+
+    print("Bytes on air per message (payload / + TLS record / + TCP/IPv4):\n")
+    print("%-36s %20s %20s" % ("Message", "ASCII/fixed", "compact"))
+    for name, before, after in rows:
+        print("%-36s %6d/%5d/%5d    %6d/%5d/%5d" %
+              (name, before, before + TLS_RECORD_OVERHEAD,
+               before + TLS_RECORD_OVERHEAD + TCP_IP_OVERHEAD,
+               after, after + TLS_RECORD_OVERHEAD,
+               after + TLS_RECORD_OVERHEAD + TCP_IP_OVERHEAD))
+
+
+if __name__ == '__main__':
+    print_size_report(int(sys.argv[1]) if len(sys.argv) > 1 else 10)
+
+# [] END OF FILE
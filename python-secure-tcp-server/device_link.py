@@ -0,0 +1,343 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   device_link.py
+#
+# Description: Connection to the secure TCP client used by tcp_secure_server.py.
+#              A single I/O thread performs all reads and writes on the TLS
+#              connection, splits the byte stream from the client into messages
+#              (acknowledgements, latency probe replies, telemetry batches,
+#              state reports, parameter replies) and
+#              hands replies to the caller through a queue. Both the ASCII and
+#              the compact encoding of the client messages are accepted.
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import queue
+import select
+import socket
+import ssl
+import struct
+import threading
+import time
+
+from compact_codec import (ACK_MESSAGES, ACK_STATUS_LED_ON, decode_ack, decode_metrics,
+                           decode_telemetry, histogram_percentile)
+
+# 'A' | status, sent instead of the ASCII acknowledgements when the TCP client
+# uses the compact encoding.
+ACK_COMPACT = struct.Struct('<cB')
+
+# 'p' | seq | server timestamp (ns) | device receive timestamp (us) |
+# device processing time (us)
+PING_REPLY = struct.Struct('<cIQII')
+
+# 'S' | status | connection count | handshake time (us), sent by the TCP
+# client as the first message on every connection.
+STATE_REPORT = struct.Struct('<cBHI')
+
+# 'T' | payload length, followed by the payload.
+TELEMETRY_HEADER = struct.Struct('<cH')
+
+# 'H' | seq, sent by the TCP client while connected; answered with 'h' | seq.
+HEARTBEAT = struct.Struct('<cI')
+
+# 'm' | payload length, followed by the metrics snapshot requested with 'M'.
+METRICS_HEADER = struct.Struct('<cH')
+
+# 'k' | text length, followed by the reply to a parameter command sent with
+# 'K' | length | command line.
+PARAM_REPLY_HEADER = struct.Struct('<cH')
+
+# 'd' | status | offset | elapsed time (us) | receive stall time (us) |
+# SHA-256, the answer of the TCP client to the bulk download messages.
+DOWNLOAD_STATUS = struct.Struct('<cBIII32s')
+
+# Blocks of a bulk download queued by send_bulk() at most. Heartbeat replies
+# and commands are sent ahead of them.
+BULK_QUEUE_DEPTH = 4
+
+
+def print_telemetry(samples, frame_length):
+    latest = samples[-1]
+    print("\n[telemetry] %d samples in %d bytes: LED %s, heap %d B (max %d B), "
+          "RSSI %d dBm, %d tasks, stack HWM %d words" %
+          (len(samples), frame_length, 'ON' if latest['led_state'] else 'OFF',
+           latest['heap_in_use'], latest['heap_max_used'], latest['rssi_dbm'],
+           latest['task_count'], latest['stack_hwm_words']))
+
+
+def print_state_report(report):
+    print("\n[state] LED %s, connection %d, device handshake %.1f ms, "
+          "first application byte %.1f ms after TCP accept" %
+          ('ON' if report['led_state'] else 'OFF', report['connection_count'],
+           report['handshake_us'] / 1000.0, report['first_byte_ms']))
+
+
+def print_metrics(metrics):
+    counters = metrics['counters']
+    gauges = metrics['gauges']
+    print("\n[metrics] uptime %.1f s" % (metrics['uptime_ms'] / 1000.0))
+    print("  traffic    : %d B in (%d records), %d B out (%d records)" %
+          (counters['bytes_in'], counters['records_in'], counters['bytes_out'],
+           counters['records_out']))
+    print("  connections: %d handshakes, %d failed, %d reconnects" %
+          (counters['handshakes'], counters['handshake_failures'], counters['reconnects']))
+    for code, count in sorted(metrics['handshake_failures'].items()):
+        print("    error 0x%08x: %d" % (code, count))
+    print("  memory     : heap %d B in use (max %d B), stack free %d B network, %d B socket" %
+          (gauges['heap_in_use'], gauges['heap_max_used'], gauges['stack_free_network'],
+           gauges['stack_free_socket']))
+    for name, histogram in metrics['histograms'].items():
+        if histogram['count'] == 0:
+            continue
+        print("  %-11s: %d samples, p50 <= %d us, p99 <= %d us, max %d us" %
+              (name, histogram['count'], histogram_percentile(histogram, 0.50),
+               histogram_percentile(histogram, 0.99), histogram['max']))
+
+
+class DeviceLink:
+    """Owns the TLS connection to the TCP client. An SSL socket must not be
+    read and written from different threads at the same time, so all I/O is
+    done by one thread; send() queues data and wakes that thread up. The
+    thread writes one queued message at a time while the socket is writable
+    and keeps reading in between, so that a bulk download does not hold up
+    the heartbeats of the client."""
+
+    def __init__(self, connstream, accepted_ns=None, on_telemetry=print_telemetry,
+                 on_state_report=print_state_report, on_metrics=print_metrics):
+        self.connstream = connstream
+        self.connstream.setblocking(False)
+        self.accepted_ns = accepted_ns if accepted_ns is not None else time.perf_counter_ns()
+        self.on_telemetry = on_telemetry
+        self.on_state_report = on_state_report
+        self.on_metrics = on_metrics
+        self.replies = queue.Queue()
+        self.outgoing = queue.Queue()
+        self.bulk = queue.Queue(maxsize=BULK_QUEUE_DEPTH)
+        self.sending = None
+        self.sending_bulk = False
+        self.wake_r, self.wake_w = socket.socketpair()
+        self.buffer = b''
+        self.closed = threading.Event()
+        self.thread = threading.Thread(target=self._run, daemon=True)
+        self.thread.start()
+
+    def send(self, data):
+        self.outgoing.put(bytes(data))
+        self.wake_w.send(b'\0')
+
+    def send_bulk(self, data):
+        """Queues a block of a bulk download, waiting while BULK_QUEUE_DEPTH
+        blocks are queued. Raises ConnectionError when the client has
+        disconnected."""
+        while True:
+            if self.closed.is_set():
+                raise ConnectionError("Connection closed by the TCP client")
+            try:
+                self.bulk.put(bytes(data), timeout=0.5)
+                break
+            except queue.Full:
+                pass
+        self.wake_w.send(b'\0')
+
+    def cancel_bulk(self, timeout=10.0):
+        """Drops the queued blocks of a bulk download and waits until the block
+        being sent, if any, is out, so that the next message is not sent ahead
+        of it."""
+        while True:
+            try:
+                self.bulk.get_nowait()
+            except queue.Empty:
+                break
+        deadline = time.monotonic() + timeout
+        while self.sending_bulk and not self.closed.is_set() and time.monotonic() < deadline:
+            time.sleep(0.01)
+
+    def get_reply(self, kind, timeout=10.0):
+        """Returns the next reply of the given kind ('ack', 'ping', 'param'
+        or 'download'), skipping
+        stale replies of other kinds. Raises ConnectionError when the client
+        has disconnected and TimeoutError when no reply arrives in time."""
+        deadline = time.monotonic() + timeout
+        while True:
+            try:
+                item = self.replies.get(timeout=max(0.0, deadline - time.monotonic()))
+            except queue.Empty:
+                raise TimeoutError("No reply from the TCP client")
+            if item is None:
+                self.replies.put(None)
+                raise ConnectionError("Connection closed by the TCP client")
+            if item[0] == kind:
+                return item[1:]
+
+    def close(self):
+        self.closed.set()
+        self.wake_w.send(b'\0')
+        self.thread.join(timeout=1.0)
+        self.wake_r.close()
+        self.wake_w.close()
+
+    def _run(self):
+        try:
+            while not self.closed.is_set():
+                writing = (self.sending is not None or not self.outgoing.empty() or
+                           not self.bulk.empty())
+                if self.connstream.pending():
+                    readable, writable = [self.connstream], []
+                else:
+                    readable, writable, _ = select.select(
+                        [self.connstream, self.wake_r], [self.connstream] if writing else [], [])
+                if self.wake_r in readable:
+                    self.wake_r.recv(4096)
+                if self.connstream in readable:
+                    self._read()
+                if self.connstream in writable:
+                    self._write()
+        except (ConnectionError, OSError, ssl.SSLError):
+            pass
+        finally:
+            self.closed.set()
+            self.replies.put(None)
+
+    def _write(self):
+        if self.sending is None:
+            try:
+                self.sending = memoryview(self.outgoing.get_nowait())
+            except queue.Empty:
+                try:
+                    self.sending = memoryview(self.bulk.get_nowait())
+                    self.sending_bulk = True
+                except queue.Empty:
+                    return
+        try:
+            sent = self.connstream.send(self.sending)
+        except (ssl.SSLWantWriteError, ssl.SSLWantReadError):
+            return
+        self.sending = self.sending[sent:]
+        if not self.sending:
+            self.sending = None
+            self.sending_bulk = False
+
+    def _read(self):
+        while True:
+            try:
+                data = self.connstream.recv(4096)
+            except ssl.SSLWantReadError:
+                return
+            if not data:
+                raise ConnectionError("Connection closed by the TCP client")
+            self.buffer += data
+            self._parse(time.perf_counter_ns())
+
+    def _parse(self, received_ns):
+        while self.buffer:
+            opcode = self.buffer[:1]
+            if opcode == b'A':
+                if len(self.buffer) < ACK_COMPACT.size:
+                    return
+                _, status = ACK_COMPACT.unpack_from(self.buffer)
+                self.buffer = self.buffer[ACK_COMPACT.size:]
+                self.replies.put(('ack', decode_ack(status)))
+            elif opcode == b'S':
+                if len(self.buffer) < STATE_REPORT.size:
+                    return
+                _, status, connection_count, handshake_us = STATE_REPORT.unpack_from(self.buffer)
+                self.buffer = self.buffer[STATE_REPORT.size:]
+                self.on_state_report({'led_state': status & ACK_STATUS_LED_ON,
+                                      'connection_count': connection_count,
+                                      'handshake_us': handshake_us,
+                                      'first_byte_ms': (received_ns - self.accepted_ns) / 1e6})
+            elif opcode == b'p':
+                if len(self.buffer) < PING_REPLY.size:
+                    return
+                fields = PING_REPLY.unpack_from(self.buffer)
+                self.buffer = self.buffer[PING_REPLY.size:]
+                self.replies.put(('ping',) + fields[1:] + (received_ns,))
+            elif opcode == b'H':
+                if len(self.buffer) < HEARTBEAT.size:
+                    return
+                _, seq = HEARTBEAT.unpack_from(self.buffer)
+                self.buffer = self.buffer[HEARTBEAT.size:]
+                self.send(HEARTBEAT.pack(b'h', seq))
+            elif opcode == b'd':
+                if len(self.buffer) < DOWNLOAD_STATUS.size:
+                    return
+                fields = DOWNLOAD_STATUS.unpack_from(self.buffer)
+                self.buffer = self.buffer[DOWNLOAD_STATUS.size:]
+                self.replies.put(('download',) + fields[1:])
+            elif opcode == b'm':
+                if len(self.buffer) < METRICS_HEADER.size:
+                    return
+                _, length = METRICS_HEADER.unpack_from(self.buffer)
+                frame_length = METRICS_HEADER.size + length
+                if len(self.buffer) < frame_length:
+                    return
+                payload = self.buffer[METRICS_HEADER.size:frame_length]
+                self.buffer = self.buffer[frame_length:]
+                self.on_metrics(decode_metrics(payload))
+            elif opcode == b'k':
+                if len(self.buffer) < PARAM_REPLY_HEADER.size:
+                    return
+                _, length = PARAM_REPLY_HEADER.unpack_from(self.buffer)
+                frame_length = PARAM_REPLY_HEADER.size + length
+                if len(self.buffer) < frame_length:
+                    return
+                text = self.buffer[PARAM_REPLY_HEADER.size:frame_length]
+                self.buffer = self.buffer[frame_length:]
+                self.replies.put(('param', text.decode('utf-8', 'replace')))
+            elif opcode == b'T':
+                if len(self.buffer) < TELEMETRY_HEADER.size:
+                    return
+                _, length = TELEMETRY_HEADER.unpack_from(self.buffer)
+                frame_length = TELEMETRY_HEADER.size + length
+                if len(self.buffer) < frame_length:
+                    return
+                payload = self.buffer[TELEMETRY_HEADER.size:frame_length]
+                self.buffer = self.buffer[frame_length:]
+                self.on_telemetry(decode_telemetry(payload), frame_length)
+            else:
+                for ack in ACK_MESSAGES:
+                    if self.buffer.startswith(ack):
+                        self.buffer = self.buffer[len(ack):]
+                        self.replies.put(('ack', ack.decode('utf-8')))
+                        break
+                else:
+                    if any(ack.startswith(self.buffer) for ack in ACK_MESSAGES):
+                        # Incomplete acknowledgement.
+                        return
+                    self.replies.put(('ack', self.buffer.decode('utf-8', 'replace')))
+                    self.buffer = b''
+
+# [] END OF FILE
@@ -0,0 +1,387 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   dtls_link.py
+#
+# Description: DTLS 1.2 transport for the LED commands, used by
+#              tcp_secure_server.py --dtls. The ssl module of Python has no DTLS, so the
+#              sessions run on the OpenSSL library of the system through ctypes, with
+#              memory BIOs between OpenSSL and one UDP socket. Commands are sent with a
+#              sequence number and retransmitted until the reply arrives, with a timeout
+#              derived from the measured round-trip time.
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import ctypes
+import ctypes.util
+import queue
+import select
+import socket
+import struct
+import threading
+import time
+
+from compact_codec import decode_ack
+
+# 'C' | seq | server timestamp (ns) | command, answered with
+# 'c' | seq | server timestamp (ns) | ack status | device processing time (us).
+DTLS_COMMAND = struct.Struct('<cIQc')
+DTLS_COMMAND_REPLY = struct.Struct('<cIQBI')
+
+# 'H' | seq, sent by the TCP client while the server is silent; answered
+# with 'h' | seq.
+HEARTBEAT = struct.Struct('<cI')
+
+# Retransmission timeout of the commands, computed as in RFC 6298 from the
+# round-trip times of the commands that were not retransmitted. The minimum
+# is far below the one of TCP, as the DTLS transport carries only commands.
+RTO_INITIAL_S = 0.2
+RTO_MIN_S = 0.02
+RTO_MAX_S = 1.0
+
+# Largest datagram sent; handshake records are packed up to this size.
+DTLS_MTU = 1200
+
+# Sessions without a datagram for this long are dropped.
+SESSION_IDLE_S = 60.0
+
+SSL_FILETYPE_PEM = 1
+SSL_ERROR_SSL = 1
+SSL_ERROR_WANT_READ = 2
+SSL_ERROR_ZERO_RETURN = 6
+SSL_OP_NO_QUERY_MTU = 0x00001000
+SSL_CTRL_SET_MTU = 17
+DTLS_CTRL_GET_TIMEOUT = 73
+DTLS_CTRL_HANDLE_TIMEOUT = 74
+BIO_CTRL_PENDING = 10
+BIO_C_SET_BUF_MEM_EOF_RETURN = 130
+
+DTLS_RECORD_HEADER = struct.Struct('>BHH6sH')
+
+
+class Timeval(ctypes.Structure):
+    _fields_ = [('tv_sec', ctypes.c_long), ('tv_usec', ctypes.c_long)]
+
+
+def _load_openssl():
+    ssl_lib = ctypes.CDLL(ctypes.util.find_library('ssl'))
+    crypto_lib = ctypes.CDLL(ctypes.util.find_library('crypto'))
+    p, i, l, s = ctypes.c_void_p, ctypes.c_int, ctypes.c_long, ctypes.c_char_p
+    for lib, name, restype, argtypes in [
+            (ssl_lib, 'DTLS_server_method', p, []),
+            (ssl_lib, 'SSL_CTX_new', p, [p]),
+            (ssl_lib, 'SSL_CTX_use_certificate_chain_file', i, [p, s]),
+            (ssl_lib, 'SSL_CTX_use_PrivateKey_file', i, [p, s, i]),
+            (ssl_lib, 'SSL_new', p, [p]),
+            (ssl_lib, 'SSL_free', None, [p]),
+            (ssl_lib, 'SSL_set_bio', None, [p, p, p]),
+            (ssl_lib, 'SSL_set_accept_state', None, [p]),
+            (ssl_lib, 'SSL_set_options', ctypes.c_uint64, [p, ctypes.c_uint64]),
+            (ssl_lib, 'SSL_ctrl', l, [p, i, l, p]),
+            (ssl_lib, 'SSL_do_handshake', i, [p]),
+            (ssl_lib, 'SSL_is_init_finished', i, [p]),
+            (ssl_lib, 'SSL_read', i, [p, p, i]),
+            (ssl_lib, 'SSL_write', i, [p, s, i]),
+            (ssl_lib, 'SSL_shutdown', i, [p]),
+            (ssl_lib, 'SSL_get_error', i, [p, i]),
+            (ssl_lib, 'SSL_get_current_cipher', p, [p]),
+            (ssl_lib, 'SSL_CIPHER_get_name', s, [p]),
+            (crypto_lib, 'BIO_s_mem', p, []),
+            (crypto_lib, 'BIO_new', p, [p]),
+            (crypto_lib, 'BIO_ctrl', l, [p, i, l, p]),
+            (crypto_lib, 'BIO_read', i, [p, p, i]),
+            (crypto_lib, 'BIO_write', i, [p, s, i]),
+            (crypto_lib, 'ERR_get_error', ctypes.c_ulong, []),
+            (crypto_lib, 'ERR_error_string_n', None, [ctypes.c_ulong, p, ctypes.c_size_t])]:
+        function = getattr(lib, name)
+        function.restype = restype
+        function.argtypes = argtypes
+    return ssl_lib, crypto_lib
+
+
+_ssl, _crypto = _load_openssl()
+
+
+class DtlsError(Exception):
+    pass
+
+
+def _openssl_error():
+    code = _crypto.ERR_get_error()
+    buffer = ctypes.create_string_buffer(256)
+    _crypto.ERR_error_string_n(code, buffer, len(buffer))
+    return DtlsError(buffer.value.decode())
+
+
+def _pack_records(data, mtu):
+    """Splits the output of OpenSSL into its DTLS records and packs them into
+    datagrams of at most mtu bytes."""
+    datagrams = []
+    current = b''
+    while data:
+        length = DTLS_RECORD_HEADER.size + DTLS_RECORD_HEADER.unpack_from(data)[4]
+        record, data = data[:length], data[length:]
+        if current and len(current) + len(record) > mtu:
+            datagrams.append(current)
+            current = b''
+        current += record
+    if current:
+        datagrams.append(current)
+    return datagrams
+
+
+class DtlsSession:
+    """Server side of one DTLS session, fed with the datagrams of its peer."""
+
+    def __init__(self, context, address):
+        self.address = address
+        self.established = False
+        self.closed = False
+        self.last_seen = time.monotonic()
+        self.ssl = _ssl.SSL_new(context)
+        self.rbio = _crypto.BIO_new(_crypto.BIO_s_mem())
+        self.wbio = _crypto.BIO_new(_crypto.BIO_s_mem())
+        # An empty read BIO means "no datagram yet", not the end of the stream.
+        _crypto.BIO_ctrl(self.rbio, BIO_C_SET_BUF_MEM_EOF_RETURN, -1, None)
+        _ssl.SSL_set_bio(self.ssl, self.rbio, self.wbio)
+        _ssl.SSL_set_options(self.ssl, SSL_OP_NO_QUERY_MTU)
+        _ssl.SSL_ctrl(self.ssl, SSL_CTRL_SET_MTU, DTLS_MTU, None)
+        _ssl.SSL_set_accept_state(self.ssl)
+
+    def receive(self, datagram):
+        """Processes a datagram of the peer. Returns the application datagrams
+        it carried. Raises DtlsError when the handshake fails."""
+        self.last_seen = time.monotonic()
+        _crypto.BIO_write(self.rbio, datagram, len(datagram))
+        if not self.established:
+            result = _ssl.SSL_do_handshake(self.ssl)
+            if result == 1:
+                self.established = True
+            elif _ssl.SSL_get_error(self.ssl, result) != SSL_ERROR_WANT_READ:
+                raise _openssl_error()
+        payloads = []
+        buffer = ctypes.create_string_buffer(2048)
+        while self.established:
+            length = _ssl.SSL_read(self.ssl, buffer, len(buffer))
+            if length > 0:
+                payloads.append(buffer.raw[:length])
+                continue
+            if _ssl.SSL_get_error(self.ssl, length) == SSL_ERROR_ZERO_RETURN:
+                self.closed = True
+            break
+        return payloads
+
+    def write(self, payload):
+        if _ssl.SSL_write(self.ssl, payload, len(payload)) != len(payload):
+            raise _openssl_error()
+
+    def outgoing(self):
+        """Returns the datagrams to send to the peer."""
+        pending = _crypto.BIO_ctrl(self.wbio, BIO_CTRL_PENDING, 0, None)
+        if pending <= 0:
+            return []
+        buffer = ctypes.create_string_buffer(pending)
+        length = _crypto.BIO_read(self.wbio, buffer, pending)
+        return _pack_records(buffer.raw[:length], DTLS_MTU)
+
+    def timeout(self):
+        """Seconds until a handshake flight must be retransmitted, or None."""
+        timeval = Timeval()
+        if _ssl.SSL_ctrl(self.ssl, DTLS_CTRL_GET_TIMEOUT, 0, ctypes.byref(timeval)) != 1:
+            return None
+        return timeval.tv_sec + timeval.tv_usec / 1e6
+
+    def handle_timeout(self):
+        _ssl.SSL_ctrl(self.ssl, DTLS_CTRL_HANDLE_TIMEOUT, 0, None)
+
+    def cipher(self):
+        return _ssl.SSL_CIPHER_get_name(_ssl.SSL_get_current_cipher(self.ssl)).decode()
+
+    def shutdown(self):
+        _ssl.SSL_shutdown(self.ssl)
+
+    def free(self):
+        _ssl.SSL_free(self.ssl)
+
+
+class DtlsServer:
+    """Accepts the DTLS sessions of the TCP client on a UDP port and sends
+    the LED commands over the newest one. All OpenSSL calls are made under
+    one lock; datagrams are received by one thread."""
+
+    def __init__(self, family, host, port, certfile, keyfile):
+        self.context = _ssl.SSL_CTX_new(_ssl.DTLS_server_method())
+        if (_ssl.SSL_CTX_use_certificate_chain_file(self.context, certfile.encode()) != 1 or
+                _ssl.SSL_CTX_use_PrivateKey_file(self.context, keyfile.encode(),
+                                                 SSL_FILETYPE_PEM) != 1):
+            raise _openssl_error()
+        self.sock = socket.socket(family, socket.SOCK_DGRAM)
+        if family == socket.AF_INET6:
+            self.sock.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_V6ONLY, 0)
+        self.sock.bind((host, port))
+        self.lock = threading.Lock()
+        self.sessions = {}
+        self.current = None
+        self.established = threading.Event()
+        self.replies = queue.Queue()
+        self.seq = 0
+        self.srtt = None
+        self.rttvar = None
+        self.rto = RTO_INITIAL_S
+        threading.Thread(target=self._run, daemon=True).start()
+
+    def wait_session(self, timeout):
+        return self.established.wait(timeout)
+
+    def command(self, command, timeout=5.0):
+        """Sends an LED command and retransmits it until the reply arrives.
+        Returns the acknowledgement, the round-trip time (ns) from the first
+        transmission, the device processing time (us) and the number of
+        retransmissions. Raises ConnectionError without a session and
+        TimeoutError when no reply arrives in time."""
+        self.seq += 1
+        sent_ns = time.perf_counter_ns()
+        datagram = DTLS_COMMAND.pack(b'C', self.seq, sent_ns, command)
+        deadline = time.monotonic() + timeout
+        rto = self.rto
+        retransmissions = 0
+        while True:
+            self._send(datagram)
+            wait_until = min(time.monotonic() + rto, deadline)
+            while True:
+                try:
+                    seq, echoed_ns, status, device_us, received_ns = self.replies.get(
+                        timeout=max(0.0, wait_until - time.monotonic()))
+                except queue.Empty:
+                    break
+                if seq == self.seq and echoed_ns == sent_ns:
+                    rtt_ns = received_ns - sent_ns
+                    if retransmissions == 0:
+                        self._update_rto(rtt_ns / 1e9)
+                    return decode_ack(status), rtt_ns, device_us, retransmissions
+            if time.monotonic() >= deadline:
+                raise TimeoutError("No reply from the TCP client over DTLS")
+            retransmissions += 1
+            rto = min(rto * 2, RTO_MAX_S)
+
+    def _update_rto(self, rtt):
+        # RFC 6298, section 2.
+        if self.srtt is None:
+            self.srtt, self.rttvar = rtt, rtt / 2
+        else:
+            self.rttvar = 0.75 * self.rttvar + 0.25 * abs(self.srtt - rtt)
+            self.srtt = 0.875 * self.srtt + 0.125 * rtt
+        self.rto = min(max(self.srtt + 4 * self.rttvar, RTO_MIN_S), RTO_MAX_S)
+
+    def _send(self, payload):
+        with self.lock:
+            session = self.sessions.get(self.current)
+            if session is None or session.closed:
+                raise ConnectionError("No DTLS session with the TCP client")
+            session.write(payload)
+            self._flush(session)
+
+    def _flush(self, session):
+        for datagram in session.outgoing():
+            try:
+                self.sock.sendto(datagram, session.address)
+            except OSError:
+                pass
+
+    def _run(self):
+        while True:
+            with self.lock:
+                timeouts = [t for t in (s.timeout() for s in self.sessions.values())
+                            if t is not None]
+            readable, _, _ = select.select([self.sock], [], [], min(timeouts + [1.0]))
+            with self.lock:
+                if readable:
+                    datagram, address = self.sock.recvfrom(4096)
+                    self._datagram(datagram, address[:2])
+                now = time.monotonic()
+                for address, session in list(self.sessions.items()):
+                    if session.timeout() == 0:
+                        session.handle_timeout()
+                        self._flush(session)
+                    if session.closed or now - session.last_seen > SESSION_IDLE_S:
+                        self._drop(address)
+
+    def _datagram(self, datagram, address):
+        session = self.sessions.get(address)
+        # A ClientHello (handshake record of epoch 0) on an established
+        # session starts a new session, e.g. after a reset of the client.
+        if session is not None and session.established and datagram[:1] == b'\x16' and \
+                datagram[3:5] == b'\0\0':
+            self._drop(address)
+            session = None
+        if session is None:
+            session = DtlsSession(self.context, address)
+            self.sessions[address] = session
+
+        was_established = session.established
+        try:
+            payloads = session.receive(datagram)
+        except DtlsError as error:
+            print("\nDTLS handshake with %s failed: %s" % (address[0], error))
+            self._drop(address)
+            return
+        self._flush(session)
+
+        if session.established and not was_established:
+            self.current = address
+            self.established.set()
+            print("\nDTLS 1.2 session with %s:%d established (%s)" %
+                  (address[0], address[1], session.cipher()))
+
+        received_ns = time.perf_counter_ns()
+        for payload in payloads:
+            if payload[:1] == b'c' and len(payload) == DTLS_COMMAND_REPLY.size:
+                self.replies.put(DTLS_COMMAND_REPLY.unpack(payload)[1:] + (received_ns,))
+            elif payload[:1] == b'H' and len(payload) == HEARTBEAT.size:
+                _, seq = HEARTBEAT.unpack(payload)
+                session.write(HEARTBEAT.pack(b'h', seq))
+                self._flush(session)
+
+    def _drop(self, address):
+        session = self.sessions.pop(address)
+        if session.established and not session.closed:
+            session.shutdown()
+            self._flush(session)
+        session.free()
+        if address == self.current:
+            self.current = None
+            self.established.clear()
+            print("\nDTLS session with %s closed" % address[0])
+
+# [] END OF FILE
@@ -1,111 +1,505 @@
-#!/usr/bin/env python
-
-#******************************************************************************
-# File Name:   tcp_secure_server.py
-#
-# Description: A simple secure TCP server for demonstrating TCP usage.
-#
-#******************************************************************************
-# Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
-# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
-#
-# This software, including source code, documentation and related
-# materials ("Software") is owned by Cypress Semiconductor Corporation
-# or one of its affiliates ("Cypress") and is protected by and subject to
-# worldwide patent protection (United States and foreign),
-# United States copyright laws and international treaty provisions.
-# Therefore, you may use this Software only as provided in the license
-# agreement accompanying the software package from which you
-# obtained this Software ("EULA").
-# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
-# non-transferable license to copy, modify, and compile the Software
-# source code solely for use in connection with Cypress's
-# integrated circuit products.  Any reproduction, modification, translation,
-# compilation, or representation of this Software except as specified
-# above is prohibited without the express written permission of Cypress.
-#
-# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
-# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
-# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
-# reserves the right to make changes to the Software without notice. Cypress
-# does not assume any liability arising out of the application or use of the
-# Software or any product or circuit described in the Software. Cypress does
-# not authorize its products for use in any products where a malfunction or
-# failure of the Cypress product may reasonably be expected to result in
-# significant property damage, injury or death ("High Risk Product"). By
-# including Cypress's product in a High Risk Product, the manufacturer
-# of such system or application assumes all risk of such use and in doing
-# so agrees to indemnify Cypress against all liability.
-#******************************************************************************/
-
-import socket
-import ssl
-import sys
-
-host = ''       # Symbolic name meaning the local host
-port = 50007    # Arbitrary non-privileged port
-
-# If argument passed is ipv6, use IPv6 addressing mode.
-if ( len(sys.argv) > 1 and sys.argv[1] == "ipv6" ):
-    print("=============================================================================")
-    print("TCP Secure Server (IPv6 addressing mode)")
-    print("=============================================================================")
-    s = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
-    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
-
-# If any argument other than ipv6 is passed, use  IPv4 addressing mode.
-else :
-    print("=============================================================================")
-    print("TCP Secure Server (IPv4 addressing mode)")
-    print("=============================================================================")
-    s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
-
-try:
-    s.bind((host, port))
-    s.listen(1)
-except socket.error as msg:
-    print("ERROR: ", msg)
-    s.close()
-    sys.exit(1)
-
-while True:
-    print("Listening on port: %d"%(port))
-    data_len = 0
-    try:
-        conn, addr = s.accept()
-        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
-        context.load_cert_chain(certfile="server.crt", keyfile="server.key")
-        context.load_verify_locations(cafile="root_ca.crt")
-        connstream = context.wrap_socket(conn, server_side=True)
-    except KeyboardInterrupt:
-        print("Closing Connection")
-        s.close()
-        sys.exit(1)
-
-    print('Incoming connection accepted: ', addr)
-
-    try:
-        while True:
-            data = input("Enter your option: '1' to turn ON LED, 0 to turn"\
-                         " OFF LED and Press the 'Enter' key: ")
-            if(data == ""):
-                print("No option entered!")
-                print("")
-            elif data not in ["0","1"]:
-                print("Invalid command! Please enter '0' or '1'.")
-                print("")
-            else:
-                connstream.write(data.encode())
-                data = connstream.read(4096)
-                if not data: break
-                print("Acknowledgement from TCP Client:", data.decode('utf-8'))
-                print("")
-
-    except KeyboardInterrupt:
-        conn.close()
-        s.close()
-        print("\nConnection Closed")
-        sys.exit(1)
-
-# [] END OF FILE
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   tcp_secure_server.py
+#
+# Description: A simple secure TCP server for demonstrating TCP usage.
+#
+#******************************************************************************
+# Copyright 2019-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import hashlib
+import math
+import queue
+import socket
+import ssl
+import struct
+import sys
+import threading
+import time
+import zlib
+
+from device_link import DeviceLink
+
+host = ''       # Symbolic name meaning the local host
+port = 50007    # Arbitrary non-privileged port
+
+# Latency probe request: 'P' | seq | server timestamp (ns). See device_link.py
+# for the reply.
+PING_REQUEST = struct.Struct('<cIQ')
+
+# Bulk download: 'D' | blob identifier | size, then 'B' | length blocks of the
+# blob from the offset the TCP client answers with. See device_link.py for the
+# status messages of the client. A block and its header must fit one TLS
+# record of the client (MBEDTLS_SSL_IN_CONTENT_LEN, 4096 bytes with
+# BUILD_PROFILE=minimal).
+DOWNLOAD_BEGIN = struct.Struct('<cII')
+DOWNLOAD_BLOCK_HEADER = struct.Struct('<cH')
+DOWNLOAD_BLOCK_MAX_LEN = 4096 - DOWNLOAD_BLOCK_HEADER.size
+DOWNLOAD_STATUS_READY = 0
+DOWNLOAD_STATUS_COMPLETE = 1
+DOWNLOAD_STATUS_BUSY = 3
+# The client pauses the download with a BUSY status when its flash writer
+# does not keep up; the download is resumed after this delay, at most
+# DOWNLOAD_BUSY_RETRIES times in a row without progress.
+DOWNLOAD_BUSY_DELAY = 0.5
+DOWNLOAD_BUSY_RETRIES = 20
+
+parser = argparse.ArgumentParser(description="TCP Secure Server")
+parser.add_argument('mode', nargs='?', default='ipv4', choices=['ipv4', 'ipv6', 'dual'],
+                    help="IP addressing mode; 'dual' accepts IPv4 and IPv6 (default: ipv4)")
+parser.add_argument('--probe-count', type=int, default=0,
+                    help="Run a latency probe train of this many probes after connecting")
+parser.add_argument('--probe-rate', type=float, default=10.0,
+                    help="Probe rate in probes per second, 0 to send the probes back to back "
+                         "(default: 10)")
+parser.add_argument('--tls-version', default='1.3', choices=['1.2', '1.3'],
+                    help="Highest TLS version accepted (default: 1.3)")
+parser.add_argument('--ciphers',
+                    help="OpenSSL cipher list for TLS 1.2, in order of preference "
+                         "(e.g. ECDHE-ECDSA-AES128-GCM-SHA256)")
+parser.add_argument('--curve',
+                    help="ECDHE curve the server accepts (e.g. prime256v1 or X25519)")
+parser.add_argument('--port', type=int, default=port,
+                    help="TCP port to listen on, e.g. behind tools/blackhole_proxy.py "
+                         "(default: %d)" % port)
+parser.add_argument('--bind', default=host, metavar='ADDRESS',
+                    help="Local address to listen on, e.g. the address of the PC on the "
+                         "device's SoftAP or on the Wi-Fi network (default: all addresses)")
+parser.add_argument('--download', metavar='FILE',
+                    help="Download this file into the serial flash of the device after "
+                         "connecting; an interrupted download resumes on the next connection "
+                         "(the TCP client must be built with FLASH_DOWNLOAD=1)")
+parser.add_argument('--dtls', action='store_true',
+                    help="Also accept DTLS sessions on the UDP port and send the LED commands "
+                         "over DTLS when the client has one (ENABLE_DTLS_COMMANDS)")
+parser.add_argument('--command-count', type=int, default=0,
+                    help="Run a train of this many LED commands after connecting, over DTLS "
+                         "with --dtls and over TCP otherwise")
+parser.add_argument('--command-rate', type=float, default=10.0,
+                    help="LED command rate in commands per second, 0 to send the commands "
+                         "back to back (default: 10)")
+parser.add_argument('--param', action='append', default=[], metavar='COMMAND',
+                    help="Run this parameter command on the client after connecting, e.g. "
+                         "--param 'set heartbeat.interval_ms 1000'; may be repeated")
+args = parser.parse_args()
+host = args.bind
+
+# Parameter commands of the client (ENABLE_APP_PARAMS), sent as
+# 'K' | length | command line. The client rejects longer lines.
+PARAM_COMMANDS = ('list', 'get', 'set', 'save', 'defaults')
+PARAM_LINE_MAX = 63
+port = args.port
+
+
+def percentile(sorted_values, fraction):
+    """Nearest-rank percentile of an already sorted list."""
+    index = min(len(sorted_values) - 1, max(0, math.ceil(fraction * len(sorted_values)) - 1))
+    return sorted_values[index]
+
+
+def print_histogram(title, values_us):
+    values = sorted(values_us)
+    print("%s (us): min %d  p50 %d  p99 %d  p999 %d  max %d  mean %.1f" %
+          (title, values[0], percentile(values, 0.50), percentile(values, 0.99),
+           percentile(values, 0.999), values[-1], sum(values) / len(values)))
+
+    # Log2-bucketed histogram.
+    buckets = {}
+    for value in values:
+        bucket = max(1, value).bit_length()
+        buckets[bucket] = buckets.get(bucket, 0) + 1
+    for bucket in sorted(buckets):
+        count = buckets[bucket]
+        print("  %8d - %8d us: %6d %s" % ((1 << (bucket - 1)) if bucket > 1 else 0,
+                                         (1 << bucket) - 1, count,
+                                         '#' * max(1, (50 * count) // len(values))))
+
+
+def read_console(commands):
+    """Reads the options entered by the user, so that the main loop can notice
+    a lost connection while waiting for the next option."""
+    while True:
+        try:
+            commands.put(input())
+        except EOFError:
+            return
+
+
+def next_option(link, commands):
+    """Returns the next option entered by the user. Raises ConnectionError when
+    the TCP client disconnects first."""
+    print("Enter your option: '1' to turn ON LED, 0 to turn"\
+          " OFF LED, 'p' to run a latency probe train, 'm' to"\
+          " read the device metrics, 'f' to download the --download file, 'c' to"\
+          " run an LED command train, 'list', 'get', 'set', 'save' or 'defaults'"\
+          " for the client parameters and"\
+          " Press the 'Enter' key: ", end='', flush=True)
+    while True:
+        try:
+            return commands.get(timeout=0.5)
+        except queue.Empty:
+            if link.closed.is_set():
+                print()
+                raise ConnectionError("Connection closed by the TCP client")
+
+
+def run_probe_train(link, count, rate):
+    """Sends 'count' latency probes at 'rate' probes per second (one
+    outstanding probe at a time) and reports the RTT, device processing
+    time and network time distributions."""
+    rtt_us = []
+    device_us = []
+    network_us = []
+    interval = 1.0 / rate if rate > 0 else 0
+    next_send = time.perf_counter()
+
+    if rate > 0:
+        print("Running %d latency probes at %.1f probes/s..." % (count, rate))
+    else:
+        print("Running %d latency probes back to back..." % count)
+    begin = time.perf_counter()
+    for seq in range(count):
+        delay = next_send - time.perf_counter()
+        if delay > 0:
+            time.sleep(delay)
+        next_send += interval
+
+        sent_ns = time.perf_counter_ns()
+        link.send(PING_REQUEST.pack(b'P', seq, sent_ns))
+        try:
+            reply_seq, echoed_ns, _, device_proc_us, received_ns = link.get_reply('ping')
+        except TimeoutError:
+            print("Probe %d timed out" % seq)
+            continue
+
+        if reply_seq != seq or echoed_ns != sent_ns:
+            print("Unexpected probe reply (seq %d)" % seq)
+            continue
+
+        rtt = (received_ns - sent_ns) // 1000
+        rtt_us.append(rtt)
+        device_us.append(device_proc_us)
+        network_us.append(max(0, rtt - device_proc_us))
+
+    elapsed = time.perf_counter() - begin
+    if rtt_us:
+        print("Completed %d probes in %.2f s: %.1f probes/s" %
+              (len(rtt_us), elapsed, len(rtt_us) / elapsed))
+        print_histogram("Round-trip time   ", rtt_us)
+        print_histogram("Device processing ", device_us)
+        print_histogram("Network           ", network_us)
+    print("")
+
+
+def run_command_train(link, dtls, count, rate):
+    """Sends 'count' LED commands, alternately ON and OFF, at 'rate' commands
+    per second (one outstanding command at a time) over DTLS when dtls is
+    given and over TCP otherwise, and reports the distribution of the time
+    from the command to its acknowledgement."""
+    rtt_us = []
+    retransmissions = 0
+    interval = 1.0 / rate if rate > 0 else 0
+    next_send = time.perf_counter()
+
+    if dtls is not None and not dtls.wait_session(10.0):
+        print("No DTLS session with the TCP client")
+        return
+    print("Running %d LED commands over %s..." % (count, 'DTLS' if dtls is not None else 'TCP'))
+    begin = time.perf_counter()
+    for index in range(count):
+        delay = next_send - time.perf_counter()
+        if delay > 0:
+            time.sleep(delay)
+        next_send += interval
+
+        command = b'1' if index % 2 == 0 else b'0'
+        try:
+            if dtls is not None:
+                _, rtt_ns, _, sent_again = dtls.command(command)
+                retransmissions += sent_again
+            else:
+                sent_ns = time.perf_counter_ns()
+                link.send(command)
+                link.get_reply('ack')
+                rtt_ns = time.perf_counter_ns() - sent_ns
+        except TimeoutError:
+            print("Command %d timed out" % index)
+            continue
+        rtt_us.append(rtt_ns // 1000)
+
+    elapsed = time.perf_counter() - begin
+    if rtt_us:
+        print("Completed %d commands in %.2f s%s" %
+              (len(rtt_us), elapsed,
+               ', %d retransmissions' % retransmissions if dtls is not None else ''))
+        print_histogram("Command to ACK    ", rtt_us)
+    print("")
+
+
+def run_param_command(link, line):
+    """Runs a parameter command on the client and prints its reply."""
+    encoded = line.strip().encode()
+    if len(encoded) > PARAM_LINE_MAX:
+        print("Parameter command longer than %d characters" % PARAM_LINE_MAX)
+        return
+    link.send(b'K' + bytes([len(encoded)]) + encoded)
+    try:
+        text, = link.get_reply('param')
+        print(text, end='')
+    except TimeoutError as msg:
+        print(msg)
+
+
+def send_download_blocks(link, blob, offset):
+    """Sends the blocks of a blob from the given offset. Stops early, and
+    returns the status, when the client answers before the last block."""
+    view = memoryview(blob)
+    for block in range(offset, len(blob), DOWNLOAD_BLOCK_MAX_LEN):
+        try:
+            return link.get_reply('download', timeout=0.0)
+        except TimeoutError:
+            pass
+        data = view[block:block + DOWNLOAD_BLOCK_MAX_LEN]
+        link.send_bulk(DOWNLOAD_BLOCK_HEADER.pack(b'B', len(data)) + data)
+
+    # The last writes and the hash are finished after the last block is sent.
+    return link.get_reply('download', timeout=60.0)
+
+
+def run_download(link, path):
+    """Downloads a file into the serial flash of the TCP client, from the
+    offset the client resumes at, and checks the SHA-256 the client computed
+    over the bytes it wrote. A download paused by the client (BUSY status) is
+    resumed once the blocks already queued are sent. Returns True once the
+    download is complete, and None when the client does not answer the 'D'
+    (built without FLASH_DOWNLOAD=1)."""
+    with open(path, 'rb') as blob_file:
+        blob = blob_file.read()
+    blob_id = zlib.crc32(blob)
+
+    begin = time.perf_counter()
+    sent = None
+    busy = 0
+    while True:
+        link.send(DOWNLOAD_BEGIN.pack(b'D', blob_id, len(blob)))
+        try:
+            status, offset, _, _, _ = link.get_reply('download')
+        except TimeoutError:
+            print("The TCP client does not take downloads; build it with FLASH_DOWNLOAD=1")
+            return None
+        if status == DOWNLOAD_STATUS_READY:
+            busy = 0
+            if offset > 0:
+                print("Resuming the download of %s at offset %d of %d" % (path, offset, len(blob)))
+            else:
+                print("Downloading %s (%d bytes)..." % (path, len(blob)))
+            if sent is None:
+                sent = len(blob) - offset
+            status, offset, elapsed_us, stall_us, digest = send_download_blocks(link, blob, offset)
+        elif status != DOWNLOAD_STATUS_BUSY:
+            print("The TCP client cannot take the download of %d bytes" % len(blob))
+            return False
+
+        if status != DOWNLOAD_STATUS_BUSY:
+            break
+        busy += 1
+        if busy > DOWNLOAD_BUSY_RETRIES:
+            print("The TCP client stayed busy, download stopped at offset %d" % offset)
+            return False
+        print("The TCP client paused the download at offset %d, its flash is busy" % offset)
+        link.cancel_bulk()
+        time.sleep(DOWNLOAD_BUSY_DELAY)
+
+    elapsed = time.perf_counter() - begin
+    if status != DOWNLOAD_STATUS_COMPLETE:
+        print("Download failed at offset %d" % offset)
+        return False
+
+    expected = hashlib.sha256(blob).digest()
+    print("Downloaded %d bytes in %.2f s: %.1f kB/s, receive stalled on the flash for %.1f ms "
+          "of %.1f ms" % (sent, elapsed, sent / elapsed / 1000.0, stall_us / 1000.0,
+                          elapsed_us / 1000.0))
+    print("SHA-256 of the flash contents: %s (%s)" %
+          (digest.hex(), 'match' if digest == expected else 'MISMATCH, expected ' + expected.hex()))
+    print("")
+    return digest == expected
+
+
+# If argument passed is dual, accept IPv4 and IPv6 connections on one socket.
+if ( args.mode == "dual" ):
+    print("=============================================================================")
+    print("TCP Secure Server (IPv4 and IPv6 addressing mode)")
+    print("=============================================================================")
+    s = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
+    s.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_V6ONLY, 0)
+    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+# If argument passed is ipv6, use IPv6 addressing mode.
+elif ( args.mode == "ipv6" ):
+    print("=============================================================================")
+    print("TCP Secure Server (IPv6 addressing mode)")
+    print("=============================================================================")
+    s = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
+    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+# If any argument other than ipv6 is passed, use  IPv4 addressing mode.
+else :
+    print("=============================================================================")
+    print("TCP Secure Server (IPv4 addressing mode)")
+    print("=============================================================================")
+    s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+try:
+    s.bind((host, port))
+    s.listen(1)
+except socket.error as msg:
+    print("ERROR: ", msg)
+    s.close()
+    sys.exit(1)
+
+# TLS 1.3 completes the handshake in one round trip. The context is shared by
+# all connections so that the session tickets it issues stay valid across
+# reconnects.
+context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+context.load_cert_chain(certfile="server.crt", keyfile="server.key")
+context.load_verify_locations(cafile="root_ca.crt")
+context.maximum_version = (ssl.TLSVersion.TLSv1_3 if args.tls_version == '1.3'
+                           else ssl.TLSVersion.TLSv1_2)
+if args.ciphers:
+    context.set_ciphers(args.ciphers)
+if args.curve:
+    context.set_ecdh_curve(args.curve)
+
+dtls = None
+if args.dtls:
+    from dtls_link import DtlsServer
+    dtls = DtlsServer(socket.AF_INET if args.mode == 'ipv4' else socket.AF_INET6, host, port,
+                      "server.crt", "server.key")
+    print("Accepting DTLS sessions on UDP port: %d" % port)
+
+commands = queue.Queue()
+download_pending = args.download is not None
+threading.Thread(target=read_console, args=(commands,), daemon=True).start()
+
+while True:
+    print("Listening on %s port: %d" % (host or 'all addresses,', port))
+    data_len = 0
+    conn, addr = None, ('-',)
+    try:
+        conn, addr = s.accept()
+        accepted_ns = time.perf_counter_ns()
+        connstream = context.wrap_socket(conn, server_side=True)
+    except KeyboardInterrupt:
+        print("Closing Connection")
+        s.close()
+        sys.exit(1)
+    except (ssl.SSLError, OSError) as msg:
+        # E.g. the connection attempt that lost the device's IPv4/IPv6 race.
+        print("Handshake with %s failed: %s" % (addr[0], msg))
+        if conn:
+            conn.close()
+        continue
+
+    print('Incoming connection accepted: ', addr)
+    print('%s handshake (%s) completed in %.1f ms%s' %
+          (connstream.version(), connstream.cipher()[0],
+           (time.perf_counter_ns() - accepted_ns) / 1e6,
+           ' (resumed session)' if connstream.session_reused else ''))
+    link = DeviceLink(connstream, accepted_ns)
+
+    try:
+        if args.probe_count > 0:
+            run_probe_train(link, args.probe_count, args.probe_rate)
+
+        if args.command_count > 0:
+            run_command_train(link, dtls, args.command_count, args.command_rate)
+
+        if download_pending:
+            download_pending = run_download(link, args.download) is False
+
+        for line in args.param:
+            run_param_command(link, line)
+
+        while True:
+            data = next_option(link, commands)
+            if(data == ""):
+                print("No option entered!")
+                print("")
+            elif data == "p":
+                run_probe_train(link, args.probe_count or 1000, args.probe_rate)
+            elif data == "m":
+                # The snapshot is printed by the link when it arrives.
+                link.send(b'M')
+            elif data == "c":
+                run_command_train(link, dtls, args.command_count or 1000, args.command_rate)
+            elif data == "f" and args.download:
+                run_download(link, args.download)
+            elif data.split(' ', 1)[0] in PARAM_COMMANDS:
+                run_param_command(link, data)
+                print("")
+            elif data not in ["0","1"]:
+                print("Invalid command! Please enter '0', '1', 'p', 'm', 'c', 'f' or a "
+                      "parameter command.")
+                print("")
+            elif dtls is not None and dtls.established.is_set():
+                try:
+                    ack, rtt_ns, _, retransmissions = dtls.command(data.encode())
+                    print("Acknowledgement from TCP Client over DTLS: %s (%.1f ms, %d "
+                          "retransmissions)" % (ack, rtt_ns / 1e6, retransmissions))
+                except (TimeoutError, ConnectionError) as msg:
+                    print(msg)
+                print("")
+            else:
+                link.send(data.encode())
+                try:
+                    ack, = link.get_reply('ack')
+                    print("Acknowledgement from TCP Client:", ack)
+                except TimeoutError as msg:
+                    print(msg)
+                print("")
+
+    except ConnectionError as msg:
+        print(msg)
+        link.close()
+
+    except KeyboardInterrupt:
+        link.close()
+        conn.close()
+        s.close()
+        print("\nConnection Closed")
+        sys.exit(1)
+
+# [] END OF FILE
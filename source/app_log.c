@@ -0,0 +1,320 @@
+/******************************************************************************
+* File Name:   app_log.c
+*
+* Description: This file contains the deferred logging subsystem. Producers
+* reserve a slot of the ring buffer with a compare-and-swap and never block;
+* the log task formats the records with printf() or streams them raw over
+* the debug UART.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+
+/* FreeRTOS header file. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Standard C header files. */
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+
+/* Logging header file. */
+#include "app_log.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define APP_LOG_RING_MASK                  (APP_LOG_RING_SIZE - 1u)
+
+#if ((APP_LOG_RING_SIZE & APP_LOG_RING_MASK) != 0u)
+    #error "APP_LOG_RING_SIZE must be a power of two"
+#endif
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+/* Ring buffer slot. The sequence number tells producers and the consumer
+ * whether the slot is free or holds a committed record.
+ */
+typedef struct
+{
+    atomic_uint_fast32_t sequence;
+    app_log_record_t record;
+} app_log_slot_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void app_log_task(void *arg);
+static void app_log_output(const app_log_record_t *record);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static app_log_slot_t log_ring[APP_LOG_RING_SIZE];
+
+/* Next position to be reserved by a producer. */
+static atomic_uint_fast32_t log_head;
+
+/* Next position to be read by the log task (single consumer). */
+static uint32_t log_tail;
+
+/* Records lost because the ring buffer was full. */
+static atomic_uint_fast32_t log_dropped;
+
+/* Runtime log level; records above it are discarded before queueing. */
+static atomic_uint_fast32_t log_level;
+
+#if (!APP_LOG_BINARY_OUTPUT)
+    static const char *const log_level_tag[] = { "", "E", "W", "I", "D" };
+#endif /* !APP_LOG_BINARY_OUTPUT */
+
+/*******************************************************************************
+ * Function Name: app_log_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the ring buffer and creates the log task.
+ *
+ *******************************************************************************/
+void app_log_init(void)
+{
+    for(uint32_t i = 0; i < APP_LOG_RING_SIZE; i++)
+    {
+        atomic_init(&log_ring[i].sequence, i);
+    }
+    atomic_init(&log_head, 0u);
+    atomic_init(&log_dropped, 0u);
+    atomic_init(&log_level, APP_LOG_LEVEL);
+    log_tail = 0u;
+
+    xTaskCreate(app_log_task, "Log task", APP_LOG_TASK_STACK_SIZE, NULL,
+                APP_LOG_TASK_PRIORITY, NULL);
+}
+
+/*******************************************************************************
+ * Function Name: app_log_write
+ *******************************************************************************
+ * Summary:
+ *  Queues a log record. Called through the APP_LOG_xxx macros. Does not block
+ *  and does not format; the record is dropped if the ring buffer is full.
+ *
+ * Parameters:
+ *  uint8_t level: Log level of the record
+ *  const char *fmt: printf() format string with static storage duration
+ *  uint32_t nargs: Number of 32-bit arguments that follow
+ *
+ *******************************************************************************/
+void app_log_write(uint8_t level, const char *fmt, uint32_t nargs, ...)
+{
+    app_log_slot_t *slot;
+    uint_fast32_t position = atomic_load_explicit(&log_head, memory_order_relaxed);
+    va_list args;
+
+    if(level > atomic_load_explicit(&log_level, memory_order_relaxed))
+    {
+        return;
+    }
+
+    for(;;)
+    {
+        slot = &log_ring[position & APP_LOG_RING_MASK];
+        int32_t diff = (int32_t)(atomic_load_explicit(&slot->sequence, memory_order_acquire) - position);
+
+        if(diff == 0)
+        {
+            /* The slot is free; try to claim it. */
+            if(atomic_compare_exchange_weak_explicit(&log_head, &position, position + 1u,
+                                                     memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if(diff < 0)
+        {
+            /* The ring buffer is full. */
+            atomic_fetch_add_explicit(&log_dropped, 1u, memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            /* Another producer claimed the slot; retry with the new head. */
+            position = atomic_load_explicit(&log_head, memory_order_relaxed);
+        }
+    }
+
+    slot->record.timestamp_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    slot->record.fmt = fmt;
+    slot->record.level = level;
+    slot->record.nargs = (uint8_t)((nargs > APP_LOG_MAX_ARGS) ? APP_LOG_MAX_ARGS : nargs);
+
+    va_start(args, nargs);
+    for(uint32_t i = 0; i < slot->record.nargs; i++)
+    {
+        slot->record.args[i] = va_arg(args, uint32_t);
+    }
+    va_end(args);
+
+    /* Publish the record to the log task. */
+    atomic_store_explicit(&slot->sequence, position + 1u, memory_order_release);
+}
+
+/*******************************************************************************
+ * Function Name: app_log_set_level
+ *******************************************************************************
+ * Summary:
+ *  Sets the runtime log level. Only lowers the verbosity below APP_LOG_LEVEL:
+ *  log statements above the compile-time level do not exist.
+ *
+ * Parameters:
+ *  uint32_t level: APP_LOG_LEVEL_NONE to APP_LOG_LEVEL
+ *
+ *******************************************************************************/
+void app_log_set_level(uint32_t level)
+{
+    atomic_store_explicit(&log_level, level, memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * Function Name: app_log_get_dropped_count
+ *******************************************************************************
+ * Summary:
+ *  Returns the number of records dropped because the ring buffer was full.
+ *
+ *******************************************************************************/
+uint32_t app_log_get_dropped_count(void)
+{
+    return (uint32_t)atomic_load_explicit(&log_dropped, memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * Function Name: app_log_task
+ *******************************************************************************
+ * Summary:
+ *  Low-priority task that drains the ring buffer.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ *******************************************************************************/
+static void app_log_task(void *arg)
+{
+    app_log_record_t record;
+    uint32_t dropped_reported = 0u;
+
+    for(;;)
+    {
+        for(;;)
+        {
+            app_log_slot_t *slot = &log_ring[log_tail & APP_LOG_RING_MASK];
+            int32_t diff = (int32_t)(atomic_load_explicit(&slot->sequence, memory_order_acquire) -
+                                     (log_tail + 1u));
+            if(diff < 0)
+            {
+                /* No committed record. */
+                break;
+            }
+
+            record = slot->record;
+
+            /* Release the slot to the producers. */
+            atomic_store_explicit(&slot->sequence, log_tail + APP_LOG_RING_SIZE, memory_order_release);
+            log_tail++;
+
+            app_log_output(&record);
+        }
+
+        if(app_log_get_dropped_count() != dropped_reported)
+        {
+            dropped_reported = app_log_get_dropped_count();
+            printf("[log] %"PRIu32" records dropped\n", dropped_reported);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(APP_LOG_DRAIN_INTERVAL_MS));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: app_log_output
+ *******************************************************************************
+ * Summary:
+ *  Writes one record to the debug UART, either formatted or raw.
+ *
+ * Parameters:
+ *  const app_log_record_t *record: Record to be written
+ *
+ *******************************************************************************/
+static void app_log_output(const app_log_record_t *record)
+{
+#if (APP_LOG_BINARY_OUTPUT)
+    /* Binary record: sync marker, level, argument count, timestamp, format
+     * string address and the arguments, all little-endian.
+     */
+    uint8_t frame[12u + (4u * APP_LOG_MAX_ARGS)];
+    size_t length = 0;
+    uint32_t fmt_address = (uint32_t)(uintptr_t)record->fmt;
+
+    frame[length++] = (uint8_t)(APP_LOG_BINARY_SYNC & 0xFFu);
+    frame[length++] = (uint8_t)(APP_LOG_BINARY_SYNC >> 8);
+    frame[length++] = record->level;
+    frame[length++] = record->nargs;
+    for(uint32_t i = 0; i < 4u; i++)
+    {
+        frame[length++] = (uint8_t)(record->timestamp_ms >> (8u * i));
+    }
+    for(uint32_t i = 0; i < 4u; i++)
+    {
+        frame[length++] = (uint8_t)(fmt_address >> (8u * i));
+    }
+    for(uint32_t arg = 0; arg < record->nargs; arg++)
+    {
+        for(uint32_t i = 0; i < 4u; i++)
+        {
+            frame[length++] = (uint8_t)(record->args[arg] >> (8u * i));
+        }
+    }
+
+    cyhal_uart_write(&cy_retarget_io_uart_obj, frame, &length);
+#else
+    printf("[%"PRIu32"][%s] ", record->timestamp_ms, log_level_tag[record->level]);
+
+    /* Unused arguments are ignored by printf(). */
+    printf(record->fmt, record->args[0], record->args[1], record->args[2], record->args[3]);
+#endif /* APP_LOG_BINARY_OUTPUT */
+}
+
+/* [] END OF FILE */
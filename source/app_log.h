@@ -0,0 +1,143 @@
+/******************************************************************************
+* File Name:   app_log.h
+*
+* Description: This file contains the declarations of the deferred logging
+* subsystem. Log records hold a pointer to the format string and raw
+* 32-bit arguments. They are queued into a lock-free ring buffer and are
+* formatted or streamed out by a low-priority task.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_LOG_H_
+#define APP_LOG_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Log levels. */
+#define APP_LOG_LEVEL_NONE                    (0)
+#define APP_LOG_LEVEL_ERR                     (1)
+#define APP_LOG_LEVEL_WARN                    (2)
+#define APP_LOG_LEVEL_INFO                    (3)
+#define APP_LOG_LEVEL_DEBUG                   (4)
+
+/* Compile-time log level. Log statements above this level compile to
+ * nothing. Can be overridden from the Makefile, e.g.
+ * DEFINES+=APP_LOG_LEVEL=APP_LOG_LEVEL_ERR
+ */
+#ifndef APP_LOG_LEVEL
+#define APP_LOG_LEVEL                         APP_LOG_LEVEL_INFO
+#endif
+
+/* Set this macro to '1' to stream the raw log records over the debug UART
+ * instead of formatting them on the device. Use tools/log_decoder.py with the
+ * application ELF file to decode the stream on the host.
+ */
+#ifndef APP_LOG_BINARY_OUTPUT
+#define APP_LOG_BINARY_OUTPUT                 (0)
+#endif
+
+/* Number of records in the ring buffer. Must be a power of two. */
+#define APP_LOG_RING_SIZE                     (64u)
+
+/* Maximum number of arguments per log record. Arguments must fit in 32 bits;
+ * strings passed for "%s" must have static storage duration.
+ */
+#define APP_LOG_MAX_ARGS                      (4u)
+
+/* Interval at which the log task drains the ring buffer. */
+#define APP_LOG_DRAIN_INTERVAL_MS             (20u)
+
+/* RTOS related macros for the log task. */
+#define APP_LOG_TASK_STACK_SIZE               (1024u)
+#define APP_LOG_TASK_PRIORITY                 (0u)
+
+/* Start-of-record marker of the binary output. */
+#define APP_LOG_BINARY_SYNC                   (0x5AA5u)
+
+/* Counts the arguments of a log statement (0 to APP_LOG_MAX_ARGS). */
+#define APP_LOG_NARGS(...)                    APP_LOG_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define APP_LOG_NARGS_(_0, _1, _2, _3, _4, N, ...)  N
+
+#define APP_LOG_WRITE(level, fmt, ...)        app_log_write((level), (fmt), \
+                                                  APP_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_ERR)
+    #define APP_LOG_ERR(fmt, ...)             APP_LOG_WRITE(APP_LOG_LEVEL_ERR, fmt, ##__VA_ARGS__)
+#else
+    #define APP_LOG_ERR(fmt, ...)             do { } while(0)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_WARN)
+    #define APP_LOG_WARN(fmt, ...)            APP_LOG_WRITE(APP_LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+    #define APP_LOG_WARN(fmt, ...)            do { } while(0)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+    #define APP_LOG_INFO(fmt, ...)            APP_LOG_WRITE(APP_LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+    #define APP_LOG_INFO(fmt, ...)            do { } while(0)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_DEBUG)
+    #define APP_LOG_DEBUG(fmt, ...)           APP_LOG_WRITE(APP_LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+    #define APP_LOG_DEBUG(fmt, ...)           do { } while(0)
+#endif
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+/* Log record as stored in the ring buffer and streamed in binary mode. */
+typedef struct
+{
+    uint32_t timestamp_ms;
+    const char *fmt;
+    uint8_t level;
+    uint8_t nargs;
+    uint32_t args[APP_LOG_MAX_ARGS];
+} app_log_record_t;
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void app_log_init(void);
+void app_log_write(uint8_t level, const char *fmt, uint32_t nargs, ...);
+void app_log_set_level(uint32_t level);
+uint32_t app_log_get_dropped_count(void);
+
+#endif /* APP_LOG_H_ */
@@ -0,0 +1,531 @@
+/******************************************************************************
+* File Name:   app_params.c
+*
+* Description: This file contains the runtime parameter store: the retry
+* and backoff policy, the timeouts, the log level and the telemetry batching
+* that were compile-time macros, with range checks, the get/set/list/save
+* commands entered on the UART terminal or sent by the TCP server, and the
+* saved values in the internal flash.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+/* Standard C header files. */
+#include <errno.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Parameter store header file. */
+#include "app_params.h"
+
+/* Header files of the compile-time defaults. */
+#include "secure_tcp_client.h"
+#include "network_credentials.h"
+#include "telemetry.h"
+#include "app_log.h"
+
+#if(ENABLE_APP_PARAMS)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Marker of a saved parameter record: "PRMS". */
+#define APP_PARAMS_MAGIC                   (0x534D5250u)
+
+/* FNV-1a, for the checksum of the saved record. */
+#define APP_PARAMS_FNV_OFFSET              (0x811C9DC5u)
+#define APP_PARAMS_FNV_PRIME               (0x01000193u)
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+/* Name, default and valid range of a parameter. apply, when set, is called
+ * with every new value, for parameters that are not read at the time of use.
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t default_value;
+    uint32_t min;
+    uint32_t max;
+    void (*apply)(uint32_t value);
+} app_param_info_t;
+
+/* Saved parameters, at the start of the storage row. */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t layout_version;
+    uint16_t count;
+    uint32_t values[APP_PARAM_COUNT];
+    uint32_t checksum;
+} app_params_record_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static int32_t app_params_find(const char *name);
+static bool app_params_parse_value(const char *text, uint32_t *value);
+static uint32_t app_params_checksum(const app_params_record_t *record);
+static bool app_params_load(void);
+static cy_rslt_t app_params_save(void);
+static void app_params_set(app_param_id_t id, uint32_t value);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static const app_param_info_t app_param_info[APP_PARAM_COUNT] =
+{
+    [APP_PARAM_CONNECT_RETRIES]          = { "connect.retries", MAX_TCP_SERVER_CONN_RETRIES, 1u, 100u, NULL },
+    [APP_PARAM_CONNECT_DEADLINE_MS]      = { "connect.deadline_ms", CONNECT_DEADLINE_MS, 1000u, 600000u, NULL },
+    [APP_PARAM_CONNECT_BACKOFF_MS]       = { "connect.backoff_ms", CONNECT_BACKOFF_MS, 10u, 60000u, NULL },
+    [APP_PARAM_CONNECT_BACKOFF_MAX_MS]   = { "connect.backoff_max_ms", CONNECT_BACKOFF_MAX_MS, 10u, 600000u, NULL },
+    [APP_PARAM_TCP_CONNECT_TIMEOUT_MS]   = { "tcp.connect_timeout_ms", TCP_CONNECT_TIMEOUT_MS, 100u, 60000u, NULL },
+    [APP_PARAM_TLS_HANDSHAKE_TIMEOUT_MS] = { "tls.handshake_timeout_ms", TLS_HANDSHAKE_TIMEOUT_MS, 100u, 60000u, NULL },
+    [APP_PARAM_FIRST_BYTE_TIMEOUT_MS]    = { "tls.first_byte_timeout_ms", FIRST_BYTE_TIMEOUT_MS, 100u, 60000u, NULL },
+    [APP_PARAM_HEARTBEAT_INTERVAL_MS]    = { "heartbeat.interval_ms", HEARTBEAT_INTERVAL_MS, 100u, 60000u, NULL },
+    [APP_PARAM_HEARTBEAT_MISSES]         = { "heartbeat.misses", HEARTBEAT_MISS_THRESHOLD, 1u, 20u, NULL },
+    [APP_PARAM_WIFI_RETRIES]             = { "wifi.retries", MAX_WIFI_CONN_RETRIES, 1u, 100u, NULL },
+    [APP_PARAM_WIFI_RETRY_INTERVAL_MS]   = { "wifi.retry_interval_ms", WIFI_CONN_RETRY_INTERVAL_MSEC, 100u, 60000u, NULL },
+    [APP_PARAM_CONSOLE_POLL_TICKS]       = { "console.poll_ticks", RTOS_TICK_TO_WAIT, 1u, 1000u, NULL },
+    /* Levels above the compile-time level have no log statements left. */
+    [APP_PARAM_LOG_LEVEL]                = { "log.level", APP_LOG_LEVEL, APP_LOG_LEVEL_NONE, APP_LOG_LEVEL, app_log_set_level },
+    /* The batch buffer has TELEMETRY_BATCH_SIZE samples. */
+    [APP_PARAM_TELEMETRY_BATCH]          = { "telemetry.batch", TELEMETRY_BATCH_SIZE, 1u, TELEMETRY_BATCH_SIZE, NULL },
+    [APP_PARAM_TELEMETRY_FLUSH_MS]       = { "telemetry.flush_ms", TELEMETRY_FLUSH_DEADLINE_MS, 100u, 600000u, NULL },
+};
+
+static atomic_uint_fast32_t app_param_values[APP_PARAM_COUNT];
+
+/* Serializes the commands of the console and of the TCP server. */
+static SemaphoreHandle_t app_params_mutex;
+
+/* Storage row of the saved parameters, in the emulated EEPROM region. Read
+ * through a volatile pointer, since it changes behind the compiler's back.
+ */
+CY_SECTION(".cy_em_eeprom") CY_ALIGN(APP_PARAMS_STORAGE_SIZE)
+static const uint8_t app_params_storage[APP_PARAMS_STORAGE_SIZE] = { 0u };
+
+/*******************************************************************************
+ * Function Name: app_params_init
+ *******************************************************************************
+ * Summary:
+ *  Sets the parameters to their defaults, or to the saved values when a valid
+ *  record is stored, and applies them.
+ *
+ *******************************************************************************/
+void app_params_init(void)
+{
+    app_params_mutex = xSemaphoreCreateMutex();
+
+    for(uint32_t id = 0; id < APP_PARAM_COUNT; id++)
+    {
+        atomic_init(&app_param_values[id], app_param_info[id].default_value);
+    }
+
+    if(app_params_load())
+    {
+        APP_LOG_INFO("Saved parameters loaded\n");
+    }
+
+    for(uint32_t id = 0; id < APP_PARAM_COUNT; id++)
+    {
+        if(app_param_info[id].apply != NULL)
+        {
+            app_param_info[id].apply(app_param_get((app_param_id_t)id));
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: app_param_get
+ *******************************************************************************
+ * Summary:
+ *  Returns the current value of a parameter. Safe to call from any task.
+ *
+ * Parameters:
+ *  app_param_id_t id: Parameter
+ *
+ * Return:
+ *  uint32_t: Value of the parameter
+ *
+ *******************************************************************************/
+uint32_t app_param_get(app_param_id_t id)
+{
+    return (uint32_t)atomic_load_explicit(&app_param_values[id], memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * Function Name: app_params_is_command
+ *******************************************************************************
+ * Summary:
+ *  Tells whether a line entered on the UART terminal is a parameter command
+ *  rather than a server address.
+ *
+ * Parameters:
+ *  const char *line: Line entered
+ *
+ * Return:
+ *  bool: true for a parameter command
+ *
+ *******************************************************************************/
+bool app_params_is_command(const char *line)
+{
+    static const char *const verbs[] = { "list", "get", "set", "save", "defaults" };
+    size_t length = strcspn(line, " ");
+
+    for(uint32_t i = 0; i < (sizeof(verbs) / sizeof(verbs[0])); i++)
+    {
+        if((strlen(verbs[i]) == length) && (0 == strncmp(line, verbs[i], length)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: app_params_command
+ *******************************************************************************
+ * Summary:
+ *  Executes a parameter command and writes its reply:
+ *   list                 - all parameters with their range and default
+ *   get <name>           - value of a parameter
+ *   set <name> <value>   - changes a parameter after checking its range
+ *   save                 - stores the current values in the flash
+ *   defaults             - restores the defaults (not saved)
+ *
+ * Parameters:
+ *  const char *line: Command line
+ *  char *reply: Buffer for the reply text
+ *  size_t reply_size: Size of the buffer
+ *
+ * Return:
+ *  size_t: Length of the reply, without the terminating NUL
+ *
+ *******************************************************************************/
+size_t app_params_command(const char *line, char *reply, size_t reply_size)
+{
+    char verb[10] = "";
+    char name[32] = "";
+    char text[16] = "";
+    int32_t id = -1;
+    uint32_t value;
+    int length = 0;
+    cy_rslt_t result;
+
+    (void)sscanf(line, "%9s %31s %15s", verb, name, text);
+    if(name[0] != '\0')
+    {
+        id = app_params_find(name);
+    }
+
+    xSemaphoreTake(app_params_mutex, portMAX_DELAY);
+
+    if(0 == strcmp(verb, "list"))
+    {
+        for(uint32_t i = 0; (i < APP_PARAM_COUNT) && ((size_t)length < reply_size); i++)
+        {
+            value = app_param_get((app_param_id_t)i);
+            length += snprintf(&reply[length], reply_size - (size_t)length,
+                               "%-26s %7"PRIu32"%s  (%"PRIu32"..%"PRIu32", default %"PRIu32")\n",
+                               app_param_info[i].name, value,
+                               (value != app_param_info[i].default_value) ? "*" : " ",
+                               app_param_info[i].min, app_param_info[i].max,
+                               app_param_info[i].default_value);
+        }
+    }
+    else if(((0 == strcmp(verb, "get")) || (0 == strcmp(verb, "set"))) && (id < 0))
+    {
+        length = snprintf(reply, reply_size, "Unknown parameter: %s\n", name);
+    }
+    else if(0 == strcmp(verb, "get"))
+    {
+        length = snprintf(reply, reply_size, "%s = %"PRIu32"\n", app_param_info[id].name,
+                          app_param_get((app_param_id_t)id));
+    }
+    else if(0 == strcmp(verb, "set"))
+    {
+        if(!app_params_parse_value(text, &value))
+        {
+            length = snprintf(reply, reply_size, "Invalid value: %s\n", text);
+        }
+        else if((value < app_param_info[id].min) || (value > app_param_info[id].max))
+        {
+            length = snprintf(reply, reply_size, "Out of range: %s must be %"PRIu32"..%"PRIu32"\n",
+                              app_param_info[id].name, app_param_info[id].min, app_param_info[id].max);
+        }
+        else
+        {
+            app_params_set((app_param_id_t)id, value);
+            length = snprintf(reply, reply_size, "%s = %"PRIu32"\n", app_param_info[id].name, value);
+        }
+    }
+    else if(0 == strcmp(verb, "save"))
+    {
+        result = app_params_save();
+        length = (result == CY_RSLT_SUCCESS) ?
+                 snprintf(reply, reply_size, "Parameters saved\n") :
+                 snprintf(reply, reply_size, "Saving the parameters failed! Error code: 0x%08"PRIx32"\n",
+                          result);
+    }
+    else if(0 == strcmp(verb, "defaults"))
+    {
+        for(uint32_t i = 0; i < APP_PARAM_COUNT; i++)
+        {
+            app_params_set((app_param_id_t)i, app_param_info[i].default_value);
+        }
+        length = snprintf(reply, reply_size, "Defaults restored; enter 'save' to keep them\n");
+    }
+    else
+    {
+        length = snprintf(reply, reply_size,
+                          "Commands: list, get <name>, set <name> <value>, save, defaults\n");
+    }
+
+    xSemaphoreGive(app_params_mutex);
+
+    if(length < 0)
+    {
+        length = 0;
+    }
+
+    return ((size_t)length < reply_size) ? (size_t)length : (reply_size - 1u);
+}
+
+/*******************************************************************************
+ * Function Name: app_params_find
+ *******************************************************************************
+ * Summary:
+ *  Looks up a parameter by name.
+ *
+ * Parameters:
+ *  const char *name: Name of the parameter
+ *
+ * Return:
+ *  int32_t: Identifier of the parameter, or -1 if there is none
+ *
+ *******************************************************************************/
+static int32_t app_params_find(const char *name)
+{
+    for(uint32_t id = 0; id < APP_PARAM_COUNT; id++)
+    {
+        if(0 == strcmp(name, app_param_info[id].name))
+        {
+            return (int32_t)id;
+        }
+    }
+
+    return -1;
+}
+
+/*******************************************************************************
+ * Function Name: app_params_parse_value
+ *******************************************************************************
+ * Summary:
+ *  Parses an unsigned decimal or hexadecimal (0x) value.
+ *
+ * Parameters:
+ *  const char *text: Value as entered
+ *  uint32_t *value: Parsed value
+ *
+ * Return:
+ *  bool: true if the whole text is a valid 32-bit value
+ *
+ *******************************************************************************/
+static bool app_params_parse_value(const char *text, uint32_t *value)
+{
+    char *end;
+    unsigned long parsed;
+
+    if((text[0] < '0') || (text[0] > '9'))
+    {
+        return false;
+    }
+
+    errno = 0;
+    parsed = strtoul(text, &end, 0);
+    if((errno != 0) || (*end != '\0') || (parsed > UINT32_MAX))
+    {
+        return false;
+    }
+
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: app_params_set
+ *******************************************************************************
+ * Summary:
+ *  Changes a parameter whose range was checked, and applies it.
+ *
+ * Parameters:
+ *  app_param_id_t id: Parameter
+ *  uint32_t value: New value
+ *
+ *******************************************************************************/
+static void app_params_set(app_param_id_t id, uint32_t value)
+{
+    atomic_store_explicit(&app_param_values[id], value, memory_order_relaxed);
+
+    if(app_param_info[id].apply != NULL)
+    {
+        app_param_info[id].apply(value);
+    }
+
+    APP_LOG_INFO("Parameter %s set to %"PRIu32"\n", app_param_info[id].name, value);
+}
+
+/*******************************************************************************
+ * Function Name: app_params_checksum
+ *******************************************************************************
+ * Summary:
+ *  Computes the FNV-1a hash of a record, up to its checksum field.
+ *
+ * Parameters:
+ *  const app_params_record_t *record: Record
+ *
+ * Return:
+ *  uint32_t: Checksum
+ *
+ *******************************************************************************/
+static uint32_t app_params_checksum(const app_params_record_t *record)
+{
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint32_t hash = APP_PARAMS_FNV_OFFSET;
+
+    for(size_t i = 0; i < offsetof(app_params_record_t, checksum); i++)
+    {
+        hash = (hash ^ bytes[i]) * APP_PARAMS_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/*******************************************************************************
+ * Function Name: app_params_load
+ *******************************************************************************
+ * Summary:
+ *  Takes the saved values when the storage holds a valid record of this
+ *  layout. Values out of range keep their default.
+ *
+ * Return:
+ *  bool: true if a record was loaded
+ *
+ *******************************************************************************/
+static bool app_params_load(void)
+{
+    const volatile uint8_t *storage = app_params_storage;
+    app_params_record_t record;
+    uint8_t *bytes = (uint8_t *)&record;
+
+    for(size_t i = 0; i < sizeof(record); i++)
+    {
+        bytes[i] = storage[i];
+    }
+
+    if((record.magic != APP_PARAMS_MAGIC) || (record.layout_version != APP_PARAMS_LAYOUT_VERSION) ||
+       (record.count != APP_PARAM_COUNT) || (record.checksum != app_params_checksum(&record)))
+    {
+        return false;
+    }
+
+    for(uint32_t id = 0; id < APP_PARAM_COUNT; id++)
+    {
+        if((record.values[id] >= app_param_info[id].min) && (record.values[id] <= app_param_info[id].max))
+        {
+            atomic_store_explicit(&app_param_values[id], record.values[id], memory_order_relaxed);
+        }
+        else
+        {
+            APP_LOG_WARN("Saved value of %s out of range, default kept\n", app_param_info[id].name);
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: app_params_save
+ *******************************************************************************
+ * Summary:
+ *  Writes the current values to the storage row.
+ *
+ * Return:
+ *  cy_rslt_t: Result of the flash write
+ *
+ *******************************************************************************/
+static cy_rslt_t app_params_save(void)
+{
+    /* One flash row; only used under app_params_mutex. */
+    static uint32_t row[APP_PARAMS_STORAGE_SIZE / sizeof(uint32_t)];
+    app_params_record_t *record = (app_params_record_t *)row;
+    cyhal_flash_t flash;
+    cy_rslt_t result;
+
+    memset(row, 0, sizeof(row));
+    record->magic = APP_PARAMS_MAGIC;
+    record->layout_version = APP_PARAMS_LAYOUT_VERSION;
+    record->count = APP_PARAM_COUNT;
+    for(uint32_t id = 0; id < APP_PARAM_COUNT; id++)
+    {
+        record->values[id] = app_param_get((app_param_id_t)id);
+    }
+    record->checksum = app_params_checksum(record);
+
+    result = cyhal_flash_init(&flash);
+    if(result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_flash_write(&flash, (uint32_t)app_params_storage, row);
+        cyhal_flash_free(&flash);
+    }
+
+    return result;
+}
+
+#endif /* ENABLE_APP_PARAMS */
+
+/* [] END OF FILE */
@@ -0,0 +1,113 @@
+/******************************************************************************
+* File Name:   app_params.h
+*
+* Description: This file contains the macros, the parameter identifiers and
+* the prototypes of the runtime parameter store.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_PARAMS_H_
+#define APP_PARAMS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set this macro to '0' to use the compile-time values of the parameters and
+ * remove the parameter store and its commands.
+ */
+#ifndef ENABLE_APP_PARAMS
+#define ENABLE_APP_PARAMS                     (1)
+#endif
+
+/* Longest command line, without the terminating NUL. */
+#define APP_PARAMS_LINE_MAX                   (63u)
+
+/* Longest reply to a command: the listing of all parameters. */
+#define APP_PARAMS_REPLY_MAX                  (1536u)
+
+/* Saved parameters are stored in one row of the emulated EEPROM region of
+ * the internal flash. Increment APP_PARAMS_LAYOUT_VERSION when parameters
+ * are added, removed or reordered, so that older saved values are ignored.
+ */
+#define APP_PARAMS_STORAGE_SIZE               (512u)
+#define APP_PARAMS_LAYOUT_VERSION             (1u)
+
+/* Value of a parameter: the runtime value when the store is enabled, the
+ * compile-time value given as fallback otherwise.
+ */
+#if(ENABLE_APP_PARAMS)
+    #define APP_PARAM(id, fallback)           app_param_get(id)
+#else
+    #define APP_PARAM(id, fallback)           (fallback)
+#endif /* ENABLE_APP_PARAMS */
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+/* Runtime parameters. The default of each one is the compile-time macro it
+ * replaces; the names, defaults and ranges are listed in app_params.c.
+ */
+typedef enum
+{
+    APP_PARAM_CONNECT_RETRIES,          /* MAX_TCP_SERVER_CONN_RETRIES */
+    APP_PARAM_CONNECT_DEADLINE_MS,      /* CONNECT_DEADLINE_MS */
+    APP_PARAM_CONNECT_BACKOFF_MS,       /* CONNECT_BACKOFF_MS */
+    APP_PARAM_CONNECT_BACKOFF_MAX_MS,   /* CONNECT_BACKOFF_MAX_MS */
+    APP_PARAM_TCP_CONNECT_TIMEOUT_MS,   /* TCP_CONNECT_TIMEOUT_MS */
+    APP_PARAM_TLS_HANDSHAKE_TIMEOUT_MS, /* TLS_HANDSHAKE_TIMEOUT_MS */
+    APP_PARAM_FIRST_BYTE_TIMEOUT_MS,    /* FIRST_BYTE_TIMEOUT_MS */
+    APP_PARAM_HEARTBEAT_INTERVAL_MS,    /* HEARTBEAT_INTERVAL_MS */
+    APP_PARAM_HEARTBEAT_MISSES,         /* HEARTBEAT_MISS_THRESHOLD */
+    APP_PARAM_WIFI_RETRIES,             /* MAX_WIFI_CONN_RETRIES */
+    APP_PARAM_WIFI_RETRY_INTERVAL_MS,   /* WIFI_CONN_RETRY_INTERVAL_MSEC */
+    APP_PARAM_CONSOLE_POLL_TICKS,       /* RTOS_TICK_TO_WAIT */
+    APP_PARAM_LOG_LEVEL,                /* APP_LOG_LEVEL */
+    APP_PARAM_TELEMETRY_BATCH,          /* TELEMETRY_BATCH_SIZE */
+    APP_PARAM_TELEMETRY_FLUSH_MS,       /* TELEMETRY_FLUSH_DEADLINE_MS */
+    APP_PARAM_COUNT
+} app_param_id_t;
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void app_params_init(void);
+uint32_t app_param_get(app_param_id_t id);
+bool app_params_is_command(const char *line);
+size_t app_params_command(const char *line, char *reply, size_t reply_size);
+
+#endif /* APP_PARAMS_H_ */
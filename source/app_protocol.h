@@ -0,0 +1,254 @@
+/******************************************************************************
+* File Name:   app_protocol.h
+*
+* Description: This file contains the definitions of the application protocol
+* spoken over the secure TCP connection between the TCP server and the
+* TCP client. All multi-byte fields are little-endian.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_PROTOCOL_H_
+#define APP_PROTOCOL_H_
+
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set this macro to '0' to send the acknowledgements as ASCII strings and the
+ * telemetry samples as fixed-size records instead of the compact encoding.
+ */
+#define USE_COMPACT_ENCODING                  (1)
+
+/* Commands issued from the TCP server. */
+#define LED_ON_CMD                            '1'
+#define LED_OFF_CMD                           '0'
+
+/* Latency probe. The request carries the sequence number and the server
+ * timestamp; the reply echoes both and adds the device receive timestamp
+ * and the time the device spent processing the request.
+ *
+ * Request : 'P' | seq (4) | server_timestamp (8)
+ * Reply   : 'p' | seq (4) | server_timestamp (8) | device_rx_us (4) | device_proc_us (4)
+ */
+#define PING_REQUEST_CMD                      'P'
+#define PING_REPLY_MSG                        'p'
+#define PING_REQUEST_PAYLOAD_LEN              (12u)
+#define PING_REPLY_LEN                        (21u)
+
+/* Telemetry batch pushed by the TCP client.
+ *
+ * Frame   : 'T' | payload length (2) | payload
+ * Payload : format (1) | sample count (1) | samples
+ *
+ * TELEMETRY_FORMAT_FIXED sample:
+ *           timestamp_ms (4) | heap_in_use (4) | heap_max_used (4) |
+ *           rssi_dbm (2, signed) | task_count (2) | stack_hwm_words (2) |
+ *           led_state (1)
+ *
+ * TELEMETRY_FORMAT_DELTA samples:
+ *           The first sample of the batch is encoded against an all-zero
+ *           sample and every other sample against the previous one. Each
+ *           sample is the zigzag varint of the difference of timestamp_ms,
+ *           heap_in_use, heap_max_used, rssi_dbm, task_count and
+ *           stack_hwm_words, in that order (differences are modulo 2^32).
+ *           The LED states of all samples follow as a bitmap, sample 0 in
+ *           bit 0 of the first byte.
+ */
+#define TELEMETRY_MSG                         'T'
+#define TELEMETRY_FRAME_HEADER_LEN            (3u)
+#define TELEMETRY_PAYLOAD_HEADER_LEN          (2u)
+#define TELEMETRY_FORMAT_FIXED                (1u)
+#define TELEMETRY_FORMAT_DELTA                (2u)
+#define TELEMETRY_SAMPLE_LEN                  (19u)
+#define TELEMETRY_DELTA_FIELD_COUNT           (6u)
+
+/* State report sent by the TCP client as the first message on every
+ * connection. The status byte uses the ACK_STATUS_* bits. The handshake time
+ * covers the TCP connection and the TLS handshake.
+ *
+ * Report  : 'S' | status (1) | connection_count (2) | handshake_us (4)
+ */
+#define STATE_REPORT_MSG                      'S'
+#define STATE_REPORT_LEN                      (8u)
+
+/* Heartbeat sent by the TCP client while connected. The server echoes the
+ * sequence number.
+ *
+ * Request : 'H' | seq (4)
+ * Reply   : 'h' | seq (4)
+ */
+#define HEARTBEAT_MSG                         'H'
+#define HEARTBEAT_REPLY_CMD                   'h'
+#define HEARTBEAT_LEN                         (5u)
+
+/* Metrics snapshot, requested by the server and returned by the TCP client.
+ * All values are varints. Counters, gauges and histograms are sent in the
+ * order of their identifiers in metrics.h; the counts let a decoder skip
+ * values added by a newer client.
+ *
+ * Request : 'M'
+ * Reply   : 'm' | payload length (2) | payload
+ * Payload : version (1) | uptime_ms | counter count (1) | counters |
+ *           gauge count (1) | gauges | histogram count (1) | histograms |
+ *           failure code count (1) | failure codes
+ * Histogram : bucket count (1) | sample count | max | buckets
+ * Failure code : result code | failure count
+ */
+#define METRICS_REQUEST_CMD                   'M'
+#define METRICS_MSG                           'm'
+#define METRICS_FRAME_HEADER_LEN              (3u)
+#define METRICS_FORMAT_VERSION                (1u)
+
+/* Bulk download into the serial flash. The server starts a blob, or resumes
+ * it after a disconnect, with 'D'. The client answers with a READY status
+ * that gives the offset from which the server sends the blob, in blocks of up
+ * to DOWNLOAD_BLOCK_MAX_LEN bytes, so that a block and its header fit the
+ * 4096-byte TLS record of BUILD_PROFILE=minimal (MBEDTLS_SSL_IN_CONTENT_LEN).
+ * Longer blocks are skipped. Other messages may be sent between the
+ * blocks. Once the last block is written, the client sends a COMPLETE status
+ * with the SHA-256 of the blob as written, the time since the 'D' and the time
+ * the receiving waited for the flash. An ERROR status carries the number of
+ * bytes written so far. A BUSY status pauses the download when the flash does
+ * not keep up (see FLASH_DOWNLOAD_WAIT_MS) or when the client is still writing
+ * at a 'D': the client skips the blocks until the next 'D', which the server
+ * sends after its queued blocks to resume the blob.
+ *
+ * Begin   : 'D' | blob_id (4) | size (4)
+ * Block   : 'B' | length (2) | data
+ * Status  : 'd' | status (1) | offset (4) | elapsed_us (4) | stall_us (4) | sha256 (32)
+ */
+#define DOWNLOAD_BEGIN_CMD                    'D'
+#define DOWNLOAD_BLOCK_CMD                    'B'
+#define DOWNLOAD_STATUS_MSG                   'd'
+#define DOWNLOAD_BEGIN_PAYLOAD_LEN            (8u)
+#define DOWNLOAD_BLOCK_HEADER_LEN             (3u)
+#define DOWNLOAD_BLOCK_MAX_LEN                (4096u - DOWNLOAD_BLOCK_HEADER_LEN)
+#define DOWNLOAD_STATUS_LEN                   (46u)
+#define DOWNLOAD_STATUS_READY                 (0u)
+#define DOWNLOAD_STATUS_COMPLETE              (1u)
+#define DOWNLOAD_STATUS_ERROR                 (2u)
+#define DOWNLOAD_STATUS_BUSY                  (3u)
+#define DOWNLOAD_SHA256_LEN                   (32u)
+
+/* LED commands over the DTLS transport, one command or reply per datagram.
+ * The server retransmits a command with the same sequence number until the
+ * reply arrives; the client executes each sequence number once and answers a
+ * retransmission with the reply it already sent. The reply echoes the server
+ * timestamp and adds the device processing time, as the latency probe does.
+ * Heartbeats ('H' / 'h') are sent over the DTLS transport as well.
+ *
+ * Command : 'C' | seq (4) | server timestamp (8) | LED_ON_CMD or LED_OFF_CMD (1)
+ * Reply   : 'c' | seq (4) | server timestamp (8) | ack status (1) | device_proc_us (4)
+ */
+#define DTLS_COMMAND_MSG                      'C'
+#define DTLS_COMMAND_REPLY_MSG                'c'
+#define DTLS_COMMAND_LEN                      (14u)
+#define DTLS_COMMAND_REPLY_LEN                (18u)
+
+/* Runtime parameter command, as entered on the UART terminal (list, get,
+ * set, save, defaults), sent by the server. The reply is the text the
+ * terminal would print.
+ *
+ * Command : 'K' | length (1) | command line
+ * Reply   : 'k' | length (2) | reply text
+ */
+#define PARAM_REQUEST_CMD                     'K'
+#define PARAM_REPLY_MSG                       'k'
+#define PARAM_REPLY_HEADER_LEN                (3u)
+
+/* Acknowledgements sent to the TCP server.
+ *
+ * Compact : 'A' | status (1)
+ * ASCII   : ACK_LED_ON, ACK_LED_OFF or MSG_INVALID_CMD
+ *
+ * The status byte carries the state of the LED after the command in bit 0
+ * and flags an invalid command in bit 1.
+ */
+#define ACK_MSG                               'A'
+#define ACK_MSG_LEN                           (2u)
+#define ACK_STATUS_LED_ON                     (1u << 0)
+#define ACK_STATUS_INVALID_CMD                (1u << 1)
+
+#define ACK_LED_ON                            "LED ON ACK"
+#define ACK_LED_OFF                           "LED OFF ACK"
+#define MSG_INVALID_CMD                       "Invalid command"
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+static inline void app_protocol_put_u32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+static inline void app_protocol_put_u16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+}
+
+static inline uint16_t app_protocol_get_u16(const uint8_t *buffer)
+{
+    return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+static inline uint32_t app_protocol_get_u32(const uint8_t *buffer)
+{
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) |
+           ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+/* Writes the acknowledgement for the given status into the buffer and
+ * returns its length.
+ */
+static inline uint32_t app_protocol_put_ack(char *buffer, uint8_t status)
+{
+#if(USE_COMPACT_ENCODING)
+    buffer[0] = ACK_MSG;
+    buffer[1] = (char)status;
+    return ACK_MSG_LEN;
+#else
+    const char *ack = ((status & ACK_STATUS_INVALID_CMD) != 0u) ? MSG_INVALID_CMD :
+                      ((status & ACK_STATUS_LED_ON) != 0u) ? ACK_LED_ON : ACK_LED_OFF;
+    strcpy(buffer, ack);
+    return (uint32_t)strlen(ack);
+#endif /* USE_COMPACT_ENCODING */
+}
+
+#endif /* APP_PROTOCOL_H_ */
@@ -0,0 +1,144 @@
+/******************************************************************************
+* File Name:   app_time.c
+*
+* Description: This file contains the high resolution timestamp functions.
+* The DWT cycle counter of the Cortex-M core runs at the CPU clock and
+* wraps after 2^32 cycles (about 28 s at 150 MHz). Durations shorter than
+* that are measured directly in cycles; app_time_us() extends the counter
+* to 64 bits and must be called at least once per wrap period.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header file. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Timestamp header file. */
+#include "app_time.h"
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Extended cycle count at the last call and the tick count read with it. */
+static uint64_t cycles_total;
+static TickType_t cycles_tick;
+
+/*******************************************************************************
+ * Function Name: app_time_init
+ *******************************************************************************
+ * Summary:
+ *  Enables the DWT cycle counter.
+ *
+ *******************************************************************************/
+void app_time_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    cycles_total = 0u;
+    cycles_tick = xTaskGetTickCount();
+}
+
+/*******************************************************************************
+ * Function Name: app_time_cycles
+ *******************************************************************************
+ * Summary:
+ *  Returns the current value of the 32-bit cycle counter.
+ *
+ *******************************************************************************/
+uint32_t app_time_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*******************************************************************************
+ * Function Name: app_time_cycles_to_us
+ *******************************************************************************
+ * Summary:
+ *  Converts a number of CPU cycles to microseconds.
+ *
+ * Parameters:
+ *  uint32_t cycles: Number of CPU cycles
+ *
+ *******************************************************************************/
+uint32_t app_time_cycles_to_us(uint32_t cycles)
+{
+    return (uint32_t)(((uint64_t)cycles * 1000000u) / SystemCoreClock);
+}
+
+/*******************************************************************************
+ * Function Name: app_time_us
+ *******************************************************************************
+ * Summary:
+ *  Returns the time in microseconds since app_time_init() was called, based
+ *  on the cycle counter extended to 64 bits. The RTOS tick count gives the
+ *  number of cycles elapsed since the last call to within one tick, so wraps
+ *  of the 32-bit counter are not missed when the function is not called for
+ *  longer than a wrap period. The counter only adds the cycles within the
+ *  tick. The result never goes backwards.
+ *
+ *******************************************************************************/
+uint64_t app_time_us(void)
+{
+    TickType_t ticks;
+    uint64_t expected;
+    uint64_t cycles;
+    uint32_t now;
+
+    taskENTER_CRITICAL();
+    now = DWT->CYCCNT;
+    ticks = xTaskGetTickCount() - cycles_tick;
+    cycles_tick += ticks;
+
+    /* Of the counts that end with the value read, take the one closest to the
+     * count expected from the ticks.
+     */
+    expected = cycles_total + ((uint64_t)ticks * (SystemCoreClock / configTICK_RATE_HZ));
+    cycles = expected + (uint64_t)(int64_t)(int32_t)(now - (uint32_t)expected);
+    if(cycles > cycles_total)
+    {
+        cycles_total = cycles;
+    }
+    cycles = cycles_total;
+    taskEXIT_CRITICAL();
+
+    return cycles / (SystemCoreClock / 1000000u);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,399 @@
+/******************************************************************************
+* File Name:   cert_cache.c
+*
+* Description: This file contains the verified server certificate cache.
+* Mbed TLS verifies the certificate chain of the server on every handshake,
+* which costs at least one ECDSA verification. The cache remembers the
+* certificates that passed verification and skips the chain verification
+* when the same certificate is presented again.
+*
+* The secure sockets library does not expose the verification hooks of Mbed
+* TLS, so the cache wraps mbedtls_x509_crt_verify_restartable() with the GNU
+* linker option --wrap (see CERT_CACHE in the Makefile).
+*
+* A cached verification is only used when:
+* - The server certificate, the trusted root CA certificates and the expected
+* common name are identical (they are hashed together into the cache key).
+* - It is younger than CERT_CACHE_TTL_MS.
+* - The certificate is still within its validity period (when Mbed TLS has
+* access to the date and time).
+* - No certificate revocation list is in use.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Standard C header files. */
+#include <string.h>
+#include <stdbool.h>
+
+/* Mbed TLS header files. */
+#include "mbedtls/build_info.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/sha256.h"
+
+/* Certificate cache and timestamp header files. */
+#include "cert_cache.h"
+#include "app_time.h"
+
+#if(ENABLE_CERT_CACHE)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define CERT_CACHE_KEY_LEN                 (32u)
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+typedef struct
+{
+    bool valid;
+    uint8_t key[CERT_CACHE_KEY_LEN];
+    TickType_t verified_tick;
+    TickType_t used_tick;
+} cert_cache_entry_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+int __real_mbedtls_x509_crt_verify_restartable(mbedtls_x509_crt *crt,
+        mbedtls_x509_crt *trust_ca, mbedtls_x509_crl *ca_crl,
+        const mbedtls_x509_crt_profile *profile, const char *cn, uint32_t *flags,
+        int (*f_vrfy)(void *, mbedtls_x509_crt *, int, uint32_t *), void *p_vrfy,
+        mbedtls_x509_crt_restart_ctx *rs_ctx);
+static bool cert_cache_compute_key(const mbedtls_x509_crt *crt, const mbedtls_x509_crt *trust_ca,
+                                   const char *cn, uint8_t *key);
+static bool cert_cache_lookup(const uint8_t *key);
+static void cert_cache_insert(const uint8_t *key);
+static void cert_cache_remove(const uint8_t *key);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static cert_cache_entry_t cert_cache[CERT_CACHE_ENTRIES];
+static cert_cache_stats_t cert_cache_stats;
+
+/*******************************************************************************
+ * Function Name: __wrap_mbedtls_x509_crt_verify_restartable
+ *******************************************************************************
+ * Summary:
+ *  Replaces mbedtls_x509_crt_verify_restartable() at link time. Returns the
+ *  cached result for a known server certificate and runs the full chain
+ *  verification otherwise. The parameters and the return value are those of
+ *  the Mbed TLS function.
+ *
+ *******************************************************************************/
+int __wrap_mbedtls_x509_crt_verify_restartable(mbedtls_x509_crt *crt,
+        mbedtls_x509_crt *trust_ca, mbedtls_x509_crl *ca_crl,
+        const mbedtls_x509_crt_profile *profile, const char *cn, uint32_t *flags,
+        int (*f_vrfy)(void *, mbedtls_x509_crt *, int, uint32_t *), void *p_vrfy,
+        mbedtls_x509_crt_restart_ctx *rs_ctx)
+{
+    uint8_t key[CERT_CACHE_KEY_LEN];
+    uint32_t begin_cycles = app_time_cycles();
+    bool cacheable;
+    int ret;
+
+    /* Revocation lists can change independently of the certificates. */
+    cacheable = (ca_crl == NULL) && cert_cache_compute_key(crt, trust_ca, cn, key);
+
+    if(cacheable && cert_cache_lookup(key))
+    {
+    #if defined(MBEDTLS_HAVE_TIME_DATE)
+        if(mbedtls_x509_time_is_past(&crt->valid_to) || mbedtls_x509_time_is_future(&crt->valid_from))
+        {
+            cert_cache_remove(key);
+        }
+        else
+    #endif /* MBEDTLS_HAVE_TIME_DATE */
+        {
+            *flags = 0u;
+            ret = 0;
+
+            /* The verification callback still sees the server certificate. */
+            if(f_vrfy != NULL)
+            {
+                ret = f_vrfy(p_vrfy, crt, 0, flags);
+                if((ret == 0) && (*flags != 0u))
+                {
+                    ret = MBEDTLS_ERR_X509_CERT_VERIFY_FAILED;
+                }
+            }
+
+            taskENTER_CRITICAL();
+            cert_cache_stats.hits++;
+            cert_cache_stats.last_verify_us = app_time_cycles_to_us(app_time_cycles() - begin_cycles);
+            taskEXIT_CRITICAL();
+
+            return ret;
+        }
+    }
+
+    ret = __real_mbedtls_x509_crt_verify_restartable(crt, trust_ca, ca_crl, profile, cn,
+                                                     flags, f_vrfy, p_vrfy, rs_ctx);
+    if(cacheable)
+    {
+        if((ret == 0) && (*flags == 0u))
+        {
+            cert_cache_insert(key);
+        }
+        else if(ret != MBEDTLS_ERR_ECP_IN_PROGRESS)
+        {
+            cert_cache_remove(key);
+        }
+    }
+
+    taskENTER_CRITICAL();
+    cert_cache_stats.misses++;
+    cert_cache_stats.last_verify_us = app_time_cycles_to_us(app_time_cycles() - begin_cycles);
+    taskEXIT_CRITICAL();
+
+    return ret;
+}
+
+/*******************************************************************************
+ * Function Name: cert_cache_compute_key
+ *******************************************************************************
+ * Summary:
+ *  Computes the cache key: SHA-256 of the server certificate, the trusted
+ *  root CA certificates and the expected common name.
+ *
+ * Parameters:
+ *  const mbedtls_x509_crt *crt: Server certificate (first of the chain)
+ *  const mbedtls_x509_crt *trust_ca: Trusted root CA certificates
+ *  const char *cn: Expected common name, or NULL
+ *  uint8_t *key: Cache key (CERT_CACHE_KEY_LEN bytes)
+ *
+ * Return:
+ *  bool: true if the key was computed
+ *
+ *******************************************************************************/
+static bool cert_cache_compute_key(const mbedtls_x509_crt *crt, const mbedtls_x509_crt *trust_ca,
+                                   const char *cn, uint8_t *key)
+{
+    mbedtls_sha256_context sha256;
+    int ret;
+
+    mbedtls_sha256_init(&sha256);
+    ret = mbedtls_sha256_starts(&sha256, 0);
+    if(ret == 0)
+    {
+        ret = mbedtls_sha256_update(&sha256, crt->raw.p, crt->raw.len);
+    }
+    for(const mbedtls_x509_crt *ca = trust_ca; (ca != NULL) && (ret == 0); ca = ca->next)
+    {
+        ret = mbedtls_sha256_update(&sha256, ca->raw.p, ca->raw.len);
+    }
+    if((cn != NULL) && (ret == 0))
+    {
+        ret = mbedtls_sha256_update(&sha256, (const unsigned char *)cn, strlen(cn) + 1u);
+    }
+    if(ret == 0)
+    {
+        ret = mbedtls_sha256_finish(&sha256, key);
+    }
+    mbedtls_sha256_free(&sha256);
+
+    return (ret == 0);
+}
+
+/*******************************************************************************
+ * Function Name: cert_cache_lookup
+ *******************************************************************************
+ * Summary:
+ *  Looks the key up and drops the entries older than CERT_CACHE_TTL_MS.
+ *
+ * Parameters:
+ *  const uint8_t *key: Cache key
+ *
+ * Return:
+ *  bool: true if the key is cached
+ *
+ *******************************************************************************/
+static bool cert_cache_lookup(const uint8_t *key)
+{
+    TickType_t now = xTaskGetTickCount();
+    bool found = false;
+
+    taskENTER_CRITICAL();
+    for(uint32_t i = 0; i < CERT_CACHE_ENTRIES; i++)
+    {
+        cert_cache_entry_t *entry = &cert_cache[i];
+
+        if(!entry->valid)
+        {
+            continue;
+        }
+
+        if((now - entry->verified_tick) >= pdMS_TO_TICKS(CERT_CACHE_TTL_MS))
+        {
+            entry->valid = false;
+            cert_cache_stats.evictions++;
+        }
+        else if(memcmp(entry->key, key, CERT_CACHE_KEY_LEN) == 0)
+        {
+            entry->used_tick = now;
+            found = true;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return found;
+}
+
+/*******************************************************************************
+ * Function Name: cert_cache_insert
+ *******************************************************************************
+ * Summary:
+ *  Remembers a verified certificate. Replaces the least recently used entry
+ *  when the cache is full.
+ *
+ * Parameters:
+ *  const uint8_t *key: Cache key
+ *
+ *******************************************************************************/
+static void cert_cache_insert(const uint8_t *key)
+{
+    TickType_t now = xTaskGetTickCount();
+    cert_cache_entry_t *slot = &cert_cache[0];
+
+    taskENTER_CRITICAL();
+    for(uint32_t i = 0; i < CERT_CACHE_ENTRIES; i++)
+    {
+        cert_cache_entry_t *entry = &cert_cache[i];
+
+        if(entry->valid && (memcmp(entry->key, key, CERT_CACHE_KEY_LEN) == 0))
+        {
+            slot = entry;
+            break;
+        }
+        if(!entry->valid)
+        {
+            if(slot->valid)
+            {
+                slot = entry;
+            }
+        }
+        else if(slot->valid && ((now - entry->used_tick) > (now - slot->used_tick)))
+        {
+            slot = entry;
+        }
+    }
+
+    if(slot->valid && (memcmp(slot->key, key, CERT_CACHE_KEY_LEN) != 0))
+    {
+        cert_cache_stats.evictions++;
+    }
+
+    memcpy(slot->key, key, CERT_CACHE_KEY_LEN);
+    slot->verified_tick = now;
+    slot->used_tick = now;
+    slot->valid = true;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: cert_cache_remove
+ *******************************************************************************
+ * Summary:
+ *  Forgets a certificate that failed verification or is no longer valid.
+ *
+ * Parameters:
+ *  const uint8_t *key: Cache key
+ *
+ *******************************************************************************/
+static void cert_cache_remove(const uint8_t *key)
+{
+    taskENTER_CRITICAL();
+    for(uint32_t i = 0; i < CERT_CACHE_ENTRIES; i++)
+    {
+        if(cert_cache[i].valid && (memcmp(cert_cache[i].key, key, CERT_CACHE_KEY_LEN) == 0))
+        {
+            cert_cache[i].valid = false;
+            cert_cache_stats.evictions++;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: cert_cache_clear
+ *******************************************************************************
+ * Summary:
+ *  Forgets all certificates, e.g. after the trusted root CA certificates have
+ *  been replaced.
+ *
+ *******************************************************************************/
+void cert_cache_clear(void)
+{
+    taskENTER_CRITICAL();
+    for(uint32_t i = 0; i < CERT_CACHE_ENTRIES; i++)
+    {
+        if(cert_cache[i].valid)
+        {
+            cert_cache[i].valid = false;
+            cert_cache_stats.evictions++;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: cert_cache_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the hit, miss and eviction counters and the duration of the last
+ *  verification.
+ *
+ * Parameters:
+ *  cert_cache_stats_t *stats: Statistics to be filled
+ *
+ *******************************************************************************/
+void cert_cache_get_stats(cert_cache_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = cert_cache_stats;
+    taskEXIT_CRITICAL();
+}
+
+#endif /* ENABLE_CERT_CACHE */
+
+/* [] END OF FILE */
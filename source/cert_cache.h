@@ -0,0 +1,81 @@
+/******************************************************************************
+* File Name:   cert_cache.h
+*
+* Description: This file contains the declarations of the verified server
+* certificate cache.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CERT_CACHE_H_
+#define CERT_CACHE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set by the Makefile (CERT_CACHE=1), together with the linker option that
+ * routes the chain verification of Mbed TLS through the cache.
+ */
+#ifndef ENABLE_CERT_CACHE
+#define ENABLE_CERT_CACHE                     (0)
+#endif
+
+/* Number of server certificates remembered. */
+#define CERT_CACHE_ENTRIES                    (4u)
+
+/* A cached verification is trusted for this long. After that, the chain is
+ * verified again in full, which also picks up changes of the trusted root CA
+ * certificates or of the certificate validity.
+ */
+#define CERT_CACHE_TTL_MS                     (60u * 60u * 1000u)
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+typedef struct
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t last_verify_us;
+} cert_cache_stats_t;
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void cert_cache_clear(void);
+void cert_cache_get_stats(cert_cache_stats_t *stats);
+
+#endif /* CERT_CACHE_H_ */
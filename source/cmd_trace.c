@@ -0,0 +1,457 @@
+/******************************************************************************
+* File Name:   cmd_trace.c
+*
+* Description: This file contains the command trace. The receive path of a
+* server command records timestamped trace points with a correlation ID into a
+* ring buffer, from the last frame delivered by the Wi-Fi driver to the
+* acknowledgement. A low-priority task writes the records to the debug UART,
+* where tools/trace_decoder.py turns them into per-stage latency
+* distributions. Optionally, every trace point also toggles a spare GPIO for
+* capture with a logic analyser.
+*
+* Built with CMD_TRACE_HOST defined, the file is a host program that runs a
+* simulated command path through the same trace, with the GPIO write stubbed
+* and a nanosecond clock in place of the cycle counter, and prints the
+* records to stdout.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+
+#if defined(CMD_TRACE_HOST)
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef ENABLE_CMD_TRACE
+#define ENABLE_CMD_TRACE                   (1)
+#endif
+#else
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Wi-Fi network interface header file. */
+#include "cy_network_mw_core.h"
+
+/* Timestamp header file. */
+#include "app_time.h"
+#endif /* CMD_TRACE_HOST */
+
+/* Command trace header file. */
+#include "cmd_trace.h"
+
+#if(ENABLE_CMD_TRACE)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define CMD_TRACE_RING_MASK                (CMD_TRACE_RING_SIZE - 1u)
+
+#if defined(CMD_TRACE_HOST)
+    /* Nanosecond clock truncated to 32 bits, in place of the cycle counter. */
+    #define CMD_TRACE_CLOCK_HZ             (1000000000u)
+    #define CMD_TRACE_GPIO_TOGGLE()        (cmd_trace_gpio_toggles++)
+
+    /* The host simulation traces from a single thread. */
+    #define CMD_TRACE_LOCK()               do { } while(0)
+    #define CMD_TRACE_UNLOCK()             do { } while(0)
+#else
+    #define CMD_TRACE_CLOCK_HZ             (SystemCoreClock)
+    #define CMD_TRACE_GPIO_TOGGLE()        cyhal_gpio_toggle(CMD_TRACE_GPIO_PIN)
+
+    /* Commands are traced by the socket worker and by the DTLS task. The
+     * critical section covers a few stores only.
+     */
+    #define CMD_TRACE_LOCK()               taskENTER_CRITICAL()
+    #define CMD_TRACE_UNLOCK()             taskEXIT_CRITICAL()
+#endif /* CMD_TRACE_HOST */
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+typedef struct
+{
+    uint32_t cycles;
+    uint16_t id;
+    uint8_t point;
+} cmd_trace_record_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static uint32_t cmd_trace_cycles(void);
+static void cmd_trace_record(uint32_t id, cmd_trace_point_t point, uint32_t cycles);
+static void cmd_trace_drain(void);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Written by the command paths under CMD_TRACE_LOCK(); read by the trace
+ * task.
+ */
+static cmd_trace_record_t cmd_trace_ring[CMD_TRACE_RING_SIZE];
+static atomic_uint_fast32_t cmd_trace_head;
+static atomic_uint_fast32_t cmd_trace_tail;
+static atomic_uint_fast32_t cmd_trace_dropped;
+
+/* Correlation ID of the last command. */
+static uint32_t cmd_trace_last_id;
+
+/* Time of the last frame delivered by the Wi-Fi driver. */
+static volatile uint32_t cmd_trace_last_rx_cycles;
+static volatile uint32_t cmd_trace_rx_frames;
+
+#if defined(CMD_TRACE_HOST)
+    static uint32_t cmd_trace_gpio_toggles;
+#endif /* CMD_TRACE_HOST */
+
+/*******************************************************************************
+ * Function Name: cmd_trace_begin
+ *******************************************************************************
+ * Summary:
+ *  Starts the trace of a command at the entry of the receive callback. The
+ *  last frame delivered by the Wi-Fi driver is recorded as the radio receive
+ *  time of the command.
+ *
+ * Return:
+ *  uint32_t: Correlation ID of the command
+ *
+ *******************************************************************************/
+uint32_t cmd_trace_begin(void)
+{
+    uint32_t now = cmd_trace_cycles();
+    uint32_t id;
+
+    CMD_TRACE_LOCK();
+    id = ++cmd_trace_last_id;
+    CMD_TRACE_UNLOCK();
+
+    if(cmd_trace_rx_frames != 0u)
+    {
+        cmd_trace_record(id, CMD_TRACE_RADIO_RX, cmd_trace_last_rx_cycles);
+    }
+    cmd_trace_record(id, CMD_TRACE_CALLBACK, now);
+
+    #if(ENABLE_CMD_TRACE_GPIO)
+        CMD_TRACE_GPIO_TOGGLE();
+    #endif /* ENABLE_CMD_TRACE_GPIO */
+
+    return id;
+}
+
+/*******************************************************************************
+ * Function Name: cmd_trace_point
+ *******************************************************************************
+ * Summary:
+ *  Records a trace point of a command. Does not block; the record is dropped
+ *  if the ring is full.
+ *
+ * Parameters:
+ *  uint32_t id: Correlation ID returned by cmd_trace_begin()
+ *  cmd_trace_point_t point: Trace point
+ *
+ *******************************************************************************/
+void cmd_trace_point(uint32_t id, cmd_trace_point_t point)
+{
+    cmd_trace_record(id, point, cmd_trace_cycles());
+
+    #if(ENABLE_CMD_TRACE_GPIO)
+        CMD_TRACE_GPIO_TOGGLE();
+    #endif /* ENABLE_CMD_TRACE_GPIO */
+}
+
+/*******************************************************************************
+ * Function Name: cmd_trace_record
+ *******************************************************************************
+ * Summary:
+ *  Adds a record to the ring. Safe to call from several tasks: the slot is
+ *  reserved, written and published under CMD_TRACE_LOCK().
+ *
+ * Parameters:
+ *  uint32_t id: Correlation ID
+ *  cmd_trace_point_t point: Trace point
+ *  uint32_t cycles: Timestamp in clock cycles
+ *
+ *******************************************************************************/
+static void cmd_trace_record(uint32_t id, cmd_trace_point_t point, uint32_t cycles)
+{
+    uint_fast32_t head;
+    cmd_trace_record_t *record;
+
+    CMD_TRACE_LOCK();
+    head = atomic_load_explicit(&cmd_trace_head, memory_order_relaxed);
+    if((head - atomic_load_explicit(&cmd_trace_tail, memory_order_acquire)) >= CMD_TRACE_RING_SIZE)
+    {
+        CMD_TRACE_UNLOCK();
+        atomic_fetch_add_explicit(&cmd_trace_dropped, 1u, memory_order_relaxed);
+        return;
+    }
+
+    record = &cmd_trace_ring[head & CMD_TRACE_RING_MASK];
+    record->cycles = cycles;
+    record->id = (uint16_t)id;
+    record->point = (uint8_t)point;
+
+    /* Publish the record to the trace task. */
+    atomic_store_explicit(&cmd_trace_head, head + 1u, memory_order_release);
+    CMD_TRACE_UNLOCK();
+}
+
+/*******************************************************************************
+ * Function Name: cmd_trace_drain
+ *******************************************************************************
+ * Summary:
+ *  Writes the pending records as "[trace] <id> <point> <cycles>" lines.
+ *
+ *******************************************************************************/
+static void cmd_trace_drain(void)
+{
+    static uint32_t dropped_reported = 0u;
+    uint_fast32_t head = atomic_load_explicit(&cmd_trace_head, memory_order_acquire);
+    uint_fast32_t tail = atomic_load_explicit(&cmd_trace_tail, memory_order_relaxed);
+    cmd_trace_record_t record;
+    uint32_t dropped;
+
+    while(tail != head)
+    {
+        record = cmd_trace_ring[tail & CMD_TRACE_RING_MASK];
+
+        /* Release the slot to the producer. */
+        tail++;
+        atomic_store_explicit(&cmd_trace_tail, tail, memory_order_release);
+
+        printf("[trace] %u %u %"PRIu32"\n", (unsigned int)record.id, (unsigned int)record.point,
+               record.cycles);
+    }
+
+    dropped = (uint32_t)atomic_load_explicit(&cmd_trace_dropped, memory_order_relaxed);
+    if(dropped != dropped_reported)
+    {
+        dropped_reported = dropped;
+        printf("[trace] dropped %"PRIu32"\n", dropped);
+    }
+}
+
+#if defined(CMD_TRACE_HOST)
+
+/*******************************************************************************
+ * Function Name: cmd_trace_cycles
+ *******************************************************************************
+ * Summary:
+ *  Returns the monotonic clock in nanoseconds, truncated to 32 bits.
+ *
+ *******************************************************************************/
+static uint32_t cmd_trace_cycles(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
+
+/*******************************************************************************
+ * Function Name: cmd_trace_init
+ *******************************************************************************
+ * Summary:
+ *  Writes the clock rate of the timestamps for the decoder.
+ *
+ *******************************************************************************/
+void cmd_trace_init(void)
+{
+    printf("[trace] clock %"PRIu32"\n", (uint32_t)CMD_TRACE_CLOCK_HZ);
+}
+
+/*******************************************************************************
+ * Function Name: cmd_trace_spin
+ *******************************************************************************
+ * Summary:
+ *  Busy-waits, standing in for the work of a stage of the command path.
+ *
+ * Parameters:
+ *  uint32_t us: Time to wait
+ *
+ *******************************************************************************/
+static void cmd_trace_spin(uint32_t us)
+{
+    uint32_t begin = cmd_trace_cycles();
+
+    while((cmd_trace_cycles() - begin) < us * 1000u)
+    {
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *  Runs a simulated command path through the trace: a frame from the Wi-Fi
+ *  driver, the socket worker dispatch, the TLS record decryption, the GPIO
+ *  write (stubbed) and the acknowledgement. Usage: cmd_trace [commands]
+ *
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t commands = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000u;
+    uint32_t id;
+
+    cmd_trace_init();
+
+    for(uint32_t i = 0; i < commands; i++)
+    {
+        /* Frame delivered by the Wi-Fi driver. */
+        cmd_trace_last_rx_cycles = cmd_trace_cycles();
+        cmd_trace_rx_frames++;
+
+        /* lwIP and the socket worker dispatch. */
+        cmd_trace_spin(50u + (uint32_t)(rand() % 200));
+        id = CMD_TRACE_BEGIN();
+
+        /* TLS record decryption. */
+        cmd_trace_spin(80u + (uint32_t)(rand() % 40));
+        CMD_TRACE_POINT(id, CMD_TRACE_DECRYPTED);
+
+        CMD_TRACE_POINT(id, CMD_TRACE_GPIO_WRITE);
+        CMD_TRACE_POINT(id, CMD_TRACE_ACTUATED);
+
+        /* Acknowledgement encrypted and sent. */
+        cmd_trace_spin(100u + (uint32_t)(rand() % 50));
+        CMD_TRACE_POINT(id, CMD_TRACE_ACK_SENT);
+
+        cmd_trace_drain();
+        usleep(1000);
+    }
+
+    fprintf(stderr, "%"PRIu32" commands traced, %"PRIu32" GPIO toggles\n",
+            commands, cmd_trace_gpio_toggles);
+
+    return 0;
+}
+
+#else
+
+/*******************************************************************************
+ * Function Name: cmd_trace_cycles
+ *******************************************************************************
+ * Summary:
+ *  Returns the cycle counter.
+ *
+ *******************************************************************************/
+static uint32_t cmd_trace_cycles(void)
+{
+    return app_time_cycles();
+}
+
+/*******************************************************************************
+ * Function Name: cmd_trace_task
+ *******************************************************************************
+ * Summary:
+ *  Low-priority task that writes the trace records to the debug UART.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ *******************************************************************************/
+static void cmd_trace_task(void *arg)
+{
+    for(;;)
+    {
+        cmd_trace_drain();
+        vTaskDelay(pdMS_TO_TICKS(CMD_TRACE_DRAIN_INTERVAL_MS));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: cmd_trace_init
+ *******************************************************************************
+ * Summary:
+ *  Creates the trace task, configures the trace GPIO and writes the clock
+ *  rate of the timestamps for the decoder.
+ *
+ *******************************************************************************/
+void cmd_trace_init(void)
+{
+    #if(ENABLE_CMD_TRACE_GPIO)
+        if(CY_RSLT_SUCCESS != cyhal_gpio_init(CMD_TRACE_GPIO_PIN, CYHAL_GPIO_DIR_OUTPUT,
+                                              CYHAL_GPIO_DRIVE_STRONG, false))
+        {
+            printf("Failed to initialize the trace GPIO!\n");
+        }
+    #endif /* ENABLE_CMD_TRACE_GPIO */
+
+    printf("[trace] clock %"PRIu32"\n", (uint32_t)CMD_TRACE_CLOCK_HZ);
+
+    if(pdPASS != xTaskCreate(cmd_trace_task, "Trace task", CMD_TRACE_TASK_STACK_SIZE, NULL,
+                             CMD_TRACE_TASK_PRIORITY, NULL))
+    {
+        printf("Failed to create the trace task!\n");
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cy_network_process_ethernet_data
+ *******************************************************************************
+ * Summary:
+ *  Records the time of every frame the Wi-Fi driver passes to lwIP. The
+ *  linker routes the calls here with -Wl,--wrap=cy_network_process_ethernet_data.
+ *
+ * Parameters:
+ *  whd_interface_t iface: Wi-Fi interface that received the frame
+ *  whd_buffer_t buf: Received frame
+ *
+ *******************************************************************************/
+void __real_cy_network_process_ethernet_data(whd_interface_t iface, whd_buffer_t buf);
+
+void __wrap_cy_network_process_ethernet_data(whd_interface_t iface, whd_buffer_t buf)
+{
+    cmd_trace_last_rx_cycles = app_time_cycles();
+    cmd_trace_rx_frames++;
+
+    __real_cy_network_process_ethernet_data(iface, buf);
+}
+
+#endif /* CMD_TRACE_HOST */
+
+#endif /* ENABLE_CMD_TRACE */
+
+/* [] END OF FILE */
@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name:   cmd_trace.h
+*
+* Description: This file contains the macros and the prototypes of the command
+* trace, which timestamps the path of a server command from the Wi-Fi driver to
+* the LED write.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CMD_TRACE_H_
+#define CMD_TRACE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set to '1' by the Makefile (CMD_TRACE=1), which also routes the frames
+ * received from the Wi-Fi driver through the trace.
+ */
+#ifndef ENABLE_CMD_TRACE
+#define ENABLE_CMD_TRACE                      (0)
+#endif
+
+/* Set this macro to '1' to toggle CMD_TRACE_GPIO_PIN at every trace point,
+ * for capture with a logic analyser.
+ */
+#define ENABLE_CMD_TRACE_GPIO                 (0)
+#define CMD_TRACE_GPIO_PIN                    (CYBSP_D2)
+
+/* Number of records in the trace ring. Must be a power of two. */
+#define CMD_TRACE_RING_SIZE                   (256u)
+
+/* Interval at which the trace task writes the records to the debug UART. */
+#define CMD_TRACE_DRAIN_INTERVAL_MS           (200u)
+
+/* RTOS related macros for the trace task. */
+#define CMD_TRACE_TASK_STACK_SIZE             (1024u)
+#define CMD_TRACE_TASK_PRIORITY               (0u)
+
+#if(ENABLE_CMD_TRACE)
+    #define CMD_TRACE_BEGIN()                 cmd_trace_begin()
+    #define CMD_TRACE_POINT(id, point)        cmd_trace_point((id), (point))
+#else
+    #define CMD_TRACE_BEGIN()                 (0u)
+    #define CMD_TRACE_POINT(id, point)        do { (void)(id); } while(0)
+#endif /* ENABLE_CMD_TRACE */
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+/* Trace points in the order a command passes them. */
+typedef enum
+{
+    CMD_TRACE_RADIO_RX,       /* Last frame from the Wi-Fi driver before the callback. */
+    CMD_TRACE_CALLBACK,       /* Receive callback entered by the socket worker. */
+    CMD_TRACE_DECRYPTED,      /* Command byte returned by cy_socket_recv(). */
+    CMD_TRACE_GPIO_WRITE,     /* cyhal_gpio_write() called. */
+    CMD_TRACE_ACTUATED,       /* cyhal_gpio_write() returned. */
+    CMD_TRACE_ACK_SENT,       /* Acknowledgement sent. */
+    CMD_TRACE_POINT_COUNT
+} cmd_trace_point_t;
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void cmd_trace_init(void);
+uint32_t cmd_trace_begin(void);
+void cmd_trace_point(uint32_t id, cmd_trace_point_t point);
+
+#endif /* CMD_TRACE_H_ */
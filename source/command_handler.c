@@ -0,0 +1,471 @@
+/******************************************************************************
+* File Name:   command_handler.c
+*
+* Description: This file contains the receive callback of the TCP client
+* socket, which handles the messages of the TCP server: the LED commands, the
+* latency probe, the heartbeat replies and the metrics requests. It only
+* depends on the secure sockets API and the LED GPIO, so it can also be built
+* into the host replay tool (tools/replay).
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <inttypes.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/* Secure TCP client header file. */
+#include "secure_tcp_client.h"
+
+/* Command handler, protocol and timestamp header files. */
+#include "command_handler.h"
+#include "app_protocol.h"
+#include "app_time.h"
+
+/* Deferred logging header file. */
+#include "app_log.h"
+
+/* Connection state and event queue header file. */
+#include "connection_events.h"
+
+/* Command trace header file. */
+#include "cmd_trace.h"
+
+/* Runtime metrics header file. */
+#include "metrics.h"
+
+/* Bulk download header file. */
+#include "flash_download.h"
+
+/* Runtime parameter header file. */
+#include "app_params.h"
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static cy_rslt_t recv_exact(cy_socket_t socket_handle, uint8_t *buffer, uint32_t length);
+static cy_rslt_t process_ping_request(cy_socket_t socket_handle, uint32_t rx_cycles);
+static cy_rslt_t process_heartbeat_reply(cy_socket_t socket_handle);
+#if(ENABLE_METRICS)
+    static cy_rslt_t process_metrics_request(cy_socket_t socket_handle);
+#endif /* ENABLE_METRICS */
+#if(ENABLE_APP_PARAMS)
+    static cy_rslt_t process_param_request(cy_socket_t socket_handle);
+#endif /* ENABLE_APP_PARAMS */
+void print_heap_usage(char *msg);
+
+/*******************************************************************************
+ * Function Name: tcp_client_recv_handler
+ *******************************************************************************
+ * Summary:
+ *  Callback function to handle incoming TCP server messages.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *  void *args : Parameter passed on to the function (unused)
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+cy_rslt_t tcp_client_recv_handler(cy_socket_t socket_handle, void *arg)
+{
+    /* Variable to store number of bytes send to the TCP server. */
+    uint32_t bytes_sent = 0;
+
+    /* Variable to store number of bytes received. */
+    uint32_t bytes_received = 0;
+
+    char message_buffer[MAX_TCP_DATA_PACKET_LENGTH] = {0};
+    uint32_t message_length = 0;
+    uint8_t ack_status = 0;
+    cy_rslt_t result = 0;
+
+    /* Timestamp of the command arrival, used by the latency probe. */
+    uint32_t rx_cycles = app_time_cycles();
+
+    /* Correlation ID of the command in the command trace. */
+    uint32_t trace_id = CMD_TRACE_BEGIN();
+
+    result = cy_socket_recv(socket_handle, message_buffer, TCP_LED_CMD_LEN,
+                            CY_SOCKET_FLAGS_NONE, &bytes_received);
+    CMD_TRACE_POINT(trace_id, CMD_TRACE_DECRYPTED);
+    if(result == CY_RSLT_SUCCESS)
+    {
+        METRICS_RECORD_RECEIVED(bytes_received);
+    }
+    if((result == CY_RSLT_SUCCESS) && (message_buffer[0] == PING_REQUEST_CMD))
+    {
+        /* The latency probe is answered without logging or heap statistics
+         * so that the measured processing time covers the command path only.
+         */
+        return process_ping_request(socket_handle, rx_cycles);
+    }
+
+    if((result == CY_RSLT_SUCCESS) && (message_buffer[0] == HEARTBEAT_REPLY_CMD))
+    {
+        return process_heartbeat_reply(socket_handle);
+    }
+
+    #if(ENABLE_METRICS)
+        if((result == CY_RSLT_SUCCESS) && (message_buffer[0] == METRICS_REQUEST_CMD))
+        {
+            return process_metrics_request(socket_handle);
+        }
+    #endif /* ENABLE_METRICS */
+
+    #if(ENABLE_APP_PARAMS)
+        if((result == CY_RSLT_SUCCESS) && (message_buffer[0] == PARAM_REQUEST_CMD))
+        {
+            return process_param_request(socket_handle);
+        }
+    #endif /* ENABLE_APP_PARAMS */
+
+    #if(ENABLE_FLASH_DOWNLOAD)
+        if((result == CY_RSLT_SUCCESS) && (message_buffer[0] == DOWNLOAD_BEGIN_CMD))
+        {
+            return flash_download_begin(socket_handle);
+        }
+
+        /* Blocks are not logged: a blob is thousands of them. */
+        if((result == CY_RSLT_SUCCESS) && (message_buffer[0] == DOWNLOAD_BLOCK_CMD))
+        {
+            return flash_download_block(socket_handle);
+        }
+    #endif /* ENABLE_FLASH_DOWNLOAD */
+
+    if(result == CY_RSLT_SUCCESS)
+    {
+        ack_status = command_handler_execute((uint8_t)message_buffer[0], trace_id);
+        message_length = app_protocol_put_ack(message_buffer, ack_status);
+    }
+
+    /* Send acknowledgement to the secure TCP server in receipt of the message received. */
+    result = cy_socket_send(socket_handle, message_buffer, message_length,
+                            CY_SOCKET_FLAGS_NONE, &bytes_sent);
+    CMD_TRACE_POINT(trace_id, CMD_TRACE_ACK_SENT);
+    if(result == CY_RSLT_SUCCESS)
+    {
+        METRICS_RECORD_SENT(bytes_sent);
+        METRICS_HISTOGRAM_ADD(METRIC_ACK_US, app_time_cycles_to_us(app_time_cycles() - rx_cycles));
+        APP_LOG_INFO("Acknowledgement sent to TCP server\n");
+    }
+    
+    print_heap_usage("After controlling the LED and ACKing server");
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: command_handler_execute
+ *******************************************************************************
+ * Summary:
+ *  Executes an LED command received over any transport.
+ *
+ * Parameters:
+ *  uint8_t command: LED_ON_CMD or LED_OFF_CMD
+ *  uint32_t trace_id: Correlation ID of the command in the command trace
+ *
+ * Return:
+ *  uint8_t: Acknowledgement status (ACK_STATUS_* bits)
+ *
+ *******************************************************************************/
+uint8_t command_handler_execute(uint8_t command, uint32_t trace_id)
+{
+    uint8_t ack_status = 0;
+
+    APP_LOG_INFO("============================================================\n");
+    if(command == LED_ON_CMD)
+    {
+        /* Turn the LED ON. */
+        CMD_TRACE_POINT(trace_id, CMD_TRACE_GPIO_WRITE);
+        cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_ON);
+        CMD_TRACE_POINT(trace_id, CMD_TRACE_ACTUATED);
+        APP_LOG_INFO("LED turned ON\n");
+    }
+    else if(command == LED_OFF_CMD)
+    {
+        /* Turn the LED OFF. */
+        CMD_TRACE_POINT(trace_id, CMD_TRACE_GPIO_WRITE);
+        cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_OFF);
+        CMD_TRACE_POINT(trace_id, CMD_TRACE_ACTUATED);
+        APP_LOG_INFO("LED turned OFF\n");
+    }
+    else
+    {
+        APP_LOG_WARN("Invalid command : %c \n", command);
+        ack_status |= ACK_STATUS_INVALID_CMD;
+    }
+
+    if(cyhal_gpio_read(CYBSP_USER_LED) == CYBSP_LED_STATE_ON)
+    {
+        ack_status |= ACK_STATUS_LED_ON;
+    }
+
+    return ack_status;
+}
+
+/*******************************************************************************
+ * Function Name: recv_exact
+ *******************************************************************************
+ * Summary:
+ *  Receives exactly the requested number of bytes from the socket.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *  uint8_t *buffer: Buffer to store the received bytes
+ *  uint32_t length: Number of bytes to receive
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t recv_exact(cy_socket_t socket_handle, uint8_t *buffer, uint32_t length)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint32_t bytes_received = 0;
+
+    while((length > 0) && (result == CY_RSLT_SUCCESS))
+    {
+        result = cy_socket_recv(socket_handle, buffer, length,
+                                CY_SOCKET_FLAGS_NONE, &bytes_received);
+        buffer += bytes_received;
+        length -= bytes_received;
+        METRICS_COUNTER_ADD(METRIC_BYTES_IN, bytes_received);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: process_ping_request
+ *******************************************************************************
+ * Summary:
+ *  Answers a latency probe. The reply echoes the sequence number and the server
+ *  timestamp and adds the device receive timestamp and the device processing
+ *  time, measured from the entry of the receive callback until just before the
+ *  reply is sent.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *  uint32_t rx_cycles: Cycle counter value at the entry of the receive callback
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t process_ping_request(cy_socket_t socket_handle, uint32_t rx_cycles)
+{
+    uint8_t reply[PING_REPLY_LEN];
+    uint32_t bytes_sent = 0;
+    cy_rslt_t result;
+
+    uint32_t device_rx_us = (uint32_t)app_time_us();
+
+    /* Sequence number and server timestamp are echoed unchanged. */
+    result = recv_exact(socket_handle, &reply[1], PING_REQUEST_PAYLOAD_LEN);
+    if(result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_WARN("Incomplete ping request! Error Code: %"PRIu32"\n", result);
+        return result;
+    }
+
+    reply[0] = PING_REPLY_MSG;
+    app_protocol_put_u32(&reply[1u + PING_REQUEST_PAYLOAD_LEN], device_rx_us);
+    app_protocol_put_u32(&reply[5u + PING_REQUEST_PAYLOAD_LEN],
+                         app_time_cycles_to_us(app_time_cycles() - rx_cycles));
+
+    result = cy_socket_send(socket_handle, reply, sizeof(reply),
+                            CY_SOCKET_FLAGS_NONE, &bytes_sent);
+    if(result == CY_RSLT_SUCCESS)
+    {
+        METRICS_RECORD_SENT(bytes_sent);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: process_heartbeat_reply
+ *******************************************************************************
+ * Summary:
+ *  Receives the sequence number of a heartbeat reply and posts it to the
+ *  network task.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t process_heartbeat_reply(cy_socket_t socket_handle)
+{
+    uint8_t sequence[HEARTBEAT_LEN - 1u];
+    connection_event_t event = { .type = CONNECTION_EVENT_HEARTBEAT };
+    cy_rslt_t result;
+
+    result = recv_exact(socket_handle, sequence, sizeof(sequence));
+    if(result == CY_RSLT_SUCCESS)
+    {
+        event.data.sequence = app_protocol_get_u32(sequence);
+        connection_event_post(&event);
+    }
+
+    return result;
+}
+
+#if(ENABLE_METRICS)
+/*******************************************************************************
+ * Function Name: process_metrics_request
+ *******************************************************************************
+ * Summary:
+ *  Answers a metrics request with a snapshot of the metrics registry.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t process_metrics_request(cy_socket_t socket_handle)
+{
+    /* Only used by the socket worker, which runs one callback at a time. */
+    static uint8_t snapshot[METRICS_SNAPSHOT_MAX_LEN];
+    uint32_t snapshot_len;
+    uint32_t bytes_sent = 0;
+    cy_rslt_t result;
+
+    snapshot_len = metrics_snapshot(snapshot);
+
+    result = cy_socket_send(socket_handle, snapshot, snapshot_len,
+                            CY_SOCKET_FLAGS_NONE, &bytes_sent);
+    if(result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_WARN("Metrics snapshot not sent! Error Code: %"PRIu32"\n", result);
+    }
+    else
+    {
+        METRICS_RECORD_SENT(bytes_sent);
+    }
+
+    return result;
+}
+#endif /* ENABLE_METRICS */
+
+#if(ENABLE_APP_PARAMS)
+/*******************************************************************************
+ * Function Name: process_param_request
+ *******************************************************************************
+ * Summary:
+ *  Reads the rest of a parameter command, executes it and sends its reply.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t process_param_request(cy_socket_t socket_handle)
+{
+    /* Only used by the socket worker, which runs one callback at a time. */
+    static uint8_t reply[PARAM_REPLY_HEADER_LEN + APP_PARAMS_REPLY_MAX];
+    char line[APP_PARAMS_LINE_MAX + 1u] = "";
+    uint8_t length;
+    size_t reply_len;
+    uint32_t bytes_sent = 0;
+    cy_rslt_t result;
+
+    result = recv_exact(socket_handle, &length, sizeof(length));
+
+    /* A command that is too long is read in pieces and discarded, so that the
+     * stream stays in sync; a truncated 'set' must not be executed.
+     */
+    for(uint32_t remaining = length; (result == CY_RSLT_SUCCESS) && (remaining > 0u); )
+    {
+        uint32_t chunk = (remaining > APP_PARAMS_LINE_MAX) ? APP_PARAMS_LINE_MAX : remaining;
+
+        result = recv_exact(socket_handle, (uint8_t *)line, chunk);
+        line[chunk] = '\0';
+        remaining -= chunk;
+    }
+    if(result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    if(length > APP_PARAMS_LINE_MAX)
+    {
+        APP_LOG_WARN("Parameter command of %u bytes rejected\n", length);
+        reply_len = (size_t)snprintf((char *)&reply[PARAM_REPLY_HEADER_LEN], APP_PARAMS_REPLY_MAX,
+                                     "Command too long\n");
+    }
+    else if(length == 0u)
+    {
+        /* An empty command is not executed; it gets the usage line. */
+        reply_len = app_params_command("", (char *)&reply[PARAM_REPLY_HEADER_LEN],
+                                       APP_PARAMS_REPLY_MAX);
+    }
+    else
+    {
+        reply_len = app_params_command(line, (char *)&reply[PARAM_REPLY_HEADER_LEN],
+                                       APP_PARAMS_REPLY_MAX);
+    }
+    reply[0] = PARAM_REPLY_MSG;
+    app_protocol_put_u16(&reply[1], (uint16_t)reply_len);
+
+    result = cy_socket_send(socket_handle, reply, PARAM_REPLY_HEADER_LEN + reply_len,
+                            CY_SOCKET_FLAGS_NONE, &bytes_sent);
+    if(result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_WARN("Parameter reply not sent! Error Code: %"PRIu32"\n", result);
+    }
+    else
+    {
+        METRICS_RECORD_SENT(bytes_sent);
+    }
+
+    return result;
+}
+#endif /* ENABLE_APP_PARAMS */
+
+/* [] END OF FILE */
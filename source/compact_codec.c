@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name:   compact_codec.c
+*
+* Description: This file contains the compact binary encoding used for the
+* messages sent by the TCP client. Integers are encoded as little-endian
+* base-128 varints: seven bits per byte, with the top bit set on every byte
+* except the last.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "compact_codec.h"
+
+/*******************************************************************************
+ * Function Name: compact_codec_put_varint
+ *******************************************************************************
+ * Summary:
+ *  Encodes an unsigned value as a varint.
+ *
+ * Parameters:
+ *  uint8_t *buffer: Output buffer, at least COMPACT_CODEC_VARINT_MAX_LEN bytes
+ *  uint32_t value: Value to be encoded
+ *
+ * Return:
+ *  uint32_t: Number of bytes written
+ *
+ *******************************************************************************/
+uint32_t compact_codec_put_varint(uint8_t *buffer, uint32_t value)
+{
+    uint32_t length = 0u;
+
+    while(value >= 0x80u)
+    {
+        buffer[length++] = (uint8_t)(value | 0x80u);
+        value >>= 7;
+    }
+    buffer[length++] = (uint8_t)value;
+
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: compact_codec_put_svarint
+ *******************************************************************************
+ * Summary:
+ *  Encodes a signed value as a zigzag varint.
+ *
+ * Parameters:
+ *  uint8_t *buffer: Output buffer, at least COMPACT_CODEC_VARINT_MAX_LEN bytes
+ *  int32_t value: Value to be encoded
+ *
+ * Return:
+ *  uint32_t: Number of bytes written
+ *
+ *******************************************************************************/
+uint32_t compact_codec_put_svarint(uint8_t *buffer, int32_t value)
+{
+    return compact_codec_put_varint(buffer, compact_codec_zigzag(value));
+}
+
+/* [] END OF FILE */
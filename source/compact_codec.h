@@ -0,0 +1,82 @@
+/******************************************************************************
+* File Name:   compact_codec.h
+*
+* Description: This file contains the declarations of the compact binary
+* encoding used for the messages sent by the TCP client: unsigned and
+* zigzag-encoded signed varints and bit-packed boolean states.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef COMPACT_CODEC_H_
+#define COMPACT_CODEC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Maximum length of a 32-bit value encoded as a varint. */
+#define COMPACT_CODEC_VARINT_MAX_LEN          (5u)
+
+/* Number of bytes needed for a bitmap of 'bits' bits. */
+#define COMPACT_CODEC_BITMAP_LEN(bits)        (((bits) + 7u) / 8u)
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+uint32_t compact_codec_put_varint(uint8_t *buffer, uint32_t value);
+uint32_t compact_codec_put_svarint(uint8_t *buffer, int32_t value);
+
+/* Maps signed values to unsigned ones so that values close to zero, positive
+ * or negative, encode into few varint bytes: 0, -1, 1, -2 -> 0, 1, 2, 3.
+ */
+static inline uint32_t compact_codec_zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline void compact_codec_put_bit(uint8_t *bitmap, uint32_t index, bool value)
+{
+    if(value)
+    {
+        bitmap[index / 8u] |= (uint8_t)(1u << (index % 8u));
+    }
+    else
+    {
+        bitmap[index / 8u] &= (uint8_t)~(1u << (index % 8u));
+    }
+}
+
+#endif /* COMPACT_CODEC_H_ */
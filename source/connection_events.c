@@ -0,0 +1,382 @@
+/******************************************************************************
+* File Name:   connection_events.c
+*
+* Description: This file contains the event queue and the state of the
+* connection to the TCP server. Socket callbacks, the connection timer, Wi-Fi
+* events and the UART console post events to a single queue, which the network
+* task processes one at a time. Events that the state machine cannot do without
+* are latched when the queue is full. Every state transition is logged with
+* the event that caused it and the time spent in the previous state.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <timers.h>
+
+/* Standard C header file. */
+#include <inttypes.h>
+
+/* Connection events, logging and timestamp header files. */
+#include "connection_events.h"
+#include "app_log.h"
+#include "app_time.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define CONNECTION_EVENT_BIT(type)         (1u << (uint32_t)(type))
+
+/* Events latched when the queue is full, because the state machine would
+ * wait for them forever. A lost console line is entered again and a lost
+ * heartbeat reply counts as a miss, so these two are dropped instead.
+ */
+#define CONNECTION_EVENTS_LATCHABLE        (CONNECTION_EVENT_BIT(CONNECTION_EVENT_TIMER) | \
+                                            CONNECTION_EVENT_BIT(CONNECTION_EVENT_CONNECT) | \
+                                            CONNECTION_EVENT_BIT(CONNECTION_EVENT_DISCONNECTED) | \
+                                            CONNECTION_EVENT_BIT(CONNECTION_EVENT_WIFI_DOWN) | \
+                                            CONNECTION_EVENT_BIT(CONNECTION_EVENT_WIFI_UP) | \
+                                            CONNECTION_EVENT_BIT(CONNECTION_EVENT_RESOLVED))
+
+/* A latched Wi-Fi event replaces the latched event of the opposite state. */
+#define CONNECTION_EVENTS_WIFI             (CONNECTION_EVENT_BIT(CONNECTION_EVENT_WIFI_DOWN) | \
+                                            CONNECTION_EVENT_BIT(CONNECTION_EVENT_WIFI_UP))
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void connection_timer_callback(TimerHandle_t timer);
+static bool connection_event_take_latched(connection_event_t *event);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static QueueHandle_t connection_event_queue;
+static TimerHandle_t connection_timer;
+
+/* Incremented by every start and stop of the timer, so that a timer event
+ * posted before the timer was restarted or stopped is discarded.
+ */
+static volatile uint32_t connection_timer_generation;
+
+static connection_state_t connection_state = CONNECTION_STATE_IDLE;
+static uint64_t connection_state_begin_us;
+
+/* Events latched because the queue was full: the last one of each type and
+ * a bit per type. Both, and the number of events dropped because the queue
+ * was full, are updated in a critical section, since events are posted from
+ * several tasks.
+ */
+static connection_event_t connection_events_latch[CONNECTION_EVENT_COUNT];
+static uint32_t connection_events_latched;
+static uint32_t connection_events_dropped;
+
+/* Names used by the state transition trace. */
+static const char *const connection_state_names[CONNECTION_STATE_COUNT] =
+{
+    "IDLE", "RESOLVING", "CONNECTING", "HANDSHAKING", "ESTABLISHED", "BACKOFF"
+};
+
+static const char *const connection_event_names[CONNECTION_EVENT_COUNT] =
+{
+    "startup", "console line", "timer", "connect", "disconnected", "heartbeat",
+    "Wi-Fi down", "Wi-Fi up", "resolved"
+};
+
+/*******************************************************************************
+ * Function Name: connection_events_init
+ *******************************************************************************
+ * Summary:
+ *  Creates the event queue and the connection timer.
+ *
+ *******************************************************************************/
+void connection_events_init(void)
+{
+    connection_event_queue = xQueueCreate(CONNECTION_EVENT_QUEUE_LENGTH, sizeof(connection_event_t));
+    connection_timer = xTimerCreate("Connection timer", 1u, pdFALSE, NULL,
+                                    connection_timer_callback);
+    if((connection_event_queue == NULL) || (connection_timer == NULL))
+    {
+        printf("Failed to create the connection event queue!\n");
+        CY_ASSERT(0);
+    }
+
+    connection_state_begin_us = app_time_us();
+}
+
+/*******************************************************************************
+ * Function Name: connection_event_post
+ *******************************************************************************
+ * Summary:
+ *  Posts an event to the network task without waiting. Safe to call from
+ *  socket callbacks, timer callbacks and other tasks. When the queue is full,
+ *  the event is latched, or dropped if it is not needed by the state machine.
+ *
+ * Parameters:
+ *  const connection_event_t *event: Event to post
+ *
+ *******************************************************************************/
+void connection_event_post(const connection_event_t *event)
+{
+    uint32_t bit = CONNECTION_EVENT_BIT(event->type);
+    uint32_t dropped = 0u;
+
+    if(pdTRUE == xQueueSend(connection_event_queue, event, 0))
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    if((bit & CONNECTION_EVENTS_LATCHABLE) != 0u)
+    {
+        if((bit & CONNECTION_EVENTS_WIFI) != 0u)
+        {
+            connection_events_latched &= ~CONNECTION_EVENTS_WIFI;
+        }
+        connection_events_latch[event->type] = *event;
+        connection_events_latched |= bit;
+    }
+    else
+    {
+        dropped = ++connection_events_dropped;
+    }
+    taskEXIT_CRITICAL();
+
+    if(dropped == 0u)
+    {
+        APP_LOG_WARN("Connection event '%s' latched, the queue is full\n",
+                     connection_event_names[event->type]);
+    }
+    else
+    {
+        APP_LOG_WARN("Connection event '%s' dropped (%"PRIu32" in total)\n",
+                     connection_event_names[event->type], dropped);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: connection_event_post_type
+ *******************************************************************************
+ * Summary:
+ *  Posts an event that carries no data.
+ *
+ * Parameters:
+ *  connection_event_type_t type: Type of the event
+ *
+ *******************************************************************************/
+void connection_event_post_type(connection_event_type_t type)
+{
+    connection_event_t event = { .type = type };
+
+    connection_event_post(&event);
+}
+
+/*******************************************************************************
+ * Function Name: connection_event_receive
+ *******************************************************************************
+ * Summary:
+ *  Waits for the next event. Latched events are returned once the events
+ *  queued before them are processed. Stale timer events are discarded.
+ *
+ * Parameters:
+ *  connection_event_t *event: Received event
+ *  TickType_t wait: Maximum time to wait
+ *
+ * Return:
+ *  bool: true if an event was received
+ *
+ *******************************************************************************/
+bool connection_event_receive(connection_event_t *event, TickType_t wait)
+{
+    /* An event is latched only while the queue is full, so the wait below
+     * returns at once for an event latched after the checks above.
+     */
+    while((pdTRUE == xQueueReceive(connection_event_queue, event, 0)) ||
+          connection_event_take_latched(event) ||
+          (pdTRUE == xQueueReceive(connection_event_queue, event, wait)))
+    {
+        if((event->type != CONNECTION_EVENT_TIMER) ||
+           (event->data.timer == connection_timer_generation))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: connection_event_take_latched
+ *******************************************************************************
+ * Summary:
+ *  Takes one of the events latched while the queue was full.
+ *
+ * Parameters:
+ *  connection_event_t *event: Latched event
+ *
+ * Return:
+ *  bool: true if an event was latched
+ *
+ *******************************************************************************/
+static bool connection_event_take_latched(connection_event_t *event)
+{
+    bool taken = false;
+
+    taskENTER_CRITICAL();
+    for(uint32_t type = 0u; (type < CONNECTION_EVENT_COUNT) && !taken; type++)
+    {
+        if((connection_events_latched & CONNECTION_EVENT_BIT(type)) != 0u)
+        {
+            *event = connection_events_latch[type];
+            connection_events_latched &= ~CONNECTION_EVENT_BIT(type);
+            taken = true;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return taken;
+}
+
+/*******************************************************************************
+ * Function Name: connection_timer_start
+ *******************************************************************************
+ * Summary:
+ *  (Re)starts the one-shot connection timer, which posts
+ *  CONNECTION_EVENT_TIMER when it expires.
+ *
+ * Parameters:
+ *  uint32_t timeout_ms: Time until the timer expires
+ *
+ *******************************************************************************/
+void connection_timer_start(uint32_t timeout_ms)
+{
+    TickType_t ticks = pdMS_TO_TICKS(timeout_ms);
+
+    connection_timer_generation++;
+
+    /* Changing the period also starts the timer. */
+    xTimerChangePeriod(connection_timer, (ticks > 0u) ? ticks : 1u, portMAX_DELAY);
+}
+
+/*******************************************************************************
+ * Function Name: connection_timer_stop
+ *******************************************************************************
+ * Summary:
+ *  Stops the connection timer.
+ *
+ *******************************************************************************/
+void connection_timer_stop(void)
+{
+    connection_timer_generation++;
+    xTimerStop(connection_timer, portMAX_DELAY);
+}
+
+/*******************************************************************************
+ * Function Name: connection_timer_callback
+ *******************************************************************************
+ * Summary:
+ *  Connection timer callback. Runs in the timer service task.
+ *
+ *******************************************************************************/
+static void connection_timer_callback(TimerHandle_t timer)
+{
+    connection_event_t event = { .type = CONNECTION_EVENT_TIMER,
+                                 .data.timer = connection_timer_generation };
+
+    connection_event_post(&event);
+}
+
+/*******************************************************************************
+ * Function Name: connection_state_enter
+ *******************************************************************************
+ * Summary:
+ *  Moves the connection to a new state and traces the transition.
+ *
+ * Parameters:
+ *  connection_state_t state: New state
+ *  connection_event_type_t cause: Event that caused the transition
+ *
+ *******************************************************************************/
+void connection_state_enter(connection_state_t state, connection_event_type_t cause)
+{
+    uint64_t now_us = app_time_us();
+
+    APP_LOG_INFO("State %s -> %s on %s after %"PRIu32" ms\n",
+                 connection_state_names[connection_state], connection_state_names[state],
+                 connection_event_names[cause], (uint32_t)((now_us - connection_state_begin_us) / 1000u));
+
+    connection_state = state;
+    connection_state_begin_us = now_us;
+}
+
+/*******************************************************************************
+ * Function Name: connection_state_get
+ *******************************************************************************
+ * Summary:
+ *  Returns the current state of the connection.
+ *
+ * Return:
+ *  connection_state_t: Current state
+ *
+ *******************************************************************************/
+connection_state_t connection_state_get(void)
+{
+    return connection_state;
+}
+
+/*******************************************************************************
+ * Function Name: connection_state_name
+ *******************************************************************************
+ * Summary:
+ *  Returns the name of a state.
+ *
+ * Parameters:
+ *  connection_state_t state: State
+ *
+ * Return:
+ *  const char *: Name of the state, with static storage duration
+ *
+ *******************************************************************************/
+const char *connection_state_name(connection_state_t state)
+{
+    return connection_state_names[state];
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,126 @@
+/******************************************************************************
+* File Name:   connection_events.h
+*
+* Description: This file contains the states of the connection to the TCP
+* server and the events that drive them.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CONNECTION_EVENTS_H_
+#define CONNECTION_EVENTS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* FreeRTOS header file. */
+#include <FreeRTOS.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of events the queue holds. Events posted to a full queue are
+ * latched, one of each type, or dropped and counted for console lines and
+ * heartbeat replies.
+ */
+#define CONNECTION_EVENT_QUEUE_LENGTH         (8u)
+
+/* Maximum length of a line entered on the UART console, including the
+ * terminating null character.
+ */
+#define CONNECTION_EVENT_LINE_SIZE            (50u)
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+typedef enum
+{
+    CONNECTION_STATE_IDLE,          /* Waiting for the server address. */
+    CONNECTION_STATE_RESOLVING,     /* Resolving the server address. */
+    CONNECTION_STATE_CONNECTING,    /* TCP connection and TLS handshake. */
+    CONNECTION_STATE_HANDSHAKING,   /* Sending the first application message. */
+    CONNECTION_STATE_ESTABLISHED,   /* Connected to the server. */
+    CONNECTION_STATE_BACKOFF,       /* Waiting before the next retry. */
+    CONNECTION_STATE_COUNT
+} connection_state_t;
+
+typedef enum
+{
+    CONNECTION_EVENT_STARTUP,       /* Initial transition; never posted. */
+    CONNECTION_EVENT_CONSOLE_LINE,  /* A line was entered on the UART console. */
+    CONNECTION_EVENT_TIMER,         /* The connection timer expired. */
+    CONNECTION_EVENT_CONNECT,       /* A connection attempt completed. */
+    CONNECTION_EVENT_DISCONNECTED,  /* The server closed the connection. */
+    CONNECTION_EVENT_HEARTBEAT,     /* The server answered a heartbeat. */
+    CONNECTION_EVENT_WIFI_DOWN,     /* The Wi-Fi link was lost. */
+    CONNECTION_EVENT_WIFI_UP,       /* The Wi-Fi link was restored. */
+    CONNECTION_EVENT_RESOLVED,      /* The DNS cache task completed a lookup. */
+    CONNECTION_EVENT_COUNT
+} connection_event_type_t;
+
+typedef struct
+{
+    connection_event_type_t type;
+    union
+    {
+        /* CONNECTION_EVENT_CONSOLE_LINE */
+        char line[CONNECTION_EVENT_LINE_SIZE];
+
+        /* CONNECTION_EVENT_DISCONNECTED */
+        cy_socket_t handle;
+
+        /* CONNECTION_EVENT_TIMER: timer start the event belongs to. */
+        uint32_t timer;
+
+        /* CONNECTION_EVENT_HEARTBEAT: echoed sequence number. */
+        uint32_t sequence;
+    } data;
+} connection_event_t;
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void connection_events_init(void);
+void connection_event_post(const connection_event_t *event);
+void connection_event_post_type(connection_event_type_t type);
+bool connection_event_receive(connection_event_t *event, TickType_t wait);
+void connection_timer_start(uint32_t timeout_ms);
+void connection_timer_stop(void);
+void connection_state_enter(connection_state_t state, connection_event_type_t cause);
+connection_state_t connection_state_get(void);
+const char *connection_state_name(connection_state_t state);
+
+#endif /* CONNECTION_EVENTS_H_ */
@@ -0,0 +1,523 @@
+/******************************************************************************
+* File Name:   crypto_benchmark.c
+*
+* Description: This file contains the crypto primitive benchmark. Each
+* primitive used by the TLS handshake (ECDSA P-256 sign and verify, ECDHE) and
+* by the record layer (SHA-256, AES-GCM, ChaCha20-Poly1305) is run under the
+* Mbed TLS configuration of the application, including any hardware
+* acceleration it enables. Primitives disabled in the configuration are
+* skipped. On the target, the time is measured with the DWT cycle counter.
+* Built with CRYPTO_BENCHMARK_HOST defined, the file is a host program that
+* runs the same benchmark and counts time-stamp counter cycles.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Mbed TLS configuration and primitives. */
+#include "mbedtls/build_info.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/chachapoly.h"
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/ecdh.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#if defined(CRYPTO_BENCHMARK_HOST)
+#include <time.h>
+#include <sys/random.h>
+#include <x86intrin.h>
+#else
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* Timestamp header file. */
+#include "app_time.h"
+#endif /* CRYPTO_BENCHMARK_HOST */
+
+/* Crypto benchmark header file. */
+#include "crypto_benchmark.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define STRINGIFY(x)                      #x
+#define TO_STRING(x)                      STRINGIFY(x)
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static uint64_t benchmark_now(void);
+static uint64_t benchmark_elapsed(uint64_t start);
+static void benchmark_report(const char *name, uint32_t bytes, uint32_t ops,
+                             uint64_t cycles, int ret);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static uint32_t benchmark_cpu_hz;
+static bool benchmark_first_result;
+
+static uint8_t benchmark_input[CRYPTO_BENCHMARK_MESSAGE_LEN];
+static uint8_t benchmark_output[CRYPTO_BENCHMARK_MESSAGE_LEN];
+
+#if defined(MBEDTLS_CTR_DRBG_C) && defined(MBEDTLS_ENTROPY_C)
+static mbedtls_entropy_context benchmark_entropy;
+static mbedtls_ctr_drbg_context benchmark_drbg;
+#endif /* MBEDTLS_CTR_DRBG_C && MBEDTLS_ENTROPY_C */
+
+#if defined(CRYPTO_BENCHMARK_HOST)
+/*******************************************************************************
+ * Function Name: benchmark_now
+ *******************************************************************************
+ * Summary:
+ *  Returns the time-stamp counter of the host CPU.
+ *
+ *******************************************************************************/
+static uint64_t benchmark_now(void)
+{
+    return __rdtsc();
+}
+
+static uint64_t benchmark_elapsed(uint64_t start)
+{
+    return __rdtsc() - start;
+}
+
+#if defined(MBEDTLS_ENTROPY_HARDWARE_ALT)
+/*******************************************************************************
+ * Function Name: mbedtls_hardware_poll
+ *******************************************************************************
+ * Summary:
+ *  Entropy source of the host program. On the target, it is provided by the
+ *  TRNG driver.
+ *
+ *******************************************************************************/
+int mbedtls_hardware_poll(void *data, unsigned char *output, size_t len, size_t *olen)
+{
+    ssize_t ret = getrandom(output, len, 0);
+
+    *olen = (ret > 0) ? (size_t)ret : 0u;
+    return (ret < 0) ? -1 : 0;
+}
+#endif /* MBEDTLS_ENTROPY_HARDWARE_ALT */
+
+/*******************************************************************************
+ * Function Name: benchmark_calibrate
+ *******************************************************************************
+ * Summary:
+ *  Measures the time-stamp counter frequency against the monotonic clock.
+ *
+ *******************************************************************************/
+static uint32_t benchmark_calibrate(void)
+{
+    struct timespec begin, end;
+    uint64_t start = __rdtsc();
+    uint64_t ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ns = (uint64_t)(end.tv_sec - begin.tv_sec) * 1000000000u +
+             (uint64_t)end.tv_nsec - (uint64_t)begin.tv_nsec;
+    } while(ns < 100000000u);
+
+    return (uint32_t)(((__rdtsc() - start) * 1000000000u) / ns);
+}
+#else
+/*******************************************************************************
+ * Function Name: benchmark_now
+ *******************************************************************************
+ * Summary:
+ *  Returns the cycle counter. A single measurement must not exceed the wrap
+ *  period of the 32-bit counter.
+ *
+ *******************************************************************************/
+static uint64_t benchmark_now(void)
+{
+    return app_time_cycles();
+}
+
+static uint64_t benchmark_elapsed(uint64_t start)
+{
+    return (uint32_t)(app_time_cycles() - (uint32_t)start);
+}
+#endif /* CRYPTO_BENCHMARK_HOST */
+
+/*******************************************************************************
+ * Function Name: benchmark_report
+ *******************************************************************************
+ * Summary:
+ *  Prints the result of one benchmark as a JSON object. Only integer
+ *  formatting is used; rates are printed with two decimals.
+ *
+ * Parameters:
+ *  const char *name: Name of the primitive
+ *  uint32_t bytes: Bytes processed per operation (0 for public key operations)
+ *  uint32_t ops: Number of operations measured
+ *  uint64_t cycles: Total cycles of the operations
+ *  int ret: Mbed TLS return code of the operations
+ *
+ *******************************************************************************/
+static void benchmark_report(const char *name, uint32_t bytes, uint32_t ops,
+                             uint64_t cycles, int ret)
+{
+    printf("%s\n      {\"name\": \"%s\"", benchmark_first_result ? "" : ",", name);
+    benchmark_first_result = false;
+
+    if((ret != 0) || (cycles == 0u))
+    {
+        printf(", \"error\": \"-0x%04x\"}", (unsigned int)-ret);
+        return;
+    }
+
+    uint64_t ops_per_sec_x100 = ((uint64_t)ops * benchmark_cpu_hz * 100u) / cycles;
+    printf(", \"bytes\": %"PRIu32", \"ops\": %"PRIu32", \"cycles_per_op\": %"PRIu32
+           ", \"ops_per_sec\": %"PRIu32".%02"PRIu32,
+           bytes, ops, (uint32_t)(cycles / ops),
+           (uint32_t)(ops_per_sec_x100 / 100u), (uint32_t)(ops_per_sec_x100 % 100u));
+
+    if(bytes > 0u)
+    {
+        uint64_t cycles_per_byte_x100 = (cycles * 100u) / ((uint64_t)ops * bytes);
+        printf(", \"cycles_per_byte\": %"PRIu32".%02"PRIu32,
+               (uint32_t)(cycles_per_byte_x100 / 100u), (uint32_t)(cycles_per_byte_x100 % 100u));
+    }
+    printf("}");
+}
+
+#if defined(MBEDTLS_SHA256_C)
+/*******************************************************************************
+ * Function Name: benchmark_sha256
+ *******************************************************************************
+ * Summary:
+ *  SHA-256: handshake transcript hash, HKDF/PRF and ECDSA message digests.
+ *
+ *******************************************************************************/
+static void benchmark_sha256(void)
+{
+    uint8_t digest[32];
+    int ret = 0;
+    uint64_t start = benchmark_now();
+
+    for(uint32_t i = 0; (i < CRYPTO_BENCHMARK_BULK_ITERATIONS) && (ret == 0); i++)
+    {
+        ret = mbedtls_sha256(benchmark_input, sizeof(benchmark_input), digest, 0);
+    }
+
+    benchmark_report("sha256", sizeof(benchmark_input), CRYPTO_BENCHMARK_BULK_ITERATIONS,
+                     benchmark_elapsed(start), ret);
+}
+#endif /* MBEDTLS_SHA256_C */
+
+#if defined(MBEDTLS_GCM_C) && defined(MBEDTLS_AES_C)
+/*******************************************************************************
+ * Function Name: benchmark_aes_gcm
+ *******************************************************************************
+ * Summary:
+ *  AES-GCM encryption of one record, including the key schedule that is run
+ *  once per connection.
+ *
+ * Parameters:
+ *  const char *name: Name of the benchmark
+ *  unsigned int key_bits: AES key size
+ *
+ *******************************************************************************/
+static void benchmark_aes_gcm(const char *name, unsigned int key_bits)
+{
+    static const uint8_t key[32] = {0};
+    static const uint8_t iv[12] = {0};
+    uint8_t aad[13] = {0};
+    uint8_t tag[16];
+    mbedtls_gcm_context gcm;
+    uint64_t start;
+    int ret;
+
+    mbedtls_gcm_init(&gcm);
+    ret = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, key_bits);
+
+    start = benchmark_now();
+    for(uint32_t i = 0; (i < CRYPTO_BENCHMARK_BULK_ITERATIONS) && (ret == 0); i++)
+    {
+        ret = mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, sizeof(benchmark_input),
+                                        iv, sizeof(iv), aad, sizeof(aad),
+                                        benchmark_input, benchmark_output, sizeof(tag), tag);
+    }
+    benchmark_report(name, sizeof(benchmark_input), CRYPTO_BENCHMARK_BULK_ITERATIONS,
+                     benchmark_elapsed(start), ret);
+
+    mbedtls_gcm_free(&gcm);
+}
+#endif /* MBEDTLS_GCM_C && MBEDTLS_AES_C */
+
+#if defined(MBEDTLS_CHACHAPOLY_C)
+/*******************************************************************************
+ * Function Name: benchmark_chachapoly
+ *******************************************************************************
+ * Summary:
+ *  ChaCha20-Poly1305 encryption of one record.
+ *
+ *******************************************************************************/
+static void benchmark_chachapoly(void)
+{
+    static const uint8_t key[32] = {0};
+    static const uint8_t nonce[12] = {0};
+    uint8_t aad[13] = {0};
+    uint8_t tag[16];
+    mbedtls_chachapoly_context chachapoly;
+    uint64_t start;
+    int ret;
+
+    mbedtls_chachapoly_init(&chachapoly);
+    ret = mbedtls_chachapoly_setkey(&chachapoly, key);
+
+    start = benchmark_now();
+    for(uint32_t i = 0; (i < CRYPTO_BENCHMARK_BULK_ITERATIONS) && (ret == 0); i++)
+    {
+        ret = mbedtls_chachapoly_encrypt_and_tag(&chachapoly, sizeof(benchmark_input),
+                                                 nonce, aad, sizeof(aad),
+                                                 benchmark_input, benchmark_output, tag);
+    }
+    benchmark_report("chacha20_poly1305", sizeof(benchmark_input),
+                     CRYPTO_BENCHMARK_BULK_ITERATIONS, benchmark_elapsed(start), ret);
+
+    mbedtls_chachapoly_free(&chachapoly);
+}
+#endif /* MBEDTLS_CHACHAPOLY_C */
+
+#if defined(MBEDTLS_CTR_DRBG_C) && defined(MBEDTLS_ENTROPY_C)
+#if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+/*******************************************************************************
+ * Function Name: benchmark_ecdsa_p256
+ *******************************************************************************
+ * Summary:
+ *  ECDSA P-256 signature (CertificateVerify of the client) and verification
+ *  (server certificate chain and handshake signature).
+ *
+ *******************************************************************************/
+static void benchmark_ecdsa_p256(void)
+{
+    static const uint8_t hash[32] = {0};
+    uint8_t signature[MBEDTLS_ECDSA_MAX_LEN];
+    size_t signature_len = 0;
+    mbedtls_ecdsa_context ecdsa;
+    uint64_t start;
+    int ret;
+
+    mbedtls_ecdsa_init(&ecdsa);
+    ret = mbedtls_ecdsa_genkey(&ecdsa, MBEDTLS_ECP_DP_SECP256R1,
+                               mbedtls_ctr_drbg_random, &benchmark_drbg);
+
+    start = benchmark_now();
+    for(uint32_t i = 0; (i < CRYPTO_BENCHMARK_PK_ITERATIONS) && (ret == 0); i++)
+    {
+        ret = mbedtls_ecdsa_write_signature(&ecdsa, MBEDTLS_MD_SHA256, hash, sizeof(hash),
+                                            signature, sizeof(signature), &signature_len,
+                                            mbedtls_ctr_drbg_random, &benchmark_drbg);
+    }
+    benchmark_report("ecdsa_p256_sign", 0u, CRYPTO_BENCHMARK_PK_ITERATIONS,
+                     benchmark_elapsed(start), ret);
+
+    start = benchmark_now();
+    for(uint32_t i = 0; (i < CRYPTO_BENCHMARK_PK_ITERATIONS) && (ret == 0); i++)
+    {
+        ret = mbedtls_ecdsa_read_signature(&ecdsa, hash, sizeof(hash), signature, signature_len);
+    }
+    benchmark_report("ecdsa_p256_verify", 0u, CRYPTO_BENCHMARK_PK_ITERATIONS,
+                     benchmark_elapsed(start), ret);
+
+    mbedtls_ecdsa_free(&ecdsa);
+}
+#endif /* MBEDTLS_ECDSA_C && MBEDTLS_ECP_DP_SECP256R1_ENABLED */
+
+#if defined(MBEDTLS_ECDH_C)
+/*******************************************************************************
+ * Function Name: benchmark_ecdhe
+ *******************************************************************************
+ * Summary:
+ *  Ephemeral key exchange as done by the client in every full handshake: one
+ *  key pair generation and one shared secret computation.
+ *
+ * Parameters:
+ *  const char *name: Name of the benchmark
+ *  mbedtls_ecp_group_id group_id: Curve
+ *
+ *******************************************************************************/
+static void benchmark_ecdhe(const char *name, mbedtls_ecp_group_id group_id)
+{
+    mbedtls_ecp_group group;
+    mbedtls_mpi private_key, peer_private_key, shared_secret;
+    mbedtls_ecp_point public_key, peer_public_key;
+    uint64_t start;
+    int ret;
+
+    mbedtls_ecp_group_init(&group);
+    mbedtls_mpi_init(&private_key);
+    mbedtls_mpi_init(&peer_private_key);
+    mbedtls_mpi_init(&shared_secret);
+    mbedtls_ecp_point_init(&public_key);
+    mbedtls_ecp_point_init(&peer_public_key);
+
+    ret = mbedtls_ecp_group_load(&group, group_id);
+    if(ret == 0)
+    {
+        ret = mbedtls_ecdh_gen_public(&group, &peer_private_key, &peer_public_key,
+                                      mbedtls_ctr_drbg_random, &benchmark_drbg);
+    }
+
+    start = benchmark_now();
+    for(uint32_t i = 0; (i < CRYPTO_BENCHMARK_PK_ITERATIONS) && (ret == 0); i++)
+    {
+        ret = mbedtls_ecdh_gen_public(&group, &private_key, &public_key,
+                                      mbedtls_ctr_drbg_random, &benchmark_drbg);
+        if(ret == 0)
+        {
+            ret = mbedtls_ecdh_compute_shared(&group, &shared_secret, &peer_public_key,
+                                              &private_key, mbedtls_ctr_drbg_random,
+                                              &benchmark_drbg);
+        }
+    }
+    benchmark_report(name, 0u, CRYPTO_BENCHMARK_PK_ITERATIONS, benchmark_elapsed(start), ret);
+
+    mbedtls_ecp_point_free(&peer_public_key);
+    mbedtls_ecp_point_free(&public_key);
+    mbedtls_mpi_free(&shared_secret);
+    mbedtls_mpi_free(&peer_private_key);
+    mbedtls_mpi_free(&private_key);
+    mbedtls_ecp_group_free(&group);
+}
+#endif /* MBEDTLS_ECDH_C */
+#endif /* MBEDTLS_CTR_DRBG_C && MBEDTLS_ENTROPY_C */
+
+/*******************************************************************************
+ * Function Name: crypto_benchmark_run
+ *******************************************************************************
+ * Summary:
+ *  Runs all benchmarks enabled by the Mbed TLS configuration and prints the
+ *  results, together with the configuration and the EC tuning parameters,
+ *  as one JSON document.
+ *
+ *******************************************************************************/
+void crypto_benchmark_run(void)
+{
+#if defined(CRYPTO_BENCHMARK_HOST)
+    benchmark_cpu_hz = benchmark_calibrate();
+#else
+    benchmark_cpu_hz = SystemCoreClock;
+#endif /* CRYPTO_BENCHMARK_HOST */
+
+    memset(benchmark_input, 0xA5, sizeof(benchmark_input));
+    benchmark_first_result = true;
+
+    printf("{\"crypto_benchmark\": {\n");
+#if defined(CRYPTO_BENCHMARK_HOST)
+    printf("    \"platform\": \"host\",\n");
+#else
+    printf("    \"platform\": \"target\",\n");
+#endif /* CRYPTO_BENCHMARK_HOST */
+    printf("    \"cpu_hz\": %"PRIu32",\n", benchmark_cpu_hz);
+#if defined(MBEDTLS_USER_CONFIG_FILE)
+    printf("    \"config\": %s,\n", TO_STRING(MBEDTLS_USER_CONFIG_FILE));
+#endif /* MBEDTLS_USER_CONFIG_FILE */
+#if defined(MBEDTLS_PROFILE_CONFIG_FILE)
+    printf("    \"profile_config\": %s,\n", TO_STRING(MBEDTLS_PROFILE_CONFIG_FILE));
+#endif /* MBEDTLS_PROFILE_CONFIG_FILE */
+#if defined(MBEDTLS_ECP_C)
+    printf("    \"ecp_window_size\": %d,\n", (int)MBEDTLS_ECP_WINDOW_SIZE);
+    printf("    \"ecp_fixed_point_optim\": %d,\n", (int)MBEDTLS_ECP_FIXED_POINT_OPTIM);
+#endif /* MBEDTLS_ECP_C */
+    printf("    \"results\": [");
+
+#if defined(MBEDTLS_SHA256_C)
+    benchmark_sha256();
+#endif /* MBEDTLS_SHA256_C */
+
+#if defined(MBEDTLS_GCM_C) && defined(MBEDTLS_AES_C)
+    benchmark_aes_gcm("aes128_gcm", 128u);
+    benchmark_aes_gcm("aes256_gcm", 256u);
+#endif /* MBEDTLS_GCM_C && MBEDTLS_AES_C */
+
+#if defined(MBEDTLS_CHACHAPOLY_C)
+    benchmark_chachapoly();
+#endif /* MBEDTLS_CHACHAPOLY_C */
+
+#if defined(MBEDTLS_CTR_DRBG_C) && defined(MBEDTLS_ENTROPY_C)
+    static const char personalization[] = "crypto_benchmark";
+
+    mbedtls_entropy_init(&benchmark_entropy);
+    mbedtls_ctr_drbg_init(&benchmark_drbg);
+    if(mbedtls_ctr_drbg_seed(&benchmark_drbg, mbedtls_entropy_func, &benchmark_entropy,
+                             (const unsigned char *)personalization,
+                             sizeof(personalization) - 1u) == 0)
+    {
+    #if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+        benchmark_ecdsa_p256();
+    #endif /* MBEDTLS_ECDSA_C && MBEDTLS_ECP_DP_SECP256R1_ENABLED */
+
+    #if defined(MBEDTLS_ECDH_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+        benchmark_ecdhe("ecdhe_p256", MBEDTLS_ECP_DP_SECP256R1);
+    #endif /* MBEDTLS_ECDH_C && MBEDTLS_ECP_DP_SECP256R1_ENABLED */
+
+    #if defined(MBEDTLS_ECDH_C) && defined(MBEDTLS_ECP_DP_CURVE25519_ENABLED)
+        benchmark_ecdhe("ecdhe_x25519", MBEDTLS_ECP_DP_CURVE25519);
+    #endif /* MBEDTLS_ECDH_C && MBEDTLS_ECP_DP_CURVE25519_ENABLED */
+    }
+    else
+    {
+        benchmark_report("ctr_drbg_seed", 0u, 0u, 0u, -1);
+    }
+
+    mbedtls_ctr_drbg_free(&benchmark_drbg);
+    mbedtls_entropy_free(&benchmark_entropy);
+#endif /* MBEDTLS_CTR_DRBG_C && MBEDTLS_ENTROPY_C */
+
+    printf("\n    ]\n}}\n");
+}
+
+#if defined(CRYPTO_BENCHMARK_HOST)
+int main(void)
+{
+    crypto_benchmark_run();
+    return 0;
+}
+#endif /* CRYPTO_BENCHMARK_HOST */
+
+/* [] END OF FILE */
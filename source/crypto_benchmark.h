@@ -0,0 +1,68 @@
+/******************************************************************************
+* File Name:   crypto_benchmark.h
+*
+* Description: This file contains the declarations of the crypto primitive
+* benchmark. The benchmark runs the primitives used by the TLS handshake and
+* record layer under the Mbed TLS configuration of the application.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CRYPTO_BENCHMARK_H_
+#define CRYPTO_BENCHMARK_H_
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set this macro to '1' to run the crypto benchmark at startup, before the
+ * Wi-Fi connection is set up. The results are printed as one JSON document.
+ */
+#ifndef ENABLE_CRYPTO_BENCHMARK
+#define ENABLE_CRYPTO_BENCHMARK               (0)
+#endif
+
+/* Message size used by the hash and AEAD benchmarks: the payload of a full
+ * TLS record is up to 16 KB, the records of this application are small.
+ */
+#define CRYPTO_BENCHMARK_MESSAGE_LEN          (1024u)
+
+/* Number of operations per benchmark. */
+#define CRYPTO_BENCHMARK_BULK_ITERATIONS      (64u)
+#define CRYPTO_BENCHMARK_PK_ITERATIONS        (8u)
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void crypto_benchmark_run(void);
+
+#endif /* CRYPTO_BENCHMARK_H_ */
@@ -0,0 +1,1262 @@
+/******************************************************************************
+* File Name:   dns_cache.c
+*
+* Description: This file contains the DNS resolver cache used to connect to the
+* TCP server by host name. Answers are cached for their TTL and served stale
+* for DNS_CACHE_STALE_S after that, while a background task refreshes them,
+* so that only the first lookup of a host name waits for the DNS server.
+* dns_cache_lookup() hands that first lookup to the same task instead of
+* waiting for it. Names without an address are cached as negative entries.
+*
+* Built with DNS_CACHE_HOST defined, the file is a host program that looks a
+* name up repeatedly with dns_cache_lookup() against a DNS server given on
+* the command line (see tools/stub_dns_server.py) and prints the outcome and
+* the latency of each lookup.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#if defined(DNS_CACHE_HOST)
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#else
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+/* Cypress secure socket and lwIP header files. */
+#include "cy_secure_sockets.h"
+#include "lwip/dns.h"
+
+/* Timestamp header file. */
+#include "app_time.h"
+#endif /* DNS_CACHE_HOST */
+
+/* DNS cache header file. */
+#include "dns_cache.h"
+
+#if(ENABLE_DNS_CACHE)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define DNS_HEADER_LEN                     (12u)
+#define DNS_MESSAGE_MAX_LEN                (512u)
+#define DNS_FLAGS_RD                       (0x0100u)
+#define DNS_FLAGS_QR                       (0x8000u)
+#define DNS_FLAGS_RCODE_MASK               (0x000Fu)
+#define DNS_RCODE_NXDOMAIN                 (3u)
+#define DNS_TYPE_A                         (1u)
+#define DNS_TYPE_SOA                       (6u)
+#define DNS_TYPE_AAAA                      (28u)
+#define DNS_CLASS_IN                       (1u)
+#define DNS_LABEL_MAX_LEN                  (63u)
+
+#define US_PER_S                           (1000000ull)
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+typedef struct
+{
+    bool valid;
+    bool refreshing;
+    bool negative;          /* No address of the IP version. */
+    char name[DNS_CACHE_NAME_LEN];
+    dns_cache_addr_t addr;
+    uint64_t expires_us;
+    uint64_t stale_until_us;
+    uint64_t used_us;
+} dns_cache_entry_t;
+
+/* Outcome of a query. */
+typedef enum
+{
+    DNS_ANSWER_ADDRESS,     /* The server returned an address. */
+    DNS_ANSWER_NEGATIVE,    /* NXDOMAIN or no address of the requested type. */
+    DNS_ANSWER_NONE         /* No valid response. */
+} dns_answer_t;
+
+typedef enum
+{
+    DNS_LOOKUP_IDLE,
+    DNS_LOOKUP_QUEUED,
+    DNS_LOOKUP_RUNNING,
+    DNS_LOOKUP_RESOLVED,
+    DNS_LOOKUP_FAILED
+} dns_lookup_state_t;
+
+/* Lookup of a host name that was not cached, run by the DNS cache task. */
+typedef struct
+{
+    dns_lookup_state_t state;
+    char name[DNS_CACHE_NAME_LEN];
+    dns_cache_addr_t addr;
+    uint64_t begin_us;
+} dns_lookup_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static dns_answer_t dns_cache_query(const char *hostname, uint8_t version, dns_cache_addr_t *addr,
+                                    uint32_t *ttl_s);
+static uint32_t dns_cache_build_query(const char *hostname, uint16_t qtype, uint16_t id,
+                                      uint8_t *msg);
+static dns_answer_t dns_cache_parse_answer(const uint8_t *msg, uint32_t len, uint16_t qtype,
+                                           uint16_t id, dns_cache_addr_t *addr, uint32_t *ttl_s);
+static int32_t dns_cache_skip_name(const uint8_t *msg, uint32_t len, uint32_t pos);
+static dns_cache_entry_t *dns_cache_find(const char *hostname, uint8_t version);
+static dns_cache_status_t dns_cache_get(const char *hostname, uint8_t version,
+                                        dns_cache_addr_t *addr, uint64_t now_us, bool *wake);
+static void dns_cache_store(const char *hostname, uint8_t version, const dns_cache_addr_t *addr,
+                            uint32_t ttl_s);
+static void dns_cache_lookup_pending(void);
+static void dns_cache_refresh_pending(void);
+
+/* Platform specific functions. */
+static uint64_t dns_cache_time_us(void);
+static void dns_cache_lock(void);
+static void dns_cache_unlock(void);
+static void dns_cache_wake_refresh(void);
+static bool dns_cache_exchange(const uint8_t *query, uint32_t query_len, uint8_t *answer,
+                               uint32_t *answer_len, uint16_t id);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static dns_cache_entry_t dns_cache[DNS_CACHE_ENTRIES];
+static dns_cache_stats_t dns_cache_stats;
+static uint16_t dns_cache_query_id;
+
+/* Lookups started by dns_cache_lookup(), one per IP version. */
+static dns_lookup_t dns_lookups[2];
+static dns_cache_callback_t dns_lookup_callback;
+
+#if defined(DNS_CACHE_HOST)
+static pthread_mutex_t dns_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static sem_t dns_cache_refresh_sem;
+static sem_t dns_cache_done_sem;
+static struct sockaddr_in dns_cache_server;
+#else
+static SemaphoreHandle_t dns_cache_mutex;
+static TaskHandle_t dns_cache_task_handle;
+#endif /* DNS_CACHE_HOST */
+
+/*******************************************************************************
+ * Function Name: dns_cache_lookup
+ *******************************************************************************
+ * Summary:
+ *  Resolves a host name without waiting for the DNS server. A host name that
+ *  is not cached is sent to the DNS cache task, which calls the callback when
+ *  the lookup completes; the caller then calls the function again to get the
+ *  address or DNS_CACHE_FAILED. A new host name replaces the lookup of the
+ *  same IP version that is in progress. A host name known to have no address
+ *  returns DNS_CACHE_NEGATIVE until its negative entry expires.
+ *
+ * Parameters:
+ *  const char *hostname: Host name to be resolved
+ *  uint8_t version: IP version of the address (4 or 6)
+ *  dns_cache_addr_t *addr: Resolved address
+ *  dns_cache_callback_t callback: Called when the lookup completes
+ *
+ * Return:
+ *  dns_cache_status_t: Where the address came from, DNS_CACHE_PENDING,
+ *  DNS_CACHE_NEGATIVE or DNS_CACHE_FAILED
+ *
+ *******************************************************************************/
+dns_cache_status_t dns_cache_lookup(const char *hostname, uint8_t version, dns_cache_addr_t *addr,
+                                    dns_cache_callback_t callback)
+{
+    dns_lookup_t *lookup = &dns_lookups[(version == 6u) ? 1u : 0u];
+    dns_cache_status_t status;
+    uint64_t now_us = dns_cache_time_us();
+    bool same_name;
+    bool wake = false;
+
+    if(strlen(hostname) >= DNS_CACHE_NAME_LEN)
+    {
+        return DNS_CACHE_FAILED;
+    }
+
+    dns_cache_lock();
+    same_name = (strcmp(lookup->name, hostname) == 0);
+    if(same_name && ((lookup->state == DNS_LOOKUP_RESOLVED) || (lookup->state == DNS_LOOKUP_FAILED)))
+    {
+        /* The outcome of a completed lookup is reported once. */
+        status = DNS_CACHE_FAILED;
+        if(lookup->state == DNS_LOOKUP_RESOLVED)
+        {
+            status = DNS_CACHE_RESOLVED;
+            *addr = lookup->addr;
+        }
+        lookup->state = DNS_LOOKUP_IDLE;
+    }
+    else if(same_name && (lookup->state != DNS_LOOKUP_IDLE))
+    {
+        status = DNS_CACHE_PENDING;
+    }
+    else
+    {
+        status = dns_cache_get(hostname, version, addr, now_us, &wake);
+        if(status != DNS_CACHE_FAILED)
+        {
+            dns_cache_stats.last_resolve_us = (uint32_t)(dns_cache_time_us() - now_us);
+        }
+        else
+        {
+            strcpy(lookup->name, hostname);
+            lookup->state = DNS_LOOKUP_QUEUED;
+            lookup->begin_us = now_us;
+            dns_lookup_callback = callback;
+            dns_cache_stats.misses++;
+            status = DNS_CACHE_PENDING;
+            wake = true;
+        }
+    }
+    dns_cache_unlock();
+
+    if(wake)
+    {
+        dns_cache_wake_refresh();
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the lookup counters and the latency of the last lookup.
+ *
+ * Parameters:
+ *  dns_cache_stats_t *stats: Statistics to be filled
+ *
+ *******************************************************************************/
+void dns_cache_get_stats(dns_cache_stats_t *stats)
+{
+    dns_cache_lock();
+    *stats = dns_cache_stats;
+    dns_cache_unlock();
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_query
+ *******************************************************************************
+ * Summary:
+ *  Sends a query for the address of the host name to the DNS server.
+ *
+ * Parameters:
+ *  const char *hostname: Host name to be resolved
+ *  uint8_t version: IP version of the address (4 or 6)
+ *  dns_cache_addr_t *addr: Resolved address
+ *  uint32_t *ttl_s: TTL of the address or of the negative answer, in seconds
+ *
+ * Return:
+ *  dns_answer_t: Outcome of the query
+ *
+ *******************************************************************************/
+static dns_answer_t dns_cache_query(const char *hostname, uint8_t version, dns_cache_addr_t *addr,
+                                    uint32_t *ttl_s)
+{
+    uint8_t query[DNS_MESSAGE_MAX_LEN];
+    uint8_t answer[DNS_MESSAGE_MAX_LEN];
+    uint16_t qtype = (version == 6u) ? DNS_TYPE_AAAA : DNS_TYPE_A;
+    uint32_t query_len;
+    uint32_t answer_len;
+    uint16_t id;
+
+    dns_cache_lock();
+    id = (uint16_t)(++dns_cache_query_id ^ (uint16_t)dns_cache_time_us());
+    dns_cache_unlock();
+
+    query_len = dns_cache_build_query(hostname, qtype, id, query);
+    if(query_len == 0u)
+    {
+        return DNS_ANSWER_NONE;
+    }
+
+    for(uint32_t attempt = 0; attempt < DNS_CACHE_QUERY_ATTEMPTS; attempt++)
+    {
+        answer_len = sizeof(answer);
+        if(dns_cache_exchange(query, query_len, answer, &answer_len, id))
+        {
+            return dns_cache_parse_answer(answer, answer_len, qtype, id, addr, ttl_s);
+        }
+    }
+
+    return DNS_ANSWER_NONE;
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_build_query
+ *******************************************************************************
+ * Summary:
+ *  Encodes a recursive query with a single question.
+ *
+ * Parameters:
+ *  const char *hostname: Host name to be resolved
+ *  uint16_t qtype: DNS_TYPE_A or DNS_TYPE_AAAA
+ *  uint16_t id: Query identifier
+ *  uint8_t *msg: Query (DNS_MESSAGE_MAX_LEN bytes)
+ *
+ * Return:
+ *  uint32_t: Length of the query, 0 if the host name is not valid
+ *
+ *******************************************************************************/
+static uint32_t dns_cache_build_query(const char *hostname, uint16_t qtype, uint16_t id,
+                                      uint8_t *msg)
+{
+    uint32_t pos = DNS_HEADER_LEN;
+    const char *label = hostname;
+
+    memset(msg, 0, DNS_HEADER_LEN);
+    msg[0] = (uint8_t)(id >> 8);
+    msg[1] = (uint8_t)id;
+    msg[2] = (uint8_t)(DNS_FLAGS_RD >> 8);
+    msg[5] = 1u;                            /* QDCOUNT */
+
+    while(*label != '\0')
+    {
+        const char *dot = strchr(label, '.');
+        uint32_t label_len = (dot != NULL) ? (uint32_t)(dot - label) : (uint32_t)strlen(label);
+
+        if((label_len == 0u) || (label_len > DNS_LABEL_MAX_LEN) ||
+           ((pos + 1u + label_len + 5u) > DNS_MESSAGE_MAX_LEN))
+        {
+            return 0u;
+        }
+
+        msg[pos++] = (uint8_t)label_len;
+        memcpy(&msg[pos], label, label_len);
+        pos += label_len;
+        label += label_len + ((dot != NULL) ? 1u : 0u);
+    }
+
+    if(pos == DNS_HEADER_LEN)
+    {
+        return 0u;
+    }
+
+    msg[pos++] = 0u;
+    msg[pos++] = (uint8_t)(qtype >> 8);
+    msg[pos++] = (uint8_t)qtype;
+    msg[pos++] = 0u;
+    msg[pos++] = (uint8_t)DNS_CLASS_IN;
+
+    return pos;
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_parse_answer
+ *******************************************************************************
+ * Summary:
+ *  Extracts the first address of the requested type from a DNS response,
+ *  following CNAME records, and the lowest TTL of the records on the way.
+ *  Without an address, the negative TTL is the lower of the TTL and the
+ *  minimum of the SOA record in the authority section (RFC 2308).
+ *
+ * Parameters:
+ *  const uint8_t *msg: DNS response
+ *  uint32_t len: Length of the response
+ *  uint16_t qtype: DNS_TYPE_A or DNS_TYPE_AAAA
+ *  uint16_t id: Identifier of the query
+ *  dns_cache_addr_t *addr: Resolved address
+ *  uint32_t *ttl_s: Lowest TTL of the answer records, or negative TTL, in
+ *  seconds
+ *
+ * Return:
+ *  dns_answer_t: Outcome of the query
+ *
+ *******************************************************************************/
+static dns_answer_t dns_cache_parse_answer(const uint8_t *msg, uint32_t len, uint16_t qtype,
+                                           uint16_t id, dns_cache_addr_t *addr, uint32_t *ttl_s)
+{
+    uint32_t addr_len = (qtype == DNS_TYPE_AAAA) ? 16u : 4u;
+    uint32_t ttl_min = DNS_CACHE_MAX_TTL_S;
+    uint16_t flags, rcode, qdcount, ancount, nscount;
+    int32_t pos;
+
+    if(len < DNS_HEADER_LEN)
+    {
+        return DNS_ANSWER_NONE;
+    }
+
+    flags = (uint16_t)((msg[2] << 8) | msg[3]);
+    rcode = (uint16_t)(flags & DNS_FLAGS_RCODE_MASK);
+    qdcount = (uint16_t)((msg[4] << 8) | msg[5]);
+    ancount = (uint16_t)((msg[6] << 8) | msg[7]);
+    nscount = (uint16_t)((msg[8] << 8) | msg[9]);
+
+    if((((msg[0] << 8) | msg[1]) != id) || ((flags & DNS_FLAGS_QR) == 0u) ||
+       ((rcode != 0u) && (rcode != DNS_RCODE_NXDOMAIN)))
+    {
+        return DNS_ANSWER_NONE;
+    }
+
+    pos = (int32_t)DNS_HEADER_LEN;
+    for(uint16_t i = 0; (i < qdcount) && (pos >= 0); i++)
+    {
+        pos = dns_cache_skip_name(msg, len, (uint32_t)pos);
+        pos = ((pos >= 0) && ((uint32_t)pos + 4u <= len)) ? (pos + 4) : -1;
+    }
+
+    for(uint16_t i = 0; (i < ancount) && (pos >= 0); i++)
+    {
+        uint16_t type, class, rdlength;
+        uint32_t ttl;
+
+        pos = dns_cache_skip_name(msg, len, (uint32_t)pos);
+        if((pos < 0) || ((uint32_t)pos + 10u > len))
+        {
+            return DNS_ANSWER_NONE;
+        }
+
+        type = (uint16_t)((msg[pos] << 8) | msg[pos + 1]);
+        class = (uint16_t)((msg[pos + 2] << 8) | msg[pos + 3]);
+        ttl = ((uint32_t)msg[pos + 4] << 24) | ((uint32_t)msg[pos + 5] << 16) |
+              ((uint32_t)msg[pos + 6] << 8) | (uint32_t)msg[pos + 7];
+        rdlength = (uint16_t)((msg[pos + 8] << 8) | msg[pos + 9]);
+        pos += 10;
+
+        if((uint32_t)pos + rdlength > len)
+        {
+            return DNS_ANSWER_NONE;
+        }
+
+        if(class == DNS_CLASS_IN)
+        {
+            if(ttl < ttl_min)
+            {
+                ttl_min = ttl;
+            }
+
+            if((type == qtype) && (rdlength == addr_len))
+            {
+                memset(addr, 0, sizeof(*addr));
+                addr->version = (qtype == DNS_TYPE_AAAA) ? 6u : 4u;
+                memcpy(addr->bytes, &msg[pos], addr_len);
+                *ttl_s = ttl_min;
+                return DNS_ANSWER_ADDRESS;
+            }
+        }
+
+        pos += rdlength;
+    }
+
+    if(pos < 0)
+    {
+        return DNS_ANSWER_NONE;
+    }
+
+    *ttl_s = DNS_CACHE_NEGATIVE_TTL_S;
+    for(uint16_t i = 0; i < nscount; i++)
+    {
+        uint16_t type, rdlength;
+        uint32_t ttl, minimum;
+
+        pos = dns_cache_skip_name(msg, len, (uint32_t)pos);
+        if((pos < 0) || ((uint32_t)pos + 10u > len))
+        {
+            break;
+        }
+
+        type = (uint16_t)((msg[pos] << 8) | msg[pos + 1]);
+        ttl = ((uint32_t)msg[pos + 4] << 24) | ((uint32_t)msg[pos + 5] << 16) |
+              ((uint32_t)msg[pos + 6] << 8) | (uint32_t)msg[pos + 7];
+        rdlength = (uint16_t)((msg[pos + 8] << 8) | msg[pos + 9]);
+        pos += 10;
+
+        if((uint32_t)pos + rdlength > len)
+        {
+            break;
+        }
+
+        /* MNAME and RNAME take at least one byte each, followed by five
+         * 32-bit fields, the last one being MINIMUM.
+         */
+        if((type == DNS_TYPE_SOA) && (rdlength >= 22u))
+        {
+            minimum = ((uint32_t)msg[pos + rdlength - 4] << 24) |
+                      ((uint32_t)msg[pos + rdlength - 3] << 16) |
+                      ((uint32_t)msg[pos + rdlength - 2] << 8) |
+                      (uint32_t)msg[pos + rdlength - 1];
+            ttl = (minimum < ttl) ? minimum : ttl;
+            *ttl_s = (ttl < *ttl_s) ? ttl : *ttl_s;
+            break;
+        }
+
+        pos += rdlength;
+    }
+
+    return DNS_ANSWER_NEGATIVE;
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_skip_name
+ *******************************************************************************
+ * Summary:
+ *  Skips an encoded (possibly compressed) domain name.
+ *
+ * Parameters:
+ *  const uint8_t *msg: DNS message
+ *  uint32_t len: Length of the message
+ *  uint32_t pos: Offset of the name
+ *
+ * Return:
+ *  int32_t: Offset after the name, -1 if the name is malformed
+ *
+ *******************************************************************************/
+static int32_t dns_cache_skip_name(const uint8_t *msg, uint32_t len, uint32_t pos)
+{
+    while(pos < len)
+    {
+        uint8_t label_len = msg[pos];
+
+        if(label_len == 0u)
+        {
+            return (int32_t)(pos + 1u);
+        }
+        if((label_len & 0xC0u) == 0xC0u)
+        {
+            return ((pos + 2u) <= len) ? (int32_t)(pos + 2u) : -1;
+        }
+        if((label_len & 0xC0u) != 0u)
+        {
+            return -1;
+        }
+        pos += 1u + label_len;
+    }
+
+    return -1;
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_find
+ *******************************************************************************
+ * Summary:
+ *  Looks a host name up. The caller holds the cache lock.
+ *
+ * Parameters:
+ *  const char *hostname: Host name
+ *  uint8_t version: IP version of the address (4 or 6)
+ *
+ * Return:
+ *  dns_cache_entry_t *: Entry of the host name, NULL if not cached
+ *
+ *******************************************************************************/
+static dns_cache_entry_t *dns_cache_find(const char *hostname, uint8_t version)
+{
+    for(uint32_t i = 0; i < DNS_CACHE_ENTRIES; i++)
+    {
+        if(dns_cache[i].valid && (dns_cache[i].addr.version == version) &&
+           (strcmp(dns_cache[i].name, hostname) == 0))
+        {
+            return &dns_cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_get
+ *******************************************************************************
+ * Summary:
+ *  Returns the cached address of a host name and counts the hit. An expired
+ *  entry is marked for refresh; an expired negative entry is not cached any
+ *  more. Called with the lock taken.
+ *
+ * Parameters:
+ *  const char *hostname: Host name
+ *  uint8_t version: IP version of the address (4 or 6)
+ *  dns_cache_addr_t *addr: Cached address
+ *  uint64_t now_us: Current time
+ *  bool *wake: Set when the background refresh must be woken up
+ *
+ * Return:
+ *  dns_cache_status_t: DNS_CACHE_HIT, DNS_CACHE_STALE, DNS_CACHE_NEGATIVE or
+ *  DNS_CACHE_FAILED if not cached
+ *
+ *******************************************************************************/
+static dns_cache_status_t dns_cache_get(const char *hostname, uint8_t version,
+                                        dns_cache_addr_t *addr, uint64_t now_us, bool *wake)
+{
+    dns_cache_entry_t *entry = dns_cache_find(hostname, version);
+
+    if((entry == NULL) || (now_us >= entry->stale_until_us))
+    {
+        return DNS_CACHE_FAILED;
+    }
+
+    entry->used_us = now_us;
+    if(entry->negative)
+    {
+        dns_cache_stats.negative_hits++;
+        return DNS_CACHE_NEGATIVE;
+    }
+
+    *addr = entry->addr;
+
+    if(now_us < entry->expires_us)
+    {
+        dns_cache_stats.hits++;
+        return DNS_CACHE_HIT;
+    }
+
+    dns_cache_stats.stale_hits++;
+    *wake = *wake || !entry->refreshing;
+    entry->refreshing = true;
+
+    return DNS_CACHE_STALE;
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_store
+ *******************************************************************************
+ * Summary:
+ *  Stores an answer, replacing the least recently used entry when the cache
+ *  is full. A negative entry is stored without an address and is not served
+ *  stale.
+ *
+ * Parameters:
+ *  const char *hostname: Host name
+ *  uint8_t version: IP version of the address (4 or 6)
+ *  const dns_cache_addr_t *addr: Resolved address, NULL for a negative entry
+ *  uint32_t ttl_s: TTL of the answer, in seconds
+ *
+ *******************************************************************************/
+static void dns_cache_store(const char *hostname, uint8_t version, const dns_cache_addr_t *addr,
+                            uint32_t ttl_s)
+{
+    uint64_t now_us = dns_cache_time_us();
+    dns_cache_entry_t *entry;
+
+    if(ttl_s > DNS_CACHE_MAX_TTL_S)
+    {
+        ttl_s = DNS_CACHE_MAX_TTL_S;
+    }
+
+    dns_cache_lock();
+    entry = dns_cache_find(hostname, version);
+    for(uint32_t i = 0; (entry == NULL) && (i < DNS_CACHE_ENTRIES); i++)
+    {
+        if(!dns_cache[i].valid)
+        {
+            entry = &dns_cache[i];
+        }
+    }
+    if(entry == NULL)
+    {
+        entry = &dns_cache[0];
+        for(uint32_t i = 1; i < DNS_CACHE_ENTRIES; i++)
+        {
+            if(!dns_cache[i].refreshing && (dns_cache[i].used_us < entry->used_us))
+            {
+                entry = &dns_cache[i];
+            }
+        }
+    }
+
+    strcpy(entry->name, hostname);
+    entry->expires_us = now_us + ((uint64_t)ttl_s * US_PER_S);
+    entry->negative = (addr == NULL);
+    if(entry->negative)
+    {
+        memset(&entry->addr, 0, sizeof(entry->addr));
+        entry->addr.version = version;
+        entry->stale_until_us = entry->expires_us;
+    }
+    else
+    {
+        entry->addr = *addr;
+        entry->stale_until_us = entry->expires_us + ((uint64_t)DNS_CACHE_STALE_S * US_PER_S);
+    }
+    entry->used_us = now_us;
+    entry->refreshing = false;
+    entry->valid = true;
+    dns_cache_unlock();
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_lookup_pending
+ *******************************************************************************
+ * Summary:
+ *  Runs the lookups queued by dns_cache_lookup() and calls the callback when
+ *  each one completes. A lookup that fails is cached as a negative entry. A
+ *  lookup replaced while it runs is not reported.
+ *
+ *******************************************************************************/
+static void dns_cache_lookup_pending(void)
+{
+    char name[DNS_CACHE_NAME_LEN];
+    dns_cache_callback_t callback;
+    dns_cache_addr_t addr;
+    dns_lookup_t *lookup;
+    dns_answer_t answer;
+    uint32_t ttl_s;
+    uint8_t version;
+    bool resolved;
+
+    for(;;)
+    {
+        lookup = NULL;
+        dns_cache_lock();
+        for(uint32_t i = 0; i < 2u; i++)
+        {
+            if(dns_lookups[i].state == DNS_LOOKUP_QUEUED)
+            {
+                lookup = &dns_lookups[i];
+                lookup->state = DNS_LOOKUP_RUNNING;
+                strcpy(name, lookup->name);
+                version = (i == 1u) ? 6u : 4u;
+                break;
+            }
+        }
+        dns_cache_unlock();
+
+        if(lookup == NULL)
+        {
+            return;
+        }
+
+        answer = dns_cache_query(name, version, &addr, &ttl_s);
+        resolved = (answer == DNS_ANSWER_ADDRESS);
+        if(answer == DNS_ANSWER_NONE)
+        {
+            ttl_s = DNS_CACHE_FAILURE_TTL_S;
+        }
+        dns_cache_store(name, version, resolved ? &addr : NULL, ttl_s);
+
+        callback = NULL;
+        dns_cache_lock();
+        if(!resolved)
+        {
+            dns_cache_stats.failures++;
+        }
+        if((lookup->state == DNS_LOOKUP_RUNNING) && (strcmp(lookup->name, name) == 0))
+        {
+            lookup->state = resolved ? DNS_LOOKUP_RESOLVED : DNS_LOOKUP_FAILED;
+            if(resolved)
+            {
+                lookup->addr = addr;
+            }
+            dns_cache_stats.last_resolve_us = (uint32_t)(dns_cache_time_us() - lookup->begin_us);
+            callback = dns_lookup_callback;
+        }
+        dns_cache_unlock();
+
+        if(callback != NULL)
+        {
+            callback();
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_refresh_pending
+ *******************************************************************************
+ * Summary:
+ *  Queries the DNS server again for every entry marked for refresh. An entry
+ *  whose refresh fails keeps its address until DNS_CACHE_STALE_S is over.
+ *
+ *******************************************************************************/
+static void dns_cache_refresh_pending(void)
+{
+    char name[DNS_CACHE_NAME_LEN];
+    dns_cache_addr_t addr;
+    dns_cache_entry_t *entry;
+    uint32_t ttl_s;
+    uint8_t version;
+
+    for(;;)
+    {
+        entry = NULL;
+        dns_cache_lock();
+        for(uint32_t i = 0; i < DNS_CACHE_ENTRIES; i++)
+        {
+            if(dns_cache[i].valid && dns_cache[i].refreshing)
+            {
+                entry = &dns_cache[i];
+                strcpy(name, entry->name);
+                version = entry->addr.version;
+                break;
+            }
+        }
+        dns_cache_unlock();
+
+        if(entry == NULL)
+        {
+            return;
+        }
+
+        if(dns_cache_query(name, version, &addr, &ttl_s) == DNS_ANSWER_ADDRESS)
+        {
+            dns_cache_store(name, version, &addr, ttl_s);
+            dns_cache_lock();
+            dns_cache_stats.refreshes++;
+            dns_cache_unlock();
+        }
+        else
+        {
+            dns_cache_lock();
+            entry = dns_cache_find(name, version);
+            if(entry != NULL)
+            {
+                entry->refreshing = false;
+            }
+            dns_cache_stats.failures++;
+            dns_cache_unlock();
+        }
+    }
+}
+
+#if defined(DNS_CACHE_HOST)
+
+/*******************************************************************************
+ * Function Name: dns_cache_refresh_thread
+ *******************************************************************************
+ * Summary:
+ *  Host thread that runs the queued lookups and refreshes the expired entries.
+ *
+ *******************************************************************************/
+static void *dns_cache_refresh_thread(void *arg)
+{
+    (void)arg;
+
+    for(;;)
+    {
+        sem_wait(&dns_cache_refresh_sem);
+        dns_cache_lookup_pending();
+        dns_cache_refresh_pending();
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_init
+ *******************************************************************************
+ * Summary:
+ *  Starts the refresh thread of the host build.
+ *
+ *******************************************************************************/
+void dns_cache_init(void)
+{
+    pthread_t thread;
+
+    sem_init(&dns_cache_refresh_sem, 0, 0);
+    pthread_create(&thread, NULL, dns_cache_refresh_thread, NULL);
+    pthread_detach(thread);
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_time_us
+ *******************************************************************************
+ * Summary:
+ *  Returns a monotonic timestamp in microseconds.
+ *
+ *******************************************************************************/
+static uint64_t dns_cache_time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * US_PER_S) + ((uint64_t)ts.tv_nsec / 1000u);
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_lock
+ *******************************************************************************
+ * Summary:
+ *  Takes the lock protecting the cache entries and the statistics.
+ *
+ *******************************************************************************/
+static void dns_cache_lock(void)
+{
+    pthread_mutex_lock(&dns_cache_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_unlock
+ *******************************************************************************
+ * Summary:
+ *  Releases the lock taken by dns_cache_lock().
+ *
+ *******************************************************************************/
+static void dns_cache_unlock(void)
+{
+    pthread_mutex_unlock(&dns_cache_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_wake_refresh
+ *******************************************************************************
+ * Summary:
+ *  Wakes the DNS cache task up.
+ *
+ *******************************************************************************/
+static void dns_cache_wake_refresh(void)
+{
+    sem_post(&dns_cache_refresh_sem);
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_exchange
+ *******************************************************************************
+ * Summary:
+ *  Sends a query to the DNS server given on the command line and waits for
+ *  the response with the same identifier.
+ *
+ *******************************************************************************/
+static bool dns_cache_exchange(const uint8_t *query, uint32_t query_len, uint8_t *answer,
+                               uint32_t *answer_len, uint16_t id)
+{
+    struct timeval timeout = { .tv_sec = DNS_CACHE_QUERY_TIMEOUT_MS / 1000u,
+                               .tv_usec = (DNS_CACHE_QUERY_TIMEOUT_MS % 1000u) * 1000u };
+    bool received = false;
+    ssize_t len;
+    int fd;
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if(sendto(fd, query, query_len, 0, (struct sockaddr *)&dns_cache_server,
+              sizeof(dns_cache_server)) == (ssize_t)query_len)
+    {
+        while(!received)
+        {
+            len = recv(fd, answer, *answer_len, 0);
+            if(len < 0)
+            {
+                break;
+            }
+            received = (len >= 2) && (((answer[0] << 8) | answer[1]) == id);
+            if(received)
+            {
+                *answer_len = (uint32_t)len;
+            }
+        }
+    }
+
+    close(fd);
+    return received;
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_done
+ *******************************************************************************
+ * Summary:
+ *  Callback of the lookups started by main(); wakes main() up.
+ *
+ *******************************************************************************/
+static void dns_cache_done(void)
+{
+    sem_post(&dns_cache_done_sem);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *  Looks the IPv4 and IPv6 addresses of a host name up repeatedly through
+ *  dns_cache_lookup(), waiting for the callback of each lookup that is not
+ *  cached, and prints the outcome and the latency of each lookup, followed by
+ *  the cache statistics.
+ *  Usage: dns_cache <server-ip> <port> <hostname> [lookups] [interval-ms]
+ *
+ *******************************************************************************/
+int main(int argc, char **argv)
+{
+    static const char *status_names[] = { "hit", "stale", "resolved", "failed", "pending",
+                                          "negative" };
+    char addr_text[INET6_ADDRSTRLEN];
+    dns_cache_stats_t stats;
+    dns_cache_addr_t addr;
+    dns_cache_status_t status;
+    uint32_t lookups, interval_ms, answered;
+    uint64_t begin_us;
+    bool missed;
+
+    if(argc < 4)
+    {
+        fprintf(stderr, "Usage: %s <server-ip> <port> <hostname> [lookups] [interval-ms]\n", argv[0]);
+        return 2;
+    }
+
+    dns_cache_server.sin_family = AF_INET;
+    dns_cache_server.sin_port = htons((uint16_t)atoi(argv[2]));
+    if(inet_pton(AF_INET, argv[1], &dns_cache_server.sin_addr) != 1)
+    {
+        fprintf(stderr, "Invalid server address: %s\n", argv[1]);
+        return 2;
+    }
+    lookups = (argc > 4) ? (uint32_t)atoi(argv[4]) : 10u;
+    interval_ms = (argc > 5) ? (uint32_t)atoi(argv[5]) : 1000u;
+
+    sem_init(&dns_cache_done_sem, 0, 0);
+    dns_cache_init();
+
+    for(uint32_t i = 0; i < lookups; i++)
+    {
+        for(uint8_t version = 4u; version <= 6u; version += 2u)
+        {
+            begin_us = dns_cache_time_us();
+            status = dns_cache_lookup(argv[3], version, &addr, dns_cache_done);
+            missed = (status == DNS_CACHE_PENDING);
+            if(missed)
+            {
+                sem_wait(&dns_cache_done_sem);
+                status = dns_cache_lookup(argv[3], version, &addr, dns_cache_done);
+            }
+
+            if((status == DNS_CACHE_FAILED) || (status == DNS_CACHE_NEGATIVE) ||
+               (status == DNS_CACHE_PENDING))
+            {
+                strcpy(addr_text, "-");
+            }
+            else
+            {
+                inet_ntop((version == 6u) ? AF_INET6 : AF_INET, addr.bytes, addr_text,
+                          sizeof(addr_text));
+            }
+            printf("lookup %2"PRIu32" IPv%u: %-4s %-8s %-24s %8"PRIu64" us\n", i,
+                   (unsigned int)version, missed ? "miss" : "", status_names[status], addr_text,
+                   dns_cache_time_us() - begin_us);
+        }
+        usleep(interval_ms * 1000u);
+    }
+
+    dns_cache_get_stats(&stats);
+    answered = stats.hits + stats.stale_hits + stats.negative_hits;
+    printf("hits %"PRIu32", stale hits %"PRIu32", negative hits %"PRIu32", misses %"PRIu32", "
+           "failures %"PRIu32", refreshes %"PRIu32", hit rate %"PRIu32"%%\n", stats.hits,
+           stats.stale_hits, stats.negative_hits, stats.misses, stats.failures, stats.refreshes,
+           (answered * 100u) / (answered + stats.misses));
+
+    return 0;
+}
+
+#else
+
+/*******************************************************************************
+ * Function Name: dns_cache_task
+ *******************************************************************************
+ * Summary:
+ *  Task that runs the queued lookups and refreshes the expired entries.
+ *
+ * Parameters:
+ *  void *arg: Unused
+ *
+ *******************************************************************************/
+static void dns_cache_task(void *arg)
+{
+    (void)arg;
+
+    for(;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        dns_cache_lookup_pending();
+        dns_cache_refresh_pending();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_init
+ *******************************************************************************
+ * Summary:
+ *  Creates the cache lock and the DNS cache task.
+ *
+ *******************************************************************************/
+void dns_cache_init(void)
+{
+    dns_cache_mutex = xSemaphoreCreateMutex();
+    if((dns_cache_mutex == NULL) ||
+       (pdPASS != xTaskCreate(dns_cache_task, "DNS cache task", DNS_CACHE_TASK_STACK_SIZE,
+                              NULL, DNS_CACHE_TASK_PRIORITY, &dns_cache_task_handle)))
+    {
+        printf("Failed to create the DNS cache task!\n");
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_time_us
+ *******************************************************************************
+ * Summary:
+ *  Returns a monotonic timestamp in microseconds.
+ *
+ *******************************************************************************/
+static uint64_t dns_cache_time_us(void)
+{
+    return app_time_us();
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_lock
+ *******************************************************************************
+ * Summary:
+ *  Takes the lock protecting the cache entries and the statistics.
+ *
+ *******************************************************************************/
+static void dns_cache_lock(void)
+{
+    xSemaphoreTake(dns_cache_mutex, portMAX_DELAY);
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_unlock
+ *******************************************************************************
+ * Summary:
+ *  Releases the lock taken by dns_cache_lock().
+ *
+ *******************************************************************************/
+static void dns_cache_unlock(void)
+{
+    xSemaphoreGive(dns_cache_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_wake_refresh
+ *******************************************************************************
+ * Summary:
+ *  Wakes the DNS cache task up.
+ *
+ *******************************************************************************/
+static void dns_cache_wake_refresh(void)
+{
+    xTaskNotifyGive(dns_cache_task_handle);
+}
+
+/*******************************************************************************
+ * Function Name: dns_cache_exchange
+ *******************************************************************************
+ * Summary:
+ *  Sends a query to the DNS server over a UDP secure socket and waits for the
+ *  response with the same identifier.
+ *
+ * Parameters:
+ *  const uint8_t *query: DNS query
+ *  uint32_t query_len: Length of the query
+ *  uint8_t *answer: Buffer for the response
+ *  uint32_t *answer_len: Size of the buffer; length of the response
+ *  uint16_t id: Identifier of the query
+ *
+ * Return:
+ *  bool: true if the response was received
+ *
+ *******************************************************************************/
+static bool dns_cache_exchange(const uint8_t *query, uint32_t query_len, uint8_t *answer,
+                               uint32_t *answer_len, uint16_t id)
+{
+    cy_socket_t handle;
+    cy_socket_sockaddr_t server = { .ip_address.version = CY_SOCKET_IP_VER_V4,
+                                    .port = DNS_CACHE_SERVER_PORT };
+    cy_socket_sockaddr_t peer;
+    uint32_t peer_len = sizeof(peer);
+    uint32_t timeout_ms = DNS_CACHE_QUERY_TIMEOUT_MS;
+    uint32_t bytes_sent = 0;
+    uint32_t bytes_received = 0;
+    bool received = false;
+    cy_rslt_t result;
+
+#if defined(DNS_CACHE_SERVER_IP)
+    server.ip_address.ip.v4 = DNS_CACHE_SERVER_IP;
+#else
+    const ip_addr_t *dns_server = dns_getserver(0);
+
+    if(ip_addr_isany(dns_server) || !IP_IS_V4(dns_server))
+    {
+        return false;
+    }
+    server.ip_address.ip.v4 = ip4_addr_get_u32(ip_2_ip4(dns_server));
+#endif /* DNS_CACHE_SERVER_IP */
+
+    result = cy_socket_create(CY_SOCKET_DOMAIN_AF_INET, CY_SOCKET_TYPE_DGRAM,
+                              CY_SOCKET_IPPROTO_UDP, &handle);
+    if(result != CY_RSLT_SUCCESS)
+    {
+        return false;
+    }
+
+    result = cy_socket_setsockopt(handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                                  &timeout_ms, sizeof(timeout_ms));
+    if(result == CY_RSLT_SUCCESS)
+    {
+        result = cy_socket_sendto(handle, query, query_len, CY_SOCKET_FLAGS_NONE,
+                                  &server, sizeof(server), &bytes_sent);
+    }
+
+    while((result == CY_RSLT_SUCCESS) && !received)
+    {
+        result = cy_socket_recvfrom(handle, answer, *answer_len, CY_SOCKET_FLAGS_NONE,
+                                    &peer, &peer_len, &bytes_received);
+        received = (result == CY_RSLT_SUCCESS) && (bytes_received >= 2u) &&
+                   (((answer[0] << 8) | answer[1]) == id);
+    }
+
+    if(received)
+    {
+        *answer_len = bytes_received;
+    }
+
+    cy_socket_delete(handle);
+    return received;
+}
+
+#endif /* DNS_CACHE_HOST */
+
+#endif /* ENABLE_DNS_CACHE */
+
+/* [] END OF FILE */
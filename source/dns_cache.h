@@ -0,0 +1,131 @@
+/******************************************************************************
+* File Name:   dns_cache.h
+*
+* Description: This file contains the macros, the data structures and the function
+* prototypes of the DNS resolver cache.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef DNS_CACHE_H_
+#define DNS_CACHE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set this macro to '0' to accept only IP addresses as the server address. */
+#define ENABLE_DNS_CACHE                      (1)
+
+/* Number of host names remembered and the longest host name accepted. */
+#define DNS_CACHE_ENTRIES                     (4u)
+#define DNS_CACHE_NAME_LEN                    (64u)
+
+/* The TTL of the answer is capped at DNS_CACHE_MAX_TTL_S. After the TTL, an
+ * entry is still served for DNS_CACHE_STALE_S while it is refreshed in the
+ * background, so that a reconnect does not wait for the DNS server.
+ */
+#define DNS_CACHE_MAX_TTL_S                   (24u * 60u * 60u)
+#define DNS_CACHE_STALE_S                     (60u * 60u)
+
+/* A host name without an address of the IP version (NXDOMAIN or no data) is
+ * remembered for the negative TTL of the answer (SOA minimum), up to
+ * DNS_CACHE_NEGATIVE_TTL_S, or for DNS_CACHE_NEGATIVE_TTL_S without an SOA
+ * record. A query the DNS server does not answer is remembered for
+ * DNS_CACHE_FAILURE_TTL_S. Negative entries are not served stale.
+ */
+#define DNS_CACHE_NEGATIVE_TTL_S              (5u * 60u)
+#define DNS_CACHE_FAILURE_TTL_S               (10u)
+
+/* A query is sent up to DNS_CACHE_QUERY_ATTEMPTS times, each time waiting
+ * DNS_CACHE_QUERY_TIMEOUT_MS for the answer.
+ */
+#define DNS_CACHE_QUERY_ATTEMPTS              (2u)
+#define DNS_CACHE_QUERY_TIMEOUT_MS            (2000u)
+
+/* UDP port of the DNS server. The server itself is the one provided by DHCP,
+ * unless DNS_CACHE_SERVER_IP is defined (IPv4 address in network byte order).
+ */
+#define DNS_CACHE_SERVER_PORT                 (53u)
+
+/* RTOS related macros for the DNS cache task, which runs the lookups of
+ * dns_cache_lookup() and the background refresh.
+ */
+#define DNS_CACHE_TASK_STACK_SIZE             (1024u)
+#define DNS_CACHE_TASK_PRIORITY               (1u)
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+typedef enum
+{
+    DNS_CACHE_HIT,          /* Answered from the cache. */
+    DNS_CACHE_STALE,        /* Answered from an expired entry being refreshed. */
+    DNS_CACHE_RESOLVED,     /* Answered by the DNS server. */
+    DNS_CACHE_FAILED,       /* No answer. */
+    DNS_CACHE_PENDING,      /* Sent to the DNS cache task; see dns_cache_lookup(). */
+    DNS_CACHE_NEGATIVE      /* No address, answered from the cache. */
+} dns_cache_status_t;
+
+/* Called by the DNS cache task when a lookup started by dns_cache_lookup()
+ * completes.
+ */
+typedef void (*dns_cache_callback_t)(void);
+
+typedef struct
+{
+    uint8_t version;        /* 4 or 6. */
+    uint8_t bytes[16];      /* Network byte order. */
+} dns_cache_addr_t;
+
+typedef struct
+{
+    uint32_t hits;
+    uint32_t stale_hits;
+    uint32_t negative_hits;
+    uint32_t misses;
+    uint32_t failures;
+    uint32_t refreshes;
+    uint32_t last_resolve_us;
+} dns_cache_stats_t;
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void dns_cache_init(void);
+dns_cache_status_t dns_cache_lookup(const char *hostname, uint8_t version, dns_cache_addr_t *addr,
+                                    dns_cache_callback_t callback);
+void dns_cache_get_stats(dns_cache_stats_t *stats);
+
+#endif /* DNS_CACHE_H_ */
@@ -0,0 +1,811 @@
+/******************************************************************************
+* File Name:   dtls_command.c
+*
+* Description: This file contains the DTLS transport for the LED commands.
+*
+* A task of its own keeps a DTLS 1.2 session to the UDP port of the TCP
+* server, with the TLS identity and the root CA of the TLS connection. Each
+* command is a datagram with a sequence number; the server retransmits it
+* until the reply arrives, and a retransmitted command is answered with the
+* reply already sent instead of being executed again. The task sends
+* heartbeats while the server is silent and opens a new session when they
+* are not answered.
+*
+* Built with DTLS_COMMAND_HOST defined, the file is a host program that
+* answers the commands of tcp_secure_server.py --dtls with a simulated LED.
+* With -t it answers them over TLS/TCP instead, so that both transports can
+* be compared under the same loss with tools/lossy_relay.py.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#if defined(DTLS_COMMAND_HOST)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <openssl/ssl.h>
+#else
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* IP address related header files. */
+#include "ip_addr.h"
+
+/* Secure TCP client and command handler header files. */
+#include "secure_tcp_client.h"
+#include "command_handler.h"
+#include "app_params.h"
+
+/* Logging, timestamp, command trace and runtime metrics header files. */
+#include "app_log.h"
+#include "app_time.h"
+#include "cmd_trace.h"
+#include "metrics.h"
+#endif /* DTLS_COMMAND_HOST */
+
+/* Protocol and DTLS transport header files. */
+#include "app_protocol.h"
+#include "dtls_command.h"
+
+#if(ENABLE_DTLS_COMMANDS) || defined(DTLS_COMMAND_HOST)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Notification bits of the DTLS command task. */
+#define DTLS_COMMAND_SERVER_BIT               (1u << 0)
+
+#if defined(DTLS_COMMAND_HOST)
+    #define APP_LOG_INFO(...)                 printf(__VA_ARGS__)
+    #define APP_LOG_WARN(...)                 printf(__VA_ARGS__)
+    #define METRICS_RECORD_SENT(bytes)
+    #define METRICS_RECORD_RECEIVED(bytes)
+    #define CMD_TRACE_BEGIN()                 (0u)
+
+    /* Returned by the socket functions once the session is closed. */
+    #define DTLS_COMMAND_HOST_CLOSED          ((cy_rslt_t)0x01000001u)
+
+    #define DTLS_COMMAND_HOST_LED_ON_ACK      "LED ON ACK"
+    #define DTLS_COMMAND_HOST_LED_OFF_ACK     "LED OFF ACK"
+#endif /* DTLS_COMMAND_HOST */
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void dtls_command_serve(void);
+static cy_rslt_t dtls_command_process(const uint8_t *datagram, uint32_t length, uint32_t rx_cycles);
+static cy_rslt_t dtls_command_send(const uint8_t *datagram, uint32_t length);
+
+#if !defined(DTLS_COMMAND_HOST)
+    static void dtls_command_task(void *arg);
+    static cy_rslt_t dtls_command_connect(void);
+    static void dtls_command_close(void);
+#endif /* DTLS_COMMAND_HOST */
+
+/* Platform specific functions. */
+static uint32_t dtls_command_cycles(void);
+static uint32_t dtls_command_cycles_to_us(uint32_t cycles);
+static uint8_t dtls_command_execute(uint8_t command, uint32_t trace_id);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Session to the server, owned by the DTLS command task. */
+static cy_socket_t dtls_command_handle;
+static uint32_t dtls_command_heartbeat_seq;
+
+/* Reply to the last command executed, sent again for its retransmissions. */
+static bool dtls_command_has_last;
+static uint32_t dtls_command_last_seq;
+static uint8_t dtls_command_last_reply[DTLS_COMMAND_REPLY_LEN];
+
+#if !defined(DTLS_COMMAND_HOST)
+    static TaskHandle_t dtls_command_task_handle;
+
+    /* Address of the server, set from the network task and taken over by the
+     * DTLS command task.
+     */
+    static cy_socket_sockaddr_t dtls_command_pending;
+
+    static cy_socket_sockaddr_t dtls_command_server;
+    static bool dtls_command_has_server;
+    static uint32_t dtls_command_backoff_ms;
+
+    /* TLS identity of the TCP client, created by the network task. */
+    extern void *tls_identity;
+#else
+    static bool dtls_command_host_led;
+#endif /* DTLS_COMMAND_HOST */
+
+/*******************************************************************************
+ * Function Name: dtls_command_serve
+ *******************************************************************************
+ * Summary:
+ *  Receives and answers the datagrams of an open session. Returns when the
+ *  session fails or the server stopped answering the heartbeats.
+ *
+ *******************************************************************************/
+static void dtls_command_serve(void)
+{
+    uint8_t datagram[DTLS_COMMAND_DATAGRAM_SIZE];
+    uint8_t heartbeat[HEARTBEAT_LEN];
+    uint32_t bytes_received = 0;
+    uint32_t rx_cycles;
+    uint32_t misses = 0u;
+    cy_rslt_t result;
+
+    dtls_command_has_last = false;
+
+    for(;;)
+    {
+        result = cy_socket_recv(dtls_command_handle, datagram, sizeof(datagram),
+                                CY_SOCKET_FLAGS_NONE, &bytes_received);
+        rx_cycles = dtls_command_cycles();
+
+        if(result == CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT)
+        {
+            if(misses >= DTLS_COMMAND_HEARTBEAT_MISSES)
+            {
+                APP_LOG_WARN("DTLS session: %"PRIu32" heartbeats not answered\n", misses);
+                return;
+            }
+            misses++;
+
+            heartbeat[0] = HEARTBEAT_MSG;
+            app_protocol_put_u32(&heartbeat[1], ++dtls_command_heartbeat_seq);
+            result = dtls_command_send(heartbeat, sizeof(heartbeat));
+        }
+        else if(result == CY_RSLT_SUCCESS)
+        {
+            misses = 0u;
+            METRICS_RECORD_RECEIVED(bytes_received);
+            result = dtls_command_process(datagram, bytes_received, rx_cycles);
+        }
+
+        if(result != CY_RSLT_SUCCESS)
+        {
+            APP_LOG_WARN("DTLS session failed! Error code: 0x%08"PRIx32"\n", (uint32_t)result);
+            return;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_process
+ *******************************************************************************
+ * Summary:
+ *  Handles a datagram of the server. A command with a new sequence number is
+ *  executed and answered; the last command again is answered with the same
+ *  reply; an older one is dropped, as its reply is no longer awaited.
+ *
+ * Parameters:
+ *  const uint8_t *datagram: Received datagram
+ *  uint32_t length: Length of the datagram
+ *  uint32_t rx_cycles: Cycle counter value when the datagram was received
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t dtls_command_process(const uint8_t *datagram, uint32_t length, uint32_t rx_cycles)
+{
+    uint8_t *reply = dtls_command_last_reply;
+    uint32_t seq;
+    uint32_t trace_id;
+
+    if((length == HEARTBEAT_LEN) && (datagram[0] == HEARTBEAT_REPLY_CMD))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    if((length != DTLS_COMMAND_LEN) || (datagram[0] != DTLS_COMMAND_MSG))
+    {
+        APP_LOG_WARN("Unexpected datagram of %"PRIu32" bytes dropped\n", length);
+        return CY_RSLT_SUCCESS;
+    }
+
+    seq = app_protocol_get_u32(&datagram[1]);
+    if(dtls_command_has_last && (seq == dtls_command_last_seq))
+    {
+        return dtls_command_send(reply, DTLS_COMMAND_REPLY_LEN);
+    }
+    if(dtls_command_has_last && ((int32_t)(seq - dtls_command_last_seq) < 0))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    trace_id = CMD_TRACE_BEGIN();
+
+    /* Sequence number and server timestamp are echoed unchanged. */
+    reply[0] = DTLS_COMMAND_REPLY_MSG;
+    memcpy(&reply[1], &datagram[1], 12u);
+    reply[13] = dtls_command_execute(datagram[13], trace_id);
+    app_protocol_put_u32(&reply[14], dtls_command_cycles_to_us(dtls_command_cycles() - rx_cycles));
+
+    dtls_command_has_last = true;
+    dtls_command_last_seq = seq;
+
+    return dtls_command_send(reply, DTLS_COMMAND_REPLY_LEN);
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_send
+ *******************************************************************************
+ * Summary:
+ *  Sends a datagram over the session.
+ *
+ * Parameters:
+ *  const uint8_t *datagram: Datagram to send
+ *  uint32_t length: Length of the datagram
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t dtls_command_send(const uint8_t *datagram, uint32_t length)
+{
+    uint32_t bytes_sent = 0;
+    cy_rslt_t result;
+
+    result = cy_socket_send(dtls_command_handle, datagram, length, CY_SOCKET_FLAGS_NONE, &bytes_sent);
+    if(result == CY_RSLT_SUCCESS)
+    {
+        METRICS_RECORD_SENT(bytes_sent);
+    }
+
+    return result;
+}
+
+#if defined(DTLS_COMMAND_HOST)
+
+/* OpenSSL objects of the host session. */
+static SSL_CTX *dtls_command_host_context;
+static int dtls_command_host_fd;
+
+/*******************************************************************************
+ * Function Name: dtls_command_cycles
+ *******************************************************************************
+ * Summary:
+ *  Returns a monotonic timestamp in microseconds, used as the cycle counter.
+ *
+ *******************************************************************************/
+static uint32_t dtls_command_cycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000u) + ((uint64_t)ts.tv_nsec / 1000u));
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_cycles_to_us
+ *******************************************************************************
+ * Summary:
+ *  The host cycle counter counts microseconds.
+ *
+ *******************************************************************************/
+static uint32_t dtls_command_cycles_to_us(uint32_t cycles)
+{
+    return cycles;
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_execute
+ *******************************************************************************
+ * Summary:
+ *  Executes an LED command on the simulated LED of the host.
+ *
+ *******************************************************************************/
+static uint8_t dtls_command_execute(uint8_t command, uint32_t trace_id)
+{
+    (void)trace_id;
+
+    if((command != LED_ON_CMD) && (command != LED_OFF_CMD))
+    {
+        return ACK_STATUS_INVALID_CMD | (dtls_command_host_led ? ACK_STATUS_LED_ON : 0u);
+    }
+    dtls_command_host_led = (command == LED_ON_CMD);
+
+    return dtls_command_host_led ? ACK_STATUS_LED_ON : 0u;
+}
+
+/*******************************************************************************
+ * Function Name: cy_socket_recv
+ *******************************************************************************
+ * Summary:
+ *  Host version of the secure sockets receive function, on an OpenSSL
+ *  connection. A datagram is received whole.
+ *
+ *******************************************************************************/
+cy_rslt_t cy_socket_recv(cy_socket_t handle, void *buffer, uint32_t length, int flags,
+                         uint32_t *bytes_received)
+{
+    SSL *ssl = (SSL *)handle;
+    int received;
+
+    (void)flags;
+
+    *bytes_received = 0u;
+    received = SSL_read(ssl, buffer, (int)length);
+    if(received > 0)
+    {
+        *bytes_received = (uint32_t)received;
+        return CY_RSLT_SUCCESS;
+    }
+    if((SSL_get_error(ssl, received) == SSL_ERROR_WANT_READ) ||
+       ((SSL_get_error(ssl, received) == SSL_ERROR_SYSCALL) &&
+        BIO_dgram_recv_timedout(SSL_get_rbio(ssl))))
+    {
+        return CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT;
+    }
+
+    return DTLS_COMMAND_HOST_CLOSED;
+}
+
+/*******************************************************************************
+ * Function Name: cy_socket_send
+ *******************************************************************************
+ * Summary:
+ *  Host version of the secure sockets send function, on an OpenSSL
+ *  connection.
+ *
+ *******************************************************************************/
+cy_rslt_t cy_socket_send(cy_socket_t handle, const void *buffer, uint32_t length, int flags,
+                         uint32_t *bytes_sent)
+{
+    int sent;
+
+    (void)flags;
+
+    sent = SSL_write((SSL *)handle, buffer, (int)length);
+    *bytes_sent = (sent > 0) ? (uint32_t)sent : 0u;
+
+    return (sent == (int)length) ? CY_RSLT_SUCCESS : DTLS_COMMAND_HOST_CLOSED;
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_host_connect
+ *******************************************************************************
+ * Summary:
+ *  Opens the DTLS session, or with stream set the TLS connection, to the
+ *  server.
+ *
+ *******************************************************************************/
+static SSL *dtls_command_host_connect(const char *host, const char *port, bool stream)
+{
+    struct addrinfo hints = { .ai_family = AF_UNSPEC,
+                              .ai_socktype = stream ? SOCK_STREAM : SOCK_DGRAM };
+    struct addrinfo *addresses;
+    struct timeval timeout = { .tv_sec = DTLS_COMMAND_HEARTBEAT_MS / 1000u,
+                               .tv_usec = (DTLS_COMMAND_HEARTBEAT_MS % 1000u) * 1000u };
+    BIO *bio;
+    SSL *ssl;
+
+    if(getaddrinfo(host, port, &hints, &addresses) != 0)
+    {
+        return NULL;
+    }
+    dtls_command_host_fd = socket(addresses->ai_family, addresses->ai_socktype,
+                                  addresses->ai_protocol);
+    if((dtls_command_host_fd < 0) ||
+       (connect(dtls_command_host_fd, addresses->ai_addr, addresses->ai_addrlen) != 0))
+    {
+        freeaddrinfo(addresses);
+        if(dtls_command_host_fd >= 0)
+        {
+            close(dtls_command_host_fd);
+        }
+        return NULL;
+    }
+
+    ssl = SSL_new(dtls_command_host_context);
+    if(stream)
+    {
+        SSL_set_fd(ssl, dtls_command_host_fd);
+    }
+    else
+    {
+        bio = BIO_new_dgram(dtls_command_host_fd, BIO_NOCLOSE);
+        BIO_ctrl(bio, BIO_CTRL_DGRAM_SET_CONNECTED, 0, addresses->ai_addr);
+        SSL_set_bio(ssl, bio, bio);
+    }
+    freeaddrinfo(addresses);
+
+    if(SSL_connect(ssl) != 1)
+    {
+        SSL_free(ssl);
+        close(dtls_command_host_fd);
+        return NULL;
+    }
+
+    if(!stream)
+    {
+        BIO_ctrl(SSL_get_rbio(ssl), BIO_CTRL_DGRAM_SET_RECV_TIMEOUT, 0, &timeout);
+    }
+
+    return ssl;
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_host_serve_stream
+ *******************************************************************************
+ * Summary:
+ *  Answers the LED commands of the server over TLS/TCP, as the TCP client
+ *  does with the ASCII acknowledgements.
+ *
+ *******************************************************************************/
+static void dtls_command_host_serve_stream(void)
+{
+    uint8_t opcode;
+    uint8_t skipped[HEARTBEAT_LEN - 1u];
+    uint32_t bytes;
+    const char *ack;
+
+    while(cy_socket_recv(dtls_command_handle, &opcode, 1u, CY_SOCKET_FLAGS_NONE,
+                         &bytes) == CY_RSLT_SUCCESS)
+    {
+        if(opcode == HEARTBEAT_REPLY_CMD)
+        {
+            cy_socket_recv(dtls_command_handle, skipped, sizeof(skipped), CY_SOCKET_FLAGS_NONE, &bytes);
+            continue;
+        }
+
+        ack = (dtls_command_execute(opcode, 0u) & ACK_STATUS_INVALID_CMD) ? MSG_INVALID_CMD :
+              (opcode == LED_ON_CMD) ? DTLS_COMMAND_HOST_LED_ON_ACK : DTLS_COMMAND_HOST_LED_OFF_ACK;
+        if(cy_socket_send(dtls_command_handle, ack, (uint32_t)strlen(ack), CY_SOCKET_FLAGS_NONE,
+                          &bytes) != CY_RSLT_SUCCESS)
+        {
+            return;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *  Host program: answers the LED commands of the server over DTLS, or over
+ *  TLS/TCP with -t, and opens a new session whenever one is lost.
+ *
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *root_ca = "python-secure-tcp-server/root_ca.crt";
+    const char *port = "50007";
+    bool stream = false;
+    SSL *ssl;
+    int option;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    while((option = getopt(argc, argv, "c:t")) != -1)
+    {
+        switch(option)
+        {
+            case 'c': root_ca = optarg; break;
+            case 't': stream = true; break;
+            default:
+                fprintf(stderr, "Usage: %s [-c root_ca] [-t] host [port]\n", argv[0]);
+                return 1;
+        }
+    }
+    if((argc - optind) < 1)
+    {
+        fprintf(stderr, "Missing server host\n");
+        return 1;
+    }
+    if((argc - optind) > 1)
+    {
+        port = argv[optind + 1];
+    }
+
+    dtls_command_host_context = SSL_CTX_new(stream ? TLS_client_method() : DTLS_client_method());
+    if(SSL_CTX_load_verify_locations(dtls_command_host_context, root_ca, NULL) != 1)
+    {
+        fprintf(stderr, "Cannot load the root CA certificate %s\n", root_ca);
+        return 1;
+    }
+    SSL_CTX_set_verify(dtls_command_host_context, SSL_VERIFY_PEER, NULL);
+
+    for(;;)
+    {
+        ssl = dtls_command_host_connect(argv[optind], port, stream);
+        if(ssl == NULL)
+        {
+            printf("Cannot connect to %s:%s, retrying\n", argv[optind], port);
+            sleep(1);
+            continue;
+        }
+        printf("Connected to %s:%s (%s)\n", argv[optind], port, SSL_get_version(ssl));
+
+        dtls_command_handle = ssl;
+        if(stream)
+        {
+            dtls_command_host_serve_stream();
+        }
+        else
+        {
+            dtls_command_serve();
+        }
+
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+        close(dtls_command_host_fd);
+        printf("Session closed\n");
+    }
+
+    return 0;
+}
+
+#else
+
+/*******************************************************************************
+ * Function Name: dtls_command_init
+ *******************************************************************************
+ * Summary:
+ *  Starts the DTLS command task. The session is opened once the address of
+ *  the server is known.
+ *
+ *******************************************************************************/
+void dtls_command_init(void)
+{
+    if(pdPASS != xTaskCreate(dtls_command_task, "DTLS command task",
+                             DTLS_COMMAND_TASK_STACK_SIZE, NULL,
+                             DTLS_COMMAND_TASK_PRIORITY, &dtls_command_task_handle))
+    {
+        printf("Failed to create the DTLS command task!\n");
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_set_server
+ *******************************************************************************
+ * Summary:
+ *  Sets the address of the server, called when the TLS connection is
+ *  established. An open session is kept, so that it is not affected by a
+ *  reconnect of the TLS connection; the address is used the next time the
+ *  session is opened.
+ *
+ * Parameters:
+ *  const cy_socket_ip_address_t *address: Address of the TCP server
+ *
+ *******************************************************************************/
+void dtls_command_set_server(const cy_socket_ip_address_t *address)
+{
+    taskENTER_CRITICAL();
+    dtls_command_pending.ip_address = *address;
+    dtls_command_pending.port = DTLS_COMMAND_SERVER_PORT;
+    taskEXIT_CRITICAL();
+
+    xTaskNotify(dtls_command_task_handle, DTLS_COMMAND_SERVER_BIT, eSetBits);
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_task
+ *******************************************************************************
+ * Summary:
+ *  Opens the DTLS session and serves it, and opens it again with a growing
+ *  delay after a failed handshake or a dead session.
+ *
+ * Parameters:
+ *  void *arg: Unused
+ *
+ *******************************************************************************/
+static void dtls_command_task(void *arg)
+{
+    uint32_t notification;
+    TickType_t wait_ticks;
+
+    (void)arg;
+
+    for(;;)
+    {
+        /* An attempt is due when the wait times out. */
+        wait_ticks = dtls_command_has_server ? pdMS_TO_TICKS(dtls_command_backoff_ms) : portMAX_DELAY;
+
+        notification = 0u;
+        xTaskNotifyWait(0u, UINT32_MAX, &notification, wait_ticks);
+
+        if(notification & DTLS_COMMAND_SERVER_BIT)
+        {
+            taskENTER_CRITICAL();
+            dtls_command_server = dtls_command_pending;
+            taskEXIT_CRITICAL();
+
+            dtls_command_has_server = true;
+            dtls_command_backoff_ms = 0u;
+        }
+
+        if(!dtls_command_has_server)
+        {
+            continue;
+        }
+
+        if(dtls_command_connect() == CY_RSLT_SUCCESS)
+        {
+            dtls_command_serve();
+            dtls_command_close();
+            dtls_command_backoff_ms = DTLS_COMMAND_BACKOFF_MS;
+        }
+        else
+        {
+            dtls_command_backoff_ms = (dtls_command_backoff_ms < DTLS_COMMAND_BACKOFF_MS) ?
+                                      DTLS_COMMAND_BACKOFF_MS : (dtls_command_backoff_ms * 2u);
+            if(dtls_command_backoff_ms > DTLS_COMMAND_BACKOFF_MAX_MS)
+            {
+                dtls_command_backoff_ms = DTLS_COMMAND_BACKOFF_MAX_MS;
+            }
+        }
+        APP_LOG_INFO("Opening the DTLS session in %"PRIu32" ms\n", dtls_command_backoff_ms);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_connect
+ *******************************************************************************
+ * Summary:
+ *  Opens the DTLS session to the server with the TLS identity of the TCP
+ *  client, and prints the handshake time.
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t dtls_command_connect(void)
+{
+    cy_socket_tls_auth_mode_t tls_auth_mode = CY_SOCKET_TLS_VERIFY_REQUIRED;
+    uint32_t receive_timeout_ms = APP_PARAM(APP_PARAM_TLS_HANDSHAKE_TIMEOUT_MS, TLS_HANDSHAKE_TIMEOUT_MS);
+    uint64_t begin_us = app_time_us();
+    cy_rslt_t result;
+
+    result = cy_socket_create((dtls_command_server.ip_address.version == CY_SOCKET_IP_VER_V6) ?
+                              CY_SOCKET_DOMAIN_AF_INET6 : CY_SOCKET_DOMAIN_AF_INET,
+                              CY_SOCKET_TYPE_DGRAM, CY_SOCKET_IPPROTO_DTLS, &dtls_command_handle);
+    if(result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_ERR("Failed to create the DTLS socket! Error Code: %"PRIu32"\n", result);
+        return result;
+    }
+
+    result = cy_socket_setsockopt(dtls_command_handle, CY_SOCKET_SOL_TLS, CY_SOCKET_SO_TLS_IDENTITY,
+                                  tls_identity, sizeof((uint32_t)tls_identity));
+    if(result == CY_RSLT_SUCCESS)
+    {
+        result = cy_socket_setsockopt(dtls_command_handle, CY_SOCKET_SOL_TLS,
+                                      CY_SOCKET_SO_TLS_AUTH_MODE,
+                                      &tls_auth_mode, sizeof(cy_socket_tls_auth_mode_t));
+    }
+
+    if(result == CY_RSLT_SUCCESS)
+    {
+        /* Bound each read of the DTLS handshake. */
+        cy_socket_setsockopt(dtls_command_handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                             &receive_timeout_ms, sizeof(receive_timeout_ms));
+
+        result = cy_socket_connect(dtls_command_handle, &dtls_command_server,
+                                   sizeof(cy_socket_sockaddr_t));
+    }
+
+    if(result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_WARN("DTLS handshake failed! Error code: 0x%08"PRIx32"\n", (uint32_t)result);
+        cy_socket_delete(dtls_command_handle);
+        return result;
+    }
+
+    /* The receive timeout paces the heartbeats. */
+    receive_timeout_ms = DTLS_COMMAND_HEARTBEAT_MS;
+    cy_socket_setsockopt(dtls_command_handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                         &receive_timeout_ms, sizeof(receive_timeout_ms));
+
+    printf("DTLS session to the TCP server opened in %"PRIu32" us\n",
+           (uint32_t)(app_time_us() - begin_us));
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_close
+ *******************************************************************************
+ * Summary:
+ *  Closes the DTLS session.
+ *
+ *******************************************************************************/
+static void dtls_command_close(void)
+{
+    cy_socket_disconnect(dtls_command_handle, 0);
+    cy_socket_delete(dtls_command_handle);
+
+    APP_LOG_INFO("DTLS session closed\n");
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_cycles
+ *******************************************************************************
+ * Summary:
+ *  Returns the cycle counter used for the device processing time.
+ *
+ *******************************************************************************/
+static uint32_t dtls_command_cycles(void)
+{
+    return app_time_cycles();
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_cycles_to_us
+ *******************************************************************************
+ * Summary:
+ *  Converts a number of cycles to microseconds.
+ *
+ *******************************************************************************/
+static uint32_t dtls_command_cycles_to_us(uint32_t cycles)
+{
+    return app_time_cycles_to_us(cycles);
+}
+
+/*******************************************************************************
+ * Function Name: dtls_command_execute
+ *******************************************************************************
+ * Summary:
+ *  Executes an LED command with the command handler of the TLS connection.
+ *
+ *******************************************************************************/
+static uint8_t dtls_command_execute(uint8_t command, uint32_t trace_id)
+{
+    return command_handler_execute(command, trace_id);
+}
+
+#endif /* DTLS_COMMAND_HOST */
+
+#endif /* ENABLE_DTLS_COMMANDS */
+
+/* [] END OF FILE */
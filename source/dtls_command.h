@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name:   dtls_command.h
+*
+* Description: This file contains the macros and the function prototypes of the
+* DTLS transport for the LED commands.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef DTLS_COMMAND_H_
+#define DTLS_COMMAND_H_
+
+#include <stdint.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set this macro to '1' to also accept the LED commands over DTLS 1.2 on UDP,
+ * next to the TLS connection. Each command is a datagram, so a lost packet
+ * delays only that command, by the retransmission timeout of the server, and
+ * not the commands behind it.
+ */
+#ifndef ENABLE_DTLS_COMMANDS
+#define ENABLE_DTLS_COMMANDS                  (0)
+#endif
+
+#if(ENABLE_DTLS_COMMANDS) && !defined(DTLS_COMMAND_HOST)
+    #include "mbedtls/build_info.h"
+
+    #if !defined(MBEDTLS_SSL_PROTO_DTLS)
+        #error "ENABLE_DTLS_COMMANDS requires MBEDTLS_SSL_PROTO_DTLS in the Mbed TLS configuration"
+    #endif
+#endif
+
+/* UDP port of the DTLS transport on the TCP server. */
+#define DTLS_COMMAND_SERVER_PORT              (50007)
+
+/* Largest datagram received over the DTLS transport. */
+#define DTLS_COMMAND_DATAGRAM_SIZE            (64u)
+
+/* A heartbeat is sent when no datagram was received for
+ * DTLS_COMMAND_HEARTBEAT_MS. The session is closed and opened again after
+ * DTLS_COMMAND_HEARTBEAT_MISSES heartbeats without a datagram in between.
+ */
+#define DTLS_COMMAND_HEARTBEAT_MS             (2000u)
+#define DTLS_COMMAND_HEARTBEAT_MISSES         (3u)
+
+/* Delay before opening the session again after a failed handshake or a dead
+ * session, in milliseconds. The delay doubles with every failure up to
+ * DTLS_COMMAND_BACKOFF_MAX_MS.
+ */
+#define DTLS_COMMAND_BACKOFF_MS               (500u)
+#define DTLS_COMMAND_BACKOFF_MAX_MS           (8000u)
+
+/* RTOS related macros for the DTLS command task. The DTLS handshake runs in
+ * this task, so it needs the stack size of the network task. The priority is
+ * above the one of the network task, so that commands are not held up by a
+ * reconnect of the TLS connection.
+ */
+#define DTLS_COMMAND_TASK_STACK_SIZE          (5 * 1024)
+#define DTLS_COMMAND_TASK_PRIORITY            (2)
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void dtls_command_init(void);
+void dtls_command_set_server(const cy_socket_ip_address_t *address);
+
+#endif /* DTLS_COMMAND_H_ */
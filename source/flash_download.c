@@ -0,0 +1,1521 @@
+/******************************************************************************
+* File Name:   flash_download.c
+*
+* Description: This file contains the bulk download of blobs (configuration
+* bundles, firmware images) from the TCP server into the QSPI serial flash.
+*
+* The download is pipelined over two buffers: the socket worker receives the
+* blocks of the blob into one buffer while the flash writer task erases and
+* programs the other one and adds it to the SHA-256 of the blob. Sectors are
+* erased as the writes reach them, and every write but the last one starts on
+* a buffer boundary. The receiving waits only when both buffers are full; the
+* time it waited is reported with the throughput once the blob is complete.
+* The wait is bounded by FLASH_DOWNLOAD_WAIT_MS: past it, the download is
+* paused and the server resumes it once the flash writer caught up. The
+* offset, the erased range and the hash of the bytes written are kept across
+* a pause or a disconnect, so that the server resumes the blob after the last
+* buffer written.
+*
+* Built with FLASH_DOWNLOAD_HOST defined, the file is a host program that
+* downloads a blob over TLS from tcp_secure_server.py into a file that
+* emulates the serial flash, with the erase and program times of a real part.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#if defined(FLASH_DOWNLOAD_HOST)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <openssl/ssl.h>
+#include <openssl/evp.h>
+#else
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* Serial flash and mbedTLS SHA-256 header files. */
+#include "cy_serial_flash_qspi.h"
+#include "mbedtls/sha256.h"
+
+/* Logging, timestamp and runtime metrics header files. */
+#include "app_log.h"
+#include "app_time.h"
+#include "metrics.h"
+#endif /* FLASH_DOWNLOAD_HOST */
+
+/* Protocol and bulk download header files. */
+#include "app_protocol.h"
+#include "flash_download.h"
+
+#if(ENABLE_FLASH_DOWNLOAD)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define FLASH_DOWNLOAD_BUFFER_COUNT        (2u)
+
+/* Size of the buffer used to skip the data of unexpected blocks. */
+#define FLASH_DOWNLOAD_SKIP_CHUNK          (64u)
+
+/* Timeout of flash_download_queue_receive() for the flash writer. */
+#define FLASH_DOWNLOAD_WAIT_FOREVER        (0xFFFFFFFFu)
+
+#if defined(MBEDTLS_SSL_IN_CONTENT_LEN) && \
+    ((DOWNLOAD_BLOCK_HEADER_LEN + DOWNLOAD_BLOCK_MAX_LEN) > MBEDTLS_SSL_IN_CONTENT_LEN)
+    #error "A download block must fit one TLS record of MBEDTLS_SSL_IN_CONTENT_LEN bytes"
+#endif
+
+#if defined(FLASH_DOWNLOAD_HOST)
+    #define APP_LOG_INFO(...)              printf(__VA_ARGS__)
+    #define APP_LOG_WARN(...)              printf(__VA_ARGS__)
+    #define APP_LOG_ERR(...)               printf(__VA_ARGS__)
+    #define METRICS_COUNTER_ADD(id, value)
+    #define METRICS_RECORD_SENT(bytes)
+
+    /* Returned by the socket functions once the connection is closed. */
+    #define FLASH_DOWNLOAD_HOST_CLOSED     ((cy_rslt_t)0x01000001u)
+
+    #define US_PER_S                       (1000000ull)
+#endif /* FLASH_DOWNLOAD_HOST */
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+/* A part of the blob, at the given offset from its start. */
+typedef struct
+{
+    uint8_t data[FLASH_DOWNLOAD_BUFFER_SIZE];
+    uint32_t offset;
+    uint32_t length;
+} flash_download_buffer_t;
+
+/* Queue of buffers handed between the receiver and the flash writer. */
+#if defined(FLASH_DOWNLOAD_HOST)
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    flash_download_buffer_t *items[FLASH_DOWNLOAD_BUFFER_COUNT];
+    uint32_t head;
+    uint32_t count;
+} flash_download_queue_t;
+#else
+typedef QueueHandle_t flash_download_queue_t;
+#endif /* FLASH_DOWNLOAD_HOST */
+
+/* State of the receiving side, owned by the socket worker. */
+typedef struct
+{
+    bool active;
+    bool paused;            /* Blocks are skipped until the next 'D'. */
+    uint32_t blob_id;
+    uint32_t size;
+    uint32_t start_offset;
+    uint32_t received;
+    flash_download_buffer_t *filling;
+    uint64_t begin_us;
+    uint64_t stall_us;
+} flash_download_receiver_t;
+
+/* State of the flash writer. The receiver reads it only when no buffer is
+ * being written.
+ */
+typedef struct
+{
+    volatile bool failed;
+    uint32_t written;
+    uint32_t erased;
+    uint64_t erase_us;
+    uint64_t program_us;
+#if defined(FLASH_DOWNLOAD_HOST)
+    EVP_MD_CTX *hash;
+#else
+    mbedtls_sha256_context hash;
+#endif /* FLASH_DOWNLOAD_HOST */
+} flash_download_writer_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void flash_download_write(flash_download_buffer_t *buffer);
+static flash_download_buffer_t *flash_download_take_buffer(void);
+static bool flash_download_drain(void);
+static cy_rslt_t flash_download_finish(cy_socket_t socket_handle);
+static cy_rslt_t flash_download_pause(cy_socket_t socket_handle);
+static cy_rslt_t flash_download_send_status(cy_socket_t socket_handle, uint8_t status,
+                                            uint32_t offset, const uint8_t *digest);
+static cy_rslt_t flash_download_recv(cy_socket_t socket_handle, uint8_t *buffer, uint32_t length);
+static cy_rslt_t flash_download_skip(cy_socket_t socket_handle, uint32_t length);
+
+/* Platform specific functions. */
+static uint64_t flash_download_time_us(void);
+static void flash_download_queue_init(flash_download_queue_t *queue);
+static void flash_download_queue_send(flash_download_queue_t *queue, flash_download_buffer_t *buffer);
+static flash_download_buffer_t *flash_download_queue_receive(flash_download_queue_t *queue,
+                                                              uint32_t timeout_ms);
+static void flash_download_start_writer(void);
+static void flash_download_flash_init(void);
+static uint32_t flash_download_erase_size(uint32_t address);
+static bool flash_download_erase(uint32_t address, uint32_t length);
+static bool flash_download_program(uint32_t address, const uint8_t *data, uint32_t length);
+static void flash_download_hash_start(void);
+static void flash_download_hash_update(const uint8_t *data, uint32_t length);
+static void flash_download_hash_finish(uint8_t *digest);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static flash_download_buffer_t flash_download_buffers[FLASH_DOWNLOAD_BUFFER_COUNT];
+static flash_download_queue_t flash_download_free;
+static flash_download_queue_t flash_download_filled;
+static flash_download_receiver_t flash_download_receiver;
+static flash_download_writer_t flash_download_writer;
+
+/* Download region, as an address of the serial flash and a size in bytes. */
+static uint32_t flash_download_region_base;
+static uint32_t flash_download_region_size;
+
+/* Set when the serial flash could not be initialized. */
+static bool flash_download_disabled;
+
+#if defined(FLASH_DOWNLOAD_HOST)
+    static int flash_download_host_fd;
+    static uint32_t flash_download_host_flash_size = 64u * 1024u * 1024u;
+    static uint32_t flash_download_host_sector_size = 256u * 1024u;
+    static uint32_t flash_download_host_erase_us = 520000u;
+    static uint32_t flash_download_host_page_size = 512u;
+    static uint32_t flash_download_host_page_us = 340u;
+    static uint32_t flash_download_host_kill_after;
+    static uint32_t flash_download_host_bytes;
+    static bool flash_download_host_completed;
+#endif /* FLASH_DOWNLOAD_HOST */
+
+/*******************************************************************************
+ * Function Name: flash_download_init
+ *******************************************************************************
+ * Summary:
+ *  Sets up the download region and the buffers, and starts the flash writer.
+ *
+ *******************************************************************************/
+void flash_download_init(void)
+{
+    uint32_t i;
+
+    flash_download_queue_init(&flash_download_free);
+    flash_download_queue_init(&flash_download_filled);
+    for(i = 0u; i < FLASH_DOWNLOAD_BUFFER_COUNT; i++)
+    {
+        flash_download_queue_send(&flash_download_free, &flash_download_buffers[i]);
+    }
+
+    flash_download_flash_init();
+    flash_download_start_writer();
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_disable
+ *******************************************************************************
+ * Summary:
+ *  Refuses the downloads, because the serial flash is not available. Called
+ *  before flash_download_init().
+ *
+ *******************************************************************************/
+void flash_download_disable(void)
+{
+    flash_download_disabled = true;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_begin
+ *******************************************************************************
+ * Summary:
+ *  Handles the 'D' command of the server. A blob with the identifier and the
+ *  size of the unfinished one is resumed after the last buffer written; any
+ *  other blob starts over at the beginning of the download region. Answers
+ *  with the offset from which the server sends the blob, or with a BUSY
+ *  status while the flash writer has not caught up after a pause.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+cy_rslt_t flash_download_begin(cy_socket_t socket_handle)
+{
+    flash_download_receiver_t *receiver = &flash_download_receiver;
+    flash_download_writer_t *writer = &flash_download_writer;
+    uint8_t payload[DOWNLOAD_BEGIN_PAYLOAD_LEN];
+    uint32_t blob_id;
+    uint32_t size;
+    bool paused;
+    cy_rslt_t result;
+
+    result = flash_download_recv(socket_handle, payload, sizeof(payload));
+    if(result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    blob_id = app_protocol_get_u32(&payload[0]);
+    size = app_protocol_get_u32(&payload[4]);
+
+    /* Data received before a disconnect, but not written, is dropped. */
+    if(!flash_download_drain())
+    {
+        APP_LOG_WARN("Download of blob 0x%08"PRIx32" deferred: the flash is still being written\n",
+                     blob_id);
+        receiver->paused = true;
+        return flash_download_send_status(socket_handle, DOWNLOAD_STATUS_BUSY, receiver->received,
+                                          NULL);
+    }
+
+    paused = receiver->paused;
+    receiver->paused = false;
+
+    if(flash_download_disabled)
+    {
+        APP_LOG_WARN("Download of blob 0x%08"PRIx32" refused: the serial flash is not available\n",
+                     blob_id);
+        receiver->active = false;
+        return flash_download_send_status(socket_handle, DOWNLOAD_STATUS_ERROR, 0u, NULL);
+    }
+
+    if((size == 0u) || (size > flash_download_region_size))
+    {
+        APP_LOG_WARN("Blob of %"PRIu32" bytes does not fit the download region of %"PRIu32" bytes\n",
+                     size, flash_download_region_size);
+        receiver->active = false;
+        return flash_download_send_status(socket_handle, DOWNLOAD_STATUS_ERROR, 0u, NULL);
+    }
+
+    if(receiver->active && !writer->failed && (blob_id == receiver->blob_id) &&
+       (size == receiver->size))
+    {
+        APP_LOG_INFO("Download of blob 0x%08"PRIx32" resumed at offset %"PRIu32"\n",
+                     blob_id, writer->written);
+    }
+    else
+    {
+        paused = false;
+        receiver->blob_id = blob_id;
+        receiver->size = size;
+        writer->written = 0u;
+        writer->erased = 0u;
+        writer->failed = false;
+        flash_download_hash_start();
+        APP_LOG_INFO("Download of blob 0x%08"PRIx32" (%"PRIu32" bytes) started\n", blob_id, size);
+    }
+
+    /* The timings of a paused download go on from where they were. */
+    if(!paused)
+    {
+        receiver->begin_us = flash_download_time_us();
+        receiver->stall_us = 0u;
+        receiver->start_offset = writer->written;
+        writer->erase_us = 0u;
+        writer->program_us = 0u;
+    }
+
+    receiver->active = true;
+    receiver->received = writer->written;
+
+    result = flash_download_send_status(socket_handle, DOWNLOAD_STATUS_READY, receiver->received,
+                                        NULL);
+
+    /* Paused after the last block: the server has nothing left to send. */
+    if((result == CY_RSLT_SUCCESS) && (receiver->received == receiver->size))
+    {
+        result = flash_download_finish(socket_handle);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_block
+ *******************************************************************************
+ * Summary:
+ *  Handles a 'B' block of the blob. The data is received directly into the
+ *  buffer being filled, and each full buffer is handed to the flash writer.
+ *  When no buffer frees up within FLASH_DOWNLOAD_WAIT_MS, the rest of the
+ *  block is skipped and the download is paused. After the last block, sends
+ *  the hash of the blob and the timings to the server.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+cy_rslt_t flash_download_block(cy_socket_t socket_handle)
+{
+    flash_download_receiver_t *receiver = &flash_download_receiver;
+    flash_download_writer_t *writer = &flash_download_writer;
+    uint8_t header[DOWNLOAD_BLOCK_HEADER_LEN - 1u];
+    flash_download_buffer_t *buffer;
+    uint32_t length;
+    uint32_t chunk;
+    cy_rslt_t result;
+
+    result = flash_download_recv(socket_handle, header, sizeof(header));
+    if(result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    length = app_protocol_get_u16(header);
+
+    /* Blocks sent before the server saw the BUSY status. */
+    if(receiver->paused)
+    {
+        return flash_download_skip(socket_handle, length);
+    }
+
+    if(!receiver->active || (length > DOWNLOAD_BLOCK_MAX_LEN) ||
+       (length > (receiver->size - receiver->received)))
+    {
+        APP_LOG_WARN("Unexpected download block of %"PRIu32" bytes skipped\n", length);
+        return flash_download_skip(socket_handle, length);
+    }
+
+    while(length > 0u)
+    {
+        if(receiver->filling == NULL)
+        {
+            receiver->filling = flash_download_take_buffer();
+            if(receiver->filling == NULL)
+            {
+                result = flash_download_skip(socket_handle, length);
+                return (result == CY_RSLT_SUCCESS) ? flash_download_pause(socket_handle) : result;
+            }
+            receiver->filling->offset = receiver->received;
+            receiver->filling->length = 0u;
+        }
+        buffer = receiver->filling;
+
+        chunk = FLASH_DOWNLOAD_BUFFER_SIZE - buffer->length;
+        chunk = (length < chunk) ? length : chunk;
+        result = flash_download_recv(socket_handle, &buffer->data[buffer->length], chunk);
+        if(result != CY_RSLT_SUCCESS)
+        {
+            return result;
+        }
+
+        buffer->length += chunk;
+        receiver->received += chunk;
+        length -= chunk;
+
+        if((buffer->length == FLASH_DOWNLOAD_BUFFER_SIZE) || (receiver->received == receiver->size))
+        {
+            flash_download_queue_send(&flash_download_filled, buffer);
+            receiver->filling = NULL;
+        }
+    }
+
+    if(writer->failed)
+    {
+        /* The writer drops the buffers of a failed blob without waiting. */
+        (void)flash_download_drain();
+        receiver->active = false;
+        return flash_download_send_status(socket_handle, DOWNLOAD_STATUS_ERROR, writer->written, NULL);
+    }
+
+    if(receiver->received < receiver->size)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    return flash_download_finish(socket_handle);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_finish
+ *******************************************************************************
+ * Summary:
+ *  Waits for the last write of the blob and sends its hash and the timings to
+ *  the server. Pauses the download when the write does not complete within
+ *  FLASH_DOWNLOAD_WAIT_MS.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t flash_download_finish(cy_socket_t socket_handle)
+{
+    flash_download_receiver_t *receiver = &flash_download_receiver;
+    flash_download_writer_t *writer = &flash_download_writer;
+    uint8_t digest[DOWNLOAD_SHA256_LEN];
+    uint32_t elapsed_us;
+
+    if(!flash_download_drain())
+    {
+        return flash_download_pause(socket_handle);
+    }
+
+    receiver->active = false;
+    if(writer->failed)
+    {
+        return flash_download_send_status(socket_handle, DOWNLOAD_STATUS_ERROR, writer->written, NULL);
+    }
+
+    flash_download_hash_finish(digest);
+
+    elapsed_us = (uint32_t)(flash_download_time_us() - receiver->begin_us);
+    printf("Download of %"PRIu32" bytes complete in %"PRIu32" ms: %"PRIu32" kB/s, receive "
+           "stalled %"PRIu32" ms on the flash (erase %"PRIu32" ms, program %"PRIu32" ms)\n",
+           receiver->size - receiver->start_offset, elapsed_us / 1000u,
+           (uint32_t)(((uint64_t)(receiver->size - receiver->start_offset) * 1000u) /
+                      ((elapsed_us > 0u) ? elapsed_us : 1u)),
+           (uint32_t)(receiver->stall_us / 1000u), (uint32_t)(writer->erase_us / 1000u),
+           (uint32_t)(writer->program_us / 1000u));
+
+    #if defined(FLASH_DOWNLOAD_HOST)
+        flash_download_host_completed = true;
+    #endif /* FLASH_DOWNLOAD_HOST */
+
+    return flash_download_send_status(socket_handle, DOWNLOAD_STATUS_COMPLETE, receiver->size, digest);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_write
+ *******************************************************************************
+ * Summary:
+ *  Writes a buffer to the download region. The sectors the buffer reaches
+ *  are erased first. After a failure, the buffers of the blob are dropped.
+ *
+ * Parameters:
+ *  flash_download_buffer_t *buffer: Buffer to be written
+ *
+ *******************************************************************************/
+static void flash_download_write(flash_download_buffer_t *buffer)
+{
+    flash_download_writer_t *writer = &flash_download_writer;
+    uint32_t end = buffer->offset + buffer->length;
+    uint32_t erase_size;
+    uint64_t begin_us;
+
+    if(writer->failed)
+    {
+        return;
+    }
+
+    begin_us = flash_download_time_us();
+    while(writer->erased < end)
+    {
+        erase_size = flash_download_erase_size(flash_download_region_base + writer->erased);
+        if(!flash_download_erase(flash_download_region_base + writer->erased, erase_size))
+        {
+            writer->failed = true;
+            return;
+        }
+        writer->erased += erase_size;
+    }
+    writer->erase_us += flash_download_time_us() - begin_us;
+
+    begin_us = flash_download_time_us();
+    if(!flash_download_program(flash_download_region_base + buffer->offset, buffer->data,
+                               buffer->length))
+    {
+        writer->failed = true;
+        return;
+    }
+    writer->program_us += flash_download_time_us() - begin_us;
+
+    flash_download_hash_update(buffer->data, buffer->length);
+    writer->written = end;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_take_buffer
+ *******************************************************************************
+ * Summary:
+ *  Returns a free buffer. While both buffers are full, waits for the flash
+ *  writer for up to FLASH_DOWNLOAD_WAIT_MS and counts the wait as receive
+ *  stall time.
+ *
+ * Return:
+ *  flash_download_buffer_t *: Free buffer, NULL on timeout
+ *
+ *******************************************************************************/
+static flash_download_buffer_t *flash_download_take_buffer(void)
+{
+    uint64_t begin_us = flash_download_time_us();
+    flash_download_buffer_t *buffer = flash_download_queue_receive(&flash_download_free,
+                                                                   FLASH_DOWNLOAD_WAIT_MS);
+
+    flash_download_receiver.stall_us += flash_download_time_us() - begin_us;
+
+    return buffer;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_drain
+ *******************************************************************************
+ * Summary:
+ *  Drops the buffer being filled and waits, for up to FLASH_DOWNLOAD_WAIT_MS,
+ *  until no buffer is being written.
+ *
+ * Return:
+ *  bool: true if no buffer is being written
+ *
+ *******************************************************************************/
+static bool flash_download_drain(void)
+{
+    flash_download_buffer_t *buffers[FLASH_DOWNLOAD_BUFFER_COUNT];
+    uint64_t deadline_us = flash_download_time_us() + (FLASH_DOWNLOAD_WAIT_MS * 1000ull);
+    uint64_t now_us;
+    uint32_t timeout_ms;
+    uint32_t count = 0u;
+    uint32_t i;
+
+    if(flash_download_receiver.filling != NULL)
+    {
+        flash_download_queue_send(&flash_download_free, flash_download_receiver.filling);
+        flash_download_receiver.filling = NULL;
+    }
+
+    while(count < FLASH_DOWNLOAD_BUFFER_COUNT)
+    {
+        now_us = flash_download_time_us();
+        if(now_us >= deadline_us)
+        {
+            break;
+        }
+        timeout_ms = (uint32_t)((deadline_us - now_us + 999u) / 1000u);
+        buffers[count] = flash_download_queue_receive(&flash_download_free, timeout_ms);
+        if(buffers[count] == NULL)
+        {
+            break;
+        }
+        count++;
+    }
+    for(i = 0u; i < count; i++)
+    {
+        flash_download_queue_send(&flash_download_free, buffers[i]);
+    }
+
+    return (count == FLASH_DOWNLOAD_BUFFER_COUNT);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_pause
+ *******************************************************************************
+ * Summary:
+ *  Pauses the download because the flash writer did not keep up. The blocks
+ *  are skipped until the server resumes the blob with a new 'D'.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t flash_download_pause(cy_socket_t socket_handle)
+{
+    flash_download_receiver.paused = true;
+    APP_LOG_WARN("Download paused at offset %"PRIu32": the flash writer did not keep up within "
+                 "%"PRIu32" ms\n", flash_download_receiver.received,
+                 (uint32_t)FLASH_DOWNLOAD_WAIT_MS);
+
+    return flash_download_send_status(socket_handle, DOWNLOAD_STATUS_BUSY,
+                                      flash_download_receiver.received, NULL);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_send_status
+ *******************************************************************************
+ * Summary:
+ *  Sends a 'd' status message with the timings of the current download.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *  uint8_t status: DOWNLOAD_STATUS_READY, _COMPLETE, _ERROR or _BUSY
+ *  uint32_t offset: Offset given by the status
+ *  const uint8_t *digest: SHA-256 of the blob, or NULL
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t flash_download_send_status(cy_socket_t socket_handle, uint8_t status,
+                                            uint32_t offset, const uint8_t *digest)
+{
+    uint8_t message[DOWNLOAD_STATUS_LEN] = {0};
+    uint32_t bytes_sent = 0;
+    cy_rslt_t result;
+
+    message[0] = DOWNLOAD_STATUS_MSG;
+    message[1] = status;
+    app_protocol_put_u32(&message[2], offset);
+    app_protocol_put_u32(&message[6],
+                         (uint32_t)(flash_download_time_us() - flash_download_receiver.begin_us));
+    app_protocol_put_u32(&message[10], (uint32_t)flash_download_receiver.stall_us);
+    if(digest != NULL)
+    {
+        memcpy(&message[14], digest, DOWNLOAD_SHA256_LEN);
+    }
+
+    result = cy_socket_send(socket_handle, message, sizeof(message), CY_SOCKET_FLAGS_NONE,
+                            &bytes_sent);
+    if(result == CY_RSLT_SUCCESS)
+    {
+        METRICS_RECORD_SENT(bytes_sent);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_recv
+ *******************************************************************************
+ * Summary:
+ *  Receives exactly the requested number of bytes from the socket.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *  uint8_t *buffer: Buffer to store the received bytes
+ *  uint32_t length: Number of bytes to receive
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t flash_download_recv(cy_socket_t socket_handle, uint8_t *buffer, uint32_t length)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint32_t bytes_received = 0;
+
+    while((length > 0u) && (result == CY_RSLT_SUCCESS))
+    {
+        result = cy_socket_recv(socket_handle, buffer, length,
+                                CY_SOCKET_FLAGS_NONE, &bytes_received);
+        buffer += bytes_received;
+        length -= bytes_received;
+        METRICS_COUNTER_ADD(METRIC_BYTES_IN, bytes_received);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_skip
+ *******************************************************************************
+ * Summary:
+ *  Receives and drops the given number of bytes, to stay in sync with the
+ *  messages of the server.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *  uint32_t length: Number of bytes to drop
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t flash_download_skip(cy_socket_t socket_handle, uint32_t length)
+{
+    uint8_t scratch[FLASH_DOWNLOAD_SKIP_CHUNK];
+    uint32_t chunk;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    while((length > 0u) && (result == CY_RSLT_SUCCESS))
+    {
+        chunk = (length < sizeof(scratch)) ? length : sizeof(scratch);
+        result = flash_download_recv(socket_handle, scratch, chunk);
+        length -= chunk;
+    }
+
+    return result;
+}
+
+#if defined(FLASH_DOWNLOAD_HOST)
+
+/*******************************************************************************
+ * Function Name: flash_download_time_us
+ *******************************************************************************
+ * Summary:
+ *  Returns a monotonic timestamp in microseconds.
+ *
+ *******************************************************************************/
+static uint64_t flash_download_time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * US_PER_S) + ((uint64_t)ts.tv_nsec / 1000u);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_queue_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes an empty buffer queue.
+ *
+ *******************************************************************************/
+static void flash_download_queue_init(flash_download_queue_t *queue)
+{
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->cond, NULL);
+    queue->head = 0u;
+    queue->count = 0u;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_queue_send
+ *******************************************************************************
+ * Summary:
+ *  Appends a buffer to a queue. A queue never holds more than all buffers.
+ *
+ *******************************************************************************/
+static void flash_download_queue_send(flash_download_queue_t *queue, flash_download_buffer_t *buffer)
+{
+    pthread_mutex_lock(&queue->mutex);
+    queue->items[(queue->head + queue->count) % FLASH_DOWNLOAD_BUFFER_COUNT] = buffer;
+    queue->count++;
+    pthread_cond_signal(&queue->cond);
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_queue_receive
+ *******************************************************************************
+ * Summary:
+ *  Removes the first buffer of a queue, waiting for one for up to timeout_ms
+ *  if it is empty. Returns NULL on timeout.
+ *
+ *******************************************************************************/
+static flash_download_buffer_t *flash_download_queue_receive(flash_download_queue_t *queue,
+                                                              uint32_t timeout_ms)
+{
+    flash_download_buffer_t *buffer = NULL;
+    struct timespec deadline;
+    int error = 0;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(timeout_ms / 1000u);
+    deadline.tv_nsec += (long)(timeout_ms % 1000u) * 1000000L;
+    if(deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&queue->mutex);
+    while((queue->count == 0u) && (error == 0))
+    {
+        error = (timeout_ms == FLASH_DOWNLOAD_WAIT_FOREVER) ?
+                pthread_cond_wait(&queue->cond, &queue->mutex) :
+                pthread_cond_timedwait(&queue->cond, &queue->mutex, &deadline);
+    }
+    if(queue->count > 0u)
+    {
+        buffer = queue->items[queue->head];
+        queue->head = (queue->head + 1u) % FLASH_DOWNLOAD_BUFFER_COUNT;
+        queue->count--;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+
+    return buffer;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_writer_thread
+ *******************************************************************************
+ * Summary:
+ *  Host thread of the flash writer.
+ *
+ *******************************************************************************/
+static void *flash_download_writer_thread(void *arg)
+{
+    flash_download_buffer_t *buffer;
+
+    (void)arg;
+
+    for(;;)
+    {
+        buffer = flash_download_queue_receive(&flash_download_filled, FLASH_DOWNLOAD_WAIT_FOREVER);
+        flash_download_write(buffer);
+        flash_download_queue_send(&flash_download_free, buffer);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_start_writer
+ *******************************************************************************
+ * Summary:
+ *  Starts the flash writer thread of the host build.
+ *
+ *******************************************************************************/
+static void flash_download_start_writer(void)
+{
+    pthread_t thread;
+
+    pthread_create(&thread, NULL, flash_download_writer_thread, NULL);
+    pthread_detach(thread);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_flash_init
+ *******************************************************************************
+ * Summary:
+ *  Uses the upper half of the emulated flash as the download region.
+ *
+ *******************************************************************************/
+static void flash_download_flash_init(void)
+{
+    flash_download_region_size = flash_download_host_flash_size / 2u;
+    flash_download_region_base = flash_download_region_size;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_erase_size
+ *******************************************************************************
+ * Summary:
+ *  Returns the size of the sector of the emulated flash at an address.
+ *
+ *******************************************************************************/
+static uint32_t flash_download_erase_size(uint32_t address)
+{
+    (void)address;
+
+    return flash_download_host_sector_size;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_erase
+ *******************************************************************************
+ * Summary:
+ *  Erases a sector of the emulated flash to 0xFF, in the erase time of the
+ *  emulated part.
+ *
+ *******************************************************************************/
+static bool flash_download_erase(uint32_t address, uint32_t length)
+{
+    static uint8_t erased[FLASH_DOWNLOAD_BUFFER_SIZE];
+    uint32_t done;
+    uint32_t chunk;
+
+    memset(erased, 0xFF, sizeof(erased));
+    for(done = 0u; done < length; done += chunk)
+    {
+        chunk = ((length - done) < sizeof(erased)) ? (length - done) : sizeof(erased);
+        if(pwrite(flash_download_host_fd, erased, chunk, (off_t)(address + done)) != (ssize_t)chunk)
+        {
+            return false;
+        }
+    }
+    usleep(flash_download_host_erase_us);
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_program
+ *******************************************************************************
+ * Summary:
+ *  Programs the emulated flash, in the page program time of the emulated part.
+ *  As on NOR flash, programming only clears bits.
+ *
+ *******************************************************************************/
+static bool flash_download_program(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    uint8_t current[FLASH_DOWNLOAD_BUFFER_SIZE];
+    uint32_t pages;
+    uint32_t i;
+
+    if(pread(flash_download_host_fd, current, length, (off_t)address) != (ssize_t)length)
+    {
+        return false;
+    }
+    for(i = 0u; i < length; i++)
+    {
+        current[i] &= data[i];
+    }
+    if(pwrite(flash_download_host_fd, current, length, (off_t)address) != (ssize_t)length)
+    {
+        return false;
+    }
+
+    pages = ((address + length - 1u) / flash_download_host_page_size) -
+            (address / flash_download_host_page_size) + 1u;
+    usleep(pages * flash_download_host_page_us);
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_hash_start
+ *******************************************************************************
+ * Summary:
+ *  Starts the SHA-256 of a new blob.
+ *
+ *******************************************************************************/
+static void flash_download_hash_start(void)
+{
+    if(flash_download_writer.hash == NULL)
+    {
+        flash_download_writer.hash = EVP_MD_CTX_new();
+    }
+    EVP_DigestInit_ex(flash_download_writer.hash, EVP_sha256(), NULL);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_hash_update
+ *******************************************************************************
+ * Summary:
+ *  Adds the bytes written to the SHA-256 of the blob.
+ *
+ *******************************************************************************/
+static void flash_download_hash_update(const uint8_t *data, uint32_t length)
+{
+    EVP_DigestUpdate(flash_download_writer.hash, data, length);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_hash_finish
+ *******************************************************************************
+ * Summary:
+ *  Returns the SHA-256 of the blob.
+ *
+ *******************************************************************************/
+static void flash_download_hash_finish(uint8_t *digest)
+{
+    EVP_DigestFinal_ex(flash_download_writer.hash, digest, NULL);
+}
+
+/*******************************************************************************
+ * Function Name: cy_socket_recv
+ *******************************************************************************
+ * Summary:
+ *  Host version of the secure sockets receive function, on an OpenSSL
+ *  connection. After the number of bytes given with -k, the connection is
+ *  dropped once, to try the resume.
+ *
+ *******************************************************************************/
+cy_rslt_t cy_socket_recv(cy_socket_t handle, void *buffer, uint32_t length, int flags,
+                         uint32_t *bytes_received)
+{
+    int received;
+
+    (void)flags;
+
+    if((flash_download_host_kill_after > 0u) &&
+       ((flash_download_host_bytes + length) > flash_download_host_kill_after))
+    {
+        printf("Dropping the connection after %"PRIu32" bytes\n", flash_download_host_bytes);
+        flash_download_host_kill_after = 0u;
+        *bytes_received = 0u;
+        return FLASH_DOWNLOAD_HOST_CLOSED;
+    }
+
+    received = SSL_read((SSL *)handle, buffer, (int)length);
+    if(received <= 0)
+    {
+        *bytes_received = 0u;
+        return FLASH_DOWNLOAD_HOST_CLOSED;
+    }
+
+    *bytes_received = (uint32_t)received;
+    flash_download_host_bytes += (uint32_t)received;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_socket_send
+ *******************************************************************************
+ * Summary:
+ *  Host version of the secure sockets send function, on an OpenSSL
+ *  connection.
+ *
+ *******************************************************************************/
+cy_rslt_t cy_socket_send(cy_socket_t handle, const void *buffer, uint32_t length, int flags,
+                         uint32_t *bytes_sent)
+{
+    int sent;
+
+    (void)flags;
+
+    sent = SSL_write((SSL *)handle, buffer, (int)length);
+    *bytes_sent = (sent > 0) ? (uint32_t)sent : 0u;
+
+    return (sent == (int)length) ? CY_RSLT_SUCCESS : FLASH_DOWNLOAD_HOST_CLOSED;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_host_connect
+ *******************************************************************************
+ * Summary:
+ *  Opens the TLS connection to the TCP server.
+ *
+ *******************************************************************************/
+static SSL *flash_download_host_connect(SSL_CTX *context, const char *host, const char *port,
+                                        int *fd)
+{
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
+    struct addrinfo *addresses;
+    SSL *ssl;
+
+    if(getaddrinfo(host, port, &hints, &addresses) != 0)
+    {
+        return NULL;
+    }
+    *fd = socket(addresses->ai_family, addresses->ai_socktype, addresses->ai_protocol);
+    if((*fd < 0) || (connect(*fd, addresses->ai_addr, addresses->ai_addrlen) != 0))
+    {
+        freeaddrinfo(addresses);
+        if(*fd >= 0)
+        {
+            close(*fd);
+        }
+        return NULL;
+    }
+    freeaddrinfo(addresses);
+
+    ssl = SSL_new(context);
+    SSL_set_fd(ssl, *fd);
+    if(SSL_connect(ssl) != 1)
+    {
+        SSL_free(ssl);
+        close(*fd);
+        return NULL;
+    }
+
+    return ssl;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_host_serve
+ *******************************************************************************
+ * Summary:
+ *  Handles the messages of the server until the connection is closed or a
+ *  blob is complete.
+ *
+ *******************************************************************************/
+static void flash_download_host_serve(SSL *ssl)
+{
+    uint8_t opcode;
+    uint8_t skipped[4];
+    uint32_t bytes_received;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    while((result == CY_RSLT_SUCCESS) && !flash_download_host_completed)
+    {
+        result = cy_socket_recv(ssl, &opcode, 1u, CY_SOCKET_FLAGS_NONE, &bytes_received);
+        if(result != CY_RSLT_SUCCESS)
+        {
+            break;
+        }
+
+        switch(opcode)
+        {
+            case DOWNLOAD_BEGIN_CMD:
+                result = flash_download_begin(ssl);
+                break;
+
+            case DOWNLOAD_BLOCK_CMD:
+                result = flash_download_block(ssl);
+                break;
+
+            case HEARTBEAT_REPLY_CMD:
+                result = flash_download_recv(ssl, skipped, sizeof(skipped));
+                break;
+
+            default:
+                printf("Unexpected message 0x%02x\n", opcode);
+                break;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *  Host program: downloads a blob from the TCP server into the emulated flash
+ *  file and reconnects after a dropped connection until the blob is complete.
+ *
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *root_ca = "python-secure-tcp-server/root_ca.crt";
+    const char *port = "50007";
+    SSL_CTX *context;
+    SSL *ssl;
+    int fd;
+    int option;
+
+    while((option = getopt(argc, argv, "c:k:s:e:p:w:z:")) != -1)
+    {
+        switch(option)
+        {
+            case 'c': root_ca = optarg; break;
+            case 'k': flash_download_host_kill_after = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': flash_download_host_sector_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'e': flash_download_host_erase_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'p': flash_download_host_page_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'w': flash_download_host_page_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'z': flash_download_host_flash_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "Usage: %s [-c root_ca] [-k drop_after_bytes] [-s sector_size] "
+                        "[-e erase_us] [-p page_size] [-w page_us] [-z flash_size] "
+                        "flash.bin host [port]\n", argv[0]);
+                return 1;
+        }
+    }
+    if((argc - optind) < 2)
+    {
+        fprintf(stderr, "Missing flash file or server host\n");
+        return 1;
+    }
+    if((argc - optind) > 2)
+    {
+        port = argv[optind + 2];
+    }
+
+    flash_download_host_fd = open(argv[optind], O_RDWR | O_CREAT, 0644);
+    if((flash_download_host_fd < 0) ||
+       (ftruncate(flash_download_host_fd, flash_download_host_flash_size) != 0))
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    printf("Emulated flash: %"PRIu32" bytes, %"PRIu32"-byte sectors erased in %"PRIu32" us, "
+           "%"PRIu32"-byte pages programmed in %"PRIu32" us\n", flash_download_host_flash_size,
+           flash_download_host_sector_size, flash_download_host_erase_us,
+           flash_download_host_page_size, flash_download_host_page_us);
+
+    context = SSL_CTX_new(TLS_client_method());
+    if(SSL_CTX_load_verify_locations(context, root_ca, NULL) != 1)
+    {
+        fprintf(stderr, "Cannot load the root CA certificate %s\n", root_ca);
+        return 1;
+    }
+    SSL_CTX_set_verify(context, SSL_VERIFY_PEER, NULL);
+
+    flash_download_init();
+
+    while(!flash_download_host_completed)
+    {
+        ssl = flash_download_host_connect(context, argv[optind + 1], port, &fd);
+        if(ssl == NULL)
+        {
+            printf("Cannot connect to %s:%s, retrying\n", argv[optind + 1], port);
+            sleep(1);
+            continue;
+        }
+        printf("Connected to %s:%s (%s)\n", argv[optind + 1], port, SSL_get_version(ssl));
+
+        flash_download_host_serve(ssl);
+
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+        close(fd);
+    }
+
+    close(flash_download_host_fd);
+    SSL_CTX_free(context);
+
+    return 0;
+}
+
+#else
+
+/*******************************************************************************
+ * Function Name: flash_download_time_us
+ *******************************************************************************
+ * Summary:
+ *  Returns the time since boot in microseconds.
+ *
+ *******************************************************************************/
+static uint64_t flash_download_time_us(void)
+{
+    return app_time_us();
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_queue_init
+ *******************************************************************************
+ * Summary:
+ *  Creates an empty buffer queue.
+ *
+ *******************************************************************************/
+static void flash_download_queue_init(flash_download_queue_t *queue)
+{
+    *queue = xQueueCreate(FLASH_DOWNLOAD_BUFFER_COUNT, sizeof(flash_download_buffer_t *));
+    CY_ASSERT(*queue != NULL);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_queue_send
+ *******************************************************************************
+ * Summary:
+ *  Appends a buffer to a queue. A queue never holds more than all buffers.
+ *
+ *******************************************************************************/
+static void flash_download_queue_send(flash_download_queue_t *queue, flash_download_buffer_t *buffer)
+{
+    xQueueSend(*queue, &buffer, portMAX_DELAY);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_queue_receive
+ *******************************************************************************
+ * Summary:
+ *  Removes the first buffer of a queue, waiting for one for up to timeout_ms
+ *  if it is empty. Returns NULL on timeout.
+ *
+ *******************************************************************************/
+static flash_download_buffer_t *flash_download_queue_receive(flash_download_queue_t *queue,
+                                                              uint32_t timeout_ms)
+{
+    flash_download_buffer_t *buffer = NULL;
+
+    xQueueReceive(*queue, &buffer, (timeout_ms == FLASH_DOWNLOAD_WAIT_FOREVER) ?
+                                   portMAX_DELAY : pdMS_TO_TICKS(timeout_ms));
+
+    return buffer;
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_task
+ *******************************************************************************
+ * Summary:
+ *  Flash writer task: writes the filled buffers and returns them to the
+ *  receiver.
+ *
+ * Parameters:
+ *  void *arg: Unused
+ *
+ *******************************************************************************/
+static void flash_download_task(void *arg)
+{
+    flash_download_buffer_t *buffer;
+
+    (void)arg;
+
+    for(;;)
+    {
+        buffer = flash_download_queue_receive(&flash_download_filled, FLASH_DOWNLOAD_WAIT_FOREVER);
+        flash_download_write(buffer);
+        flash_download_queue_send(&flash_download_free, buffer);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_start_writer
+ *******************************************************************************
+ * Summary:
+ *  Starts the flash writer task.
+ *
+ *******************************************************************************/
+static void flash_download_start_writer(void)
+{
+    if(pdPASS != xTaskCreate(flash_download_task, "Flash download task",
+                             FLASH_DOWNLOAD_TASK_STACK_SIZE, NULL,
+                             FLASH_DOWNLOAD_TASK_PRIORITY, NULL))
+    {
+        printf("Failed to create the flash download task!\n");
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_flash_init
+ *******************************************************************************
+ * Summary:
+ *  Uses the upper half of the serial flash, initialized in main(), as the
+ *  download region.
+ *
+ *******************************************************************************/
+static void flash_download_flash_init(void)
+{
+    if(flash_download_disabled)
+    {
+        return;
+    }
+
+    flash_download_region_size = (uint32_t)(cy_serial_flash_qspi_get_size() / 2u);
+    flash_download_region_base = flash_download_region_size;
+
+    APP_LOG_INFO("Download region: %"PRIu32" bytes at 0x%08"PRIx32" of the serial flash\n",
+                 flash_download_region_size, flash_download_region_base);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_erase_size
+ *******************************************************************************
+ * Summary:
+ *  Returns the size of the sector at an address of the serial flash, which
+ *  differs between the regions of hybrid-sector parts.
+ *
+ *******************************************************************************/
+static uint32_t flash_download_erase_size(uint32_t address)
+{
+    return (uint32_t)cy_serial_flash_qspi_get_erase_size(address);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_erase
+ *******************************************************************************
+ * Summary:
+ *  Erases a sector of the serial flash.
+ *
+ *******************************************************************************/
+static bool flash_download_erase(uint32_t address, uint32_t length)
+{
+    cy_rslt_t result;
+
+    #if defined(CY_DEVICE_PSOC6A512K)
+        /* The Wi-Fi firmware is only read through XIP while the Wi-Fi device
+         * is initialized, so XIP can be off while the flash is busy.
+         */
+        cy_serial_flash_qspi_enable_xip(false);
+    #endif /* CY_DEVICE_PSOC6A512K */
+
+    result = cy_serial_flash_qspi_erase(address, length);
+
+    #if defined(CY_DEVICE_PSOC6A512K)
+        cy_serial_flash_qspi_enable_xip(true);
+    #endif /* CY_DEVICE_PSOC6A512K */
+
+    if(result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_ERR("Erase at 0x%08"PRIx32" failed! Error code: 0x%08"PRIx32"\n",
+                    address, (uint32_t)result);
+    }
+
+    return (result == CY_RSLT_SUCCESS);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_program
+ *******************************************************************************
+ * Summary:
+ *  Programs data into erased serial flash.
+ *
+ *******************************************************************************/
+static bool flash_download_program(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    cy_rslt_t result;
+
+    #if defined(CY_DEVICE_PSOC6A512K)
+        cy_serial_flash_qspi_enable_xip(false);
+    #endif /* CY_DEVICE_PSOC6A512K */
+
+    result = cy_serial_flash_qspi_write(address, length, data);
+
+    #if defined(CY_DEVICE_PSOC6A512K)
+        cy_serial_flash_qspi_enable_xip(true);
+    #endif /* CY_DEVICE_PSOC6A512K */
+
+    if(result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_ERR("Program at 0x%08"PRIx32" failed! Error code: 0x%08"PRIx32"\n",
+                    address, (uint32_t)result);
+    }
+
+    return (result == CY_RSLT_SUCCESS);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_hash_start
+ *******************************************************************************
+ * Summary:
+ *  Starts the SHA-256 of a new blob.
+ *
+ *******************************************************************************/
+static void flash_download_hash_start(void)
+{
+    mbedtls_sha256_init(&flash_download_writer.hash);
+    mbedtls_sha256_starts(&flash_download_writer.hash, 0);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_hash_update
+ *******************************************************************************
+ * Summary:
+ *  Adds the bytes written to the SHA-256 of the blob.
+ *
+ *******************************************************************************/
+static void flash_download_hash_update(const uint8_t *data, uint32_t length)
+{
+    mbedtls_sha256_update(&flash_download_writer.hash, data, length);
+}
+
+/*******************************************************************************
+ * Function Name: flash_download_hash_finish
+ *******************************************************************************
+ * Summary:
+ *  Returns the SHA-256 of the blob.
+ *
+ *******************************************************************************/
+static void flash_download_hash_finish(uint8_t *digest)
+{
+    mbedtls_sha256_finish(&flash_download_writer.hash, digest);
+    mbedtls_sha256_free(&flash_download_writer.hash);
+}
+
+#endif /* FLASH_DOWNLOAD_HOST */
+
+#endif /* ENABLE_FLASH_DOWNLOAD */
+
+/* [] END OF FILE */
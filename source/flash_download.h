@@ -0,0 +1,95 @@
+/******************************************************************************
+* File Name:   flash_download.h
+*
+* Description: This file contains the macros and the function prototypes of the
+* bulk download into the serial flash.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FLASH_DOWNLOAD_H_
+#define FLASH_DOWNLOAD_H_
+
+#include <stdint.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set this macro to '1' (or build with FLASH_DOWNLOAD=1) to accept bulk
+ * downloads from the TCP server into the upper half of the QSPI serial flash.
+ * The lower half is left alone, as some kits keep the Wi-Fi firmware at the
+ * start of the serial flash. Off by default, except in the host build: the
+ * download lets the server erase and rewrite that part of the flash.
+ */
+#ifndef ENABLE_FLASH_DOWNLOAD
+#if defined(FLASH_DOWNLOAD_HOST)
+#define ENABLE_FLASH_DOWNLOAD                 (1)
+#else
+#define ENABLE_FLASH_DOWNLOAD                 (0)
+#endif /* FLASH_DOWNLOAD_HOST */
+#endif
+
+/* Size of each of the two receive buffers. One buffer is filled from the TLS
+ * connection while the other one is written to the flash. Must be a multiple
+ * of the program page size of the serial flash; every write but the last one
+ * of a blob starts at a multiple of it.
+ */
+#define FLASH_DOWNLOAD_BUFFER_SIZE            (4096u)
+
+/* Longest time the socket worker waits for the flash writer, for a free
+ * buffer or for the last write of the blob. The blocks are received in the
+ * receive callback of the socket worker, which also serves the other sockets;
+ * rather than holding it up during a slow erase, the download is paused with
+ * a BUSY status on timeout and resumed by the server.
+ */
+#define FLASH_DOWNLOAD_WAIT_MS                (1000u)
+
+/* RTOS related macros for the flash writer task. Its priority is below the
+ * one of the socket worker, so that receiving preempts the polling of the
+ * flash while an erase or a program operation is in progress.
+ */
+#define FLASH_DOWNLOAD_TASK_STACK_SIZE        (1024u)
+#define FLASH_DOWNLOAD_TASK_PRIORITY          (1)
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void flash_download_init(void);
+void flash_download_disable(void);
+cy_rslt_t flash_download_begin(cy_socket_t socket_handle);
+cy_rslt_t flash_download_block(cy_socket_t socket_handle);
+
+#endif /* FLASH_DOWNLOAD_H_ */
@@ -0,0 +1,604 @@
+/******************************************************************************
+* File Name:   happy_eyeballs.c
+*
+* Description: This file contains the dual-stack connector. The TCP server is
+* reached over IPv6 and IPv4 with a staggered start (Happy Eyeballs, RFC 8305):
+* the attempt of the preferred family starts first, the other one after
+* HAPPY_EYEBALLS_ATTEMPT_DELAY_MS or as soon as the first one fails. The first
+* socket that completes its TLS handshake is kept and its family is preferred
+* for the next connection.
+*
+* The connection is asynchronous: happy_eyeballs_connect_start() starts a
+* race and happy_eyeballs_connect_poll() advances it, so that the caller can
+* handle other events between polls and bound the time spent connecting.
+*
+* Each family has its own attempt task, because cy_socket_connect() blocks
+* until the TLS handshake completes or the connection fails. The secure
+* sockets library cannot abort a connection attempt, so an attempt that loses
+* the race or exceeds its timeouts is abandoned: it is closed as soon as it
+* returns and the caller does not wait for it.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <semphr.h>
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <inttypes.h>
+
+/* Dual-stack connector, logging and timestamp header files. */
+#include "happy_eyeballs.h"
+#include "app_log.h"
+#include "app_time.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define HAPPY_EYEBALLS_FAMILIES            (2u)
+
+/* Attempt index of an IP version, and the IP version of an index. */
+#define HAPPY_EYEBALLS_INDEX(version)      (((version) == 6u) ? 0u : 1u)
+#define HAPPY_EYEBALLS_VERSION(index)      (((index) == 0u) ? 6u : 4u)
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+/* Connection attempt task of one address family. */
+typedef struct
+{
+    uint8_t version;
+    bool busy;
+    uint32_t race;
+    uint32_t tls_ms;
+    cy_socket_sockaddr_t address;
+    TaskHandle_t task;
+} happy_eyeballs_attempt_t;
+
+typedef struct
+{
+    uint8_t version;
+    uint32_t race;
+    cy_rslt_t result;
+    cy_socket_t handle;
+} happy_eyeballs_outcome_t;
+
+/* State of an address family in the current race. */
+typedef enum
+{
+    HAPPY_EYEBALLS_IDLE,            /* No address, failed or timed out. */
+    HAPPY_EYEBALLS_SCHEDULED,       /* Starts at start_tick. */
+    HAPPY_EYEBALLS_RUNNING          /* Abandoned at deadline_tick. */
+} happy_eyeballs_state_t;
+
+typedef struct
+{
+    happy_eyeballs_endpoint_t endpoint;
+    happy_eyeballs_timeouts_t timeouts;
+    happy_eyeballs_state_t state[HAPPY_EYEBALLS_FAMILIES];
+    TickType_t start_tick[HAPPY_EYEBALLS_FAMILIES];
+    TickType_t deadline_tick[HAPPY_EYEBALLS_FAMILIES];
+    bool busy_logged[HAPPY_EYEBALLS_FAMILIES];
+    cy_rslt_t last_error;
+    uint64_t begin_us;
+    bool active;
+} happy_eyeballs_race_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void happy_eyeballs_task(void *arg);
+static void happy_eyeballs_start_due(TickType_t now);
+static void happy_eyeballs_attempt_failed(uint32_t index, cy_rslt_t result, TickType_t now);
+static void happy_eyeballs_finish(void);
+static void happy_eyeballs_close_loser(uint8_t version, cy_socket_t handle);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static happy_eyeballs_acquire_t happy_eyeballs_acquire;
+static happy_eyeballs_release_t happy_eyeballs_release;
+static happy_eyeballs_notify_t happy_eyeballs_notify;
+static happy_eyeballs_attempt_t happy_eyeballs_attempts[HAPPY_EYEBALLS_FAMILIES];
+static QueueHandle_t happy_eyeballs_outcomes;
+static SemaphoreHandle_t happy_eyeballs_mutex;
+
+/* Current race; attempts of an earlier or decided race close their socket. */
+static happy_eyeballs_race_t happy_eyeballs_state;
+static uint32_t happy_eyeballs_race;
+static bool happy_eyeballs_decided = true;
+
+static uint8_t happy_eyeballs_preferred = HAPPY_EYEBALLS_PREFERRED_VERSION;
+
+/*******************************************************************************
+ * Function Name: happy_eyeballs_init
+ *******************************************************************************
+ * Summary:
+ *  Creates the connection attempt tasks of both address families.
+ *
+ * Parameters:
+ *  happy_eyeballs_acquire_t acquire: Provides a configured socket
+ *  happy_eyeballs_release_t release: Deletes a socket that is not kept
+ *  happy_eyeballs_notify_t notify: Called when an attempt has completed
+ *
+ *******************************************************************************/
+void happy_eyeballs_init(happy_eyeballs_acquire_t acquire, happy_eyeballs_release_t release,
+                         happy_eyeballs_notify_t notify)
+{
+    static const char *task_names[HAPPY_EYEBALLS_FAMILIES] = { "IPv6 connect task",
+                                                               "IPv4 connect task" };
+
+    happy_eyeballs_acquire = acquire;
+    happy_eyeballs_release = release;
+    happy_eyeballs_notify = notify;
+
+    happy_eyeballs_mutex = xSemaphoreCreateMutex();
+    happy_eyeballs_outcomes = xQueueCreate(HAPPY_EYEBALLS_FAMILIES, sizeof(happy_eyeballs_outcome_t));
+    if((happy_eyeballs_mutex == NULL) || (happy_eyeballs_outcomes == NULL))
+    {
+        printf("Failed to create the Happy Eyeballs queue!\n");
+        CY_ASSERT(0);
+    }
+
+    for(uint32_t i = 0; i < HAPPY_EYEBALLS_FAMILIES; i++)
+    {
+        happy_eyeballs_attempts[i].version = HAPPY_EYEBALLS_VERSION(i);
+        if(pdPASS != xTaskCreate(happy_eyeballs_task, task_names[i], HAPPY_EYEBALLS_TASK_STACK_SIZE,
+                                 &happy_eyeballs_attempts[i], HAPPY_EYEBALLS_TASK_PRIORITY,
+                                 &happy_eyeballs_attempts[i].task))
+        {
+            printf("Failed to create the %s!\n", task_names[i]);
+            CY_ASSERT(0);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: happy_eyeballs_connect_start
+ *******************************************************************************
+ * Summary:
+ *  Starts a race of the connection attempts of the address families of the
+ *  endpoint. The race is advanced by happy_eyeballs_connect_poll().
+ *
+ * Parameters:
+ *  const happy_eyeballs_endpoint_t *endpoint: Addresses of the TCP server
+ *  const happy_eyeballs_timeouts_t *timeouts: Timeouts of each attempt
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+cy_rslt_t happy_eyeballs_connect_start(const happy_eyeballs_endpoint_t *endpoint,
+                                       const happy_eyeballs_timeouts_t *timeouts)
+{
+    happy_eyeballs_race_t *race = &happy_eyeballs_state;
+    uint32_t first = HAPPY_EYEBALLS_INDEX(happy_eyeballs_preferred);
+    TickType_t now = xTaskGetTickCount();
+
+    if(!endpoint->has_v4 && !endpoint->has_v6)
+    {
+        return CY_RSLT_MODULE_SECURE_SOCKETS_BADARG;
+    }
+
+    if(race->active)
+    {
+        happy_eyeballs_connect_cancel();
+    }
+
+    xSemaphoreTake(happy_eyeballs_mutex, portMAX_DELAY);
+    happy_eyeballs_race++;
+    happy_eyeballs_decided = false;
+    xSemaphoreGive(happy_eyeballs_mutex);
+
+    race->endpoint = *endpoint;
+    race->timeouts = *timeouts;
+    race->last_error = CY_RSLT_MODULE_SECURE_SOCKETS_NOT_CONNECTED;
+    race->begin_us = app_time_us();
+    race->active = true;
+
+    for(uint32_t i = 0; i < HAPPY_EYEBALLS_FAMILIES; i++)
+    {
+        bool has_address = (i == HAPPY_EYEBALLS_INDEX(6u)) ? endpoint->has_v6 : endpoint->has_v4;
+
+        race->state[i] = has_address ? HAPPY_EYEBALLS_SCHEDULED : HAPPY_EYEBALLS_IDLE;
+        race->start_tick[i] = now;
+        race->busy_logged[i] = false;
+    }
+
+    /* Stagger the second family only if the preferred one has an address. */
+    if(race->state[first] == HAPPY_EYEBALLS_SCHEDULED)
+    {
+        race->start_tick[first ^ 1u] = now + pdMS_TO_TICKS(HAPPY_EYEBALLS_ATTEMPT_DELAY_MS);
+    }
+
+    happy_eyeballs_start_due(now);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: happy_eyeballs_connect_poll
+ *******************************************************************************
+ * Summary:
+ *  Advances the current race: waits up to the given time for an attempt to
+ *  complete, starts the scheduled attempts and abandons the attempts that
+ *  exceeded their timeouts.
+ *
+ * Parameters:
+ *  cy_socket_t *handle: Connected socket, when the race is won
+ *  uint8_t *version: IP version of the connected socket, when the race is won
+ *  TickType_t wait: Maximum time to wait
+ *
+ * Return:
+ *  cy_result result: CY_RSLT_SUCCESS when connected,
+ *  CY_RSLT_MODULE_SECURE_SOCKETS_WOULDBLOCK while the race is in progress, or
+ *  the error of the last failed attempt
+ *
+ *******************************************************************************/
+cy_rslt_t happy_eyeballs_connect_poll(cy_socket_t *handle, uint8_t *version, TickType_t wait)
+{
+    happy_eyeballs_race_t *race = &happy_eyeballs_state;
+    happy_eyeballs_outcome_t outcome;
+    TickType_t now = xTaskGetTickCount();
+    TickType_t next;
+    uint32_t index;
+    bool pending = false;
+
+    if(!race->active)
+    {
+        return CY_RSLT_MODULE_SECURE_SOCKETS_NOT_CONNECTED;
+    }
+
+    /* Wait no longer than the next scheduled start or attempt deadline. */
+    for(uint32_t i = 0; i < HAPPY_EYEBALLS_FAMILIES; i++)
+    {
+        if(race->state[i] == HAPPY_EYEBALLS_SCHEDULED)
+        {
+            next = race->start_tick[i] - now;
+        }
+        else if(race->state[i] == HAPPY_EYEBALLS_RUNNING)
+        {
+            next = race->deadline_tick[i] - now;
+        }
+        else
+        {
+            continue;
+        }
+        /* Past events show up as large unsigned differences. */
+        wait = ((int32_t)next <= 0) ? 0u : ((next < wait) ? next : wait);
+    }
+
+    if(pdTRUE == xQueueReceive(happy_eyeballs_outcomes, &outcome, wait))
+    {
+        now = xTaskGetTickCount();
+        index = HAPPY_EYEBALLS_INDEX(outcome.version);
+
+        if(race->state[index] != HAPPY_EYEBALLS_RUNNING)
+        {
+            /* Completed after its deadline. */
+            if(outcome.result == CY_RSLT_SUCCESS)
+            {
+                happy_eyeballs_close_loser(outcome.version, outcome.handle);
+            }
+        }
+        else if(outcome.result == CY_RSLT_SUCCESS)
+        {
+            race->state[index] = HAPPY_EYEBALLS_IDLE;
+            *handle = outcome.handle;
+            *version = outcome.version;
+            happy_eyeballs_preferred = outcome.version;
+            happy_eyeballs_finish();
+
+            APP_LOG_INFO("IPv%"PRIu32" won the connection race in %"PRIu32" us\n",
+                         (uint32_t)outcome.version, (uint32_t)(app_time_us() - race->begin_us));
+            return CY_RSLT_SUCCESS;
+        }
+        else
+        {
+            happy_eyeballs_attempt_failed(index, outcome.result, now);
+        }
+    }
+
+    now = xTaskGetTickCount();
+    for(uint32_t i = 0; i < HAPPY_EYEBALLS_FAMILIES; i++)
+    {
+        if((race->state[i] == HAPPY_EYEBALLS_RUNNING) && ((int32_t)(now - race->deadline_tick[i]) >= 0))
+        {
+            APP_LOG_WARN("IPv%"PRIu32" connection attempt timed out after %"PRIu32" ms\n",
+                         (uint32_t)HAPPY_EYEBALLS_VERSION(i),
+                         race->timeouts.tcp_ms + race->timeouts.tls_ms);
+            happy_eyeballs_attempt_failed(i, CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT, now);
+        }
+    }
+
+    happy_eyeballs_start_due(now);
+
+    for(uint32_t i = 0; i < HAPPY_EYEBALLS_FAMILIES; i++)
+    {
+        pending = pending || (race->state[i] != HAPPY_EYEBALLS_IDLE);
+    }
+
+    if(!pending)
+    {
+        happy_eyeballs_finish();
+        return race->last_error;
+    }
+
+    return CY_RSLT_MODULE_SECURE_SOCKETS_WOULDBLOCK;
+}
+
+/*******************************************************************************
+ * Function Name: happy_eyeballs_connect_cancel
+ *******************************************************************************
+ * Summary:
+ *  Abandons the current race. Attempts still running close their socket when
+ *  they complete.
+ *
+ *******************************************************************************/
+void happy_eyeballs_connect_cancel(void)
+{
+    if(happy_eyeballs_state.active)
+    {
+        happy_eyeballs_finish();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: happy_eyeballs_start_due
+ *******************************************************************************
+ * Summary:
+ *  Starts the scheduled attempts whose start time has come, the preferred
+ *  family first. An attempt whose task is still busy with an earlier race is
+ *  retried after HAPPY_EYEBALLS_BUSY_RETRY_MS.
+ *
+ * Parameters:
+ *  TickType_t now: Current tick count
+ *
+ *******************************************************************************/
+static void happy_eyeballs_start_due(TickType_t now)
+{
+    happy_eyeballs_race_t *race = &happy_eyeballs_state;
+    uint32_t first = HAPPY_EYEBALLS_INDEX(happy_eyeballs_preferred);
+
+    for(uint32_t n = 0; n < HAPPY_EYEBALLS_FAMILIES; n++)
+    {
+        uint32_t i = first ^ n;
+        happy_eyeballs_attempt_t *attempt = &happy_eyeballs_attempts[i];
+        bool started = false;
+
+        if((race->state[i] != HAPPY_EYEBALLS_SCHEDULED) || ((int32_t)(now - race->start_tick[i]) < 0))
+        {
+            continue;
+        }
+
+        xSemaphoreTake(happy_eyeballs_mutex, portMAX_DELAY);
+        if(!attempt->busy)
+        {
+            attempt->busy = true;
+            attempt->race = happy_eyeballs_race;
+            attempt->tls_ms = race->timeouts.tls_ms;
+            attempt->address.ip_address = (attempt->version == 6u) ? race->endpoint.v6 :
+                                                                     race->endpoint.v4;
+            attempt->address.port = race->endpoint.port;
+            started = true;
+        }
+        xSemaphoreGive(happy_eyeballs_mutex);
+
+        if(started)
+        {
+            race->state[i] = HAPPY_EYEBALLS_RUNNING;
+            race->deadline_tick[i] = now + pdMS_TO_TICKS(race->timeouts.tcp_ms + race->timeouts.tls_ms);
+            xTaskNotifyGive(attempt->task);
+        }
+        else
+        {
+            race->start_tick[i] = now + pdMS_TO_TICKS(HAPPY_EYEBALLS_BUSY_RETRY_MS);
+            if(!race->busy_logged[i])
+            {
+                race->busy_logged[i] = true;
+                APP_LOG_WARN("IPv%"PRIu32" connection attempt of an earlier race still "
+                             "running\n", (uint32_t)attempt->version);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: happy_eyeballs_attempt_failed
+ *******************************************************************************
+ * Summary:
+ *  Records a failed or timed out attempt and starts the other family right
+ *  away if it is still waiting for its staggered start.
+ *
+ * Parameters:
+ *  uint32_t index: Attempt index
+ *  cy_rslt_t result: Error of the attempt
+ *  TickType_t now: Current tick count
+ *
+ *******************************************************************************/
+static void happy_eyeballs_attempt_failed(uint32_t index, cy_rslt_t result, TickType_t now)
+{
+    happy_eyeballs_race_t *race = &happy_eyeballs_state;
+
+    race->state[index] = HAPPY_EYEBALLS_IDLE;
+    race->last_error = result;
+
+    if((race->state[index ^ 1u] == HAPPY_EYEBALLS_SCHEDULED) &&
+       ((int32_t)(race->start_tick[index ^ 1u] - now) > 0))
+    {
+        race->start_tick[index ^ 1u] = now;
+    }
+
+    if(result != CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT)
+    {
+        APP_LOG_WARN("IPv%"PRIu32" connection attempt failed! Error Code: %"PRIu32"\n",
+                     (uint32_t)HAPPY_EYEBALLS_VERSION(index), result);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: happy_eyeballs_finish
+ *******************************************************************************
+ * Summary:
+ *  Ends the current race. Connections of other attempts that completed in the
+ *  meantime are closed; attempts still running close theirs when they return.
+ *
+ *******************************************************************************/
+static void happy_eyeballs_finish(void)
+{
+    happy_eyeballs_outcome_t outcome;
+
+    xSemaphoreTake(happy_eyeballs_mutex, portMAX_DELAY);
+    happy_eyeballs_decided = true;
+    xSemaphoreGive(happy_eyeballs_mutex);
+
+    while(pdTRUE == xQueueReceive(happy_eyeballs_outcomes, &outcome, 0))
+    {
+        if(outcome.result == CY_RSLT_SUCCESS)
+        {
+            happy_eyeballs_close_loser(outcome.version, outcome.handle);
+        }
+    }
+
+    happy_eyeballs_state.active = false;
+}
+
+/*******************************************************************************
+ * Function Name: happy_eyeballs_task
+ *******************************************************************************
+ * Summary:
+ *  Connection attempt task of one address family. Reports the outcome of each
+ *  attempt to the race, or closes the socket if the race is already decided.
+ *
+ * Parameters:
+ *  void *arg: Attempt state of the address family
+ *
+ *******************************************************************************/
+static void happy_eyeballs_task(void *arg)
+{
+    happy_eyeballs_attempt_t *attempt = (happy_eyeballs_attempt_t *)arg;
+    happy_eyeballs_outcome_t outcome;
+    uint32_t receive_timeout_ms;
+    bool connect_failed;
+    bool lost;
+
+    for(;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        outcome.version = attempt->version;
+        outcome.race = attempt->race;
+        connect_failed = false;
+        outcome.result = happy_eyeballs_acquire(attempt->version, &outcome.handle);
+        if(outcome.result == CY_RSLT_SUCCESS)
+        {
+            /* Bound each read of the TLS handshake. */
+            receive_timeout_ms = attempt->tls_ms;
+            cy_socket_setsockopt(outcome.handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                                 &receive_timeout_ms, sizeof(receive_timeout_ms));
+
+            outcome.result = cy_socket_connect(outcome.handle, &attempt->address,
+                                               sizeof(cy_socket_sockaddr_t));
+            if(outcome.result == CY_RSLT_SUCCESS)
+            {
+                receive_timeout_ms = CY_SOCKET_DEFAULT_RECEIVE_TIMEOUT;
+                cy_socket_setsockopt(outcome.handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                                     &receive_timeout_ms, sizeof(receive_timeout_ms));
+            }
+            connect_failed = (outcome.result != CY_RSLT_SUCCESS);
+        }
+
+        xSemaphoreTake(happy_eyeballs_mutex, portMAX_DELAY);
+        lost = happy_eyeballs_decided || (outcome.race != happy_eyeballs_race);
+        if(!lost)
+        {
+            xQueueSend(happy_eyeballs_outcomes, &outcome, 0);
+        }
+        attempt->busy = false;
+        xSemaphoreGive(happy_eyeballs_mutex);
+
+        if(!lost)
+        {
+            happy_eyeballs_notify();
+        }
+        else if(outcome.result == CY_RSLT_SUCCESS)
+        {
+            happy_eyeballs_close_loser(attempt->version, outcome.handle);
+        }
+
+        /* The socket of a failed connection is deleted once the outcome is
+         * reported, so that the deletion does not delay the next attempt.
+         */
+        if(connect_failed)
+        {
+            happy_eyeballs_release(attempt->version, outcome.handle);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: happy_eyeballs_close_loser
+ *******************************************************************************
+ * Summary:
+ *  Closes a connection that lost the race or completed too late. Its callbacks
+ *  are removed first, so that the application only sees the connection it
+ *  kept.
+ *
+ * Parameters:
+ *  uint8_t version: IP version of the socket
+ *  cy_socket_t handle: Connected socket
+ *
+ *******************************************************************************/
+static void happy_eyeballs_close_loser(uint8_t version, cy_socket_t handle)
+{
+    cy_socket_opt_callback_t no_callback = { .callback = NULL, .arg = NULL };
+
+    cy_socket_setsockopt(handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RECEIVE_CALLBACK,
+                         &no_callback, sizeof(no_callback));
+    cy_socket_setsockopt(handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_DISCONNECT_CALLBACK,
+                         &no_callback, sizeof(no_callback));
+    cy_socket_disconnect(handle, 0);
+    happy_eyeballs_release(version, handle);
+
+    APP_LOG_INFO("Closed the IPv%"PRIu32" connection that lost the race\n", (uint32_t)version);
+}
+
+/* [] END OF FILE */
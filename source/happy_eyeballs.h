@@ -0,0 +1,120 @@
+/******************************************************************************
+* File Name:   happy_eyeballs.h
+*
+* Description: This file contains the macros, the data structures and the function
+* prototypes of the dual-stack (Happy Eyeballs) connector.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef HAPPY_EYEBALLS_H_
+#define HAPPY_EYEBALLS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* FreeRTOS header file. */
+#include <FreeRTOS.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* The connection attempt of the second address family starts this long after
+ * the first one, unless the first one fails earlier (RFC 8305 recommends
+ * 250 ms).
+ */
+#define HAPPY_EYEBALLS_ATTEMPT_DELAY_MS       (250u)
+
+/* Interval at which a scheduled attempt is retried while the attempt task of
+ * its family is still busy with an attempt of an earlier race.
+ */
+#define HAPPY_EYEBALLS_BUSY_RETRY_MS          (100u)
+
+/* Address family tried first until a race has been won. */
+#define HAPPY_EYEBALLS_PREFERRED_VERSION      (6u)
+
+/* RTOS related macros for the connection attempt tasks. The TLS handshake runs
+ * in these tasks, so they need the stack size of the network task.
+ */
+#define HAPPY_EYEBALLS_TASK_STACK_SIZE        (5 * 1024)
+#define HAPPY_EYEBALLS_TASK_PRIORITY          (1)
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+/* Addresses of the TCP server. At least one address family must be set. */
+typedef struct
+{
+    bool has_v4;
+    bool has_v6;
+    cy_socket_ip_address_t v4;
+    cy_socket_ip_address_t v6;
+    uint16_t port;
+} happy_eyeballs_endpoint_t;
+
+/* Timeouts of a connection attempt. cy_socket_connect() runs the TCP
+ * connection and the TLS handshake in one call, so an attempt is abandoned
+ * when both phases together exceed tcp_ms + tls_ms; tls_ms is also the
+ * receive timeout of the socket during the handshake.
+ */
+typedef struct
+{
+    uint32_t tcp_ms;
+    uint32_t tls_ms;
+} happy_eyeballs_timeouts_t;
+
+/* Provides a configured socket of the given IP version (4 or 6), and deletes
+ * it when the attempt has failed or lost the race.
+ */
+typedef cy_rslt_t (*happy_eyeballs_acquire_t)(uint8_t version, cy_socket_t *handle);
+typedef void (*happy_eyeballs_release_t)(uint8_t version, cy_socket_t handle);
+
+/* Called from the attempt task when an attempt has completed, so that the
+ * caller can poll the race without waiting.
+ */
+typedef void (*happy_eyeballs_notify_t)(void);
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void happy_eyeballs_init(happy_eyeballs_acquire_t acquire, happy_eyeballs_release_t release,
+                         happy_eyeballs_notify_t notify);
+cy_rslt_t happy_eyeballs_connect_start(const happy_eyeballs_endpoint_t *endpoint,
+                                       const happy_eyeballs_timeouts_t *timeouts);
+cy_rslt_t happy_eyeballs_connect_poll(cy_socket_t *handle, uint8_t *version, TickType_t wait);
+void happy_eyeballs_connect_cancel(void);
+
+#endif /* HAPPY_EYEBALLS_H_ */
@@ -3,7 +3,8 @@
 *
 * Description: This file contains the code for printing heap usage.
 *              Supports only GCC_ARM compiler. Define PRINT_HEAP_USAGE for
-*              printing the heap usage numbers.
+*              printing the heap usage numbers. get_heap_usage() returns the
+*              numbers for the telemetry publisher.
 *
 * Related Document: See README.md
 *
@@ -57,7 +58,12 @@
 /*******************************************************************************
  * Macros
  ******************************************************************************/
-#define TO_KB(size_bytes)  ((float)(size_bytes)/1024)
+/* Integer-only formatting helpers, so that printf() does not need floating
+ * point support. Values are printed with two decimal places.
+ */
+#define TO_KB_INT(size_bytes)         ((uint32_t)(size_bytes) / 1024u)
+#define TO_KB_FRAC(size_bytes)        ((((uint32_t)(size_bytes) % 1024u) * 100u) / 1024u)
+#define TO_PERCENT_X100(part, total)  ((uint32_t)(((uint64_t)(part) * 10000u) / (total)))
 
 
 /*******************************************************************************
@@ -86,16 +92,45 @@ void print_heap_usage(char *msg)
 
     printf("\r\n\n********** Heap Usage **********\r\n");
     printf(msg);
-    printf("\r\nTotal available heap        : %"PRIu32" bytes/%.2f KB\r\n", heap_size, TO_KB(heap_size));
+    printf("\r\nTotal available heap        : %"PRIu32" bytes/%"PRIu32".%02"PRIu32" KB\r\n",
+            heap_size, TO_KB_INT(heap_size), TO_KB_FRAC(heap_size));
 
-    printf("Maximum heap utilized so far: %u bytes/%.2f KB, %.2f%% of available heap\r\n",
-            mall_info.arena, TO_KB(mall_info.arena), ((float) mall_info.arena * 100u)/heap_size);
+    printf("Maximum heap utilized so far: %u bytes/%"PRIu32".%02"PRIu32" KB, "
+           "%"PRIu32".%02"PRIu32"%% of available heap\r\n",
+            mall_info.arena, TO_KB_INT(mall_info.arena), TO_KB_FRAC(mall_info.arena),
+            TO_PERCENT_X100(mall_info.arena, heap_size) / 100u,
+            TO_PERCENT_X100(mall_info.arena, heap_size) % 100u);
 
-    printf("Heap in use at this point   : %u bytes/%.2f KB, %.2f%% of available heap\r\n",
-            mall_info.uordblks, TO_KB(mall_info.uordblks), ((float) mall_info.uordblks * 100u)/heap_size);
+    printf("Heap in use at this point   : %u bytes/%"PRIu32".%02"PRIu32" KB, "
+           "%"PRIu32".%02"PRIu32"%% of available heap\r\n",
+            mall_info.uordblks, TO_KB_INT(mall_info.uordblks), TO_KB_FRAC(mall_info.uordblks),
+            TO_PERCENT_X100(mall_info.uordblks, heap_size) / 100u,
+            TO_PERCENT_X100(mall_info.uordblks, heap_size) % 100u);
 
     printf("********************************\r\n\n");
 #endif /* #if defined(PRINT_HEAP_USAGE) && defined (__GNUC__) && !defined(__ARMCC_VERSION) */
 }
 
+/*******************************************************************************
+* Function Name: get_heap_usage
+********************************************************************************
+* Summary:
+* Returns the heap in use and the maximum heap utilized so far by using
+* mallinfo(). Both values are zero with compilers other than GCC_ARM.
+*
+*******************************************************************************/
+void get_heap_usage(uint32_t *heap_in_use, uint32_t *heap_max_used)
+{
+    /* ARM compiler also defines __GNUC__ */
+#if defined (__GNUC__) && !defined(__ARMCC_VERSION)
+    struct mallinfo mall_info = mallinfo();
+
+    *heap_in_use = (uint32_t)mall_info.uordblks;
+    *heap_max_used = (uint32_t)mall_info.arena;
+#else
+    *heap_in_use = 0u;
+    *heap_max_used = 0u;
+#endif /* #if defined (__GNUC__) && !defined(__ARMCC_VERSION) */
+}
+
 /* [] END OF FILE */
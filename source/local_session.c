@@ -0,0 +1,391 @@
+/******************************************************************************
+* File Name:   local_session.c
+*
+* Description: This file contains the session to a TCP server on the SoftAP
+* subnet, which runs next to the session to the TCP server on the Wi-Fi network
+* when the SoftAP and the STA interface are up concurrently (AP+STA mode).
+*
+* The local session is a second TLS connection of the client, with the same
+* credentials, receive handler and socket options as the first one, so the
+* server on either interface controls the LED, pings and queries the metrics
+* the same way. Its socket is bound to the SoftAP address, so that its traffic
+* leaves on the SoftAP interface whatever the routes of the STA interface are.
+* The session is owned by its own task: cy_socket_connect() blocks until the
+* TLS handshake completes, and the session to the Wi-Fi network is not held up
+* while the local session connects or reconnects.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/* Wi-Fi connection manager header files. */
+#include "cy_wcm.h"
+
+/* IP address related header files. */
+#include "ip_addr.h"
+
+/* Secure TCP client, Wi-Fi credentials and local session header files. */
+#include "secure_tcp_client.h"
+#include "network_credentials.h"
+#include "local_session.h"
+#include "app_params.h"
+
+/* Logging and timestamp header files. */
+#include "app_log.h"
+#include "app_time.h"
+
+#if(USE_AP_STA_INTERFACE)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Notification bits of the local session task. */
+#define LOCAL_SESSION_SERVER_BIT           (1u << 0)
+#define LOCAL_SESSION_DISCONNECTED_BIT     (1u << 1)
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void local_session_task(void *arg);
+static cy_rslt_t local_session_connect(void);
+static void local_session_close(void);
+static cy_rslt_t local_session_disconnection_handler(cy_socket_t socket_handle, void *arg);
+void get_heap_usage(uint32_t *heap_in_use, uint32_t *heap_max_used);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static local_session_create_t local_session_create;
+static TaskHandle_t local_session_task_handle;
+
+/* Address of the server, set from the console task and taken over by the
+ * local session task.
+ */
+static cy_socket_sockaddr_t local_session_pending;
+
+/* State of the session, owned by the local session task. */
+static cy_socket_sockaddr_t local_session_server;
+static bool local_session_has_server;
+static bool local_session_connected;
+static cy_socket_t local_session_handle;
+static uint32_t local_session_backoff_ms;
+
+/*******************************************************************************
+ * Function Name: local_session_init
+ *******************************************************************************
+ * Summary:
+ *  Starts the local session task. The session connects once the address of
+ *  the server is set with local_session_set_server().
+ *
+ * Parameters:
+ *  local_session_create_t create: Creates a configured client socket
+ *
+ *******************************************************************************/
+void local_session_init(local_session_create_t create)
+{
+    local_session_create = create;
+
+    if(pdPASS != xTaskCreate(local_session_task, "Local session task",
+                             LOCAL_SESSION_TASK_STACK_SIZE, NULL,
+                             LOCAL_SESSION_TASK_PRIORITY, &local_session_task_handle))
+    {
+        printf("Failed to create the local session task!\n");
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: local_session_set_server
+ *******************************************************************************
+ * Summary:
+ *  Sets the IPv4 address of the TCP server on the SoftAP subnet. An open
+ *  local session is closed and the session connects to the new server.
+ *
+ * Parameters:
+ *  const char *input: IPv4 address of the server
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+cy_rslt_t local_session_set_server(const char *input)
+{
+    ip4_addr_t address;
+
+    if(0 == ip4addr_aton(input, &address))
+    {
+        printf("Invalid IPv4 address of the TCP server on the SoftAP: %s\n", input);
+        return CY_RSLT_MODULE_SECURE_SOCKETS_HOST_NOT_FOUND;
+    }
+
+    if((ip4_addr_get_u32(&address) & SOFTAP_NETMASK) != (SOFTAP_IP_ADDRESS & SOFTAP_NETMASK))
+    {
+        /* printf(): the deferred log only takes strings with static storage. */
+        printf("Warning: %s is not on the SoftAP subnet\n", input);
+    }
+
+    taskENTER_CRITICAL();
+    local_session_pending.ip_address.version = CY_SOCKET_IP_VER_V4;
+    local_session_pending.ip_address.ip.v4 = ip4_addr_get_u32(&address);
+    local_session_pending.port = LOCAL_SESSION_SERVER_PORT;
+    taskEXIT_CRITICAL();
+
+    xTaskNotify(local_session_task_handle, LOCAL_SESSION_SERVER_BIT, eSetBits);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: local_session_task
+ *******************************************************************************
+ * Summary:
+ *  Connects the local session, and reconnects it with a growing delay after a
+ *  failed attempt or a lost connection.
+ *
+ * Parameters:
+ *  void *arg: Unused
+ *
+ *******************************************************************************/
+static void local_session_task(void *arg)
+{
+    uint32_t notification;
+    TickType_t wait_ticks;
+
+    (void)arg;
+
+    for(;;)
+    {
+        /* An attempt is due when the wait times out. */
+        wait_ticks = (local_session_has_server && !local_session_connected) ?
+                     pdMS_TO_TICKS(local_session_backoff_ms) : portMAX_DELAY;
+
+        notification = 0u;
+        xTaskNotifyWait(0u, UINT32_MAX, &notification, wait_ticks);
+
+        if((notification & LOCAL_SESSION_DISCONNECTED_BIT) && local_session_connected)
+        {
+            local_session_close();
+            local_session_backoff_ms = LOCAL_SESSION_BACKOFF_MS;
+            APP_LOG_WARN("Local session lost, reconnecting in %"PRIu32" ms\n",
+                         local_session_backoff_ms);
+        }
+
+        if(notification & LOCAL_SESSION_SERVER_BIT)
+        {
+            if(local_session_connected)
+            {
+                local_session_close();
+            }
+
+            taskENTER_CRITICAL();
+            local_session_server = local_session_pending;
+            taskEXIT_CRITICAL();
+
+            local_session_has_server = true;
+            local_session_backoff_ms = 0u;
+        }
+
+        if((notification != 0u) || !local_session_has_server || local_session_connected)
+        {
+            continue;
+        }
+
+        if(local_session_connect() == CY_RSLT_SUCCESS)
+        {
+            local_session_backoff_ms = LOCAL_SESSION_BACKOFF_MS;
+        }
+        else
+        {
+            local_session_backoff_ms = (local_session_backoff_ms < LOCAL_SESSION_BACKOFF_MS) ?
+                                       LOCAL_SESSION_BACKOFF_MS : (local_session_backoff_ms * 2u);
+            if(local_session_backoff_ms > LOCAL_SESSION_BACKOFF_MAX_MS)
+            {
+                local_session_backoff_ms = LOCAL_SESSION_BACKOFF_MAX_MS;
+            }
+            APP_LOG_INFO("Retrying the local session in %"PRIu32" ms\n", local_session_backoff_ms);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: local_session_connect
+ *******************************************************************************
+ * Summary:
+ *  Opens the TLS connection to the server on the SoftAP subnet and prints the
+ *  connection time and the heap taken by the second TLS session.
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t local_session_connect(void)
+{
+    cy_rslt_t result;
+    cy_socket_sockaddr_t local_address = {
+        .ip_address.version = CY_SOCKET_IP_VER_V4,
+        .ip_address.ip.v4 = SOFTAP_IP_ADDRESS,
+        .port = 0u
+    };
+    cy_socket_opt_callback_t disconnection_option = {
+        .callback = local_session_disconnection_handler,
+        .arg = NULL
+    };
+    uint32_t receive_timeout_ms = APP_PARAM(APP_PARAM_TLS_HANDSHAKE_TIMEOUT_MS, TLS_HANDSHAKE_TIMEOUT_MS);
+    uint32_t heap_before;
+    uint32_t heap_in_use;
+    uint32_t heap_max_used;
+    uint64_t begin_us;
+
+    get_heap_usage(&heap_before, &heap_max_used);
+    begin_us = app_time_us();
+
+    result = local_session_create(4u, &local_session_handle);
+    if(result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    /* The disconnection of this socket is handled here, not by the state
+     * machine of the session to the Wi-Fi network.
+     */
+    result = cy_socket_setsockopt(local_session_handle, CY_SOCKET_SOL_SOCKET,
+                                  CY_SOCKET_SO_DISCONNECT_CALLBACK,
+                                  &disconnection_option, sizeof(disconnection_option));
+
+    /* Leave on the SoftAP interface. */
+    if(result == CY_RSLT_SUCCESS)
+    {
+        result = cy_socket_bind(local_session_handle, &local_address, sizeof(local_address));
+    }
+
+    if(result == CY_RSLT_SUCCESS)
+    {
+        /* Bound each read of the TLS handshake. */
+        cy_socket_setsockopt(local_session_handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                             &receive_timeout_ms, sizeof(receive_timeout_ms));
+
+        result = cy_socket_connect(local_session_handle, &local_session_server,
+                                   sizeof(cy_socket_sockaddr_t));
+    }
+
+    if(result != CY_RSLT_SUCCESS)
+    {
+        printf("Local session to %s failed! Error code: 0x%08"PRIx32"\n",
+               ip4addr_ntoa((const ip4_addr_t *)&local_session_server.ip_address.ip.v4),
+               (uint32_t)result);
+        cy_socket_delete(local_session_handle);
+        return result;
+    }
+
+    receive_timeout_ms = CY_SOCKET_DEFAULT_RECEIVE_TIMEOUT;
+    cy_socket_setsockopt(local_session_handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                         &receive_timeout_ms, sizeof(receive_timeout_ms));
+
+    local_session_connected = true;
+
+    get_heap_usage(&heap_in_use, &heap_max_used);
+    printf("Local session connected to %s over the SoftAP in %"PRIu32" us, "
+           "%"PRIu32" heap bytes\n",
+           ip4addr_ntoa((const ip4_addr_t *)&local_session_server.ip_address.ip.v4),
+           (uint32_t)(app_time_us() - begin_us), heap_in_use - heap_before);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: local_session_close
+ *******************************************************************************
+ * Summary:
+ *  Closes the local session. Its callbacks are removed first, so that the
+ *  task is not notified of its own disconnection.
+ *
+ *******************************************************************************/
+static void local_session_close(void)
+{
+    cy_socket_opt_callback_t no_callback = { .callback = NULL, .arg = NULL };
+
+    cy_socket_setsockopt(local_session_handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RECEIVE_CALLBACK,
+                         &no_callback, sizeof(no_callback));
+    cy_socket_setsockopt(local_session_handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_DISCONNECT_CALLBACK,
+                         &no_callback, sizeof(no_callback));
+    cy_socket_disconnect(local_session_handle, 0);
+    cy_socket_delete(local_session_handle);
+
+    local_session_connected = false;
+
+    APP_LOG_INFO("Local session closed\n");
+}
+
+/*******************************************************************************
+ * Function Name: local_session_disconnection_handler
+ *******************************************************************************
+ * Summary:
+ *  Disconnection callback of the local session. The socket is closed by the
+ *  local session task.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connection handle for the TCP client socket
+ *  void *args: Parameter passed on to the function (unused)
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t local_session_disconnection_handler(cy_socket_t socket_handle, void *arg)
+{
+    (void)socket_handle;
+    (void)arg;
+
+    xTaskNotify(local_session_task_handle, LOCAL_SESSION_DISCONNECTED_BIT, eSetBits);
+
+    return CY_RSLT_SUCCESS;
+}
+
+#endif /* USE_AP_STA_INTERFACE */
+
+/* [] END OF FILE */
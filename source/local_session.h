@@ -0,0 +1,84 @@
+/******************************************************************************
+* File Name:   local_session.h
+*
+* Description: This file contains the macros and the function prototypes of the
+* session to a TCP server on the SoftAP subnet in AP+STA mode.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LOCAL_SESSION_H_
+#define LOCAL_SESSION_H_
+
+#include <stdint.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Console command that sets the address of the TCP server on the SoftAP
+ * subnet, e.g. "ap 192.168.10.2".
+ */
+#define LOCAL_SESSION_CONSOLE_PREFIX          "ap "
+
+/* TCP port of the TCP server on the SoftAP subnet. */
+#define LOCAL_SESSION_SERVER_PORT             (50007)
+
+/* Delay before reconnecting after a failed attempt or a lost connection, in
+ * milliseconds. The delay doubles with every failure up to
+ * LOCAL_SESSION_BACKOFF_MAX_MS.
+ */
+#define LOCAL_SESSION_BACKOFF_MS              (500u)
+#define LOCAL_SESSION_BACKOFF_MAX_MS          (8000u)
+
+/* RTOS related macros for the local session task. The TLS handshake runs in
+ * this task, so it needs the stack size of the network task.
+ */
+#define LOCAL_SESSION_TASK_STACK_SIZE         (5 * 1024)
+#define LOCAL_SESSION_TASK_PRIORITY           (1)
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+/* Creates a configured client socket of the given IP version (4 or 6). */
+typedef cy_rslt_t (*local_session_create_t)(uint8_t version, cy_socket_t *handle);
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void local_session_init(local_session_create_t create);
+cy_rslt_t local_session_set_server(const char *input);
+
+#endif /* LOCAL_SESSION_H_ */
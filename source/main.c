@@ -44,6 +44,10 @@
 #include "cybsp.h"
 #include "cy_retarget_io.h"
 
+/* Standard C header files */
+#include <stdio.h>
+#include <inttypes.h>
+
 /* FreeRTOS header file */
 #include <FreeRTOS.h>
 #include <task.h>
@@ -51,10 +55,18 @@
 /* Secure TCP client task header file. */
 #include "secure_tcp_client.h"
 
+/* Deferred logging and timestamp header files. */
+#include "app_log.h"
+#include "app_time.h"
+
+/* Bulk download header file. */
+#include "flash_download.h"
+
 /* Include serial flash library and QSPI memory configurations only for the
- * kits that require the Wi-Fi firmware to be loaded in external QSPI NOR flash.
+ * kits that require the Wi-Fi firmware to be loaded in external QSPI NOR flash,
+ * or when blobs are downloaded into the serial flash.
  */
-#if defined(CY_DEVICE_PSOC6A512K)
+#if defined(CY_DEVICE_PSOC6A512K) || (ENABLE_FLASH_DOWNLOAD)
 #include "cy_serial_flash_qspi.h"
 #include "cycfg_qspi_memslot.h"
 #endif
@@ -88,6 +100,9 @@
 int main()
 {
     cy_rslt_t result;
+#if defined(CY_DEVICE_PSOC6A512K) || (ENABLE_FLASH_DOWNLOAD)
+    cy_rslt_t flash_result;
+#endif
 
     /* Initialize the board support package */
     result = cybsp_init();
@@ -107,13 +122,15 @@ int main()
     cyhal_gpio_init(CYBSP_USER_LED, CYHAL_GPIO_DIR_OUTPUT,
                         CYHAL_GPIO_DRIVE_STRONG, CYBSP_LED_STATE_OFF);
 
-    #if defined(CY_DEVICE_PSOC6A512K)
+    #if defined(CY_DEVICE_PSOC6A512K) || (ENABLE_FLASH_DOWNLOAD)
     const uint32_t bus_frequency = 50000000lu;
 
-    cy_serial_flash_qspi_init(smifMemConfigs[0], CYBSP_QSPI_D0, CYBSP_QSPI_D1,
-                                  CYBSP_QSPI_D2, CYBSP_QSPI_D3, NC, NC, NC, NC,
-                                  CYBSP_QSPI_SCK, CYBSP_QSPI_SS, bus_frequency);
+    flash_result = cy_serial_flash_qspi_init(smifMemConfigs[0], CYBSP_QSPI_D0, CYBSP_QSPI_D1,
+                                             CYBSP_QSPI_D2, CYBSP_QSPI_D3, NC, NC, NC, NC,
+                                             CYBSP_QSPI_SCK, CYBSP_QSPI_SS, bus_frequency);
+    #endif
 
+    #if defined(CY_DEVICE_PSOC6A512K)
     cy_serial_flash_qspi_enable_xip(true);
     #endif
 
@@ -123,6 +140,25 @@ int main()
     printf("CE229252 - Secure TCP Client\n");
     printf("===============================================================\n\n");
 
+    /* Enable the cycle counter used for timestamps. */
+    app_time_init();
+
+    /* Initialize the deferred logging subsystem and its log task. */
+    app_log_init();
+
+    #if defined(CY_DEVICE_PSOC6A512K) || (ENABLE_FLASH_DOWNLOAD)
+    if(flash_result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_ERR("Serial flash initialization failed! Error code: 0x%08"PRIx32"\n",
+                    (uint32_t)flash_result);
+
+        #if(ENABLE_FLASH_DOWNLOAD)
+            /* Blobs sent by the server are refused. */
+            flash_download_disable();
+        #endif /* ENABLE_FLASH_DOWNLOAD */
+    }
+    #endif
+
     /* Create the tasks */
     xTaskCreate(tcp_secure_client_task, "Network task", TCP_SECURE_CLIENT_TASK_STACK_SIZE,
                 NULL, TCP_SECURE_CLIENT_TASK_PRIORITY, NULL);
@@ -0,0 +1,318 @@
+/******************************************************************************
+* File Name:   metrics.c
+*
+* Description: This file contains the runtime metrics registry: counters,
+* gauges and log2-bucketed latency histograms in fixed memory, updated with
+* lock-free atomic operations from any task, and the compact snapshot that is
+* returned to the TCP server on request.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Standard C header files. */
+#include <stdatomic.h>
+
+/* Metrics, protocol and encoding header files. */
+#include "metrics.h"
+#include "app_protocol.h"
+#include "compact_codec.h"
+
+#if(ENABLE_METRICS)
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+typedef struct
+{
+    atomic_uint_least32_t count;
+    atomic_uint_least32_t max;
+    atomic_uint_least32_t buckets[METRICS_HISTOGRAM_BUCKETS];
+} metrics_histogram_data_t;
+
+typedef struct
+{
+    atomic_uint_least32_t code;     /* 0 while the slot is free. */
+    atomic_uint_least32_t count;
+} metrics_error_slot_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void get_heap_usage(uint32_t *heap_in_use, uint32_t *heap_max_used);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static atomic_uint_least32_t metrics_counters[METRIC_COUNTER_COUNT];
+static metrics_histogram_data_t metrics_histograms[METRIC_HISTOGRAM_COUNT];
+static metrics_error_slot_t metrics_errors[METRICS_ERROR_SLOTS];
+
+/* Task whose stack high-water mark is reported as METRIC_STACK_FREE_NETWORK. */
+static TaskHandle_t metrics_network_task;
+
+/*******************************************************************************
+ * Function Name: metrics_counter_add
+ *******************************************************************************
+ * Summary:
+ *  Adds a value to a counter. Counters wrap around at 2^32.
+ *
+ * Parameters:
+ *  metrics_counter_t id: Counter
+ *  uint32_t value: Value to add
+ *
+ *******************************************************************************/
+void metrics_counter_add(metrics_counter_t id, uint32_t value)
+{
+    atomic_fetch_add_explicit(&metrics_counters[id], value, memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * Function Name: metrics_record_sent
+ *******************************************************************************
+ * Summary:
+ *  Counts a message sent to the server.
+ *
+ * Parameters:
+ *  uint32_t bytes: Length of the message
+ *
+ *******************************************************************************/
+void metrics_record_sent(uint32_t bytes)
+{
+    metrics_counter_add(METRIC_BYTES_OUT, bytes);
+    metrics_counter_add(METRIC_RECORDS_OUT, 1u);
+}
+
+/*******************************************************************************
+ * Function Name: metrics_record_received
+ *******************************************************************************
+ * Summary:
+ *  Counts a message received from the server.
+ *
+ * Parameters:
+ *  uint32_t bytes: Length of the message
+ *
+ *******************************************************************************/
+void metrics_record_received(uint32_t bytes)
+{
+    metrics_counter_add(METRIC_BYTES_IN, bytes);
+    metrics_counter_add(METRIC_RECORDS_IN, 1u);
+}
+
+/*******************************************************************************
+ * Function Name: metrics_histogram_add
+ *******************************************************************************
+ * Summary:
+ *  Adds a sample to a histogram.
+ *
+ * Parameters:
+ *  metrics_histogram_t id: Histogram
+ *  uint32_t value: Sample
+ *
+ *******************************************************************************/
+void metrics_histogram_add(metrics_histogram_t id, uint32_t value)
+{
+    metrics_histogram_data_t *histogram = &metrics_histograms[id];
+    uint32_t bucket = (value == 0u) ? 0u : (32u - __CLZ(value));
+    uint_least32_t max = atomic_load_explicit(&histogram->max, memory_order_relaxed);
+
+    if(bucket >= METRICS_HISTOGRAM_BUCKETS)
+    {
+        bucket = METRICS_HISTOGRAM_BUCKETS - 1u;
+    }
+
+    atomic_fetch_add_explicit(&histogram->buckets[bucket], 1u, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->count, 1u, memory_order_relaxed);
+
+    /* On failure, 'max' is reloaded with the current maximum. */
+    while((value > max) &&
+          !atomic_compare_exchange_weak_explicit(&histogram->max, &max, value,
+                                                 memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+}
+
+/*******************************************************************************
+ * Function Name: metrics_handshake_failure
+ *******************************************************************************
+ * Summary:
+ *  Counts a failed connection attempt and its result code. The first
+ *  METRICS_ERROR_SLOTS distinct codes are counted separately.
+ *
+ * Parameters:
+ *  uint32_t code: Result code of the attempt
+ *
+ *******************************************************************************/
+void metrics_handshake_failure(uint32_t code)
+{
+    uint_least32_t slot_code;
+
+    metrics_counter_add(METRIC_HANDSHAKE_FAILURES, 1u);
+    if(code == 0u)
+    {
+        return;
+    }
+
+    for(uint32_t i = 0; i < METRICS_ERROR_SLOTS; i++)
+    {
+        slot_code = atomic_load_explicit(&metrics_errors[i].code, memory_order_relaxed);
+
+        /* Claim a free slot; another task may claim it first, with the same
+         * or another code.
+         */
+        if((slot_code == 0u) &&
+           atomic_compare_exchange_strong_explicit(&metrics_errors[i].code, &slot_code, code,
+                                                   memory_order_relaxed, memory_order_relaxed))
+        {
+            slot_code = code;
+        }
+
+        if(slot_code == code)
+        {
+            atomic_fetch_add_explicit(&metrics_errors[i].count, 1u, memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: metrics_set_network_task
+ *******************************************************************************
+ * Summary:
+ *  Sets the task whose stack high-water mark is reported as the network task
+ *  stack.
+ *
+ * Parameters:
+ *  TaskHandle_t task: Network task
+ *
+ *******************************************************************************/
+void metrics_set_network_task(TaskHandle_t task)
+{
+    metrics_network_task = task;
+}
+
+/*******************************************************************************
+ * Function Name: metrics_snapshot
+ *******************************************************************************
+ * Summary:
+ *  Samples the gauges and encodes all metrics into a snapshot frame. The
+ *  values are read one at a time, so a snapshot taken while other tasks
+ *  update the metrics may mix values from just before and just after an
+ *  update. The socket worker stack is that of the calling task, so this is
+ *  called from the receive callback.
+ *
+ * Parameters:
+ *  uint8_t *frame: Buffer of METRICS_SNAPSHOT_MAX_LEN bytes
+ *
+ * Return:
+ *  uint32_t: Length of the frame
+ *
+ *******************************************************************************/
+uint32_t metrics_snapshot(uint8_t *frame)
+{
+    uint32_t gauges[METRIC_GAUGE_COUNT] = {0};
+    uint8_t *ptr = &frame[METRICS_FRAME_HEADER_LEN];
+    uint8_t *failure_count;
+    uint32_t code;
+
+    get_heap_usage(&gauges[METRIC_HEAP_IN_USE], &gauges[METRIC_HEAP_MAX_USED]);
+    if(metrics_network_task != NULL)
+    {
+        gauges[METRIC_STACK_FREE_NETWORK] = (uint32_t)(uxTaskGetStackHighWaterMark(metrics_network_task) *
+                                                       sizeof(StackType_t));
+    }
+    gauges[METRIC_STACK_FREE_SOCKET] = (uint32_t)(uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t));
+
+    *ptr++ = METRICS_FORMAT_VERSION;
+    ptr += compact_codec_put_varint(ptr, (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS));
+
+    *ptr++ = METRIC_COUNTER_COUNT;
+    for(uint32_t i = 0; i < METRIC_COUNTER_COUNT; i++)
+    {
+        ptr += compact_codec_put_varint(ptr, (uint32_t)atomic_load_explicit(&metrics_counters[i],
+                                                                            memory_order_relaxed));
+    }
+
+    *ptr++ = METRIC_GAUGE_COUNT;
+    for(uint32_t i = 0; i < METRIC_GAUGE_COUNT; i++)
+    {
+        ptr += compact_codec_put_varint(ptr, gauges[i]);
+    }
+
+    *ptr++ = METRIC_HISTOGRAM_COUNT;
+    for(uint32_t i = 0; i < METRIC_HISTOGRAM_COUNT; i++)
+    {
+        metrics_histogram_data_t *histogram = &metrics_histograms[i];
+
+        *ptr++ = METRICS_HISTOGRAM_BUCKETS;
+        ptr += compact_codec_put_varint(ptr, (uint32_t)atomic_load_explicit(&histogram->count,
+                                                                            memory_order_relaxed));
+        ptr += compact_codec_put_varint(ptr, (uint32_t)atomic_load_explicit(&histogram->max,
+                                                                            memory_order_relaxed));
+        for(uint32_t j = 0; j < METRICS_HISTOGRAM_BUCKETS; j++)
+        {
+            ptr += compact_codec_put_varint(ptr, (uint32_t)atomic_load_explicit(&histogram->buckets[j],
+                                                                                memory_order_relaxed));
+        }
+    }
+
+    failure_count = ptr++;
+    *failure_count = 0u;
+    for(uint32_t i = 0; i < METRICS_ERROR_SLOTS; i++)
+    {
+        code = (uint32_t)atomic_load_explicit(&metrics_errors[i].code, memory_order_relaxed);
+        if(code != 0u)
+        {
+            ptr += compact_codec_put_varint(ptr, code);
+            ptr += compact_codec_put_varint(ptr, (uint32_t)atomic_load_explicit(&metrics_errors[i].count,
+                                                                                memory_order_relaxed));
+            (*failure_count)++;
+        }
+    }
+
+    frame[0] = METRICS_MSG;
+    app_protocol_put_u16(&frame[1], (uint16_t)(ptr - frame - METRICS_FRAME_HEADER_LEN));
+
+    return (uint32_t)(ptr - frame);
+}
+
+#endif /* ENABLE_METRICS */
+
+/* [] END OF FILE */
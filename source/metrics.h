@@ -0,0 +1,140 @@
+/******************************************************************************
+* File Name:   metrics.h
+*
+* Description: This file contains the macros, the metric identifiers and the
+* prototypes of the runtime metrics registry.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <stdint.h>
+
+/* FreeRTOS header file. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Protocol and encoding header files. */
+#include "app_protocol.h"
+#include "compact_codec.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set this macro to '0' to remove the metrics registry. */
+#define ENABLE_METRICS                        (1)
+
+/* Histograms use log2 buckets: bucket 0 counts the value 0 and bucket i the
+ * values in [2^(i-1), 2^i). The last bucket also counts all larger values,
+ * so with 24 buckets the resolution ends at 8.4 s for values in us.
+ */
+#define METRICS_HISTOGRAM_BUCKETS             (24u)
+
+/* Number of distinct handshake failure codes counted separately. Failures
+ * with other codes are counted together.
+ */
+#define METRICS_ERROR_SLOTS                   (8u)
+
+/* Largest snapshot frame: the frame header, the version and count bytes, the
+ * bucket count of every histogram, and every value as a full-length varint.
+ */
+#define METRICS_SNAPSHOT_MAX_LEN              (METRICS_FRAME_HEADER_LEN + 5u + \
+                                               COMPACT_CODEC_VARINT_MAX_LEN * \
+                                               (1u + METRIC_COUNTER_COUNT + METRIC_GAUGE_COUNT + \
+                                                METRIC_HISTOGRAM_COUNT * \
+                                                (2u + METRICS_HISTOGRAM_BUCKETS) + \
+                                                2u * METRICS_ERROR_SLOTS) + \
+                                               METRIC_HISTOGRAM_COUNT)
+
+#if(ENABLE_METRICS)
+    #define METRICS_COUNTER_ADD(id, value)    metrics_counter_add((id), (value))
+    #define METRICS_HISTOGRAM_ADD(id, value)  metrics_histogram_add((id), (value))
+    #define METRICS_HANDSHAKE_FAILURE(code)   metrics_handshake_failure(code)
+    #define METRICS_RECORD_SENT(bytes)        metrics_record_sent(bytes)
+    #define METRICS_RECORD_RECEIVED(bytes)    metrics_record_received(bytes)
+#else
+    #define METRICS_COUNTER_ADD(id, value)    do { (void)(value); } while(0)
+    #define METRICS_HISTOGRAM_ADD(id, value)  do { (void)(value); } while(0)
+    #define METRICS_HANDSHAKE_FAILURE(code)   do { (void)(code); } while(0)
+    #define METRICS_RECORD_SENT(bytes)        do { (void)(bytes); } while(0)
+    #define METRICS_RECORD_RECEIVED(bytes)    do { (void)(bytes); } while(0)
+#endif /* ENABLE_METRICS */
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+/* Monotonic counters. The snapshot sends them in this order. */
+typedef enum
+{
+    METRIC_BYTES_IN,            /* Application bytes received. */
+    METRIC_BYTES_OUT,           /* Application bytes sent. */
+    METRIC_RECORDS_IN,          /* Messages received; one TLS record each. */
+    METRIC_RECORDS_OUT,         /* Messages sent; one TLS record each. */
+    METRIC_HANDSHAKES,          /* Successful TLS handshakes. */
+    METRIC_HANDSHAKE_FAILURES,  /* Failed connection attempts, by code below. */
+    METRIC_RECONNECTS,          /* Connections restored after a lost connection. */
+    METRIC_COUNTER_COUNT
+} metrics_counter_t;
+
+/* Gauges, sampled when the snapshot is taken. */
+typedef enum
+{
+    METRIC_HEAP_IN_USE,         /* Bytes. */
+    METRIC_HEAP_MAX_USED,       /* Bytes. */
+    METRIC_STACK_FREE_NETWORK,  /* Stack high-water mark of the network task, bytes. */
+    METRIC_STACK_FREE_SOCKET,   /* Stack high-water mark of the socket worker, bytes. */
+    METRIC_GAUGE_COUNT
+} metrics_gauge_t;
+
+/* Latency histograms, in us. */
+typedef enum
+{
+    METRIC_CONNECT_US,          /* TCP connection and TLS handshake. */
+    METRIC_ACK_US,              /* Command received to acknowledgement sent. */
+    METRIC_HISTOGRAM_COUNT
+} metrics_histogram_t;
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void metrics_counter_add(metrics_counter_t id, uint32_t value);
+void metrics_histogram_add(metrics_histogram_t id, uint32_t value);
+void metrics_handshake_failure(uint32_t code);
+void metrics_record_sent(uint32_t bytes);
+void metrics_record_received(uint32_t bytes);
+void metrics_set_network_task(TaskHandle_t task);
+uint32_t metrics_snapshot(uint8_t *frame);
+
+#endif /* METRICS_H_ */
@@ -57,32 +57,46 @@
                                                        (((uint32_t) c) << 16) | \
                                                        (((uint32_t) b) << 8) | \
                                                        ((uint32_t) a))
-#if(USE_IPV6_ADDRESS)
-    /* Converts a 16-bit value from host byte order (little-endian) to network byte order (big-endian) */
-    #define HTONS(x) ( ( ( (x) & 0x0000FF00) >> 8 ) | ((x) & 0x000000FF) << 8 )
 
-    #define MAKE_IPV6_ADDRESS(a, b, c, d, e, f, g, h)  { \
+/* Converts a 16-bit value from host byte order (little-endian) to network byte order (big-endian) */
+#define HTONS(x) ( ( ( (x) & 0x0000FF00) >> 8 ) | ((x) & 0x000000FF) << 8 )
+
+#define MAKE_IPV6_ADDRESS(a, b, c, d, e, f, g, h)      { \
                                                          ( (uint32_t) (HTONS(a)) | ( (uint32_t) (HTONS(b)) << 16 ) ), \
                                                          ( (uint32_t) (HTONS(c)) | ( (uint32_t) (HTONS(d)) << 16 ) ), \
                                                          ( (uint32_t) (HTONS(e)) | ( (uint32_t) (HTONS(f)) << 16 ) ), \
                                                          ( (uint32_t) (HTONS(g)) | ( (uint32_t) (HTONS(h)) << 16 ) ), \
                                                        }
-#endif /* USE_IPV6_ADDRESS */
 
 /* To use the Wi-Fi device in AP interface mode, set this macro as '1' */
 #define USE_AP_INTERFACE                               (0)
 
+/* To run the SoftAP and the STA interface concurrently, set this macro as
+ * '1'. The device then keeps its session to the TCP server on the Wi-Fi
+ * network and accepts a second session to a TCP server on the SoftAP subnet.
+ * USE_AP_INTERFACE is ignored in this mode.
+ */
+#define USE_AP_STA_INTERFACE                           (0)
+
+/* Interfaces brought up by the application */
+#define ENABLE_SOFTAP                                  (USE_AP_STA_INTERFACE || USE_AP_INTERFACE)
+#define ENABLE_STA                                     (USE_AP_STA_INTERFACE || !USE_AP_INTERFACE)
+
 /* Change the server IP address to match the TCP server address (IP address
  * of the PC).
  */
-#if(USE_IPV6_ADDRESS)
-    #define TCP_SERVER_IP_ADDRESS                      MAKE_IPV6_ADDRESS(0xFE80, 0, 0 ,0, 0xF0F3, 0xB58C, 0x8FC2, 0xA690)
+#define TCP_SERVER_IP_ADDRESS                          MAKE_IPV4_ADDRESS(192, 168, 43, 105)
+#define TCP_SERVER_IPV6_ADDRESS                        MAKE_IPV6_ADDRESS(0xFE80, 0, 0 ,0, 0xF0F3, 0xB58C, 0x8FC2, 0xA690)
+
+#if(USE_AP_STA_INTERFACE)
+    #define WIFI_INTERFACE_TYPE                        CY_WCM_INTERFACE_TYPE_AP_STA
+#elif(USE_AP_INTERFACE)
+    #define WIFI_INTERFACE_TYPE                        CY_WCM_INTERFACE_TYPE_AP
 #else
-    #define TCP_SERVER_IP_ADDRESS                      MAKE_IPV4_ADDRESS(192, 168, 43, 105)
+    #define WIFI_INTERFACE_TYPE                        CY_WCM_INTERFACE_TYPE_STA
 #endif
 
-#if(USE_AP_INTERFACE)
-    #define WIFI_INTERFACE_TYPE                        CY_WCM_INTERFACE_TYPE_AP
+#if(ENABLE_SOFTAP)
     /* SoftAP Credentials: Modify SOFTAP_SSID and SOFTAP_PASSWORD as required */
     #define SOFTAP_SSID                                "MY_SOFT_AP"
     #define SOFTAP_PASSWORD                            "psoc1234"
@@ -97,9 +111,14 @@
     #define SOFTAP_IP_ADDRESS                          MAKE_IPV4_ADDRESS(192, 168, 10, 1)
     #define SOFTAP_NETMASK                             MAKE_IPV4_ADDRESS(255, 255, 255, 0)
     #define SOFTAP_GATEWAY                             MAKE_IPV4_ADDRESS(192, 168, 10, 1)
+
+    /* In AP+STA mode the radio stays on the channel of the Wi-Fi network
+     * and the SoftAP follows it; this channel is then not used.
+     */
     #define SOFTAP_RADIO_CHANNEL                       (1u)
-#else
-    #define WIFI_INTERFACE_TYPE                        CY_WCM_INTERFACE_TYPE_STA
+#endif
+
+#if(ENABLE_STA)
     /* Wi-Fi Credentials: Modify WIFI_SSID, WIFI_PASSWORD, and WIFI_SECURITY_TYPE
      * to match your Wi-Fi network credentials.
      * Note: Maximum length of the Wi-Fi SSID and password is set to
@@ -45,6 +45,7 @@
 #include <FreeRTOS.h>
 #include <task.h>
 #include <semphr.h>
+#include <event_groups.h>
 
 /* Standard C header file. */
 #include <string.h>
@@ -53,6 +54,12 @@
 #include "cy_secure_sockets.h"
 #include "cy_tls.h"
 
+/* Mbed TLS configuration, for MBEDTLS_SSL_PROTO_TLS1_3. */
+#include "mbedtls/build_info.h"
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+#include "psa/crypto.h"
+#endif /* MBEDTLS_SSL_PROTO_TLS1_3 */
+
 /* Wi-Fi connection manager header files. */
 #include "cy_wcm.h"
 #include "cy_wcm_error.h"
@@ -69,31 +76,128 @@
 /* to use the portable formatting macros */
 #include <inttypes.h>
 
+/* Deferred logging header file. */
+#include "app_log.h"
+
+/* Application protocol and timestamp header files. */
+#include "app_protocol.h"
+#include "app_time.h"
+
+/* Telemetry publisher header file. */
+#include "telemetry.h"
+
+/* Crypto benchmark header file. */
+#include "crypto_benchmark.h"
+
+/* Server certificate cache header file. */
+#include "cert_cache.h"
+
+/* Secure socket pool header file. */
+#include "socket_pool.h"
+
+/* DNS resolver cache header file. */
+#include "dns_cache.h"
+
+/* Dual-stack connector header file. */
+#include "happy_eyeballs.h"
+
+/* Connection state and event queue header file. */
+#include "connection_events.h"
+
+/* Command trace header file. */
+#include "cmd_trace.h"
+
+/* Runtime metrics header file. */
+#include "metrics.h"
+
+/* Server command handler header file. */
+#include "command_handler.h"
+
+/* Traffic capture header file. */
+#include "traffic_capture.h"
+
+/* SoftAP session header file. */
+#include "local_session.h"
+
+/* Bulk download header file. */
+#include "flash_download.h"
+
+/* DTLS command transport header file. */
+#include "dtls_command.h"
+
+/* Network tuning profile (configs/net_profile.h). */
+#include "net_profile.h"
+
+/* Runtime parameter header file. */
+#include "app_params.h"
+
 /******************************************************************************
 * Macros
 ******************************************************************************/
-#define LED_ON_CMD                         '1'
-#define LED_OFF_CMD                        '0'
-#define ACK_LED_ON                         "LED ON ACK"
-#define ACK_LED_OFF                        "LED OFF ACK"
-#define MSG_INVALID_CMD                    "Invalid command"
+/* RTOS related macros for the TLS credentials task used by the startup
+ * pipeline. X.509 and EC key parsing need a deep stack.
+ */
+#define TLS_CREDENTIALS_TASK_STACK_SIZE    (4 * 1024)
+#define TLS_CREDENTIALS_TASK_PRIORITY      (1)
+
+/* Event bits set by the startup stages. */
+#define STARTUP_CREDENTIALS_READY_BIT      (1u << 0)
+
+/* RTOS related macros for the UART console task. */
+#define CONSOLE_TASK_STACK_SIZE            (1024u)
+#define CONSOLE_TASK_PRIORITY              (1)
 
 
 /******************************************************************************
 * Function Prototypes
 ******************************************************************************/
-cy_rslt_t connect_to_secure_tcp_server(cy_socket_sockaddr_t address);
-cy_rslt_t create_secure_tcp_client_socket();
-cy_rslt_t tcp_client_recv_handler(cy_socket_t socket_handle, void *arg);
+static void connection_handle_event(const connection_event_t *event);
+static void connection_idle(connection_event_type_t cause);
+static void connection_start(connection_event_type_t cause);
+static void connection_attempt(connection_event_type_t cause);
+static void connection_poll(connection_event_type_t cause);
+static void connection_backoff(connection_event_type_t cause);
+static void connection_established(connection_event_type_t cause);
+static void connection_closed(cy_socket_t handle);
+static void connection_lost(connection_event_type_t cause);
+#if(ENABLE_HEARTBEAT)
+static void heartbeat_send(void);
+#endif /* ENABLE_HEARTBEAT */
+static void connection_notify(void);
+static void console_task(void *arg);
+cy_rslt_t create_secure_tcp_client_socket(uint8_t version, cy_socket_t *handle);
+static cy_rslt_t acquire_client_socket(uint8_t version, cy_socket_t *handle);
+static void release_client_socket(uint8_t version, cy_socket_t handle);
+static cy_rslt_t parse_tcp_server_endpoint(const char *input, happy_eyeballs_endpoint_t *endpoint);
 cy_rslt_t tcp_disconnection_handler(cy_socket_t socket_handle, void *arg);
-void read_uart_input(uint8_t* input_buffer_ptr);
+#if(ENABLE_CONNECT_STATE_REPORT)
+static cy_rslt_t send_state_report(uint64_t connect_begin_us, uint32_t handshake_us);
+#endif /* ENABLE_CONNECT_STATE_REPORT */
+void read_uart_input(uint8_t* input_buffer_ptr, size_t buffer_size);
 void print_heap_usage(char *msg);
-
-#if(USE_AP_INTERFACE)
+void get_heap_usage(uint32_t *heap_in_use, uint32_t *heap_max_used);
+static cy_rslt_t tls_credentials_init(void);
+#if(ENABLE_DNS_CACHE)
+static void connection_resolve(connection_event_type_t cause);
+static dns_cache_status_t resolve_tcp_server_endpoint(happy_eyeballs_endpoint_t *endpoint);
+static dns_cache_status_t resolve_tcp_server_hostname(const char *hostname, uint8_t version,
+                                                      cy_socket_ip_address_t *ip_address);
+static void resolve_tcp_server_done(void);
+#endif /* ENABLE_DNS_CACHE */
+static void print_startup_report(void);
+
+#if(ENABLE_STARTUP_OVERLAP)
+    static void tls_credentials_task(void *arg);
+#endif /* ENABLE_STARTUP_OVERLAP */
+
+#if(ENABLE_SOFTAP)
     static cy_rslt_t softap_start(void);
-#else
+#endif /* ENABLE_SOFTAP */
+
+#if(ENABLE_STA)
     static cy_rslt_t connect_to_wifi_ap(void);
-#endif /* USE_AP_INTERFACE */
+    static void wifi_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t *event_data);
+#endif /* ENABLE_STA */
 
 
 /******************************************************************************
@@ -112,90 +216,928 @@ void *tls_identity;
 /* TCP client socket handle */
 cy_socket_t client_handle;
 
-/* Binary semaphore handle to keep track of secure TCP server connection. */
-SemaphoreHandle_t connect_to_server;
+/* IP version (4 or 6) of the connected socket. */
+static uint8_t client_version;
+
+/* IP addresses and TCP port number of the TCP server to which the TCP
+ * client connects to. The address families to be used are set from the
+ * UART input.
+ */
+static happy_eyeballs_endpoint_t tcp_server_endpoint = {
+        .v4.ip.v4 = TCP_SERVER_IP_ADDRESS,
+        .v4.version = CY_SOCKET_IP_VER_V4,
+        .v6.ip.v6 = TCP_SERVER_IPV6_ADDRESS,
+        .v6.version = CY_SOCKET_IP_VER_V6,
+        .port = TCP_SERVER_PORT
+};
+
+#if(ENABLE_DNS_CACHE)
+    /* Host name of the TCP server; empty when an IP address was entered.
+     * The name is resolved again before every retry and reconnect, so that
+     * the client follows a change of the address of the server.
+     */
+    static char tcp_server_hostname[DNS_CACHE_NAME_LEN];
+
+    /* Set when the host name was resolved for the next connection attempt. */
+    static bool tcp_server_resolved;
+#endif /* ENABLE_DNS_CACHE */
+
+/* Progress of the connection to the TCP server across retries. */
+static uint32_t connect_retries;
+static TickType_t connect_deadline;
+static uint32_t connect_backoff_ms;
+static uint64_t connect_begin_us;
+
+/* Cleared while the Wi-Fi link is down; retries wait for it. */
+static bool wifi_link_up = true;
+
+/* Tick count at which the client started waiting for the server address. */
+static TickType_t idle_begin_tick;
+
+/* Tick count at which the loss of the connection was detected; 0 when the
+ * connection was not lost.
+ */
+static TickType_t connection_lost_tick;
+
+#if(ENABLE_HEARTBEAT)
+    /* Sequence number of the last heartbeat and the number of heartbeats in
+     * a row that were not answered.
+     */
+    static uint32_t heartbeat_sequence;
+    static uint32_t heartbeat_misses;
+    static uint64_t heartbeat_sent_us;
+#endif /* ENABLE_HEARTBEAT */
 
 /* Holds the IP address obtained for SoftAP using Wi-Fi Connection Manager (WCM). */
 cy_wcm_ip_address_t softap_ip_address;
 
+#if(ENABLE_STARTUP_OVERLAP)
+    /* Event group used to wait for the startup stages that run concurrently. */
+    static EventGroupHandle_t startup_events;
+
+    /* Result of the TLS credentials stage. */
+    static volatile cy_rslt_t tls_credentials_result;
+#endif /* ENABLE_STARTUP_OVERLAP */
+
+/* Tick counts recorded by the startup pipeline for the boot-to-connected
+ * report. The time spent waiting for the user to type the server address
+ * is excluded from the total.
+ */
+static TickType_t startup_begin_tick;
+static TickType_t tls_credentials_ticks;
+static TickType_t wifi_ready_ticks;
+static TickType_t network_ready_ticks;
+static TickType_t uart_input_ticks;
+static bool startup_report_printed = false;
+
+/* Number of successful connections to the TCP server since boot. */
+static uint16_t connection_count;
+
+/*******************************************************************************
+ * Function Name: tcp_secure_client_task
+ *******************************************************************************
+ * Summary:
+ *  Task used to establish a secure connection to a remote TCP server and
+ *  control the LED state (ON/OFF) based on the command received from TCP server.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void tcp_secure_client_task(void *arg)
+{
+    cy_rslt_t result;
+    connection_event_t event;
+
+    /* The configuration in which WCM should be initialized */
+    cy_wcm_config_t wifi_config = { .interface = WIFI_INTERFACE_TYPE };
+
+    #if(ENABLE_APP_PARAMS)
+        /* The saved parameters apply from the first Wi-Fi connection on. */
+        app_params_init();
+    #endif /* ENABLE_APP_PARAMS */
+
+    #if(ENABLE_CRYPTO_BENCHMARK)
+        /* Run the crypto benchmark before the startup is timed and before
+         * any other task uses the CPU.
+         */
+        crypto_benchmark_run();
+    #endif /* ENABLE_CRYPTO_BENCHMARK */
+
+    #if(ENABLE_CMD_TRACE)
+        cmd_trace_init();
+    #endif /* ENABLE_CMD_TRACE */
+
+    #if(ENABLE_METRICS)
+        metrics_set_network_task(xTaskGetCurrentTaskHandle());
+    #endif /* ENABLE_METRICS */
+
+    #if(ENABLE_TRAFFIC_CAPTURE)
+        traffic_capture_init();
+    #endif /* ENABLE_TRAFFIC_CAPTURE */
+
+    #if(ENABLE_FLASH_DOWNLOAD)
+        flash_download_init();
+    #endif /* ENABLE_FLASH_DOWNLOAD */
+
+    #if(ENABLE_DTLS_COMMANDS)
+        dtls_command_init();
+    #endif /* ENABLE_DTLS_COMMANDS */
+
+    startup_begin_tick = xTaskGetTickCount();
+
+    #if(ENABLE_STARTUP_OVERLAP)
+        /* Parse the TLS credentials in a separate task while the Wi-Fi device
+         * is being initialized and associated with the AP.
+         */
+        startup_events = xEventGroupCreate();
+        if(pdPASS != xTaskCreate(tls_credentials_task, "TLS init task",
+                                 TLS_CREDENTIALS_TASK_STACK_SIZE, NULL,
+                                 TLS_CREDENTIALS_TASK_PRIORITY, NULL))
+        {
+            printf("Failed to create the TLS credentials task!\n");
+            CY_ASSERT(0);
+        }
+    #endif /* ENABLE_STARTUP_OVERLAP */
+
+    /* Initialize Wi-Fi connection manager. */
+    result = cy_wcm_init(&wifi_config);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("Wi-Fi Connection Manager initialization failed! Error code: 0x%08"PRIx32"\n", (uint32_t)result);
+        CY_ASSERT(0);
+    }
+    printf("Wi-Fi Connection Manager initialized.\r\n");
+
+    #if(ENABLE_STA)
+        /* Connect to Wi-Fi AP. In AP+STA mode this comes first, so that the
+         * SoftAP is started on the channel of the Wi-Fi network.
+         */
+        if(connect_to_wifi_ap() != CY_RSLT_SUCCESS )
+        {
+            printf("\n Failed to connect to Wi-Fi AP.\n");
+            CY_ASSERT(0);
+        }
+    #endif /* ENABLE_STA */
+
+    #if(ENABLE_SOFTAP)
+        /* Start the Wi-Fi device as a Soft AP interface. */
+        result = softap_start();
+        if (result != CY_RSLT_SUCCESS)
+        {
+            printf("Failed to Start Soft AP! Error code: 0x%08"PRIx32"\n", (uint32_t)result);
+            CY_ASSERT(0);
+        }
+    #endif /* ENABLE_SOFTAP */
+
+    wifi_ready_ticks = xTaskGetTickCount() - startup_begin_tick;
+
+    #if(ENABLE_STARTUP_OVERLAP)
+        /* Wait for the TLS credentials stage to complete. */
+        xEventGroupWaitBits(startup_events, STARTUP_CREDENTIALS_READY_BIT,
+                            pdFALSE, pdTRUE, portMAX_DELAY);
+        result = tls_credentials_result;
+    #else
+        result = tls_credentials_init();
+    #endif /* ENABLE_STARTUP_OVERLAP */
+
+    if(result != CY_RSLT_SUCCESS)
+    {
+        printf("TLS credentials initialization failed! Error code: %"PRIu32"\n", result);
+        CY_ASSERT(0);
+    }
+
+    #if(ENABLE_SOCKET_POOL)
+        /* Create and configure the client sockets ahead of the first
+         * connection attempt.
+         */
+        result = socket_pool_init(create_secure_tcp_client_socket);
+        if(result != CY_RSLT_SUCCESS)
+        {
+            printf("Socket pool initialization failed! Error code: %"PRIu32"\n", result);
+            CY_ASSERT(0);
+        }
+    #endif /* ENABLE_SOCKET_POOL */
+
+    /* Socket callbacks, timers, Wi-Fi events and the UART console post their
+     * events to the connection event queue.
+     */
+    connection_events_init();
+
+    /* Start the connection attempt tasks of both address families. */
+    happy_eyeballs_init(acquire_client_socket, release_client_socket, connection_notify);
+
+    #if(ENABLE_DNS_CACHE)
+        dns_cache_init();
+    #endif /* ENABLE_DNS_CACHE */
+
+    network_ready_ticks = xTaskGetTickCount() - startup_begin_tick;
+    APP_LOG_INFO("Network tuning profile: %s\n", NET_PROFILE_NAME);
+
+    #if(ENABLE_TELEMETRY)
+        /* Start sampling; batches are sent once connected. */
+        telemetry_init();
+    #endif /* ENABLE_TELEMETRY */
+
+    #if(ENABLE_STA)
+        /* Pause the connection retries while the Wi-Fi link is down. */
+        cy_wcm_register_event_callback(wifi_event_callback);
+    #endif /* ENABLE_STA */
+
+    #if(USE_AP_STA_INTERFACE)
+        /* Session to a TCP server on the SoftAP subnet, next to the one on
+         * the Wi-Fi network.
+         */
+        local_session_init(create_secure_tcp_client_socket);
+    #endif /* USE_AP_STA_INTERFACE */
+
+    if(pdPASS != xTaskCreate(console_task, "Console task", CONSOLE_TASK_STACK_SIZE, NULL,
+                             CONSOLE_TASK_PRIORITY, NULL))
+    {
+        printf("Failed to create the console task!\n");
+        CY_ASSERT(0);
+    }
+
+    /* Prevent system from entering deep sleep mode
+     * when receiving data from UART.
+     */
+    cyhal_syspm_lock_deepsleep();
+
+    connection_idle(CONNECTION_EVENT_STARTUP);
+
+    for(;;)
+    {
+        connection_event_receive(&event, portMAX_DELAY);
+        connection_handle_event(&event);
+    }
+ }
+
+/*******************************************************************************
+ * Function Name: connection_handle_event
+ *******************************************************************************
+ * Summary:
+ *  Processes an event in the current connection state. HANDSHAKING is left
+ *  before the next event is processed; RESOLVING waits for the DNS cache
+ *  task when the host name of the server is not cached.
+ *
+ * Parameters:
+ *  const connection_event_t *event: Event to process
+ *
+ *******************************************************************************/
+static void connection_handle_event(const connection_event_t *event)
+{
+    cy_rslt_t result;
+
+    switch(connection_state_get())
+    {
+        case CONNECTION_STATE_IDLE:
+            if(event->type == CONNECTION_EVENT_CONSOLE_LINE)
+            {
+                uart_input_ticks += xTaskGetTickCount() - idle_begin_tick;
+
+                connection_state_enter(CONNECTION_STATE_RESOLVING, event->type);
+                result = parse_tcp_server_endpoint(event->data.line, &tcp_server_endpoint);
+                if(result != CY_RSLT_SUCCESS)
+                {
+                    printf("No IPv4 or IPv6 address for %s\n", event->data.line);
+                    connection_idle(event->type);
+                }
+                else
+                {
+                    connection_start(event->type);
+                }
+            }
+            break;
+
+    #if(ENABLE_DNS_CACHE)
+        case CONNECTION_STATE_RESOLVING:
+            if(event->type == CONNECTION_EVENT_RESOLVED)
+            {
+                connection_resolve(event->type);
+            }
+            else if(event->type == CONNECTION_EVENT_CONSOLE_LINE)
+            {
+                APP_LOG_WARN("Connection to the TCP server cancelled\n");
+                connection_idle(event->type);
+            }
+            break;
+    #endif /* ENABLE_DNS_CACHE */
+
+        case CONNECTION_STATE_CONNECTING:
+            if((event->type == CONNECTION_EVENT_CONNECT) || (event->type == CONNECTION_EVENT_TIMER))
+            {
+                connection_poll(event->type);
+            }
+            else if(event->type == CONNECTION_EVENT_WIFI_DOWN)
+            {
+                /* Retried when the link is restored. */
+                happy_eyeballs_connect_cancel();
+                connection_timer_stop();
+                connection_state_enter(CONNECTION_STATE_BACKOFF, event->type);
+            }
+            else if(event->type == CONNECTION_EVENT_CONSOLE_LINE)
+            {
+                happy_eyeballs_connect_cancel();
+                connection_timer_stop();
+                APP_LOG_WARN("Connection to the TCP server cancelled\n");
+                connection_idle(event->type);
+            }
+            break;
+
+        case CONNECTION_STATE_BACKOFF:
+            if(((event->type == CONNECTION_EVENT_TIMER) && wifi_link_up) ||
+               (event->type == CONNECTION_EVENT_WIFI_UP))
+            {
+                connection_timer_stop();
+                connection_attempt(event->type);
+            }
+            else if(event->type == CONNECTION_EVENT_CONSOLE_LINE)
+            {
+                connection_timer_stop();
+                APP_LOG_WARN("Connection to the TCP server cancelled\n");
+                connection_idle(event->type);
+            }
+            break;
+
+        case CONNECTION_STATE_ESTABLISHED:
+            if((event->type == CONNECTION_EVENT_DISCONNECTED) && (event->data.handle == client_handle))
+            {
+                /* Closed by the server or dropped by TCP keepalive. */
+                connection_lost(event->type);
+            }
+            else if(event->type == CONNECTION_EVENT_WIFI_DOWN)
+            {
+                /* Reconnected from BACKOFF when the link is restored. */
+                connection_lost(event->type);
+            }
+        #if(ENABLE_HEARTBEAT)
+            else if((event->type == CONNECTION_EVENT_HEARTBEAT) &&
+                    (event->data.sequence == heartbeat_sequence))
+            {
+                heartbeat_misses = 0u;
+                APP_LOG_DEBUG("Heartbeat %"PRIu32" answered in %"PRIu32" us\n", heartbeat_sequence,
+                              (uint32_t)(app_time_us() - heartbeat_sent_us));
+            }
+            else if(event->type == CONNECTION_EVENT_TIMER)
+            {
+                if(heartbeat_misses >= APP_PARAM(APP_PARAM_HEARTBEAT_MISSES, HEARTBEAT_MISS_THRESHOLD))
+                {
+                    APP_LOG_WARN("%"PRIu32" heartbeats not answered, the TCP server is "
+                                 "unreachable\n", heartbeat_misses);
+                    connection_lost(event->type);
+                }
+                else
+                {
+                    heartbeat_send();
+                    connection_timer_start(APP_PARAM(APP_PARAM_HEARTBEAT_INTERVAL_MS, HEARTBEAT_INTERVAL_MS));
+                }
+            }
+        #endif /* ENABLE_HEARTBEAT */
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: connection_idle
+ *******************************************************************************
+ * Summary:
+ *  Enters the IDLE state and asks for the address of the TCP server.
+ *
+ * Parameters:
+ *  connection_event_type_t cause: Event that caused the transition
+ *
+ *******************************************************************************/
+static void connection_idle(connection_event_type_t cause)
+{
+    connection_state_enter(CONNECTION_STATE_IDLE, cause);
+
+    printf("Connect to TCP server\n");
+
+    #if(ENABLE_DNS_CACHE)
+        printf("Enter the IPv4 or IPv6 address or the host name of the TCP Server:\n");
+    #else
+        printf("Enter the IPv4 or IPv6 address of the TCP Server:\n");
+    #endif
+
+    #if(USE_AP_STA_INTERFACE)
+        printf("Enter '%s<IPv4 address>' to connect to a TCP server on the SoftAP\n",
+               LOCAL_SESSION_CONSOLE_PREFIX);
+    #endif /* USE_AP_STA_INTERFACE */
+
+    idle_begin_tick = xTaskGetTickCount();
+}
+
+/*******************************************************************************
+ * Function Name: connection_start
+ *******************************************************************************
+ * Summary:
+ *  Starts connecting to the TCP server. The connection is retried up to
+ *  MAX_TCP_SERVER_CONN_RETRIES times within CONNECT_DEADLINE_MS.
+ *
+ * Parameters:
+ *  connection_event_type_t cause: Event that caused the transition
+ *
+ *******************************************************************************/
+static void connection_start(connection_event_type_t cause)
+{
+    printf("Connecting to TCP server... Press Enter to cancel\n");
+
+    connect_retries = 0u;
+    connect_deadline = xTaskGetTickCount() + pdMS_TO_TICKS(APP_PARAM(APP_PARAM_CONNECT_DEADLINE_MS, CONNECT_DEADLINE_MS));
+    connect_backoff_ms = APP_PARAM(APP_PARAM_CONNECT_BACKOFF_MS, CONNECT_BACKOFF_MS);
+
+    if(wifi_link_up)
+    {
+        connection_attempt(cause);
+    }
+    else
+    {
+        connection_state_enter(CONNECTION_STATE_BACKOFF, cause);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: connection_attempt
+ *******************************************************************************
+ * Summary:
+ *  Starts a race of the connection attempts over IPv6 and IPv4. The race is
+ *  polled on CONNECTION_EVENT_CONNECT and on every CONNECT_POLL_INTERVAL_MS.
+ *
+ * Parameters:
+ *  connection_event_type_t cause: Event that caused the transition
+ *
+ *******************************************************************************/
+static void connection_attempt(connection_event_type_t cause)
+{
+    const happy_eyeballs_timeouts_t timeouts = {
+        .tcp_ms = APP_PARAM(APP_PARAM_TCP_CONNECT_TIMEOUT_MS, TCP_CONNECT_TIMEOUT_MS),
+        .tls_ms = APP_PARAM(APP_PARAM_TLS_HANDSHAKE_TIMEOUT_MS, TLS_HANDSHAKE_TIMEOUT_MS)
+    };
+    cy_rslt_t result;
+
+    #if(ENABLE_DNS_CACHE)
+        /* Every attempt resolves the host name again. */
+        if((tcp_server_hostname[0] != '\0') && !tcp_server_resolved)
+        {
+            connection_resolve(cause);
+            return;
+        }
+        tcp_server_resolved = false;
+    #endif /* ENABLE_DNS_CACHE */
+
+    connection_state_enter(CONNECTION_STATE_CONNECTING, cause);
+    connect_retries++;
+    connect_begin_us = app_time_us();
+
+    result = happy_eyeballs_connect_start(&tcp_server_endpoint, &timeouts);
+    if(result != CY_RSLT_SUCCESS)
+    {
+        METRICS_HANDSHAKE_FAILURE(result);
+        APP_LOG_WARN("Could not connect to TCP server.\n");
+        connection_backoff(cause);
+        return;
+    }
+
+    connection_timer_start(CONNECT_POLL_INTERVAL_MS);
+}
+
+#if(ENABLE_DNS_CACHE)
+/*******************************************************************************
+ * Function Name: connection_resolve
+ *******************************************************************************
+ * Summary:
+ *  Resolves the host name of the TCP server and starts the connection
+ *  attempt. A host name that is not cached is resolved by the DNS cache task
+ *  and the function is called again on CONNECTION_EVENT_RESOLVED. When the
+ *  name cannot be resolved, the last known addresses are used; without any,
+ *  the client asks for the server address again.
+ *
+ * Parameters:
+ *  connection_event_type_t cause: Event that caused the transition
+ *
+ *******************************************************************************/
+static void connection_resolve(connection_event_type_t cause)
+{
+    dns_cache_status_t status;
+
+    if(connection_state_get() != CONNECTION_STATE_RESOLVING)
+    {
+        connection_state_enter(CONNECTION_STATE_RESOLVING, cause);
+    }
+
+    status = resolve_tcp_server_endpoint(&tcp_server_endpoint);
+    if(status == DNS_CACHE_PENDING)
+    {
+        return;
+    }
+
+    if(status == DNS_CACHE_FAILED)
+    {
+        if(!tcp_server_endpoint.has_v4 && !tcp_server_endpoint.has_v6)
+        {
+            printf("No IPv4 or IPv6 address for %s\n", tcp_server_hostname);
+            connection_idle(cause);
+            return;
+        }
+
+        printf("No address for %s, using the last known address\n", tcp_server_hostname);
+    }
+
+    tcp_server_resolved = true;
+    connection_attempt(cause);
+}
+#endif /* ENABLE_DNS_CACHE */
+
+/*******************************************************************************
+ * Function Name: connection_poll
+ *******************************************************************************
+ * Summary:
+ *  Advances the race of the connection attempts without waiting.
+ *
+ * Parameters:
+ *  connection_event_type_t cause: Event that caused the call
+ *
+ *******************************************************************************/
+static void connection_poll(connection_event_type_t cause)
+{
+    cy_rslt_t result;
+
+    result = happy_eyeballs_connect_poll(&client_handle, &client_version, 0);
+    if(result == CY_RSLT_MODULE_SECURE_SOCKETS_WOULDBLOCK)
+    {
+        if((int32_t)(xTaskGetTickCount() - connect_deadline) >= 0)
+        {
+            happy_eyeballs_connect_cancel();
+            connection_timer_stop();
+            METRICS_HANDSHAKE_FAILURE(CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT);
+            APP_LOG_ERR("No connection to the TCP server within %"PRIu32" ms\n",
+                        (uint32_t)APP_PARAM(APP_PARAM_CONNECT_DEADLINE_MS, CONNECT_DEADLINE_MS));
+            printf("Failed to connect to TCP server. Error code: %"PRIu32"\n",
+                   (uint32_t)CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT);
+            connection_idle(cause);
+        }
+        else if(cause == CONNECTION_EVENT_TIMER)
+        {
+            connection_timer_start(CONNECT_POLL_INTERVAL_MS);
+        }
+        return;
+    }
+
+    connection_timer_stop();
+
+    if(result != CY_RSLT_SUCCESS)
+    {
+        METRICS_HANDSHAKE_FAILURE(result);
+        APP_LOG_WARN("Could not connect to TCP server.\n");
+        connection_backoff(cause);
+        return;
+    }
+
+    connection_established(cause);
+}
+
+/*******************************************************************************
+ * Function Name: connection_backoff
+ *******************************************************************************
+ * Summary:
+ *  Schedules the next retry after a failed attempt, doubling the delay up to
+ *  CONNECT_BACKOFF_MAX_MS. Returns to IDLE when the retries are exhausted or
+ *  the retry would start after the deadline.
+ *
+ * Parameters:
+ *  connection_event_type_t cause: Event that caused the transition
+ *
+ *******************************************************************************/
+static void connection_backoff(connection_event_type_t cause)
+{
+    TickType_t retry_tick = xTaskGetTickCount() + pdMS_TO_TICKS(connect_backoff_ms);
+
+    if((connect_retries >= APP_PARAM(APP_PARAM_CONNECT_RETRIES, MAX_TCP_SERVER_CONN_RETRIES)) ||
+       ((int32_t)(retry_tick - connect_deadline) >= 0))
+    {
+        /* Stop retrying after maximum retry attempts. */
+        APP_LOG_ERR("Exceeded maximum connection attempts to the TCP server\n");
+        printf("Failed to connect to TCP server. Error code: %"PRIu32"\n",
+               (uint32_t)CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT);
+        connection_idle(cause);
+        return;
+    }
+
+    connection_state_enter(CONNECTION_STATE_BACKOFF, cause);
+    APP_LOG_INFO("Trying to reconnect to TCP server in %"PRIu32" ms...Please check if "
+                 "server is listening\n", connect_backoff_ms);
+
+    connection_timer_start(connect_backoff_ms);
+    connect_backoff_ms = (2u * connect_backoff_ms < CONNECT_BACKOFF_MAX_MS) ?
+                         (2u * connect_backoff_ms) : CONNECT_BACKOFF_MAX_MS;
+}
+
+/*******************************************************************************
+ * Function Name: connection_established
+ *******************************************************************************
+ * Summary:
+ *  Completes a connection: sends the state report as the first application
+ *  message, bounded by FIRST_BYTE_TIMEOUT_MS, and starts the telemetry.
+ *
+ * Parameters:
+ *  connection_event_type_t cause: Event that caused the transition
+ *
+ *******************************************************************************/
+static void connection_established(connection_event_type_t cause)
+{
+    uint32_t handshake_us = (uint32_t)(app_time_us() - connect_begin_us);
+    uint32_t heap_in_use;
+    uint32_t heap_max_used;
+#if(ENABLE_CONNECT_STATE_REPORT)
+    uint32_t send_timeout_ms;
+    cy_rslt_t result;
+#endif /* ENABLE_CONNECT_STATE_REPORT */
+#if(ENABLE_CERT_CACHE)
+    cert_cache_stats_t cert_stats;
+#endif /* ENABLE_CERT_CACHE */
+
+    connection_state_enter(CONNECTION_STATE_HANDSHAKING, cause);
+    connection_count++;
+    METRICS_COUNTER_ADD(METRIC_HANDSHAKES, 1u);
+    METRICS_HISTOGRAM_ADD(METRIC_CONNECT_US, handshake_us);
+
+    APP_LOG_INFO("============================================================\n");
+    APP_LOG_INFO("TLS Handshake successful and connected to TCP server over "
+                 "IPv%"PRIu32" (%"PRIu32" us)\n", (uint32_t)client_version, handshake_us);
+
+    /* The heap high-water mark is reached during the first handshake
+     * and is used to compare the cipher suite and curve selections.
+     */
+    get_heap_usage(&heap_in_use, &heap_max_used);
+    APP_LOG_INFO("Heap after handshake: %"PRIu32" bytes in use, "
+                 "%"PRIu32" bytes peak\n", heap_in_use, heap_max_used);
+
+    #if(ENABLE_CERT_CACHE)
+        cert_cache_get_stats(&cert_stats);
+        APP_LOG_INFO("Certificate cache: %"PRIu32" hits, %"PRIu32" misses, "
+                     "last verification %"PRIu32" us\n",
+                     cert_stats.hits, cert_stats.misses, cert_stats.last_verify_us);
+    #endif /* ENABLE_CERT_CACHE */
+
+    #if(ENABLE_CONNECT_STATE_REPORT)
+        /* A server that accepts the handshake but does not read is
+         * treated as a failed attempt.
+         */
+        send_timeout_ms = APP_PARAM(APP_PARAM_FIRST_BYTE_TIMEOUT_MS, FIRST_BYTE_TIMEOUT_MS);
+        cy_socket_setsockopt(client_handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_SNDTIMEO,
+                             &send_timeout_ms, sizeof(send_timeout_ms));
+        result = send_state_report(connect_begin_us, handshake_us);
+        send_timeout_ms = CY_SOCKET_DEFAULT_SEND_TIMEOUT;
+        cy_socket_setsockopt(client_handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_SNDTIMEO,
+                             &send_timeout_ms, sizeof(send_timeout_ms));
+
+        if(result != CY_RSLT_SUCCESS)
+        {
+            METRICS_HANDSHAKE_FAILURE(result);
+            connection_closed(client_handle);
+            connection_backoff(cause);
+            return;
+        }
+    #endif /* ENABLE_CONNECT_STATE_REPORT */
+
+    connection_state_enter(CONNECTION_STATE_ESTABLISHED, cause);
+
+    if(connection_lost_tick != 0u)
+    {
+        METRICS_COUNTER_ADD(METRIC_RECONNECTS, 1u);
+        APP_LOG_INFO("Reconnected %"PRIu32" ms after the connection was lost\n",
+                     (uint32_t)((xTaskGetTickCount() - connection_lost_tick) * portTICK_PERIOD_MS));
+        connection_lost_tick = 0u;
+    }
+
+    #if(ENABLE_TELEMETRY)
+        telemetry_start(client_handle, xTaskGetCurrentTaskHandle());
+    #endif /* ENABLE_TELEMETRY */
+
+    #if(ENABLE_HEARTBEAT)
+        heartbeat_misses = 0u;
+        connection_timer_start(APP_PARAM(APP_PARAM_HEARTBEAT_INTERVAL_MS, HEARTBEAT_INTERVAL_MS));
+    #endif /* ENABLE_HEARTBEAT */
+
+    #if(ENABLE_DTLS_COMMANDS)
+        dtls_command_set_server((client_version == 6u) ? &tcp_server_endpoint.v6 :
+                                                         &tcp_server_endpoint.v4);
+    #endif /* ENABLE_DTLS_COMMANDS */
+
+    if(!startup_report_printed)
+    {
+        print_startup_report();
+        startup_report_printed = true;
+    }
+
+    print_heap_usage("After connecting to TCP server");
+
+    /* Allow system to enter deep sleep mode. */
+    cyhal_syspm_unlock_deepsleep();
+}
+
+/*******************************************************************************
+ * Function Name: connection_closed
+ *******************************************************************************
+ * Summary:
+ *  Disconnects and releases the client socket.
+ *
+ * Parameters:
+ *  cy_socket_t handle: Client socket
+ *
+ *******************************************************************************/
+static void connection_closed(cy_socket_t handle)
+{
+    #if(ENABLE_TELEMETRY)
+        /* Stop publishing before the socket is deleted. */
+        telemetry_stop();
+    #endif /* ENABLE_TELEMETRY */
+
+    /* Disconnect the TCP client. */
+    cy_socket_disconnect(handle, 0);
+
+    /* Free the resources allocated to the socket. */
+    release_client_socket(client_version, handle);
+
+    APP_LOG_INFO("Disconnected from the TCP server! \n");
+}
+
+/*******************************************************************************
+ * Function Name: connection_lost
+ *******************************************************************************
+ * Summary:
+ *  Closes a connection that was lost and reconnects to the same server, once
+ *  the Wi-Fi link is up. The time from the detection to the new connection
+ *  is logged once connected.
+ *
+ * Parameters:
+ *  connection_event_type_t cause: Event that caused the transition
+ *
+ *******************************************************************************/
+static void connection_lost(connection_event_type_t cause)
+{
+    connection_lost_tick = xTaskGetTickCount();
+    if(connection_lost_tick == 0u)
+    {
+        connection_lost_tick = 1u;
+    }
+
+    connection_timer_stop();
+    connection_closed(client_handle);
+
+    /* Prevent system from entering deep sleep mode
+     * when receiving data from UART.
+     */
+    cyhal_syspm_lock_deepsleep();
+
+    connection_start(cause);
+}
+
+#if(ENABLE_HEARTBEAT)
+/*******************************************************************************
+ * Function Name: heartbeat_send
+ *******************************************************************************
+ * Summary:
+ *  Sends the next heartbeat and counts it as unanswered until the server
+ *  echoes its sequence number.
+ *
+ *******************************************************************************/
+static void heartbeat_send(void)
+{
+    uint8_t heartbeat[HEARTBEAT_LEN];
+    uint32_t bytes_sent = 0;
+    cy_rslt_t result;
+
+    heartbeat_sequence++;
+    heartbeat_misses++;
+    heartbeat_sent_us = app_time_us();
+
+    heartbeat[0] = HEARTBEAT_MSG;
+    app_protocol_put_u32(&heartbeat[1], heartbeat_sequence);
+
+    result = cy_socket_send(client_handle, heartbeat, sizeof(heartbeat),
+                            CY_SOCKET_FLAGS_NONE, &bytes_sent);
+    if(result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_WARN("Heartbeat not sent! Error Code: %"PRIu32"\n", result);
+    }
+    else
+    {
+        METRICS_RECORD_SENT(bytes_sent);
+    }
+}
+#endif /* ENABLE_HEARTBEAT */
+
+/*******************************************************************************
+ * Function Name: connection_notify
+ *******************************************************************************
+ * Summary:
+ *  Called from the connection attempt tasks when an attempt has completed.
+ *
+ *******************************************************************************/
+static void connection_notify(void)
+{
+    connection_event_post_type(CONNECTION_EVENT_CONNECT);
+}
+
 /*******************************************************************************
- * Function Name: tcp_secure_client_task
+ * Function Name: console_task
  *******************************************************************************
  * Summary:
- *  Task used to establish a secure connection to a remote TCP server and
- *  control the LED state (ON/OFF) based on the command received from TCP server.
+ *  Reads lines from the UART terminal and posts them to the network task: the
+ *  server address in the IDLE state, or an empty line to cancel a connection.
+ *  Parameter commands (list, get, set, save, defaults) are executed here.
  *
  * Parameters:
  *  void *args : Task parameter defined during task creation (unused)
  *
- * Return:
- *  void
- *
  *******************************************************************************/
-void tcp_secure_client_task(void *arg)
+static void console_task(void *arg)
 {
-    cy_rslt_t result;
     uint8_t uart_input[UART_BUFFER_SIZE];
+    connection_event_t event = { .type = CONNECTION_EVENT_CONSOLE_LINE };
+#if(ENABLE_APP_PARAMS)
+    static char param_reply[APP_PARAMS_REPLY_MAX];
+#endif /* ENABLE_APP_PARAMS */
 
-    /* The configuration in which WCM should be initialized */
-    cy_wcm_config_t wifi_config = { .interface = WIFI_INTERFACE_TYPE };
-
-    /* IP address and TCP port number of the TCP server to which the TCP client
-     * connects to. */
-    cy_socket_sockaddr_t tcp_server_address = {
-        #if(USE_IPV6_ADDRESS)
-            .ip_address.ip.v6 =  TCP_SERVER_IP_ADDRESS,
-            .ip_address.version = CY_SOCKET_IP_VER_V6,
-        #else
-            .ip_address.ip.v4 = TCP_SERVER_IP_ADDRESS,
-            .ip_address.version = CY_SOCKET_IP_VER_V4,
-        #endif
-            .port = TCP_SERVER_PORT
-    };
-
-    /* Initialize Wi-Fi connection manager. */
-    result = cy_wcm_init(&wifi_config);
-    if (result != CY_RSLT_SUCCESS)
+    for(;;)
     {
-        printf("Wi-Fi Connection Manager initialization failed! Error code: 0x%08"PRIx32"\n", (uint32_t)result);
-        CY_ASSERT(0);
-    }
-    printf("Wi-Fi Connection Manager initialized.\r\n");
+        /* Clear the UART input buffer. */
+        memset(uart_input, 0, UART_BUFFER_SIZE);
 
-    #if(USE_AP_INTERFACE)
+        read_uart_input(uart_input, sizeof(uart_input));
 
-        /* Start the Wi-Fi device as a Soft AP interface. */
-        result = softap_start();
-        if (result != CY_RSLT_SUCCESS)
-        {
-            printf("Failed to Start Soft AP! Error code: 0x%08"PRIx32"\n", (uint32_t)result);
-            CY_ASSERT(0);
-        }
-    #else
-        /* Connect to Wi-Fi AP */
-        if(connect_to_wifi_ap() != CY_RSLT_SUCCESS )
-        {
-            printf("\n Failed to connect to Wi-Fi AP.\n");
-            CY_ASSERT(0);
-        }
-    #endif /* USE_AP_INTERFACE */
+        #if(ENABLE_APP_PARAMS)
+            if(app_params_is_command((char *)uart_input))
+            {
+                (void)app_params_command((char *)uart_input, param_reply, sizeof(param_reply));
+                printf("%s", param_reply);
+                continue;
+            }
+        #endif /* ENABLE_APP_PARAMS */
+
+        #if(USE_AP_STA_INTERFACE)
+            /* The server on the SoftAP subnet is set independently of the
+             * session to the Wi-Fi network.
+             */
+            if(0 == strncmp((char *)uart_input, LOCAL_SESSION_CONSOLE_PREFIX,
+                            sizeof(LOCAL_SESSION_CONSOLE_PREFIX) - 1u))
+            {
+                local_session_set_server((char *)uart_input + sizeof(LOCAL_SESSION_CONSOLE_PREFIX) - 1u);
+                continue;
+            }
+        #endif /* USE_AP_STA_INTERFACE */
 
-    /* Create a binary semaphore to keep track of secure TCP server connection. */
-    connect_to_server = xSemaphoreCreateBinary();
+        strncpy(event.data.line, (char *)uart_input, CONNECTION_EVENT_LINE_SIZE - 1u);
+        event.data.line[CONNECTION_EVENT_LINE_SIZE - 1u] = '\0';
+        connection_event_post(&event);
+    }
+}
 
-    /* Give the semaphore so as to connect to TCP server. */
-    xSemaphoreGive(connect_to_server); 
+/*******************************************************************************
+ * Function Name: tls_credentials_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the secure socket library, loads the global trusted RootCA
+ *  certificate and creates the TLS identity of the TCP client. This stage is
+ *  CPU-bound and does not depend on the Wi-Fi connection.
+ *
+ * Return:
+ *  cy_result result: Result of the operation.
+ *
+ *******************************************************************************/
+static cy_rslt_t tls_credentials_init(void)
+{
+    cy_rslt_t result;
+    TickType_t stage_begin = xTaskGetTickCount();
 
     /* TCP client certificate length and private key length. */
     const size_t tcp_client_cert_len = strlen( tcp_client_cert );
     const size_t pkey_len = strlen( client_private_key );
 
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+    /* The TLS 1.3 key schedule uses PSA crypto, which must be initialized
+     * before the first handshake.
+     */
+    if(psa_crypto_init() != PSA_SUCCESS)
+    {
+        printf("PSA crypto initialization failed!\n");
+        return CY_RSLT_MODULE_SECURE_SOCKETS_TLS_ERROR;
+    }
+#endif /* MBEDTLS_SSL_PROTO_TLS1_3 */
+
     /* Initialize secure socket library. */
     result = cy_socket_init();
     if (result != CY_RSLT_SUCCESS)
     {
         printf("Secure Socket initialization failed!\n");
-        CY_ASSERT(0);
+        return result;
     }
     printf("Secure Socket initialized\n");
 
@@ -211,6 +1153,11 @@ void tcp_secure_client_task(void *arg)
     else
     {
         printf("Global trusted RootCA certificate loaded\n");
+
+        #if(ENABLE_CERT_CACHE)
+            /* Certificates verified against the previous root CAs are not reused. */
+            cert_cache_clear();
+        #endif /* ENABLE_CERT_CACHE */
     }
 
     /* Create TCP client identity using the SSL certificate and private key. */
@@ -219,75 +1166,249 @@ void tcp_secure_client_task(void *arg)
     if(result != CY_RSLT_SUCCESS)
     {
         printf("Failed cy_tls_create_identity! Error code: %"PRIu32"\n", result);
-        CY_ASSERT(0);
-    }   
+    }
 
-    for(;;)
-    {
-        /* Wait till semaphore is acquired so as to connect to a secure TCP server. */
-        xSemaphoreTake(connect_to_server, portMAX_DELAY);
+    tls_credentials_ticks = xTaskGetTickCount() - stage_begin;
+
+    return result;
+}
 
-        printf("Connect to TCP server\n");
+#if(ENABLE_STARTUP_OVERLAP)
+/*******************************************************************************
+ * Function Name: tls_credentials_task
+ *******************************************************************************
+ * Summary:
+ *  Task that runs the TLS credentials stage concurrently with the Wi-Fi
+ *  initialization and join, and signals its completion to the network task.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void tls_credentials_task(void *arg)
+{
+    tls_credentials_result = tls_credentials_init();
 
-        #if(USE_IPV6_ADDRESS)
-            printf("Enter the IPv6 address of the TCP Server:\n");
-        #else
-            printf("Enter the IPv4 address of the TCP Server:\n");
-        #endif
-            
+    xEventGroupSetBits(startup_events, STARTUP_CREDENTIALS_READY_BIT);
 
-        /* Prevent system from entering deep sleep mode
-         * when receiving data from UART.
-         */
-        cyhal_syspm_lock_deepsleep();
+    vTaskDelete(NULL);
+}
+#endif /* ENABLE_STARTUP_OVERLAP */
 
-        /* Clear the UART input buffer. */
-        memset(uart_input, 0, UART_BUFFER_SIZE);
+/*******************************************************************************
+ * Function Name: parse_tcp_server_endpoint
+ *******************************************************************************
+ * Summary:
+ *  Sets the addresses of the TCP server from the UART input: an IPv4 address,
+ *  an IPv6 address or, with the DNS cache enabled, a host name that the
+ *  connection attempts resolve to both address families.
+ *
+ * Parameters:
+ *  const char *input: Address or host name entered by the user
+ *  happy_eyeballs_endpoint_t *endpoint: Addresses of the TCP server
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t parse_tcp_server_endpoint(const char *input, happy_eyeballs_endpoint_t *endpoint)
+{
+    endpoint->has_v4 = (0 != ip4addr_aton(input, (ip4_addr_t *)&endpoint->v4.ip.v4));
+    endpoint->has_v6 = !endpoint->has_v4 && (strchr(input, ':') != NULL) &&
+                       (0 != ip6addr_aton(input, (ip6_addr_t *)&endpoint->v6.ip.v6));
 
-        /* Read the TCP server's IPv4 address from  the user via the
-         * UART terminal.
-         */
-        read_uart_input(uart_input);
-
-        /* Allow system to enter deep sleep mode. */
-        cyhal_syspm_unlock_deepsleep();
-        
-        #if(USE_IPV6_ADDRESS)
-            ip6addr_aton((char *)uart_input,
-                         (ip6_addr_t *)&tcp_server_address.ip_address.ip.v6);
-        #else
-            ip4addr_aton((char *)uart_input,
-                         (ip4_addr_t *)&tcp_server_address.ip_address.ip.v4);
-        #endif
-
-        #if(USE_IPV6_ADDRESS)
-            printf("Connecting to TCP Server (IPv6 Address: %s, Port: %d)\n\n",
-                    ip6addr_ntoa((const ip6_addr_t *)&tcp_server_address.ip_address.ip.v6),
-                    TCP_SERVER_PORT);
-        #else
-            printf("Connecting to TCP Server (IPv4 Address: %s, Port: %d)\n\n",
-                    ip4addr_ntoa((const ip4_addr_t *)&tcp_server_address.ip_address.ip.v4),
-                    TCP_SERVER_PORT);
-        #endif
-
-        /* Connect to the secure TCP server. If the connection fails, retry
-         * to connect to the server for MAX_TCP_SERVER_CONN_RETRIES times. */
-        printf("Connecting to TCP server...\n");
-        result = connect_to_secure_tcp_server(tcp_server_address);
+    #if(ENABLE_DNS_CACHE)
+        tcp_server_hostname[0] = '\0';
 
-        if(result != CY_RSLT_SUCCESS)
+        /* Not an IP address: the host name is resolved by the connection
+         * attempts.
+         */
+        if(!endpoint->has_v4 && !endpoint->has_v6 && (input[0] != '\0') &&
+           (strlen(input) < sizeof(tcp_server_hostname)))
         {
-            printf("Failed to connect to TCP server. Error code: %"PRIu32"\n", result);
-            /* Give the semaphore so as to connect to TCP server. */
-            xSemaphoreGive(connect_to_server);
-
+            strcpy(tcp_server_hostname, input);
+            printf("Connecting to TCP Server (Host name: %s, Port: %d)\n\n",
+                   tcp_server_hostname, endpoint->port);
+            return CY_RSLT_SUCCESS;
         }
-        
-        print_heap_usage("After connecting to TCP server");
+    #endif /* ENABLE_DNS_CACHE */
+
+    if(endpoint->has_v6)
+    {
+        printf("Connecting to TCP Server (IPv6 Address: %s, Port: %d)\n",
+                ip6addr_ntoa((const ip6_addr_t *)&endpoint->v6.ip.v6), endpoint->port);
     }
- }
+    if(endpoint->has_v4)
+    {
+        printf("Connecting to TCP Server (IPv4 Address: %s, Port: %d)\n",
+                ip4addr_ntoa((const ip4_addr_t *)&endpoint->v4.ip.v4), endpoint->port);
+    }
+    printf("\n");
+
+    return (endpoint->has_v4 || endpoint->has_v6) ? CY_RSLT_SUCCESS :
+                                                    CY_RSLT_MODULE_SECURE_SOCKETS_HOST_NOT_FOUND;
+}
+
+#if(ENABLE_DNS_CACHE)
+/*******************************************************************************
+ * Function Name: resolve_tcp_server_endpoint
+ *******************************************************************************
+ * Summary:
+ *  Resolves the host name of the TCP server to both address families. A
+ *  pending lookup is waited for only when the other family has no cached
+ *  address; otherwise it completes in the background and the pending family
+ *  keeps its last known address, so that a retry or reconnect does not wait
+ *  for the DNS server. The addresses are left unchanged when neither family
+ *  resolves.
+ *
+ * Parameters:
+ *  happy_eyeballs_endpoint_t *endpoint: Addresses of the TCP server
+ *
+ * Return:
+ *  dns_cache_status_t: DNS_CACHE_PENDING while the lookups are waited for,
+ *  DNS_CACHE_FAILED if neither family resolves, DNS_CACHE_RESOLVED otherwise
+ *
+ *******************************************************************************/
+static dns_cache_status_t resolve_tcp_server_endpoint(happy_eyeballs_endpoint_t *endpoint)
+{
+    cy_socket_ip_address_t v6 = endpoint->v6;
+    cy_socket_ip_address_t v4 = endpoint->v4;
+    dns_cache_status_t status_v6;
+    dns_cache_status_t status_v4;
+    bool cached_v6, cached_v4;
+    bool failed_v6, failed_v4;
+
+    status_v6 = resolve_tcp_server_hostname(tcp_server_hostname, 6u, &v6);
+    status_v4 = resolve_tcp_server_hostname(tcp_server_hostname, 4u, &v4);
+    cached_v6 = (status_v6 == DNS_CACHE_HIT) || (status_v6 == DNS_CACHE_STALE);
+    cached_v4 = (status_v4 == DNS_CACHE_HIT) || (status_v4 == DNS_CACHE_STALE);
+    if(((status_v6 == DNS_CACHE_PENDING) && !cached_v4) ||
+       ((status_v4 == DNS_CACHE_PENDING) && !cached_v6))
+    {
+        return DNS_CACHE_PENDING;
+    }
+
+    failed_v6 = (status_v6 == DNS_CACHE_FAILED) || (status_v6 == DNS_CACHE_NEGATIVE);
+    failed_v4 = (status_v4 == DNS_CACHE_FAILED) || (status_v4 == DNS_CACHE_NEGATIVE);
+    if(failed_v6 && failed_v4)
+    {
+        return DNS_CACHE_FAILED;
+    }
+
+    if(status_v6 != DNS_CACHE_PENDING)
+    {
+        endpoint->v6 = v6;
+        endpoint->has_v6 = !failed_v6;
+    }
+    if(status_v4 != DNS_CACHE_PENDING)
+    {
+        endpoint->v4 = v4;
+        endpoint->has_v4 = !failed_v4;
+    }
+
+    return DNS_CACHE_RESOLVED;
+}
+
+/*******************************************************************************
+ * Function Name: resolve_tcp_server_hostname
+ *******************************************************************************
+ * Summary:
+ *  Resolves the host name of the TCP server through the DNS cache without
+ *  waiting for the DNS server, and prints the lookup latency and the cache
+ *  hit rate once the lookup completes.
+ *
+ * Parameters:
+ *  const char *hostname: Host name of the TCP server
+ *  uint8_t version: IP version of the address (4 or 6)
+ *  cy_socket_ip_address_t *ip_address: Resolved address
+ *
+ * Return:
+ *  dns_cache_status_t: Outcome of the lookup
+ *
+ *******************************************************************************/
+static dns_cache_status_t resolve_tcp_server_hostname(const char *hostname, uint8_t version,
+                                                      cy_socket_ip_address_t *ip_address)
+{
+    static const char *status_names[] = { "cache hit", "stale cache hit, refreshing",
+                                          "resolved", "failed", "pending",
+                                          "no address (cache hit)" };
+    dns_cache_addr_t addr;
+    dns_cache_stats_t stats;
+    dns_cache_status_t status;
+    uint32_t answered;
+
+    status = dns_cache_lookup(hostname, version, &addr, resolve_tcp_server_done);
+    if(status == DNS_CACHE_PENDING)
+    {
+        return status;
+    }
+
+    dns_cache_get_stats(&stats);
+    answered = stats.hits + stats.stale_hits + stats.negative_hits;
+    printf("DNS lookup of %s (IPv%d): %s in %"PRIu32" us (cache hit rate %"PRIu32"%%)\n",
+           hostname, (int)version, status_names[status], stats.last_resolve_us,
+           (answered * 100u) / (answered + stats.misses));
+
+    if((status == DNS_CACHE_FAILED) || (status == DNS_CACHE_NEGATIVE))
+    {
+        return status;
+    }
+
+    if(version == 6u)
+    {
+        memcpy(ip_address->ip.v6, addr.bytes, sizeof(ip_address->ip.v6));
+    }
+    else
+    {
+        memcpy(&ip_address->ip.v4, addr.bytes, sizeof(ip_address->ip.v4));
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+ * Function Name: resolve_tcp_server_done
+ *******************************************************************************
+ * Summary:
+ *  Called by the DNS cache task when a lookup of the host name of the TCP
+ *  server completes.
+ *
+ *******************************************************************************/
+static void resolve_tcp_server_done(void)
+{
+    connection_event_post_type(CONNECTION_EVENT_RESOLVED);
+}
+#endif /* ENABLE_DNS_CACHE */
 
-#if(USE_AP_INTERFACE)
+/*******************************************************************************
+ * Function Name: print_startup_report
+ *******************************************************************************
+ * Summary:
+ *  Prints the duration of each startup stage and the boot-to-connected time,
+ *  excluding the time spent waiting for the user to enter the server address.
+ *  The sequential time is the sum of the stages, i.e. the boot-to-network-ready
+ *  time without the overlap.
+ *
+ *******************************************************************************/
+static void print_startup_report(void)
+{
+    TickType_t connected_ticks = xTaskGetTickCount() - startup_begin_tick - uart_input_ticks;
+
+    printf("\n********** Startup Timing **********\n");
+    printf("Startup overlap              : %s\n", ENABLE_STARTUP_OVERLAP ? "enabled" : "disabled");
+    printf("TLS credentials stage        : %"PRIu32" ms\n", (uint32_t)(tls_credentials_ticks * portTICK_PERIOD_MS));
+    printf("Wi-Fi init and join stage    : %"PRIu32" ms\n", (uint32_t)(wifi_ready_ticks * portTICK_PERIOD_MS));
+    printf("Sum of stages (sequential)   : %"PRIu32" ms\n",
+           (uint32_t)((tls_credentials_ticks + wifi_ready_ticks) * portTICK_PERIOD_MS));
+    printf("Boot-to-network-ready        : %"PRIu32" ms\n", (uint32_t)(network_ready_ticks * portTICK_PERIOD_MS));
+    printf("Boot-to-connected            : %"PRIu32" ms\n", (uint32_t)(connected_ticks * portTICK_PERIOD_MS));
+    printf("************************************\n\n");
+}
+
+#if(ENABLE_SOFTAP)
 /********************************************************************************
  * Function Name: softap_start
  ********************************************************************************
@@ -307,9 +1428,7 @@ void tcp_secure_client_task(void *arg)
 static cy_rslt_t softap_start(void)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
-    #if(USE_IPV6_ADDRESS)
-        cy_wcm_ip_address_t ip_address;
-    #endif 
+    cy_wcm_ip_address_t ip_address;
 
     /* Initialize the Wi-Fi device as a Soft AP. */
     cy_wcm_ap_credentials_t softap_credentials = {SOFTAP_SSID, SOFTAP_PASSWORD,
@@ -332,25 +1451,24 @@ static cy_rslt_t softap_start(void)
         printf("Wi-Fi Device configured as Soft AP\n");
         printf("Connect TCP client device to the network: SSID: %s Password:%s\n",
                 SOFTAP_SSID, SOFTAP_PASSWORD);
-    #if(USE_IPV6_ADDRESS)
-        /* Get the IPv6 address.*/
-        result = cy_wcm_get_ipv6_addr(CY_WCM_INTERFACE_TYPE_AP, CY_WCM_IPV6_LINK_LOCAL, &ip_address);
-        if(result == CY_RSLT_SUCCESS)
+        printf("SofAP IPv4 Address : %s\n",
+                ip4addr_ntoa((const ip4_addr_t *)&softap_ip_info.ip_address.ip.v4));
+
+        /* Get the IPv6 address. The clients may connect over either family. */
+        if(CY_RSLT_SUCCESS == cy_wcm_get_ipv6_addr(CY_WCM_INTERFACE_TYPE_AP,
+                                                   CY_WCM_IPV6_LINK_LOCAL, &ip_address))
         {
-            printf("SofAP IPv6 Address : %s\n\n",
+            printf("SofAP IPv6 Address : %s\n",
                    ip6addr_ntoa((const ip6_addr_t*)&ip_address.ip.v6));
         }
-    #else
-        printf("SofAP IPv4 Address : %s\n\n",
-                ip4addr_ntoa((const ip4_addr_t *)&softap_ip_info.ip_address.ip.v4));
-    #endif  
+        printf("\n");
     }
 
     return result;
 }
-#endif /* USE_AP_INTERFACE */
+#endif /* ENABLE_SOFTAP */
 
-#if(!USE_AP_INTERFACE)
+#if(ENABLE_STA)
 /*******************************************************************************
  * Function Name: connect_to_wifi_ap()
  *******************************************************************************
@@ -378,7 +1496,7 @@ cy_rslt_t connect_to_wifi_ap(void)
     wifi_conn_param.ap_credentials.security = WIFI_SECURITY_TYPE;
 
     /* Join the Wi-Fi AP. */
-    for(uint32_t conn_retries = 0; conn_retries < MAX_WIFI_CONN_RETRIES; conn_retries++ )
+    for(uint32_t conn_retries = 0; conn_retries < APP_PARAM(APP_PARAM_WIFI_RETRIES, MAX_WIFI_CONN_RETRIES); conn_retries++ )
     {
         result = cy_wcm_connect_ap(&wifi_conn_param, &ip_address);
 
@@ -387,28 +1505,25 @@ cy_rslt_t connect_to_wifi_ap(void)
             printf("Successfully connected to Wi-Fi network '%s'.\n",
                                 wifi_conn_param.ap_credentials.SSID);
 
-            #if(USE_IPV6_ADDRESS)
-            /* Get the IPv6 address.*/
-                result = cy_wcm_get_ipv6_addr(CY_WCM_INTERFACE_TYPE_STA,
-                                              CY_WCM_IPV6_LINK_LOCAL, &ip_address);
-                if(result == CY_RSLT_SUCCESS)
-                {
-                    printf("IPv6 address (link-local) assigned: %s\n",
-                            ip6addr_ntoa((const ip6_addr_t*)&ip_address.ip.v6));
-                }
-            #else      
-                printf("IPv4 address assigned: %s\n",
-                        ip4addr_ntoa((const ip4_addr_t*)&ip_address.ip.v4));
-       
-            #endif /* USE_IPV6_ADDRESS */
+            printf("IPv4 address assigned: %s\n",
+                    ip4addr_ntoa((const ip4_addr_t*)&ip_address.ip.v4));
+
+            /* Get the IPv6 address. The server may be reached over either family. */
+            if(CY_RSLT_SUCCESS == cy_wcm_get_ipv6_addr(CY_WCM_INTERFACE_TYPE_STA,
+                                                       CY_WCM_IPV6_LINK_LOCAL, &ip_address))
+            {
+                printf("IPv6 address (link-local) assigned: %s\n",
+                        ip6addr_ntoa((const ip6_addr_t*)&ip_address.ip.v6));
+            }
 
             return result;
         }
 
         printf("Connection to Wi-Fi network failed with error code %"PRIu32"."
-               "Retrying in %d ms...\n", result, WIFI_CONN_RETRY_INTERVAL_MSEC);
+               "Retrying in %"PRIu32" ms...\n", result,
+               (uint32_t)APP_PARAM(APP_PARAM_WIFI_RETRY_INTERVAL_MS, WIFI_CONN_RETRY_INTERVAL_MSEC));
 
-        vTaskDelay(pdMS_TO_TICKS(WIFI_CONN_RETRY_INTERVAL_MSEC));
+        vTaskDelay(pdMS_TO_TICKS(APP_PARAM(APP_PARAM_WIFI_RETRY_INTERVAL_MS, WIFI_CONN_RETRY_INTERVAL_MSEC)));
     }
 
     /* Stop retrying after maximum retry attempts. */
@@ -416,7 +1531,35 @@ cy_rslt_t connect_to_wifi_ap(void)
 
     return result;
 }
-#endif /* (!USE_AP_INTERFACE)*/
+
+/*******************************************************************************
+ * Function Name: wifi_event_callback
+ *******************************************************************************
+ * Summary:
+ *  Wi-Fi connection manager event callback. Posts the loss and the recovery of
+ *  the Wi-Fi link to the network task.
+ *
+ * Parameters:
+ *  cy_wcm_event_t event: Wi-Fi event
+ *  cy_wcm_event_data_t *event_data: Event data (unused)
+ *
+ *******************************************************************************/
+static void wifi_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t *event_data)
+{
+    if(event == CY_WCM_EVENT_DISCONNECTED)
+    {
+        wifi_link_up = false;
+        APP_LOG_WARN("Wi-Fi link lost\n");
+        connection_event_post_type(CONNECTION_EVENT_WIFI_DOWN);
+    }
+    else if(event == CY_WCM_EVENT_RECONNECTED)
+    {
+        wifi_link_up = true;
+        APP_LOG_INFO("Wi-Fi link restored\n");
+        connection_event_post_type(CONNECTION_EVENT_WIFI_UP);
+    }
+}
+#endif /* ENABLE_STA */
 
 /*******************************************************************************
  * Function Name: create_secure_tcp_client_socket
@@ -424,13 +1567,18 @@ cy_rslt_t connect_to_wifi_ap(void)
  * Summary:
  *  Function to create a secure socket and set the socket options to use TLS
  *  identity, set call back function for handling incoming messages, call back
- *  function to handle disconnection.
+ *  function to handle disconnection. The socket is deleted if a required
+ *  option cannot be set.
+ *
+ * Parameters:
+ *  uint8_t version: IP version of the socket (4 or 6)
+ *  cy_socket_t *handle: Handle of the created socket
  *
  * Return:
  *  cy_result result: Result of the operation.
  *
  *******************************************************************************/
-cy_rslt_t create_secure_tcp_client_socket()
+cy_rslt_t create_secure_tcp_client_socket(uint8_t version, cy_socket_t *handle)
 {
     cy_rslt_t result;
 
@@ -441,31 +1589,38 @@ cy_rslt_t create_secure_tcp_client_socket()
     /* TLS authentication mode. */
     cy_socket_tls_auth_mode_t tls_auth_mode = CY_SOCKET_TLS_VERIFY_REQUIRED;
 
+#if(ENABLE_TCP_KEEPALIVE)
+    uint32_t keepalive_idle_ms = TCP_KEEPALIVE_IDLE_MS;
+    uint32_t keepalive_interval_ms = TCP_KEEPALIVE_INTERVAL_MS;
+    uint32_t keepalive_count = TCP_KEEPALIVE_COUNT;
+    int keepalive_enable = 1;
+#endif /* ENABLE_TCP_KEEPALIVE */
+
+#if defined(NET_PROFILE_TCP_NODELAY)
+    int nodelay = NET_PROFILE_TCP_NODELAY;
+#endif /* NET_PROFILE_TCP_NODELAY */
+
     /* Create a new secure TCP socket. */
-    #if(USE_IPV6_ADDRESS)
-        result = cy_socket_create(CY_SOCKET_DOMAIN_AF_INET6, CY_SOCKET_TYPE_STREAM,
-                              CY_SOCKET_IPPROTO_TLS, &client_handle);
-    #else
-        result = cy_socket_create(CY_SOCKET_DOMAIN_AF_INET, CY_SOCKET_TYPE_STREAM,
-                                      CY_SOCKET_IPPROTO_TLS, &client_handle);
-    #endif
+    result = cy_socket_create((version == 6u) ? CY_SOCKET_DOMAIN_AF_INET6 : CY_SOCKET_DOMAIN_AF_INET,
+                              CY_SOCKET_TYPE_STREAM, CY_SOCKET_IPPROTO_TLS, handle);
 
     if (result != CY_RSLT_SUCCESS)
     {
-        printf("Failed to create socket! Error Code: %"PRIu32"\n", result);
+        APP_LOG_ERR("Failed to create socket! Error Code: %"PRIu32"\n", result);
         return result;
     }
 
     /* Register the callback function to handle messages received from TCP server. */
     tcp_recv_option.callback = tcp_client_recv_handler;
     tcp_recv_option.arg = NULL;
-    result = cy_socket_setsockopt(client_handle, CY_SOCKET_SOL_SOCKET,
+    result = cy_socket_setsockopt(*handle, CY_SOCKET_SOL_SOCKET,
                                   CY_SOCKET_SO_RECEIVE_CALLBACK,
                                   &tcp_recv_option, sizeof(cy_socket_opt_callback_t));
     if (result != CY_RSLT_SUCCESS)
     {
-        printf("Set socket option: CY_SOCKET_SO_RECEIVE_CALLBACK failed! "
-                "Error Code: %"PRIu32"\n", result);
+        APP_LOG_ERR("Set socket option: CY_SOCKET_SO_RECEIVE_CALLBACK failed! "
+                    "Error Code: %"PRIu32"\n", result);
+        cy_socket_delete(*handle);
         return result;
     }
 
@@ -473,151 +1628,198 @@ cy_rslt_t create_secure_tcp_client_socket()
     tcp_disconnection_option.callback = tcp_disconnection_handler;
     tcp_disconnection_option.arg = NULL;
 
-    result = cy_socket_setsockopt(client_handle, CY_SOCKET_SOL_SOCKET,
+    result = cy_socket_setsockopt(*handle, CY_SOCKET_SOL_SOCKET,
                                   CY_SOCKET_SO_DISCONNECT_CALLBACK,
                                   &tcp_disconnection_option, sizeof(cy_socket_opt_callback_t));
     if(result != CY_RSLT_SUCCESS)
     {
-        printf("Set socket option: CY_SOCKET_SO_DISCONNECT_CALLBACK failed! "
-                "Error Code: %"PRIu32"\n", result);
+        APP_LOG_ERR("Set socket option: CY_SOCKET_SO_DISCONNECT_CALLBACK failed! "
+                    "Error Code: %"PRIu32"\n", result);
+        cy_socket_delete(*handle);
         return result;
     }
 
     /* Set the TCP socket to use the TLS identity. */
-    result = cy_socket_setsockopt(client_handle, CY_SOCKET_SOL_TLS, CY_SOCKET_SO_TLS_IDENTITY,
+    result = cy_socket_setsockopt(*handle, CY_SOCKET_SOL_TLS, CY_SOCKET_SO_TLS_IDENTITY,
                                   tls_identity, sizeof((uint32_t)tls_identity));
     if(result != CY_RSLT_SUCCESS)
     {
-        printf("Set socket option: CY_SOCKET_SO_TLS_IDENTITY failed! "
-               "Error Code: %"PRIu32"\n", result);
+        APP_LOG_ERR("Set socket option: CY_SOCKET_SO_TLS_IDENTITY failed! "
+                    "Error Code: %"PRIu32"\n", result);
+        cy_socket_delete(*handle);
+        return result;
     }
 
     /* Set the TLS authentication mode. */
-    result = cy_socket_setsockopt(client_handle, CY_SOCKET_SOL_TLS, CY_SOCKET_SO_TLS_AUTH_MODE,
+    result = cy_socket_setsockopt(*handle, CY_SOCKET_SOL_TLS, CY_SOCKET_SO_TLS_AUTH_MODE,
                         &tls_auth_mode, sizeof(cy_socket_tls_auth_mode_t));
     if(result != CY_RSLT_SUCCESS)
     {
-        printf("Set socket option: CY_SOCKET_SO_TLS_AUTH_MODE failed! "
-               "Error Code: %"PRIu32"\n", result);
+        APP_LOG_ERR("Set socket option: CY_SOCKET_SO_TLS_AUTH_MODE failed! "
+                    "Error Code: %"PRIu32"\n", result);
+        cy_socket_delete(*handle);
+        return result;
     }
 
+    #if(ENABLE_TCP_KEEPALIVE)
+        /* Detect a server that disappeared without closing the connection. A
+         * failure is not fatal: the heartbeat also detects a dead server.
+         */
+        if((CY_RSLT_SUCCESS != cy_socket_setsockopt(*handle, CY_SOCKET_SOL_TCP,
+                                                    CY_SOCKET_SO_TCP_KEEPALIVE_IDLE_TIME,
+                                                    &keepalive_idle_ms, sizeof(keepalive_idle_ms))) ||
+           (CY_RSLT_SUCCESS != cy_socket_setsockopt(*handle, CY_SOCKET_SOL_TCP,
+                                                    CY_SOCKET_SO_TCP_KEEPALIVE_INTERVAL,
+                                                    &keepalive_interval_ms, sizeof(keepalive_interval_ms))) ||
+           (CY_RSLT_SUCCESS != cy_socket_setsockopt(*handle, CY_SOCKET_SOL_TCP,
+                                                    CY_SOCKET_SO_TCP_KEEPALIVE_COUNT,
+                                                    &keepalive_count, sizeof(keepalive_count))) ||
+           (CY_RSLT_SUCCESS != cy_socket_setsockopt(*handle, CY_SOCKET_SOL_SOCKET,
+                                                    CY_SOCKET_SO_TCP_KEEPALIVE_ENABLE,
+                                                    &keepalive_enable, sizeof(keepalive_enable))))
+        {
+            APP_LOG_WARN("TCP keepalive not enabled on the client socket\n");
+        }
+    #endif /* ENABLE_TCP_KEEPALIVE */
+
+    #if defined(NET_PROFILE_TCP_NODELAY)
+        /* Nagle's algorithm, as set by the network tuning profile. */
+        if(CY_RSLT_SUCCESS != cy_socket_setsockopt(*handle, CY_SOCKET_SOL_TCP, CY_SOCKET_SO_TCP_NODELAY,
+                                                   &nodelay, sizeof(nodelay)))
+        {
+            APP_LOG_WARN("TCP_NODELAY not set on the client socket\n");
+        }
+    #endif /* NET_PROFILE_TCP_NODELAY */
+
     return result;
 }
 
 /*******************************************************************************
- * Function Name: connect_to_secure_tcp_server
+ * Function Name: acquire_client_socket
  *******************************************************************************
  * Summary:
- *  Function to connect to secure TCP server.
+ *  Provides a configured client socket for a connection attempt, from the
+ *  socket pool when enabled, and prints the time the attempt spent on it and
+ *  what the creation of the socket cost. A pooled socket costs the attempt
+ *  no time, but was allocated by the refill task all the same.
  *
  * Parameters:
- *  cy_socket_sockaddr_t address: Address of TCP server socket
+ *  uint8_t version: IP version of the socket (4 or 6)
+ *  cy_socket_t *handle: Configured socket
  *
  * Return:
  *  cy_result result: Result of the operation
  *
  *******************************************************************************/
-cy_rslt_t connect_to_secure_tcp_server(cy_socket_sockaddr_t address)
+static cy_rslt_t acquire_client_socket(uint8_t version, cy_socket_t *handle)
 {
-    cy_rslt_t result = CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT;
-    cy_rslt_t conn_result;  
+    cy_rslt_t result;
+    uint64_t setup_begin_us;
+    uint32_t setup_us;
+    #if(ENABLE_SOCKET_POOL)
+        socket_pool_info_t info;
+    #else
+        uint32_t heap_before;
+        uint32_t heap_in_use;
+        uint32_t heap_max_used;
+    #endif /* ENABLE_SOCKET_POOL */
+
+    setup_begin_us = app_time_us();
+    #if(ENABLE_SOCKET_POOL)
+        result = socket_pool_acquire(version, handle, &info);
+    #else
+        get_heap_usage(&heap_before, &heap_max_used);
+        result = create_secure_tcp_client_socket(version, handle);
+        get_heap_usage(&heap_in_use, &heap_max_used);
+    #endif /* ENABLE_SOCKET_POOL */
+    setup_us = (uint32_t)(app_time_us() - setup_begin_us);
 
-    for(uint32_t conn_retries = 0; conn_retries < MAX_TCP_SERVER_CONN_RETRIES; conn_retries++)
+    if(result != CY_RSLT_SUCCESS)
     {
-        /* Create a secure TCP socket */
-        conn_result = create_secure_tcp_client_socket();
-        if(conn_result != CY_RSLT_SUCCESS)
-        {
-            printf("Failed to create secure socket! Error Code: %"PRIu32"\n", result);
-            CY_ASSERT(0);
-        }
-        
-        conn_result = cy_socket_connect(client_handle, &address, sizeof(cy_socket_sockaddr_t));
-        if (conn_result == CY_RSLT_SUCCESS)
-        {
-            printf("============================================================\n");
-            printf("TLS Handshake successful and connected to TCP server\n");
-            return conn_result;
-        }
-
-        printf("Could not connect to TCP server.\n");
-        printf("Trying to reconnect to TCP server...Please check if server is listening\n");
-
-        /* The resources allocated during the socket creation (cy_socket_create)
-         * should be deleted.
-         */
-        cy_socket_delete(client_handle);
+        APP_LOG_ERR("Failed to create secure socket! Error Code: %"PRIu32"\n", result);
+        return result;
     }
 
-     /* Stop retrying after maximum retry attempts. */
-     printf("Exceeded maximum connection attempts to the TCP server\n");
+    #if(ENABLE_SOCKET_POOL)
+        APP_LOG_INFO("IPv%"PRIu32" socket setup: %"PRIu32" us; socket created %s "
+                     "in %"PRIu32" us, %"PRIu32" heap bytes allocated\n",
+                     (uint32_t)version, setup_us,
+                     info.pooled ? "by the pool refill" : "by this attempt",
+                     info.create_us, info.heap_bytes);
+    #else
+        APP_LOG_INFO("IPv%"PRIu32" socket setup: %"PRIu32" us, %"PRIu32" heap bytes allocated\n",
+                     (uint32_t)version, setup_us, heap_in_use - heap_before);
+    #endif /* ENABLE_SOCKET_POOL */
 
-     return result;
+    return result;
 }
 
 /*******************************************************************************
- * Function Name: tcp_client_recv_handler
+ * Function Name: release_client_socket
  *******************************************************************************
  * Summary:
- *  Callback function to handle incoming TCP server messages.
+ *  Frees a client socket after a failed or lost connection attempt, or after
+ *  a disconnection.
  *
  * Parameters:
- *  cy_socket_t socket_handle: Connection handle for the TCP client socket
- *  void *args : Parameter passed on to the function (unused)
+ *  uint8_t version: IP version of the socket (4 or 6)
+ *  cy_socket_t handle: Socket to be freed
+ *
+ *******************************************************************************/
+static void release_client_socket(uint8_t version, cy_socket_t handle)
+{
+    #if(ENABLE_SOCKET_POOL)
+        socket_pool_release(version, handle);
+    #else
+        (void)version;
+        cy_socket_delete(handle);
+    #endif /* ENABLE_SOCKET_POOL */
+}
+
+#if(ENABLE_CONNECT_STATE_REPORT)
+/*******************************************************************************
+ * Function Name: send_state_report
+ *******************************************************************************
+ * Summary:
+ *  Sends the state report as the first application message on a new
+ *  connection and logs the time to the first application byte, measured from
+ *  the start of the TCP connection.
+ *
+ * Parameters:
+ *  uint64_t connect_begin_us: Timestamp taken before cy_socket_connect()
+ *  uint32_t handshake_us: Duration of the TCP connection and TLS handshake
  *
  * Return:
  *  cy_result result: Result of the operation
  *
  *******************************************************************************/
-cy_rslt_t tcp_client_recv_handler(cy_socket_t socket_handle, void *arg)
+static cy_rslt_t send_state_report(uint64_t connect_begin_us, uint32_t handshake_us)
 {
-    /* Variable to store number of bytes send to the TCP server. */
+    uint8_t report[STATE_REPORT_LEN];
     uint32_t bytes_sent = 0;
+    cy_rslt_t result;
 
-    /* Variable to store number of bytes received. */
-    uint32_t bytes_received = 0;
-
-    char message_buffer[MAX_TCP_DATA_PACKET_LENGTH] = {0};
-    cy_rslt_t result = 0;
+    report[0] = STATE_REPORT_MSG;
+    report[1] = (cyhal_gpio_read(CYBSP_USER_LED) == CYBSP_LED_STATE_ON) ? ACK_STATUS_LED_ON : 0u;
+    app_protocol_put_u16(&report[2], connection_count);
+    app_protocol_put_u32(&report[4], handshake_us);
 
-    result = cy_socket_recv(socket_handle, message_buffer, TCP_LED_CMD_LEN,
-                            CY_SOCKET_FLAGS_NONE, &bytes_received);
-    if(result == CY_RSLT_SUCCESS)
+    result = cy_socket_send(client_handle, report, sizeof(report),
+                            CY_SOCKET_FLAGS_NONE, &bytes_sent);
+    if(result != CY_RSLT_SUCCESS)
     {
-        printf("============================================================\n");
-        if(message_buffer[0] == LED_ON_CMD)
-        {
-            /* Turn the LED ON. */
-            cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_ON);
-            printf("LED turned ON\n");
-            sprintf(message_buffer, ACK_LED_ON);
-        }
-        else if(message_buffer[0] == LED_OFF_CMD)
-        {
-            /* Turn the LED OFF. */
-            cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_OFF);
-            printf("LED turned OFF\n");
-            sprintf(message_buffer, ACK_LED_OFF);
-        }
-        else
-        {
-            printf("Invalid command : %c \n", message_buffer[0]);
-            sprintf(message_buffer, MSG_INVALID_CMD);
-        }
+        APP_LOG_WARN("State report not sent! Error Code: %"PRIu32"\n", result);
     }
-
-    /* Send acknowledgement to the secure TCP server in receipt of the message received. */
-    result = cy_socket_send(socket_handle, message_buffer, strlen(message_buffer),
-                            CY_SOCKET_FLAGS_NONE, &bytes_sent);
-    if(result == CY_RSLT_SUCCESS)
+    else
     {
-        printf("Acknowledgement sent to TCP server\n");
+        METRICS_RECORD_SENT(bytes_sent);
+        APP_LOG_INFO("Time to first application byte: %"PRIu32" us\n",
+                     (uint32_t)(app_time_us() - connect_begin_us));
     }
-    
-    print_heap_usage("After controlling the LED and ACKing server");
 
     return result;
 }
+#endif /* ENABLE_CONNECT_STATE_REPORT */
 
 /*******************************************************************************
  * Function Name: tcp_disconnection_handler
@@ -635,39 +1837,35 @@ cy_rslt_t tcp_client_recv_handler(cy_socket_t socket_handle, void *arg)
  *******************************************************************************/
 cy_rslt_t tcp_disconnection_handler(cy_socket_t socket_handle, void *arg)
 {
-    cy_rslt_t result;
-
-    /* Disconnect the TCP client. */
-    result = cy_socket_disconnect(socket_handle, 0);
-    
-    /* Free the resources allocated to the socket. */
-    cy_socket_delete(socket_handle);
+    connection_event_t event = { .type = CONNECTION_EVENT_DISCONNECTED,
+                                 .data.handle = socket_handle };
 
-    printf("Disconnected from the TCP server! \n");
+    /* The socket is closed by the network task. */
+    connection_event_post(&event);
 
-    /* Give the semaphore so as to connect to TCP server.  */
-    xSemaphoreGive(connect_to_server);
-
-    return result;
+    return CY_RSLT_SUCCESS;
 }
 
 /*******************************************************************************
  * Function Name: read_uart_input
  *******************************************************************************
  * Summary:
- *  Function to read user input from UART terminal.
+ *  Function to read user input from UART terminal. Characters beyond the size
+ *  of the buffer are dropped.
  *
  * Parameters:
  *  uint8_t* input_buffer_ptr: Pointer to input buffer
+ *  size_t buffer_size: Size of the input buffer, including the NUL
  *
  * Return:
  *  None
  *
  *******************************************************************************/
-void read_uart_input(uint8_t* input_buffer_ptr)
+void read_uart_input(uint8_t* input_buffer_ptr, size_t buffer_size)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;    
     uint8_t *ptr = input_buffer_ptr; 
+    uint8_t *last = input_buffer_ptr + buffer_size - 1u;
     uint32_t numBytes;
 
     do
@@ -693,7 +1891,13 @@ void read_uart_input(uint8_t* input_buffer_ptr)
 
                     if (*ptr != '\b')
                     {
-                        ptr++;
+                        /* When the buffer is full, the last character is
+                         * overwritten.
+                         */
+                        if(ptr != last)
+                        {
+                            ptr++;
+                        }
                     }
                     else if(ptr != input_buffer_ptr)
                     {
@@ -703,7 +1907,7 @@ void read_uart_input(uint8_t* input_buffer_ptr)
             }
         }
 
-        vTaskDelay(RTOS_TICK_TO_WAIT);
+        vTaskDelay(APP_PARAM(APP_PARAM_CONSOLE_POLL_TICKS, RTOS_TICK_TO_WAIT));
 
     } while((*ptr != '\r') && (*ptr != '\n'));
 
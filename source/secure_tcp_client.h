@@ -52,15 +52,68 @@
 /* Length of the LED ON/OFF command issued from the TCP server. */
 #define TCP_LED_CMD_LEN                       (1)
 
-/* Set this macro to '1' to enable IPv6 protocol. Default value is '0' to use
- * IPv4 protocol.
+/* Timeouts of each connection attempt, in milliseconds. TCP establishment and
+ * the TLS handshake share one budget of TCP_CONNECT_TIMEOUT_MS +
+ * TLS_HANDSHAKE_TIMEOUT_MS, and each read of the handshake is bounded by
+ * TLS_HANDSHAKE_TIMEOUT_MS. FIRST_BYTE_TIMEOUT_MS bounds the send of the first
+ * application message once connected.
  */
-#define USE_IPV6_ADDRESS                      (0)
+#define TCP_CONNECT_TIMEOUT_MS                (5000u)
+#define TLS_HANDSHAKE_TIMEOUT_MS              (5000u)
+#define FIRST_BYTE_TIMEOUT_MS                 (2000u)
+
+/* Overall time allowed for all connection retries, in milliseconds. */
+#define CONNECT_DEADLINE_MS                   (30000u)
+
+/* Interval at which the connection attempts are polled for their staggered
+ * start and their timeouts. Completed attempts are processed immediately.
+ */
+#define CONNECT_POLL_INTERVAL_MS              (100u)
+
+/* Delay before the first retry after a failed attempt, in milliseconds. The
+ * delay doubles with every retry up to CONNECT_BACKOFF_MAX_MS.
+ */
+#define CONNECT_BACKOFF_MS                    (500u)
+#define CONNECT_BACKOFF_MAX_MS                (4000u)
+
+/* Set this macro to '1' to enable TCP keepalive on the client socket. After
+ * TCP_KEEPALIVE_IDLE_MS without traffic, a probe is sent every
+ * TCP_KEEPALIVE_INTERVAL_MS, and the connection is dropped when
+ * TCP_KEEPALIVE_COUNT probes are unanswered. Requires LWIP_TCP_KEEPALIVE in
+ * lwipopts.h.
+ */
+#define ENABLE_TCP_KEEPALIVE                  (1)
+#define TCP_KEEPALIVE_IDLE_MS                 (10000u)
+#define TCP_KEEPALIVE_INTERVAL_MS             (2000u)
+#define TCP_KEEPALIVE_COUNT                   (3u)
+
+/* Set this macro to '1' to send an application heartbeat every
+ * HEARTBEAT_INTERVAL_MS while connected. The server is declared dead and the
+ * client reconnects when HEARTBEAT_MISS_THRESHOLD heartbeats in a row are
+ * not answered. Unlike TCP keepalive, the heartbeat also detects a server
+ * whose TCP stack is alive but whose application is stuck.
+ */
+#define ENABLE_HEARTBEAT                      (1)
+#define HEARTBEAT_INTERVAL_MS                 (2000u)
+#define HEARTBEAT_MISS_THRESHOLD              (3u)
+
 #define TCP_SERVER_PORT                       (50007)
 #define RTOS_TICK_TO_WAIT                     (50u)
 #define UART_INPUT_TIMEOUT_MS                 (1u)
 #define UART_BUFFER_SIZE                      (50u)
 
+/* Set this macro to '1' to parse the TLS credentials in a separate task while
+ * the Wi-Fi device joins the network. Set it to '0' to run the startup stages
+ * one after another. The boot-to-connected time is printed in both cases.
+ */
+#define ENABLE_STARTUP_OVERLAP                (1)
+
+/* Set this macro to '1' to send a state report (LED state, connection count
+ * and handshake time) as the first message after every connection. The
+ * report is idempotent, so it can be sent without waiting for the server.
+ */
+#define ENABLE_CONNECT_STATE_REPORT           (1)
+
 /*******************************************************************************
 * Function Prototype
 ********************************************************************************/
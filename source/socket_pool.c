@@ -0,0 +1,312 @@
+/******************************************************************************
+* File Name:   socket_pool.c
+*
+* Description: This file contains the secure socket pool. The client socket is
+* created and configured (receive and disconnection callbacks, TLS identity and
+* authentication mode) ahead of time, so that a connection attempt starts with
+* cy_socket_connect() instead of cy_socket_create() and four socket options.
+*
+* A socket is not connected twice: once lwIP has attempted a TCP connection
+* on it, the underlying connection cannot be reused, and the TLS context of
+* secure sockets is allocated by cy_socket_connect() and freed on disconnect.
+* A released socket is therefore deleted, and a low-priority task creates its
+* replacement once the connection attempt tasks and the network task are idle.
+* The pool does not save any allocation: it only moves the socket creation out
+* of the connection attempt.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <task.h>
+
+/* Standard C header files. */
+#include <inttypes.h>
+
+/* Socket pool, logging and timestamp header files. */
+#include "socket_pool.h"
+#include "app_log.h"
+#include "app_time.h"
+
+#if(ENABLE_SOCKET_POOL)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define SOCKET_POOL_FAMILIES               (2u)
+
+/* Pool index of an IP version. */
+#define SOCKET_POOL_INDEX(version)         (((version) == 6u) ? 1u : 0u)
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static cy_rslt_t socket_pool_create_measured(uint8_t version, cy_socket_t *handle,
+                                             socket_pool_info_t *info);
+static void socket_pool_refill(uint8_t version);
+static void socket_pool_task(void *arg);
+void get_heap_usage(uint32_t *heap_in_use, uint32_t *heap_max_used);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static socket_pool_create_t socket_pool_create;
+static SemaphoreHandle_t socket_pool_mutex;
+static TaskHandle_t socket_pool_task_handle;
+static cy_socket_t socket_pool[SOCKET_POOL_FAMILIES][SOCKET_POOL_SIZE];
+static socket_pool_info_t socket_pool_info[SOCKET_POOL_FAMILIES][SOCKET_POOL_SIZE];
+static uint32_t socket_pool_count[SOCKET_POOL_FAMILIES];
+
+/*******************************************************************************
+ * Function Name: socket_pool_init
+ *******************************************************************************
+ * Summary:
+ *  Binds the socket configuration of the application, fills the pools of
+ *  both IP versions and starts the refill task.
+ *
+ * Parameters:
+ *  socket_pool_create_t create: Creates and configures one socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+cy_rslt_t socket_pool_init(socket_pool_create_t create)
+{
+    socket_pool_create = create;
+
+    socket_pool_mutex = xSemaphoreCreateMutex();
+    if(socket_pool_mutex == NULL)
+    {
+        APP_LOG_ERR("Failed to create the socket pool mutex!\n");
+        return CY_RSLT_MODULE_SECURE_SOCKETS_NOMEM;
+    }
+
+    socket_pool_refill(4u);
+    socket_pool_refill(6u);
+
+    if(pdPASS != xTaskCreate(socket_pool_task, "Socket pool task", SOCKET_POOL_TASK_STACK_SIZE,
+                             NULL, SOCKET_POOL_TASK_PRIORITY, &socket_pool_task_handle))
+    {
+        APP_LOG_ERR("Failed to create the socket pool task!\n");
+        return CY_RSLT_MODULE_SECURE_SOCKETS_NOMEM;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: socket_pool_acquire
+ *******************************************************************************
+ * Summary:
+ *  Returns a configured socket for a connection attempt. Creates one when the
+ *  pool is empty.
+ *
+ * Parameters:
+ *  uint8_t version: IP version of the socket (4 or 6)
+ *  cy_socket_t *handle: Configured socket
+ *  socket_pool_info_t *info: Origin and creation cost of the socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+cy_rslt_t socket_pool_acquire(uint8_t version, cy_socket_t *handle, socket_pool_info_t *info)
+{
+    uint32_t index = SOCKET_POOL_INDEX(version);
+    bool pooled;
+
+    xSemaphoreTake(socket_pool_mutex, portMAX_DELAY);
+    pooled = (socket_pool_count[index] > 0u);
+    if(pooled)
+    {
+        socket_pool_count[index]--;
+        *handle = socket_pool[index][socket_pool_count[index]];
+        *info = socket_pool_info[index][socket_pool_count[index]];
+    }
+    xSemaphoreGive(socket_pool_mutex);
+
+    if(pooled)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    /* The refill task has not caught up: the creation is part of the attempt. */
+    return socket_pool_create_measured(version, handle, info);
+}
+
+/*******************************************************************************
+ * Function Name: socket_pool_release
+ *******************************************************************************
+ * Summary:
+ *  Deletes a socket after its connection attempt or connection has ended and
+ *  wakes up the refill task. The replacement socket is created once the
+ *  calling task and the other application tasks are blocked.
+ *
+ * Parameters:
+ *  uint8_t version: IP version of the socket (4 or 6)
+ *  cy_socket_t handle: Socket returned by socket_pool_acquire()
+ *
+ *******************************************************************************/
+void socket_pool_release(uint8_t version, cy_socket_t handle)
+{
+    (void)version;
+
+    cy_socket_delete(handle);
+    xTaskNotifyGive(socket_pool_task_handle);
+}
+
+/*******************************************************************************
+ * Function Name: socket_pool_create_measured
+ *******************************************************************************
+ * Summary:
+ *  Creates and configures one socket and records the time and the heap bytes
+ *  spent on it. Both include the work of any task that preempts the creation.
+ *
+ * Parameters:
+ *  uint8_t version: IP version of the socket (4 or 6)
+ *  cy_socket_t *handle: Configured socket
+ *  socket_pool_info_t *info: Creation cost of the socket
+ *
+ * Return:
+ *  cy_result result: Result of the operation
+ *
+ *******************************************************************************/
+static cy_rslt_t socket_pool_create_measured(uint8_t version, cy_socket_t *handle,
+                                             socket_pool_info_t *info)
+{
+    uint64_t create_begin_us;
+    uint32_t heap_before;
+    uint32_t heap_in_use;
+    uint32_t heap_max_used;
+    cy_rslt_t result;
+
+    get_heap_usage(&heap_before, &heap_max_used);
+    create_begin_us = app_time_us();
+    result = socket_pool_create(version, handle);
+    info->create_us = (uint32_t)(app_time_us() - create_begin_us);
+    get_heap_usage(&heap_in_use, &heap_max_used);
+
+    info->pooled = false;
+    info->heap_bytes = heap_in_use - heap_before;
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: socket_pool_refill
+ *******************************************************************************
+ * Summary:
+ *  Creates sockets until the pool of an IP version holds SOCKET_POOL_SIZE of
+ *  them, and prints the time and the heap bytes spent on each of them.
+ *
+ * Parameters:
+ *  uint8_t version: IP version of the pool (4 or 6)
+ *
+ *******************************************************************************/
+static void socket_pool_refill(uint8_t version)
+{
+    uint32_t index = SOCKET_POOL_INDEX(version);
+    socket_pool_info_t info;
+    cy_socket_t handle;
+    cy_rslt_t result;
+    bool full;
+
+    for(;;)
+    {
+        xSemaphoreTake(socket_pool_mutex, portMAX_DELAY);
+        full = (socket_pool_count[index] >= SOCKET_POOL_SIZE);
+        xSemaphoreGive(socket_pool_mutex);
+
+        if(full)
+        {
+            break;
+        }
+
+        /* Created without the mutex, so that an acquire does not wait for the
+         * refill. Only this task and socket_pool_init() add sockets.
+         */
+        result = socket_pool_create_measured(version, &handle, &info);
+        if(result != CY_RSLT_SUCCESS)
+        {
+            /* Retried on the next release; acquire falls back to creating. */
+            APP_LOG_WARN("Socket pool refill failed! Error Code: %"PRIu32"\n", result);
+            break;
+        }
+        info.pooled = true;
+
+        xSemaphoreTake(socket_pool_mutex, portMAX_DELAY);
+        socket_pool[index][socket_pool_count[index]] = handle;
+        socket_pool_info[index][socket_pool_count[index]] = info;
+        socket_pool_count[index]++;
+        xSemaphoreGive(socket_pool_mutex);
+
+        APP_LOG_INFO("IPv%"PRIu32" socket pool refill: 1 socket in %"PRIu32" us, "
+                     "%"PRIu32" heap bytes allocated\n", (uint32_t)version,
+                     info.create_us, info.heap_bytes);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: socket_pool_task
+ *******************************************************************************
+ * Summary:
+ *  Refills the pools after each release. The task runs at the lowest priority,
+ *  after the outcome of the attempt has been handled.
+ *
+ * Parameters:
+ *  void *arg: Unused
+ *
+ *******************************************************************************/
+static void socket_pool_task(void *arg)
+{
+    (void)arg;
+
+    for(;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        socket_pool_refill(4u);
+        socket_pool_refill(6u);
+    }
+}
+
+#endif /* ENABLE_SOCKET_POOL */
+
+/* [] END OF FILE */
@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name:   socket_pool.h
+*
+* Description: This file contains the macros and the function prototypes of the
+* secure socket pool.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SOCKET_POOL_H_
+#define SOCKET_POOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set this macro to '0' to create and configure the client socket at the
+ * start of every connection attempt instead.
+ */
+#define ENABLE_SOCKET_POOL                    (1)
+
+/* Number of configured sockets kept ready for connection attempts, for each
+ * IP version.
+ */
+#define SOCKET_POOL_SIZE                      (1u)
+
+/* The refill task runs below the network and connection attempt tasks, so that
+ * a refill does not delay the outcome of an attempt or the next attempt.
+ */
+#define SOCKET_POOL_TASK_STACK_SIZE           (2 * 1024)
+#define SOCKET_POOL_TASK_PRIORITY             (0u)
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+/* Creates a socket of the given IP version (4 or 6) and applies the socket
+ * options of the application.
+ */
+typedef cy_rslt_t (*socket_pool_create_t)(uint8_t version, cy_socket_t *handle);
+
+/* Creation cost of an acquired socket. The time and heap bytes are those of
+ * its cy_socket_create() and socket options, whether they were spent by the
+ * refill task or by socket_pool_acquire() itself.
+ */
+typedef struct
+{
+    bool pooled;
+    uint32_t create_us;
+    uint32_t heap_bytes;
+} socket_pool_info_t;
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+cy_rslt_t socket_pool_init(socket_pool_create_t create);
+cy_rslt_t socket_pool_acquire(uint8_t version, cy_socket_t *handle, socket_pool_info_t *info);
+void socket_pool_release(uint8_t version, cy_socket_t handle);
+
+#endif /* SOCKET_POOL_H_ */
@@ -0,0 +1,406 @@
+/******************************************************************************
+* File Name:   telemetry.c
+*
+* Description: This file contains the telemetry publisher. A FreeRTOS timer
+* wakes the telemetry task, which samples the device state and adds the
+* sample to the current batch. The batch is sent to the TCP server as one
+* TLS record when it is full or when its flush deadline passes.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#include <timers.h>
+
+/* Standard C header file. */
+#include <inttypes.h>
+
+/* Wi-Fi connection manager header file. */
+#include "cy_wcm.h"
+
+/* Telemetry, protocol and logging header files. */
+#include "telemetry.h"
+#include "app_protocol.h"
+#include "app_log.h"
+#include "compact_codec.h"
+#include "metrics.h"
+#include "app_params.h"
+
+/* Secure TCP client and Wi-Fi credentials header files for ENABLE_STA. */
+#include "secure_tcp_client.h"
+#include "network_credentials.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Task notification bit set by the sampling timer. */
+#define TELEMETRY_SAMPLE_BIT               (1u << 0)
+
+#if(USE_COMPACT_ENCODING)
+/* Worst case: every difference needs a full-length varint. */
+#define TELEMETRY_FRAME_MAX_LEN            (TELEMETRY_FRAME_HEADER_LEN + \
+                                            TELEMETRY_PAYLOAD_HEADER_LEN + \
+                                            (TELEMETRY_BATCH_SIZE * TELEMETRY_DELTA_FIELD_COUNT * \
+                                             COMPACT_CODEC_VARINT_MAX_LEN) + \
+                                            COMPACT_CODEC_BITMAP_LEN(TELEMETRY_BATCH_SIZE))
+#else
+#define TELEMETRY_FRAME_MAX_LEN            (TELEMETRY_FRAME_HEADER_LEN + \
+                                            TELEMETRY_PAYLOAD_HEADER_LEN + \
+                                            (TELEMETRY_BATCH_SIZE * TELEMETRY_SAMPLE_LEN))
+#endif /* USE_COMPACT_ENCODING */
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void get_heap_usage(uint32_t *heap_in_use, uint32_t *heap_max_used);
+static void telemetry_task(void *arg);
+static void telemetry_timer_callback(TimerHandle_t timer);
+static void telemetry_take_sample(telemetry_sample_t *sample);
+static uint8_t *telemetry_encode_batch(uint8_t *ptr);
+static void telemetry_flush(void);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static TaskHandle_t telemetry_task_handle;
+static TimerHandle_t telemetry_timer;
+
+/* Protects the batch and the socket handle, which the telemetry task uses
+ * while the network task calls telemetry_start() and telemetry_stop() from
+ * connection_established() and connection_closed(). Holding it while a batch
+ * is sent makes telemetry_stop() wait for the send, so the network task does
+ * not delete the socket under the telemetry task.
+ */
+static SemaphoreHandle_t telemetry_mutex;
+
+/* Socket the batches are sent on; NULL while disconnected. */
+static cy_socket_t telemetry_socket;
+
+/* Task whose stack high-water mark is reported. */
+static TaskHandle_t telemetry_monitored_task;
+
+static telemetry_sample_t telemetry_batch[TELEMETRY_BATCH_SIZE];
+static uint32_t telemetry_batch_count;
+static TickType_t telemetry_batch_deadline;
+
+static uint8_t telemetry_frame[TELEMETRY_FRAME_MAX_LEN];
+
+/*******************************************************************************
+ * Function Name: telemetry_init
+ *******************************************************************************
+ * Summary:
+ *  Creates the telemetry task and starts the sampling timer.
+ *
+ *******************************************************************************/
+void telemetry_init(void)
+{
+    telemetry_mutex = xSemaphoreCreateMutex();
+
+    xTaskCreate(telemetry_task, "Telemetry task", TELEMETRY_TASK_STACK_SIZE,
+                NULL, TELEMETRY_TASK_PRIORITY, &telemetry_task_handle);
+
+    telemetry_timer = xTimerCreate("Telemetry timer",
+                                   pdMS_TO_TICKS(TELEMETRY_SAMPLE_INTERVAL_MS),
+                                   pdTRUE, NULL, telemetry_timer_callback);
+    xTimerStart(telemetry_timer, 0);
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_start
+ *******************************************************************************
+ * Summary:
+ *  Starts publishing telemetry on a connected socket.
+ *
+ * Parameters:
+ *  cy_socket_t socket_handle: Connected TCP client socket
+ *  TaskHandle_t monitored_task: Task whose stack high-water mark is reported
+ *
+ *******************************************************************************/
+void telemetry_start(cy_socket_t socket_handle, TaskHandle_t monitored_task)
+{
+    xSemaphoreTake(telemetry_mutex, portMAX_DELAY);
+    telemetry_socket = socket_handle;
+    telemetry_monitored_task = monitored_task;
+    telemetry_batch_count = 0u;
+    xSemaphoreGive(telemetry_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_stop
+ *******************************************************************************
+ * Summary:
+ *  Stops publishing telemetry and discards the current batch. Must be called
+ *  before the socket is deleted; waits for a batch being sent to complete.
+ *
+ *******************************************************************************/
+void telemetry_stop(void)
+{
+    xSemaphoreTake(telemetry_mutex, portMAX_DELAY);
+    telemetry_socket = NULL;
+    telemetry_batch_count = 0u;
+    xSemaphoreGive(telemetry_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_timer_callback
+ *******************************************************************************
+ * Summary:
+ *  Sampling timer callback. Runs in the timer service task, so the sample is
+ *  taken in the telemetry task instead.
+ *
+ *******************************************************************************/
+static void telemetry_timer_callback(TimerHandle_t timer)
+{
+    xTaskNotify(telemetry_task_handle, TELEMETRY_SAMPLE_BIT, eSetBits);
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_task
+ *******************************************************************************
+ * Summary:
+ *  Takes a sample on every timer tick, adds it to the batch and flushes the
+ *  batch when it is full or when its deadline passes.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ *******************************************************************************/
+static void telemetry_task(void *arg)
+{
+    telemetry_sample_t sample;
+    uint32_t notification;
+    TickType_t wait_ticks;
+
+    for(;;)
+    {
+        /* Wake up for the next sample or for the batch deadline. */
+        wait_ticks = portMAX_DELAY;
+        if(telemetry_batch_count > 0u)
+        {
+            TickType_t now = xTaskGetTickCount();
+            wait_ticks = ((int32_t)(telemetry_batch_deadline - now) > 0) ?
+                         (telemetry_batch_deadline - now) : 0u;
+        }
+
+        notification = 0u;
+        xTaskNotifyWait(0u, UINT32_MAX, &notification, wait_ticks);
+
+        if((notification & TELEMETRY_SAMPLE_BIT) != 0u)
+        {
+            telemetry_take_sample(&sample);
+        }
+
+        xSemaphoreTake(telemetry_mutex, portMAX_DELAY);
+
+        if(telemetry_socket != NULL)
+        {
+            if((notification & TELEMETRY_SAMPLE_BIT) != 0u)
+            {
+                if(telemetry_batch_count == 0u)
+                {
+                    telemetry_batch_deadline = xTaskGetTickCount() +
+                        pdMS_TO_TICKS(APP_PARAM(APP_PARAM_TELEMETRY_FLUSH_MS, TELEMETRY_FLUSH_DEADLINE_MS));
+                }
+                telemetry_batch[telemetry_batch_count++] = sample;
+            }
+
+            if((telemetry_batch_count >= APP_PARAM(APP_PARAM_TELEMETRY_BATCH, TELEMETRY_BATCH_SIZE)) ||
+               ((telemetry_batch_count > 0u) &&
+                ((int32_t)(xTaskGetTickCount() - telemetry_batch_deadline) >= 0)))
+            {
+                telemetry_flush();
+            }
+        }
+
+        xSemaphoreGive(telemetry_mutex);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_take_sample
+ *******************************************************************************
+ * Summary:
+ *  Samples the LED state, heap usage, RSSI and task statistics.
+ *
+ * Parameters:
+ *  telemetry_sample_t *sample: Sample to be filled
+ *
+ *******************************************************************************/
+static void telemetry_take_sample(telemetry_sample_t *sample)
+{
+    sample->timestamp_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    sample->led_state = (cyhal_gpio_read(CYBSP_USER_LED) == CYBSP_LED_STATE_ON) ? 1u : 0u;
+
+    get_heap_usage(&sample->heap_in_use, &sample->heap_max_used);
+
+    sample->rssi_dbm = 0;
+#if(ENABLE_STA)
+    cy_wcm_associated_ap_info_t ap_info;
+    if(cy_wcm_get_associated_ap_info(&ap_info) == CY_RSLT_SUCCESS)
+    {
+        sample->rssi_dbm = ap_info.signal_strength;
+    }
+#endif /* ENABLE_STA */
+
+    sample->task_count = (uint16_t)uxTaskGetNumberOfTasks();
+    sample->stack_hwm_words = (telemetry_monitored_task != NULL) ?
+                              (uint16_t)uxTaskGetStackHighWaterMark(telemetry_monitored_task) : 0u;
+}
+
+#if(USE_COMPACT_ENCODING)
+/*******************************************************************************
+ * Function Name: telemetry_encode_batch
+ *******************************************************************************
+ * Summary:
+ *  Encodes the batch in TELEMETRY_FORMAT_DELTA. Consecutive samples differ
+ *  little, so most differences fit in one or two varint bytes. Every batch
+ *  starts from an all-zero sample, so a lost batch does not affect the
+ *  decoding of the next one.
+ *
+ * Parameters:
+ *  uint8_t *ptr: Start of the telemetry payload
+ *
+ * Return:
+ *  uint8_t *: End of the encoded payload
+ *
+ *******************************************************************************/
+static uint8_t *telemetry_encode_batch(uint8_t *ptr)
+{
+    telemetry_sample_t previous = {0};
+    uint8_t *led_bitmap;
+
+    *ptr++ = TELEMETRY_FORMAT_DELTA;
+    *ptr++ = (uint8_t)telemetry_batch_count;
+
+    for(uint32_t i = 0; i < telemetry_batch_count; i++)
+    {
+        const telemetry_sample_t *sample = &telemetry_batch[i];
+
+        ptr += compact_codec_put_svarint(ptr, (int32_t)(sample->timestamp_ms - previous.timestamp_ms));
+        ptr += compact_codec_put_svarint(ptr, (int32_t)(sample->heap_in_use - previous.heap_in_use));
+        ptr += compact_codec_put_svarint(ptr, (int32_t)(sample->heap_max_used - previous.heap_max_used));
+        ptr += compact_codec_put_svarint(ptr, (int32_t)sample->rssi_dbm - previous.rssi_dbm);
+        ptr += compact_codec_put_svarint(ptr, (int32_t)sample->task_count - previous.task_count);
+        ptr += compact_codec_put_svarint(ptr, (int32_t)sample->stack_hwm_words - previous.stack_hwm_words);
+        previous = *sample;
+    }
+
+    led_bitmap = ptr;
+    for(uint32_t i = 0; i < telemetry_batch_count; i++)
+    {
+        compact_codec_put_bit(led_bitmap, i, (telemetry_batch[i].led_state != 0u));
+    }
+
+    return ptr + COMPACT_CODEC_BITMAP_LEN(telemetry_batch_count);
+}
+#else
+/*******************************************************************************
+ * Function Name: telemetry_encode_batch
+ *******************************************************************************
+ * Summary:
+ *  Encodes the batch in TELEMETRY_FORMAT_FIXED.
+ *
+ * Parameters:
+ *  uint8_t *ptr: Start of the telemetry payload
+ *
+ * Return:
+ *  uint8_t *: End of the encoded payload
+ *
+ *******************************************************************************/
+static uint8_t *telemetry_encode_batch(uint8_t *ptr)
+{
+    *ptr++ = TELEMETRY_FORMAT_FIXED;
+    *ptr++ = (uint8_t)telemetry_batch_count;
+
+    for(uint32_t i = 0; i < telemetry_batch_count; i++)
+    {
+        const telemetry_sample_t *sample = &telemetry_batch[i];
+
+        app_protocol_put_u32(ptr, sample->timestamp_ms);
+        app_protocol_put_u32(ptr + 4, sample->heap_in_use);
+        app_protocol_put_u32(ptr + 8, sample->heap_max_used);
+        app_protocol_put_u16(ptr + 12, (uint16_t)sample->rssi_dbm);
+        app_protocol_put_u16(ptr + 14, sample->task_count);
+        app_protocol_put_u16(ptr + 16, sample->stack_hwm_words);
+        ptr[18] = sample->led_state;
+        ptr += TELEMETRY_SAMPLE_LEN;
+    }
+
+    return ptr;
+}
+#endif /* USE_COMPACT_ENCODING */
+
+/*******************************************************************************
+ * Function Name: telemetry_flush
+ *******************************************************************************
+ * Summary:
+ *  Serializes the batch into a telemetry frame and sends it with a single
+ *  cy_socket_send() call. Called with the telemetry mutex held.
+ *
+ *******************************************************************************/
+static void telemetry_flush(void)
+{
+    uint8_t *ptr;
+    uint32_t bytes_sent = 0;
+    cy_rslt_t result;
+
+    ptr = telemetry_encode_batch(&telemetry_frame[TELEMETRY_FRAME_HEADER_LEN]);
+
+    uint32_t frame_len = (uint32_t)(ptr - telemetry_frame);
+    telemetry_frame[0] = TELEMETRY_MSG;
+    app_protocol_put_u16(&telemetry_frame[1], (uint16_t)(frame_len - TELEMETRY_FRAME_HEADER_LEN));
+
+    result = cy_socket_send(telemetry_socket, telemetry_frame, frame_len,
+                            CY_SOCKET_FLAGS_NONE, &bytes_sent);
+    if(result != CY_RSLT_SUCCESS)
+    {
+        APP_LOG_WARN("Telemetry batch not sent! Error Code: %"PRIu32"\n", result);
+    }
+    else
+    {
+        METRICS_RECORD_SENT(bytes_sent);
+        APP_LOG_DEBUG("Telemetry batch sent: %"PRIu32" samples, %"PRIu32" bytes\n",
+                      telemetry_batch_count, frame_len);
+    }
+
+    telemetry_batch_count = 0u;
+}
+
+/* [] END OF FILE */
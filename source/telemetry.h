@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name:   telemetry.h
+*
+* Description: This file contains the declarations of the telemetry publisher,
+* which samples the device state on a FreeRTOS timer and pushes batches
+* of samples to the TCP server over the secure connection.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+
+/* FreeRTOS header file. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set this macro to '0' to disable the telemetry publisher. */
+#define ENABLE_TELEMETRY                      (1)
+
+/* Sampling interval of the telemetry timer. */
+#define TELEMETRY_SAMPLE_INTERVAL_MS          (1000u)
+
+/* A batch is sent as a single TLS record when it holds this many samples or
+ * when its oldest sample is TELEMETRY_FLUSH_DEADLINE_MS old, whichever comes
+ * first.
+ */
+#define TELEMETRY_BATCH_SIZE                  (10u)
+#define TELEMETRY_FLUSH_DEADLINE_MS           (5000u)
+
+/* RTOS related macros for the telemetry task. */
+#define TELEMETRY_TASK_STACK_SIZE             (1024u)
+#define TELEMETRY_TASK_PRIORITY               (1u)
+
+/*******************************************************************************
+* Data structure
+********************************************************************************/
+typedef struct
+{
+    uint32_t timestamp_ms;
+    uint32_t heap_in_use;
+    uint32_t heap_max_used;
+    int16_t rssi_dbm;
+    uint16_t task_count;
+    uint16_t stack_hwm_words;
+    uint8_t led_state;
+} telemetry_sample_t;
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void telemetry_init(void);
+void telemetry_start(cy_socket_t socket_handle, TaskHandle_t monitored_task);
+void telemetry_stop(void);
+
+#endif /* TELEMETRY_H_ */
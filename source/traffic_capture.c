@@ -0,0 +1,264 @@
+/******************************************************************************
+* File Name:   traffic_capture.c
+*
+* Description: This file contains the traffic capture. With CAPTURE=1 the
+* linker routes every cy_socket_send() and cy_socket_recv() call through this
+* file, which records the application data with a timestamp into a ring
+* buffer. A low-priority task writes the ring to the debug UART as hex lines,
+* which tools/capture_extract.py turns into a capture file for the host
+* replay tool (tools/replay).
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes. */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header files. */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <inttypes.h>
+
+/* Cypress secure socket header file. */
+#include "cy_secure_sockets.h"
+
+/* Capture, encoding and timestamp header files. */
+#include "traffic_capture.h"
+#include "compact_codec.h"
+#include "app_time.h"
+
+#if(ENABLE_TRAFFIC_CAPTURE)
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define TRAFFIC_CAPTURE_RING_MASK          (TRAFFIC_CAPTURE_RING_SIZE - 1u)
+#define TRAFFIC_CAPTURE_HEADER_MAX_LEN     (2u * COMPACT_CODEC_VARINT_MAX_LEN)
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void traffic_capture_record(uint8_t direction, const void *data, uint32_t length);
+static void traffic_capture_task(void *arg);
+cy_rslt_t __real_cy_socket_send(cy_socket_t handle, const void *buffer, uint32_t length,
+                                int flags, uint32_t *bytes_sent);
+cy_rslt_t __real_cy_socket_recv(cy_socket_t handle, void *buffer, uint32_t length,
+                                int flags, uint32_t *bytes_received);
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Written by the senders and receivers in a critical section; read by the
+ * capture task. The indices run freely and are masked on access.
+ */
+static uint8_t traffic_capture_ring[TRAFFIC_CAPTURE_RING_SIZE];
+static volatile uint32_t traffic_capture_head;
+static volatile uint32_t traffic_capture_tail;
+static volatile uint32_t traffic_capture_dropped;
+
+/* Timestamp of the last record. */
+static uint64_t traffic_capture_last_us;
+
+/*******************************************************************************
+ * Function Name: traffic_capture_init
+ *******************************************************************************
+ * Summary:
+ *  Marks the start of a capture on the debug UART and creates the capture
+ *  task.
+ *
+ *******************************************************************************/
+void traffic_capture_init(void)
+{
+    traffic_capture_last_us = app_time_us();
+    printf("[capture] start\n");
+
+    if(pdPASS != xTaskCreate(traffic_capture_task, "Capture task", TRAFFIC_CAPTURE_TASK_STACK_SIZE,
+                             NULL, TRAFFIC_CAPTURE_TASK_PRIORITY, NULL))
+    {
+        printf("Failed to create the capture task!\n");
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: traffic_capture_record
+ *******************************************************************************
+ * Summary:
+ *  Adds a record to the ring, or drops it if the ring is full. Senders and
+ *  receivers run in different tasks, so the record is written in a critical
+ *  section; the records are a few hundred bytes at most.
+ *
+ * Parameters:
+ *  uint8_t direction: TRAFFIC_CAPTURE_DIR_IN or TRAFFIC_CAPTURE_DIR_OUT
+ *  const void *data: Application data
+ *  uint32_t length: Length of the data
+ *
+ *******************************************************************************/
+static void traffic_capture_record(uint8_t direction, const void *data, uint32_t length)
+{
+    uint8_t header[TRAFFIC_CAPTURE_HEADER_MAX_LEN];
+    uint32_t header_len;
+    uint32_t head;
+    uint64_t now;
+    uint64_t delta_us;
+
+    taskENTER_CRITICAL();
+
+    now = app_time_us();
+    delta_us = now - traffic_capture_last_us;
+    header_len = compact_codec_put_varint(header, (delta_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)delta_us);
+    header_len += compact_codec_put_varint(&header[header_len], (length << 1) | direction);
+
+    head = traffic_capture_head;
+    if((header_len + length) > (TRAFFIC_CAPTURE_RING_SIZE - (head - traffic_capture_tail)))
+    {
+        traffic_capture_dropped++;
+    }
+    else
+    {
+        for(uint32_t i = 0; i < header_len; i++)
+        {
+            traffic_capture_ring[head++ & TRAFFIC_CAPTURE_RING_MASK] = header[i];
+        }
+        for(uint32_t i = 0; i < length; i++)
+        {
+            traffic_capture_ring[head++ & TRAFFIC_CAPTURE_RING_MASK] = ((const uint8_t *)data)[i];
+        }
+        traffic_capture_head = head;
+        traffic_capture_last_us = now;
+    }
+
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: traffic_capture_task
+ *******************************************************************************
+ * Summary:
+ *  Low-priority task that writes the ring to the debug UART as
+ *  "[capture] <hex>" lines.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ *******************************************************************************/
+static void traffic_capture_task(void *arg)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    char line[(2u * TRAFFIC_CAPTURE_LINE_BYTES) + 1u];
+    uint32_t dropped_reported = 0u;
+    uint32_t tail;
+    uint32_t count;
+    uint8_t value;
+
+    for(;;)
+    {
+        tail = traffic_capture_tail;
+        while(tail != traffic_capture_head)
+        {
+            count = 0u;
+            while((tail != traffic_capture_head) && (count < TRAFFIC_CAPTURE_LINE_BYTES))
+            {
+                value = traffic_capture_ring[tail & TRAFFIC_CAPTURE_RING_MASK];
+                line[2u * count] = hex_digits[value >> 4];
+                line[(2u * count) + 1u] = hex_digits[value & 0x0Fu];
+                tail++;
+                count++;
+            }
+            line[2u * count] = '\0';
+
+            /* Release the bytes to the writers. */
+            traffic_capture_tail = tail;
+
+            printf("[capture] %s\n", line);
+        }
+
+        if(traffic_capture_dropped != dropped_reported)
+        {
+            dropped_reported = traffic_capture_dropped;
+            printf("[capture] dropped %"PRIu32"\n", dropped_reported);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(TRAFFIC_CAPTURE_DRAIN_INTERVAL_MS));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cy_socket_send
+ *******************************************************************************
+ * Summary:
+ *  Records the data accepted by cy_socket_send(). The linker routes the calls
+ *  here with -Wl,--wrap=cy_socket_send.
+ *
+ *******************************************************************************/
+cy_rslt_t __wrap_cy_socket_send(cy_socket_t handle, const void *buffer, uint32_t length,
+                                int flags, uint32_t *bytes_sent)
+{
+    cy_rslt_t result = __real_cy_socket_send(handle, buffer, length, flags, bytes_sent);
+
+    if((result == CY_RSLT_SUCCESS) && (bytes_sent != NULL) && (*bytes_sent > 0u))
+    {
+        traffic_capture_record(TRAFFIC_CAPTURE_DIR_OUT, buffer, *bytes_sent);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cy_socket_recv
+ *******************************************************************************
+ * Summary:
+ *  Records the data returned by cy_socket_recv(). The linker routes the calls
+ *  here with -Wl,--wrap=cy_socket_recv.
+ *
+ *******************************************************************************/
+cy_rslt_t __wrap_cy_socket_recv(cy_socket_t handle, void *buffer, uint32_t length,
+                                int flags, uint32_t *bytes_received)
+{
+    cy_rslt_t result = __real_cy_socket_recv(handle, buffer, length, flags, bytes_received);
+
+    if((result == CY_RSLT_SUCCESS) && (bytes_received != NULL) && (*bytes_received > 0u))
+    {
+        traffic_capture_record(TRAFFIC_CAPTURE_DIR_IN, buffer, *bytes_received);
+    }
+
+    return result;
+}
+
+#endif /* ENABLE_TRAFFIC_CAPTURE */
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/******************************************************************************
+* File Name:   traffic_capture.h
+*
+* Description: This file contains the macros and the prototype of the traffic
+* capture, which records the application data passed to and from the secure
+* sockets for replay on the host.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TRAFFIC_CAPTURE_H_
+#define TRAFFIC_CAPTURE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set to '1' by the Makefile (CAPTURE=1), which also routes cy_socket_send()
+ * and cy_socket_recv() through the capture.
+ */
+#ifndef ENABLE_TRAFFIC_CAPTURE
+#define ENABLE_TRAFFIC_CAPTURE                (0)
+#endif
+
+/* Size of the capture ring in bytes. Records that do not fit are dropped. */
+#define TRAFFIC_CAPTURE_RING_SIZE             (4096u)
+
+/* Number of capture bytes written per line to the debug UART. */
+#define TRAFFIC_CAPTURE_LINE_BYTES            (32u)
+
+/* Interval at which the capture task writes the ring to the debug UART. */
+#define TRAFFIC_CAPTURE_DRAIN_INTERVAL_MS     (100u)
+
+/* RTOS related macros for the capture task. */
+#define TRAFFIC_CAPTURE_TASK_STACK_SIZE       (1024u)
+#define TRAFFIC_CAPTURE_TASK_PRIORITY         (0u)
+
+/* Capture file format, shared with tools/capture_extract.py and
+ * tools/replay/traffic_replay.c.
+ *
+ * File    : "TCAP" | version (1) | records
+ * Record  : delta_us | (length << 1) | direction | data
+ *
+ * delta_us is the time since the previous record and both fields are
+ * varints. Direction 0 is data returned by cy_socket_recv(), 1 is data
+ * accepted by cy_socket_send().
+ */
+#define TRAFFIC_CAPTURE_MAGIC                 "TCAP"
+#define TRAFFIC_CAPTURE_VERSION               (1u)
+#define TRAFFIC_CAPTURE_DIR_IN                (0u)
+#define TRAFFIC_CAPTURE_DIR_OUT               (1u)
+
+/*******************************************************************************
+* Function Prototype
+********************************************************************************/
+void traffic_capture_init(void);
+
+#endif /* TRAFFIC_CAPTURE_H_ */
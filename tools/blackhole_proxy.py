@@ -0,0 +1,189 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   blackhole_proxy.py
+#
+# Description: TCP proxy for measuring the dead-peer detection of the secure TCP client.
+#              Forwards the connections of the client to the TCP server and, after a
+#              configurable time, silently drops all traffic of the open connections
+#              without closing them, as an AP roam or a server crash without FIN would.
+#              New connections are forwarded again, so the time from the black hole to
+#              the next connection of the client is its detection-to-reconnect time.
+#              Usage: python tcp_secure_server.py --port 50008
+#                     python blackhole_proxy.py [--listen-port 50007]
+#                     [--server 127.0.0.1:50008] [--after 10] [--trials 5]
+#              Enter the address of the proxy host on the client.
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import selectors
+import socket
+import sys
+import time
+
+
+class Proxy:
+    def __init__(self, server, after, trials):
+        self.server = server
+        self.after = after
+        self.trials = trials
+        self.selector = selectors.DefaultSelector()
+        self.peers = {}
+        self.connections = []
+        self.blackhole_at = None
+        self.results = []
+
+    def log(self, message):
+        print('%s %s' % (time.strftime('%H:%M:%S'), message))
+        sys.stdout.flush()
+
+    def accept(self, listener):
+        client, address = listener.accept()
+        try:
+            server = socket.create_connection(self.server)
+        except OSError as error:
+            self.log('Cannot reach the TCP server: %s' % error)
+            client.close()
+            return
+        now = time.monotonic()
+        if self.blackhole_at is not None:
+            elapsed = now - self.blackhole_at
+            self.results.append(elapsed)
+            self.log('Client %s reconnected %.1f s after the black hole' % (address[0], elapsed))
+            self.blackhole_at = None
+        else:
+            self.log('Client %s connected' % address[0])
+        for sock in (client, server):
+            sock.setblocking(False)
+            self.selector.register(sock, selectors.EVENT_READ)
+        self.peers[client] = server
+        self.peers[server] = client
+        self.connections.append({'client': client, 'server': server, 'since': now,
+                                 'blackholed': False})
+
+    def close(self, sock):
+        peer = self.peers.pop(sock, None)
+        for s in (sock, peer):
+            if s is None:
+                continue
+            self.peers.pop(s, None)
+            try:
+                self.selector.unregister(s)
+            except (KeyError, ValueError):
+                pass
+            s.close()
+        self.connections = [c for c in self.connections
+                            if c['client'] is not sock and c['server'] is not sock]
+
+    def forward(self, sock):
+        try:
+            data = sock.recv(65536)
+        except OSError:
+            data = b''
+        connection = next(c for c in self.connections if c['client'] is sock or c['server'] is sock)
+        if connection['blackholed']:
+            # Dropped, but the connection is kept open: the client must
+            # detect the dead peer itself.
+            if not data:
+                self.selector.unregister(sock)
+                self.peers.pop(sock, None)
+                sock.close()
+                self.connections.remove(connection)
+            return
+        if not data:
+            self.close(sock)
+            return
+        try:
+            self.peers[sock].sendall(data)
+        except OSError:
+            self.close(sock)
+
+    def check_blackhole(self):
+        now = time.monotonic()
+        for connection in self.connections:
+            if not connection['blackholed'] and now - connection['since'] >= self.after:
+                # The server side is closed, so that the server accepts the
+                # next connection; the client is not told.
+                connection['blackholed'] = True
+                server = connection['server']
+                self.peers.pop(server, None)
+                self.selector.unregister(server)
+                server.close()
+                self.blackhole_at = now
+                self.log('Black hole: dropping all traffic of the connection')
+
+    def run(self, listener):
+        self.selector.register(listener, selectors.EVENT_READ)
+        while len(self.results) < self.trials:
+            for key, _ in self.selector.select(timeout=0.1):
+                if key.fileobj is listener:
+                    self.accept(listener)
+                elif key.fileobj in self.peers:
+                    self.forward(key.fileobj)
+            self.check_blackhole()
+
+        print('\nDetection-to-reconnect time over %d trials: min %.1f s, avg %.1f s, max %.1f s' %
+              (len(self.results), min(self.results), sum(self.results) / len(self.results),
+               max(self.results)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Black-hole proxy for the dead-peer detection tests.')
+    parser.add_argument('--listen-port', type=int, default=50007, help='TCP port the client connects to')
+    parser.add_argument('--server', default='127.0.0.1:50008', metavar='HOST:PORT',
+                        help='Address of the TCP server')
+    parser.add_argument('--after', type=float, default=10.0,
+                        help='Seconds after each connection is opened until its traffic is dropped')
+    parser.add_argument('--trials', type=int, default=5, help='Number of black holes to measure')
+    args = parser.parse_args()
+
+    host, _, port = args.server.rpartition(':')
+    listener = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
+    listener.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_V6ONLY, 0)
+    listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    listener.bind(('::', args.listen_port))
+    listener.listen(5)
+    print('Black-hole proxy on port %d to %s, black hole %.1f s after each connection' %
+          (args.listen_port, args.server, args.after))
+    sys.stdout.flush()
+
+    try:
+        Proxy((host.strip('[]'), int(port)), args.after, args.trials).run(listener)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,175 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   capture_extract.py
+#
+# Description: Extracts a traffic capture of the secure TCP client (CAPTURE=1)
+#              from a captured debug UART log into a capture file for the replay tool
+#              (tools/replay). The last capture in the log is used.
+#              Usage: python capture_extract.py uart.log capture.tcap
+#                     python capture_extract.py --example capture.tcap
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import random
+import re
+import struct
+import sys
+
+MAGIC = b'TCAP'
+VERSION = 1
+DIR_IN = 0
+DIR_OUT = 1
+
+CAPTURE = re.compile(r'\[capture\] (start|dropped (\d+)|([0-9a-f]+))\s*$')
+
+
+def put_varint(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def get_varint(data, offset):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return value, offset
+        shift += 7
+
+
+def extract(lines):
+    """Returns the records of the last capture in the log and the number of
+    records the client dropped."""
+    stream = None
+    dropped = 0
+    for line in lines:
+        match = CAPTURE.search(line)
+        if not match:
+            continue
+        if match.group(1) == 'start':
+            stream = bytearray()
+            dropped = 0
+        elif match.group(2):
+            dropped = int(match.group(2))
+        elif stream is not None:
+            stream += bytes.fromhex(match.group(3))
+    return stream, dropped
+
+
+def summarize(stream):
+    counts = {DIR_IN: [0, 0], DIR_OUT: [0, 0]}
+    offset = 0
+    time_us = 0
+    while offset < len(stream):
+        delta_us, offset = get_varint(stream, offset)
+        field, offset = get_varint(stream, offset)
+        time_us += delta_us
+        counts[field & 1][0] += 1
+        counts[field & 1][1] += field >> 1
+        offset += field >> 1
+    if offset != len(stream):
+        print("Warning: the last record is incomplete")
+    return counts, time_us
+
+
+def example_stream(seconds=60, seed=1):
+    """Traffic resembling a server that sends an LED command every second and
+    runs a latency probe train at 10 probes/s, with heartbeats and telemetry
+    from the client."""
+    rng = random.Random(seed)
+    events = []
+    for second in range(seconds):
+        events.append((second * 1000000 + rng.randint(0, 500000),
+                       [(DIR_IN, b'1' if second % 2 else b'0'), (DIR_OUT, b'A' + bytes([second % 2]))]))
+        if second % 2 == 0:
+            events.append((second * 1000000 + rng.randint(0, 999999), [(DIR_OUT, b'H' + struct.pack('<I', second)),
+                                                                       (DIR_IN, b'h'), (DIR_IN, struct.pack('<I', second))]))
+        if second % 10 == 0:
+            events.append((second * 1000000 + 999000, [(DIR_OUT, b'T' + bytes(rng.randint(60, 90)))]))
+        for probe in range(10):
+            seq = second * 10 + probe
+            events.append((second * 1000000 + probe * 100000 + rng.randint(0, 20000),
+                           [(DIR_IN, b'P'), (DIR_IN, struct.pack('<IQ', seq, seq * 100000000)),
+                            (DIR_OUT, b'p' + bytes(20))]))
+    stream = bytearray()
+    last_us = 0
+    for time_us, records in sorted(events, key=lambda event: event[0]):
+        time_us = max(time_us, last_us)
+        for direction, data in records:
+            stream += put_varint(time_us - last_us) + put_varint((len(data) << 1) | direction) + data
+            last_us = time_us
+            time_us += rng.randint(50, 300)
+    return stream
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Extracts a traffic capture from a UART log.')
+    parser.add_argument('log', nargs='?', help='Captured debug UART log')
+    parser.add_argument('capture', help='Capture file to write')
+    parser.add_argument('--example', action='store_true',
+                        help='Write a synthetic one-minute capture instead of reading a log')
+    args = parser.parse_args()
+
+    if args.example:
+        stream, dropped = example_stream(), 0
+    elif args.log:
+        with open(args.log, errors='replace') as log:
+            stream, dropped = extract(log)
+        if stream is None:
+            sys.exit('No capture found in %s' % args.log)
+    else:
+        parser.error('a log file or --example is required')
+
+    with open(args.capture, 'wb') as capture:
+        capture.write(MAGIC + bytes([VERSION]) + stream)
+
+    counts, time_us = summarize(stream)
+    print('%s: %d records received (%d bytes), %d records sent (%d bytes) over %.1f s' %
+          (args.capture, counts[DIR_IN][0], counts[DIR_IN][1], counts[DIR_OUT][0],
+           counts[DIR_OUT][1], time_us / 1e6))
+    if dropped:
+        print('Warning: the client dropped %d records; enlarge TRAFFIC_CAPTURE_RING_SIZE' % dropped)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,193 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   dual_session_client.py
+#
+# Description: Host stand-in for the secure TCP client in AP+STA mode. Opens one
+#              TLS session per interface, each bound to its own local address, answers
+#              the latency probes and LED commands of the server like the device does, and
+#              reconnects a lost session without affecting the other one. On one host the
+#              two interfaces are modelled with loopback aliases:
+#              Usage: python tcp_secure_server.py --bind 127.0.0.2 --probe-count 2000 --probe-rate 0
+#                     python tcp_secure_server.py --bind 127.0.0.3 --probe-count 2000 --probe-rate 0
+#                     python dual_session_client.py [--sta 127.0.0.2] [--ap 127.0.0.3]
+#              Each server then reports the throughput and latency of its interface.
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import os
+import socket
+import ssl
+import struct
+import sys
+import threading
+import time
+
+# Latency probe request and reply, as in app_protocol.h.
+PING_REQUEST = struct.Struct('<IQ')
+PING_REPLY = struct.Struct('<cIQII')
+
+ACK_MESSAGES = {b'1': b'LED ON ACK', b'0': b'LED OFF ACK'}
+
+DEFAULT_ROOT_CA = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..',
+                               'python-secure-tcp-server', 'root_ca.crt')
+
+# Reconnect delays, as LOCAL_SESSION_BACKOFF_MS and LOCAL_SESSION_BACKOFF_MAX_MS.
+BACKOFF_S = 0.5
+BACKOFF_MAX_S = 8.0
+
+print_lock = threading.Lock()
+
+
+def log(name, message):
+    with print_lock:
+        print('%s [%s] %s' % (time.strftime('%H:%M:%S'), name, message))
+        sys.stdout.flush()
+
+
+def recv_exact(sock, length):
+    data = b''
+    while len(data) < length:
+        chunk = sock.recv(length - len(data))
+        if not chunk:
+            raise ConnectionError('Connection closed by the TCP server')
+        data += chunk
+    return data
+
+
+class Session(threading.Thread):
+    """One TLS session of the client, on one interface."""
+
+    def __init__(self, name, server, source, context):
+        super().__init__(daemon=True)
+        self.name = name
+        self.server = server
+        self.source = source
+        self.context = context
+        self.probes = 0
+        self.connects = 0
+
+    def connect(self):
+        begin = time.perf_counter()
+        raw = socket.create_connection(self.server, timeout=5,
+                                       source_address=(self.source, 0) if self.source else None)
+        raw.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        sock = self.context.wrap_socket(raw)
+        sock.settimeout(None)
+        self.connects += 1
+        log(self.name, 'Connected to %s:%d from %s in %.1f ms (%s)' %
+            (self.server[0], self.server[1], sock.getsockname()[0],
+             (time.perf_counter() - begin) * 1e3, sock.version()))
+        return sock
+
+    def serve(self, sock):
+        while True:
+            opcode = recv_exact(sock, 1)
+            received_ns = time.perf_counter_ns()
+            if opcode == b'P':
+                seq, server_ns = PING_REQUEST.unpack(recv_exact(sock, PING_REQUEST.size))
+                device_us = (time.perf_counter_ns() - received_ns) // 1000
+                sock.sendall(PING_REPLY.pack(b'p', seq, server_ns,
+                                             (received_ns // 1000) & 0xFFFFFFFF, device_us))
+                self.probes += 1
+            elif opcode in ACK_MESSAGES:
+                sock.sendall(ACK_MESSAGES[opcode])
+                log(self.name, 'LED %s' % ('ON' if opcode == b'1' else 'OFF'))
+            elif opcode == b'h':
+                recv_exact(sock, 4)
+            else:
+                sock.sendall(b'Invalid command')
+
+    def run(self):
+        backoff = 0.0
+        while True:
+            try:
+                sock = self.connect()
+            except OSError as error:
+                backoff = min(max(backoff * 2, BACKOFF_S), BACKOFF_MAX_S)
+                log(self.name, 'Connection failed (%s), retrying in %.1f s' % (error, backoff))
+                time.sleep(backoff)
+                continue
+
+            backoff = BACKOFF_S
+            try:
+                self.serve(sock)
+            except (OSError, ConnectionError) as error:
+                log(self.name, 'Session lost (%s), reconnecting in %.1f s' % (error, backoff))
+            finally:
+                sock.close()
+            time.sleep(backoff)
+
+
+def parse_server(text, port):
+    host, _, server_port = text.rpartition(':') if ':' in text else (text, '', '')
+    return host, int(server_port) if server_port else port
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Two-session stand-in for the secure TCP client.')
+    parser.add_argument('--sta', default='127.0.0.2', metavar='HOST[:PORT]',
+                        help='TCP server reached over the STA interface (default: 127.0.0.2)')
+    parser.add_argument('--ap', default='127.0.0.3', metavar='HOST[:PORT]',
+                        help='TCP server reached over the SoftAP interface (default: 127.0.0.3)')
+    parser.add_argument('--sta-source', default='', metavar='ADDRESS',
+                        help='Local address of the STA session')
+    parser.add_argument('--ap-source', default='', metavar='ADDRESS',
+                        help='Local address of the SoftAP session, as the device binds to '
+                             'SOFTAP_IP_ADDRESS')
+    parser.add_argument('--port', type=int, default=50007, help='Default TCP port of the servers')
+    parser.add_argument('--root-ca', default=DEFAULT_ROOT_CA, help='Root CA of the servers')
+    args = parser.parse_args()
+
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_CLIENT)
+    context.check_hostname = False
+    context.load_verify_locations(cafile=args.root_ca)
+
+    sessions = [Session('sta', parse_server(args.sta, args.port), args.sta_source, context),
+                Session('ap', parse_server(args.ap, args.port), args.ap_source, context)]
+    for session in sessions:
+        session.start()
+
+    try:
+        while True:
+            time.sleep(3600)
+    except KeyboardInterrupt:
+        for session in sessions:
+            print('%s: %d connections, %d probes answered' %
+                  (session.name, session.connects, session.probes))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,181 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   handshake_benchmark.py
+#
+# Description: Measures the cost of each TLS version, cipher suite and ECDHE
+#              curve combination the secure TCP client can negotiate with the Python
+#              server: handshake bytes in each direction, round trips before the client
+#              can send application data and host CPU time. Both ends run in-process with
+#              OpenSSL using the server certificate of python-secure-tcp-server. The device
+#              logs its own handshake time and heap peak for the configuration it is built
+#              with (see TLS_CIPHERSUITES and TLS_CURVES in the Makefile).
+#              Usage: python handshake_benchmark.py [--iterations N] [--json]
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import json
+import os
+import ssl
+import statistics
+import sys
+import time
+
+CERT_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'python-secure-tcp-server')
+
+VERSIONS = (('TLSv1.2', ssl.TLSVersion.TLSv1_2), ('TLSv1.3', ssl.TLSVersion.TLSv1_3))
+
+# TLS 1.2 suites usable with the ECDSA P-256 identity. The ssl module cannot
+# restrict TLS 1.3 suites, so TLS 1.3 rows report the suite that was chosen.
+TLS12_SUITES = ('ECDHE-ECDSA-AES128-GCM-SHA256', 'ECDHE-ECDSA-AES256-GCM-SHA384',
+                'ECDHE-ECDSA-CHACHA20-POLY1305')
+
+# Curves offered by the client. 'X25519,P-256' is the OpenSSL default list and
+# matches the order Mbed TLS uses when both curves are enabled.
+CLIENT_CURVES = (('P-256', 'prime256v1'), ('X25519,P-256', None))
+
+# Curve the server is pinned to (tcp_secure_server.py --curve).
+SERVER_CURVES = (('P-256', 'prime256v1'), ('X25519', 'X25519'))
+
+
+def make_contexts(version, suite, client_curve, server_curve):
+    server = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    server.load_cert_chain(os.path.join(CERT_DIR, 'server.crt'), os.path.join(CERT_DIR, 'server.key'))
+    client = ssl.SSLContext(ssl.PROTOCOL_TLS_CLIENT)
+    client.check_hostname = False
+    client.load_verify_locations(os.path.join(CERT_DIR, 'root_ca.crt'))
+    for context in (server, client):
+        context.minimum_version = version
+        context.maximum_version = version
+    if suite:
+        client.set_ciphers(suite)
+    if client_curve:
+        client.set_ecdh_curve(client_curve)
+    server.set_ecdh_curve(server_curve)
+    return client, server
+
+
+def handshake(client_context, server_context):
+    """Runs one handshake over memory BIOs. Returns the bytes sent by each
+    side, the round trips before the client finished and the elapsed time."""
+    client_in, client_out, server_in, server_out = (ssl.MemoryBIO() for _ in range(4))
+    client = client_context.wrap_bio(client_in, client_out)
+    server = server_context.wrap_bio(server_in, server_out, server_side=True)
+    sent = {'client': 0, 'server': 0}
+    round_trips = 0
+    client_done = server_done = False
+
+    start = time.perf_counter_ns()
+    while not (client_done and server_done):
+        if not client_done:
+            try:
+                client.do_handshake()
+                client_done = True
+            except ssl.SSLWantReadError:
+                round_trips += 1
+        data = client_out.read()
+        sent['client'] += len(data)
+        server_in.write(data)
+
+        if not server_done:
+            try:
+                server.do_handshake()
+                server_done = True
+            except ssl.SSLWantReadError:
+                pass
+        data = server_out.read()
+        sent['server'] += len(data)
+        client_in.write(data)
+    elapsed_us = (time.perf_counter_ns() - start) / 1000.0
+
+    return {'version': client.version(), 'suite': client.cipher()[0],
+            'client_bytes': sent['client'], 'server_bytes': sent['server'],
+            'round_trips': round_trips, 'time_us': elapsed_us}
+
+
+def run(iterations):
+    results = []
+    for version_name, version in VERSIONS:
+        suites = TLS12_SUITES if version == ssl.TLSVersion.TLSv1_2 else (None,)
+        for suite in suites:
+            for client_name, client_curve in CLIENT_CURVES:
+                for server_name, server_curve in SERVER_CURVES:
+                    row = {'version': version_name, 'suite': suite or '(negotiated)',
+                           'client_curves': client_name, 'server_curve': server_name}
+                    try:
+                        client, server = make_contexts(version, suite, client_curve, server_curve)
+                        runs = [handshake(client, server) for _ in range(iterations)]
+                    except ssl.SSLError as error:
+                        row['error'] = error.reason or str(error)
+                        results.append(row)
+                        continue
+                    row.update({key: runs[0][key] for key in ('suite', 'client_bytes',
+                                                              'server_bytes', 'round_trips')})
+                    row['time_us'] = statistics.median(run['time_us'] for run in runs)
+                    results.append(row)
+    return results
+
+
+def print_table(results):
+    print("%-8s %-38s %-13s %-7s %8s %8s %3s %10s" %
+          ("Version", "Suite", "Client offer", "Server", "C->S B", "S->C B", "RTT", "Host us"))
+    for row in results:
+        if 'error' in row:
+            print("%-8s %-38s %-13s %-7s   fails: %s" % (row['version'], row['suite'],
+                  row['client_curves'], row['server_curve'], row['error']))
+            continue
+        print("%-8s %-38s %-13s %-7s %8d %8d %3d %10.0f" %
+              (row['version'], row['suite'], row['client_curves'], row['server_curve'],
+               row['client_bytes'], row['server_bytes'], row['round_trips'], row['time_us']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='TLS handshake cost per version, cipher suite and curve')
+    parser.add_argument('--iterations', type=int, default=20, help='Handshakes per combination (default: 20)')
+    parser.add_argument('--json', action='store_true', help='Print the results as JSON')
+    args = parser.parse_args()
+
+    results = run(max(1, args.iterations))
+    if args.json:
+        json.dump(results, sys.stdout, indent=2)
+        print()
+    else:
+        print_table(results)
+
+
+if __name__ == '__main__':
+    main()
+
+# [] END OF FILE
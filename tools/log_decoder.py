@@ -0,0 +1,164 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   log_decoder.py
+#
+# Description: Host-side decoder for the binary log stream produced when
+#              APP_LOG_BINARY_OUTPUT is set to 1. Format strings are looked up
+#              in the application ELF file by address.
+#              Usage: python log_decoder.py <app.elf> <serial port | capture file>
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+SYNC = b'\xa5\x5a'
+HEADER = struct.Struct('<2sBBII')
+LEVEL_TAG = ['', 'E', 'W', 'I', 'D']
+MAX_ARGS = 4
+
+# printf conversion specification; length modifiers are dropped because all
+# arguments are 32-bit.
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z|j|t)?([diouxXcsp%])')
+
+
+class ElfStrings:
+    """Reads NUL-terminated strings from the loadable sections of an ELF file."""
+
+    def __init__(self, path):
+        self.sections = []
+        with open(path, 'rb') as f:
+            elf = ELFFile(f)
+            for section in elf.iter_sections():
+                if section['sh_addr'] and section['sh_type'] == 'SHT_PROGBITS':
+                    self.sections.append((section['sh_addr'], section.data()))
+
+    def read(self, address):
+        for base, data in self.sections:
+            if base <= address < base + len(data):
+                start = address - base
+                end = data.find(b'\0', start)
+                return data[start:end].decode('utf-8', 'replace')
+        return '<unknown string 0x%08x>' % address
+
+
+def format_record(strings, fmt, args):
+    arg_iter = iter(args)
+
+    def convert(match):
+        flags, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+        value = next(arg_iter, 0)
+        if conversion == 's':
+            return ('%' + flags + 's') % strings.read(value)
+        if conversion == 'c':
+            return chr(value & 0xFF)
+        if conversion in 'di':
+            value = struct.unpack('<i', struct.pack('<I', value))[0]
+            conversion = 'd'
+        if conversion == 'u':
+            conversion = 'd'
+        if conversion == 'p':
+            return '0x%08x' % value
+        return ('%' + flags + conversion) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(stream, strings, out=sys.stdout):
+    """Decodes records from a byte stream. Bytes outside records (regular
+    printf() output) are passed through unchanged."""
+    buffer = b''
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            out.write(buffer.decode('utf-8', 'replace'))
+            break
+        buffer += chunk
+        while True:
+            index = buffer.find(SYNC)
+            if index < 0:
+                out.write(buffer[:-1].decode('utf-8', 'replace'))
+                buffer = buffer[-1:]
+                break
+            if index > 0:
+                out.write(buffer[:index].decode('utf-8', 'replace'))
+                buffer = buffer[index:]
+            if len(buffer) < HEADER.size:
+                break
+            _, level, nargs, timestamp, fmt_address = HEADER.unpack_from(buffer)
+            if level >= len(LEVEL_TAG) or nargs > MAX_ARGS:
+                # False sync marker; skip it.
+                out.write(buffer[:1].decode('utf-8', 'replace'))
+                buffer = buffer[1:]
+                continue
+            length = HEADER.size + 4 * nargs
+            if len(buffer) < length:
+                break
+            args = struct.unpack_from('<%dI' % nargs, buffer, HEADER.size)
+            buffer = buffer[length:]
+            text = format_record(strings, strings.read(fmt_address), args)
+            out.write('[%d][%s] %s' % (timestamp, LEVEL_TAG[level], text))
+        out.flush()
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: python log_decoder.py <app.elf> <serial port | capture file>")
+        sys.exit(1)
+
+    strings = ElfStrings(sys.argv[1])
+    source = sys.argv[2]
+
+    try:
+        stream = open(source, 'rb')
+    except OSError:
+        import serial
+        stream = serial.Serial(source, 115200, timeout=None)
+
+    try:
+        decode(stream, strings)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
+
+# [] END OF FILE
@@ -0,0 +1,230 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   lossy_relay.py
+#
+# Description: Relay that adds packet loss between the secure TCP client
+#              and the TCP server, to compare the command latency of the TLS/TCP and the
+#              DTLS transports under the same loss. Datagrams are dropped at random.
+#              TCP segments cannot be dropped from user space, so the relay models a lost
+#              segment as TCP recovers from it: the data and everything behind it on the
+#              connection is held for the retransmission timeout, doubled for every
+#              further loss of the same data.
+#              Usage: python tcp_secure_server.py --port 50008 [--dtls]
+#                     python lossy_relay.py [--listen-port 50007]
+#                     [--server 127.0.0.1:50008] [--loss 5] [--tcp-rto 0.2]
+#              Enter the address of the relay host on the client.
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import heapq
+import random
+import selectors
+import socket
+import sys
+import time
+
+
+class Relay:
+    def __init__(self, server, loss, tcp_rto, delay):
+        self.server = server
+        self.loss = loss
+        self.tcp_rto = tcp_rto
+        self.delay = delay
+        self.selector = selectors.DefaultSelector()
+        self.peers = {}
+        self.release_at = {}
+        self.udp_upstream = {}
+        self.schedule = []
+        self.order = 0
+        self.stats = {'tcp': [0, 0], 'udp': [0, 0]}
+
+    def log(self, message):
+        print('%s %s' % (time.strftime('%H:%M:%S'), message))
+        sys.stdout.flush()
+
+    def later(self, when, action):
+        self.order += 1
+        heapq.heappush(self.schedule, (when, self.order, action))
+
+    def accept(self, listener):
+        client, address = listener.accept()
+        try:
+            server = socket.create_connection(self.server)
+        except OSError as error:
+            self.log('Cannot reach the TCP server: %s' % error)
+            client.close()
+            return
+        self.log('TCP client %s connected' % address[0])
+        for sock in (client, server):
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            sock.setblocking(False)
+            self.selector.register(sock, selectors.EVENT_READ, self.forward_tcp)
+            self.release_at[sock] = 0.0
+        self.peers[client] = server
+        self.peers[server] = client
+
+    def close(self, sock):
+        for s in (sock, self.peers.get(sock)):
+            if s is None or s not in self.peers:
+                continue
+            self.peers.pop(s)
+            self.release_at.pop(s, None)
+            self.selector.unregister(s)
+            s.close()
+
+    def forward_tcp(self, sock):
+        try:
+            data = sock.recv(65536)
+        except OSError:
+            data = b''
+        if not data:
+            self.close(sock)
+            return
+        peer = self.peers[sock]
+        now = time.monotonic()
+        # In order: data is never released before the data received before it.
+        when = max(self.release_at[sock], now + self.delay)
+        retransmission = 0
+        while random.random() < self.loss:
+            when += self.tcp_rto * (2 ** retransmission)
+            retransmission += 1
+        self.stats['tcp'][0 if retransmission == 0 else 1] += 1
+        self.release_at[sock] = when
+        self.later(when, lambda: self.send_tcp(peer, data))
+
+    def send_tcp(self, sock, data):
+        if sock not in self.peers:
+            return
+        try:
+            sock.setblocking(True)
+            sock.sendall(data)
+            sock.setblocking(False)
+        except OSError:
+            self.close(sock)
+
+    def forward_udp_up(self, listener):
+        datagram, address = listener.recvfrom(65536)
+        upstream = self.udp_upstream.get(address)
+        if upstream is None:
+            upstream = socket.socket(socket.AF_INET6 if ':' in self.server[0] else socket.AF_INET,
+                                     socket.SOCK_DGRAM)
+            upstream.connect(self.server)
+            upstream.setblocking(False)
+            self.udp_upstream[address] = upstream
+            self.selector.register(upstream, selectors.EVENT_READ,
+                                   lambda sock: self.forward_udp_down(sock, listener, address))
+            self.log('UDP client %s started sending' % address[0])
+        self.send_udp(lambda: upstream.send(datagram))
+
+    def forward_udp_down(self, upstream, listener, address):
+        try:
+            datagram = upstream.recv(65536)
+        except OSError:
+            return
+        self.send_udp(lambda: listener.sendto(datagram, address))
+
+    def send_udp(self, action):
+        if random.random() < self.loss:
+            self.stats['udp'][1] += 1
+            return
+        self.stats['udp'][0] += 1
+        self.later(time.monotonic() + self.delay, action)
+
+    def run(self, tcp_listener, udp_listener):
+        self.selector.register(tcp_listener, selectors.EVENT_READ, self.accept)
+        self.selector.register(udp_listener, selectors.EVENT_READ, self.forward_udp_up)
+        while True:
+            timeout = None
+            if self.schedule:
+                timeout = max(0.0, self.schedule[0][0] - time.monotonic())
+            for key, _ in self.selector.select(timeout=timeout):
+                key.data(key.fileobj)
+            now = time.monotonic()
+            while self.schedule and self.schedule[0][0] <= now:
+                _, _, action = heapq.heappop(self.schedule)
+                try:
+                    action()
+                except OSError:
+                    pass
+
+    def report(self):
+        for name, (passed, lost) in self.stats.items():
+            total = passed + lost
+            if total:
+                print('%s: %d %s, %d lost (%.1f%%)' %
+                      (name.upper(), total, 'segments' if name == 'tcp' else 'datagrams', lost,
+                       100.0 * lost / total))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Lossy relay for the transport latency tests.')
+    parser.add_argument('--listen-port', type=int, default=50007,
+                        help='TCP and UDP port the client connects to')
+    parser.add_argument('--server', default='127.0.0.1:50008', metavar='HOST:PORT',
+                        help='Address of the TCP server')
+    parser.add_argument('--loss', type=float, default=5.0,
+                        help='Packet loss in percent, in each direction')
+    parser.add_argument('--tcp-rto', type=float, default=0.2,
+                        help='TCP retransmission timeout in seconds; 0.2 s is the minimum of '
+                             'Linux, lwIP waits at least twice as long')
+    parser.add_argument('--delay', type=float, default=0.002,
+                        help='One-way delay in seconds added to all traffic')
+    parser.add_argument('--seed', type=int, help='Seed of the random losses')
+    args = parser.parse_args()
+
+    random.seed(args.seed)
+    host, _, port = args.server.rpartition(':')
+    tcp_listener = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
+    tcp_listener.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_V6ONLY, 0)
+    tcp_listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    tcp_listener.bind(('::', args.listen_port))
+    tcp_listener.listen(5)
+    udp_listener = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+    udp_listener.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_V6ONLY, 0)
+    udp_listener.bind(('::', args.listen_port))
+    print('Lossy relay on port %d to %s: %.1f%% loss, TCP RTO %.2f s, %.1f ms delay' %
+          (args.listen_port, args.server, args.loss, args.tcp_rto, args.delay * 1000))
+    sys.stdout.flush()
+
+    relay = Relay((host.strip('[]'), int(port)), args.loss / 100.0, args.tcp_rto, args.delay)
+    try:
+        relay.run(tcp_listener, udp_listener)
+    except KeyboardInterrupt:
+        relay.report()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,492 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   net_profile_benchmark.py
+#
+# Description: Compares the network tuning profiles of configs/net_profile.h:
+#              throughput in each direction, command round-trip time with the link idle,
+#              with periodic reports and with telemetry filling the send buffer, and the
+#              RAM lwIP needs for the buffers of the profile. The client and the server
+#              run in-process with OpenSSL over an emulated Wi-Fi link with a fixed rate
+#              and round-trip time. The link applies the options of the profile as lwIP
+#              does: the receive window (TCP_WND) bounds the data in flight to the client
+#              and not yet read, the send buffer (TCP_SND_BUF) bounds the data queued and
+#              in flight from the client, segments are at most TCP_MSS bytes, and Nagle's
+#              algorithm holds a small segment while data is in flight unless TCP_NODELAY
+#              is set. The receivers delay their ACKs as Linux and lwIP do.
+#              Usage: python net_profile_benchmark.py [--rtt-ms 10] [--rate-mbps 20]
+#                     [--bytes 1000000] [--count 200] [--json] [profile ...]
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import heapq
+import json
+import random
+import os
+import re
+import ssl
+import statistics
+import subprocess
+import sys
+import threading
+import time
+
+REPO_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+PROFILE_HEADER = os.path.join(REPO_DIR, 'configs', 'net_profile.h')
+CERT_DIR = os.path.join(REPO_DIR, 'python-secure-tcp-server')
+
+PROFILES = ('low_latency', 'high_throughput', 'minimal_ram')
+
+# Window of the server, which is not the bottleneck.
+SERVER_WND = 65535
+
+# Delayed ACK of the server (Linux) and timer interval of lwIP, in seconds.
+SERVER_DELAYED_ACK = 0.040
+LWIP_TCP_TMR_INTERVAL = 0.250
+
+# Sizes used for the RAM estimate on the 32-bit target: IPv4 and TCP headers,
+# link header, struct pbuf, struct tcp_seg.
+IP_TCP_HEADERS = 40
+LINK_HEADER = 14
+PBUF_STRUCT = 16
+TCP_SEG_STRUCT = 20
+
+# Application messages: a bulk block (download or upload), a telemetry batch,
+# an LED command and its compact acknowledgement, and a short periodic report
+# such as a heartbeat. Telemetry is written TELEMETRY_BATCHES at a time so
+# that the host keeps the send buffer full.
+BLOCK_SIZE = 4096
+TELEMETRY_SIZE = 512
+TELEMETRY_BATCHES = 8
+REPORT_SIZE = 64
+REPORT_INTERVAL = 0.050
+COMMAND_INTERVAL = 0.040
+
+# Traffic sent by the client while the round-trip time is measured.
+LOADS = ('idle', 'periodic', 'saturated')
+COMMAND = b'1'
+ACK = b'A\x01'
+
+
+def load_profile(name):
+    """Returns the NET_PROFILE_* values of a profile, as evaluated by the C
+    preprocessor."""
+    selector = 'NET_PROFILE_' + name.upper()
+    output = subprocess.check_output(['cpp', '-dM', '-D' + selector, PROFILE_HEADER],
+                                     universal_newlines=True)
+    macros = dict(re.findall(r'#define (NET_PROFILE_\w+) (.+)', output))
+    macros.pop(selector)
+    if 'NET_PROFILE_TCP_WND' not in macros:
+        raise ValueError('%s sets no lwIP options' % name)
+    values = {}
+
+    def evaluate(text):
+        text = re.sub(r'NET_PROFILE_\w+', lambda m: str(evaluate(macros[m.group(0)])), text)
+        return eval(text, {'__builtins__': {}})
+
+    for macro, text in macros.items():
+        if macro != 'NET_PROFILE_NAME':
+            values[macro[len('NET_PROFILE_'):]] = evaluate(text)
+    return values
+
+
+def estimate_ram(profile):
+    """Worst-case bytes of the lwIP buffers of the profile: the pbuf pool that
+    stores the received segments, and the heap used by a full send buffer."""
+    bufsize = (profile['TCP_MSS'] + IP_TCP_HEADERS + LINK_HEADER + 3) & ~3
+    pool = profile['PBUF_POOL_SIZE'] * (bufsize + PBUF_STRUCT)
+    send = (profile['TCP_SND_BUF'] +
+            profile['TCP_SND_QUEUELEN'] * (PBUF_STRUCT + IP_TCP_HEADERS + LINK_HEADER) +
+            profile['MEMP_NUM_TCP_SEG'] * TCP_SEG_STRUCT)
+    return pool, send
+
+
+class Direction:
+    """One direction of the emulated link. The receiver acknowledges every
+    second segment at once and a single segment when its delayed ACK timer
+    fires, or with the data it sends back, whichever comes first."""
+
+    def __init__(self, link, mss, snd_buf, wnd, nagle, delayed_ack):
+        self.link = link
+        self.mss = mss
+        self.snd_buf = snd_buf
+        self.wnd = wnd
+        self.nagle = nagle
+        self.delayed_ack = delayed_ack
+        self.reverse = None
+        self.unsent = bytearray()
+        self.in_flight = 0
+        self.unread = bytearray()
+        self.link_free = 0.0
+        self.unacked = 0
+        self.unacked_segments = 0
+        self.ack_timer = 0
+
+    def send(self, data):
+        """Queues data, blocking while the send buffer is full."""
+        view = memoryview(data)
+        with self.link.cond:
+            while view:
+                if not self.link.running:
+                    raise EOFError
+                space = self.snd_buf - len(self.unsent) - self.in_flight
+                if space <= 0:
+                    self.link.cond.wait()
+                    continue
+                self.unsent += view[:space]
+                view = view[space:]
+                self.link.cond.notify_all()
+
+    def recv(self):
+        """Returns the data received, blocking until there is some."""
+        with self.link.cond:
+            while not self.unread:
+                if not self.link.running:
+                    raise EOFError
+                self.link.cond.wait()
+            data = bytes(self.unread)
+            del self.unread[:]
+            self.link.cond.notify_all()
+            return data
+
+    def arrive(self, now, segment):
+        self.unread += segment
+        self.unacked += len(segment)
+        self.unacked_segments += 1
+        if self.unacked_segments >= 2:
+            self.acknowledge(now)
+        elif self.unacked_segments == 1:
+            self.link.schedule(self.delayed_ack(now), self, 'delayed_ack', self.ack_timer)
+
+    def acknowledge(self, now):
+        if self.unacked:
+            self.link.schedule(now + self.link.one_way, self, 'ack', self.unacked)
+        self.unacked = 0
+        self.unacked_segments = 0
+        self.ack_timer += 1
+
+    def transmit(self, now):
+        while self.unsent:
+            window = self.wnd - self.in_flight - len(self.unread)
+            size = min(len(self.unsent), self.mss, window)
+            if size <= 0:
+                return
+            if self.nagle and size < self.mss and self.in_flight:
+                return
+            segment = bytes(self.unsent[:size])
+            del self.unsent[:size]
+            start = max(now, self.link_free)
+            self.link_free = start + size / self.link.rate
+            self.in_flight += size
+            # The segment carries the acknowledgement of the other direction.
+            self.reverse.acknowledge(start)
+            self.link.schedule(self.link_free + self.link.one_way, self, 'arrive', segment)
+
+
+class Link:
+    """Emulated link between the client (up) and the server (down), driven by
+    one thread in real time. The server acknowledges after 40 ms as Linux
+    does, and lwIP on the next TCP_TMR_INTERVAL tick (250 ms)."""
+
+    def __init__(self, profile, rtt, rate):
+        self.rate = rate
+        self.one_way = rtt / 2.0
+        self.cond = threading.Condition()
+        self.events = []
+        self.order = iter(range(1 << 62))
+        begin = time.monotonic()
+        nagle = not profile['TCP_NODELAY']
+        self.up = Direction(self, profile['TCP_MSS'], profile['TCP_SND_BUF'], SERVER_WND, nagle,
+                            lambda now: now + SERVER_DELAYED_ACK)
+        self.down = Direction(self, profile['TCP_MSS'], 1 << 30, profile['TCP_WND'], False,
+                              lambda now: begin + LWIP_TCP_TMR_INTERVAL *
+                              (1 + int((now - begin) / LWIP_TCP_TMR_INTERVAL)))
+        self.up.reverse = self.down
+        self.down.reverse = self.up
+        self.running = True
+        self.thread = threading.Thread(target=self.run, daemon=True)
+        self.thread.start()
+
+    def schedule(self, when, direction, kind, value):
+        heapq.heappush(self.events, (when, next(self.order), direction, kind, value))
+
+    def run(self):
+        with self.cond:
+            while self.running:
+                now = time.monotonic()
+                while self.events and self.events[0][0] <= now:
+                    when, _, direction, kind, value = heapq.heappop(self.events)
+                    if kind == 'arrive':
+                        direction.arrive(when, value)
+                    elif kind == 'delayed_ack':
+                        if value == direction.ack_timer:
+                            direction.acknowledge(when)
+                    else:
+                        direction.in_flight -= value
+                    self.cond.notify_all()
+                self.up.transmit(now)
+                self.down.transmit(now)
+                timeout = (self.events[0][0] - now) if self.events else None
+                self.cond.wait(timeout)
+
+    def stop(self):
+        with self.cond:
+            self.running = False
+            self.cond.notify_all()
+        self.thread.join()
+
+
+class TlsEnd:
+    """TLS over memory BIOs on one end of the link."""
+
+    def __init__(self, context, out, inp, server_side):
+        self.incoming = ssl.MemoryBIO()
+        self.outgoing = ssl.MemoryBIO()
+        self.ssl = context.wrap_bio(self.incoming, self.outgoing, server_side=server_side)
+        self.out = out
+        self.inp = inp
+        self.lock = threading.Lock()
+        self.send_lock = threading.Lock()
+        self.pending = bytearray()
+
+    def handshake(self):
+        while True:
+            with self.lock:
+                try:
+                    self.ssl.do_handshake()
+                    done = True
+                except ssl.SSLWantReadError:
+                    done = False
+                data = self.outgoing.read()
+            if data:
+                self.out.send(data)
+            if done:
+                return
+            data = self.inp.recv()
+            with self.lock:
+                self.incoming.write(data)
+
+    def write(self, data):
+        with self.send_lock:
+            with self.lock:
+                self.ssl.write(data)
+                records = self.outgoing.read()
+            self.out.send(records)
+
+    def read(self, size):
+        """Returns exactly size bytes of application data."""
+        while len(self.pending) < size:
+            data = self.inp.recv()
+            with self.lock:
+                self.incoming.write(data)
+                while True:
+                    try:
+                        self.pending += self.ssl.read(65536)
+                    except (ssl.SSLWantReadError, ssl.SSLZeroReturnError):
+                        break
+        data = bytes(self.pending[:size])
+        del self.pending[:size]
+        return data
+
+
+def make_contexts():
+    server = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    server.load_cert_chain(os.path.join(CERT_DIR, 'server.crt'), os.path.join(CERT_DIR, 'server.key'))
+    client = ssl.SSLContext(ssl.PROTOCOL_TLS_CLIENT)
+    client.check_hostname = False
+    client.load_verify_locations(os.path.join(CERT_DIR, 'root_ca.crt'))
+    return client, server
+
+
+def connect(profile, rtt, rate):
+    link = Link(profile, rtt, rate)
+    client_context, server_context = make_contexts()
+    client = TlsEnd(client_context, link.up, link.down, False)
+    server = TlsEnd(server_context, link.down, link.up, True)
+    thread = threading.Thread(target=server.handshake)
+    thread.start()
+    client.handshake()
+    thread.join()
+    return link, client, server
+
+
+def percentile(values, fraction):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(fraction * len(values)))]
+
+
+def measure_throughput(profile, rtt, rate, total, upstream):
+    """Returns the kB/s of a bulk transfer of total bytes."""
+    link, client, server = connect(profile, rtt, rate)
+    sender, receiver = (client, server) if upstream else (server, client)
+    block = bytes(BLOCK_SIZE)
+
+    def send():
+        for _ in range(total // BLOCK_SIZE):
+            sender.write(block)
+
+    thread = threading.Thread(target=send)
+    start = time.monotonic()
+    thread.start()
+    receiver.read((total // BLOCK_SIZE) * BLOCK_SIZE)
+    elapsed = time.monotonic() - start
+    thread.join()
+    link.stop()
+    return (total // BLOCK_SIZE) * BLOCK_SIZE / elapsed / 1000.0
+
+
+def measure_rtt(profile, rtt, rate, count, load):
+    """Returns the command-to-acknowledgement times in ms. The client sends a
+    short report every REPORT_INTERVAL with the 'periodic' load, and
+    telemetry as fast as the send buffer accepts it with the 'saturated'
+    load. Commands are sent at random times relative to the reports."""
+    link, client, server = connect(profile, rtt, rate)
+    stop = threading.Event()
+    unit = {'periodic': REPORT_SIZE, 'saturated': TELEMETRY_SIZE}.get(load)
+    randomizer = random.Random(count)
+
+    def respond():
+        for _ in range(count):
+            client.read(len(COMMAND))
+            client.write(ACK)
+
+    def report():
+        try:
+            while not stop.wait(REPORT_INTERVAL):
+                client.write(bytes(REPORT_SIZE))
+        except EOFError:
+            pass
+
+    def upload():
+        telemetry = bytes(TELEMETRY_SIZE * TELEMETRY_BATCHES)
+        try:
+            while not stop.is_set():
+                client.write(telemetry)
+        except EOFError:
+            pass
+
+    threads = [threading.Thread(target=respond)]
+    if load == 'periodic':
+        threads.append(threading.Thread(target=report))
+    elif load == 'saturated':
+        threads.append(threading.Thread(target=upload))
+    for thread in threads:
+        thread.start()
+
+    samples = []
+    for _ in range(count):
+        time.sleep(COMMAND_INTERVAL * (0.5 + randomizer.random()))
+        start = time.monotonic()
+        server.write(COMMAND)
+        # The acknowledgement arrives behind the data sent before it.
+        while True:
+            data = server.read(1)
+            if data == ACK[:1]:
+                server.read(len(ACK) - 1)
+                break
+            server.read(unit - 1)
+        samples.append((time.monotonic() - start) * 1000.0)
+
+    stop.set()
+    link.stop()
+    for thread in threads:
+        thread.join()
+    return samples
+
+
+def run(profile_names, rtt, rate, total, count):
+    results = []
+    for name in profile_names:
+        profile = load_profile(name)
+        pool, send = estimate_ram(profile)
+        latency = {load: measure_rtt(profile, rtt, rate, count, load) for load in LOADS}
+        results.append({
+            'profile': name,
+            'options': profile,
+            'down_kBps': measure_throughput(profile, rtt, rate, total, False),
+            'up_kBps': measure_throughput(profile, rtt, rate, total, True),
+            'rtt_ms': {load: {'p50': statistics.median(samples), 'p99': percentile(samples, 0.99)}
+                       for load, samples in latency.items()},
+            'ram_pbuf_pool': pool,
+            'ram_send_buffer': send,
+        })
+    return results
+
+
+def print_table(results, rtt, rate):
+    print("Link: %.1f ms RTT, %.1f Mbit/s\n" % (rtt * 1000.0, rate * 8 / 1e6))
+    print("%-16s %9s %9s %s %9s %9s %9s" %
+          (("Profile", "Down kB/s", "Up kB/s") +
+           (' '.join("%14s" % ("RTT %s" % load) for load in LOADS),) +
+           ("pbuf pool", "send buf", "lwIP RAM")))
+    print("%-16s %9s %9s %s" % ('', '', '', ' '.join("%14s" % "p50/p99 ms" for _ in LOADS)))
+    for row in results:
+        print("%-16s %9.0f %9.0f %s %7d B %7d B %7d B" %
+              (row['profile'], row['down_kBps'], row['up_kBps'],
+               ' '.join("%6.1f/%7.1f" % (row['rtt_ms'][load]['p50'], row['rtt_ms'][load]['p99'])
+                        for load in LOADS),
+               row['ram_pbuf_pool'], row['ram_send_buffer'],
+               row['ram_pbuf_pool'] + row['ram_send_buffer']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Throughput, latency and RAM of the network tuning profiles')
+    parser.add_argument('profiles', nargs='*', metavar='profile',
+                        help='Profiles to compare: %s (default: all)' % ', '.join(PROFILES))
+    parser.add_argument('--rtt-ms', type=float, default=10.0, help='Round-trip time of the link (default: 10)')
+    parser.add_argument('--rate-mbps', type=float, default=20.0, help='Rate of the link (default: 20)')
+    parser.add_argument('--bytes', type=int, default=1000000, help='Bytes per throughput run (default: 1000000)')
+    parser.add_argument('--count', type=int, default=200, help='Commands per round-trip run (default: 200)')
+    parser.add_argument('--json', action='store_true', help='Print the results as JSON')
+    args = parser.parse_args()
+
+    for name in args.profiles:
+        if name not in PROFILES:
+            parser.error('unknown profile: %s' % name)
+
+    rtt = args.rtt_ms / 1000.0
+    rate = args.rate_mbps * 1e6 / 8
+    results = run(args.profiles or PROFILES, rtt, rate, args.bytes, args.count)
+    if args.json:
+        json.dump(results, sys.stdout, indent=2)
+        print()
+    else:
+        print_table(results, rtt, rate)
+
+
+if __name__ == '__main__':
+    main()
+
+# [] END OF FILE
@@ -0,0 +1,1141 @@
+/******************************************************************************
+* File Name:   reference_server.cpp
+*
+* Description: Native reference server for load tests of the secure TCP
+* client. Speaks the protocol of python-secure-tcp-server with its
+* certificates, runs one epoll loop per thread on its own SO_REUSEPORT
+* listening socket, shares the session ticket keys between the threads so
+* that a resumed session can land on any of them, sends LED commands to
+* every session at a fixed interval, and reports the handshake rate, the
+* concurrent sessions and the command-to-acknowledgement latency.
+*
+* Build and run from the root of the application:
+* g++ -O2 -std=c++17 -pthread -o reference_server
+* tools/reference_server/reference_server.cpp -lssl -lcrypto
+* ./reference_server [-p port] [-b address] [-t threads] [-i command_ms]
+* [-r report_s] [-d duration_s] [-v 1.2|1.3] [-c ciphers] [-g groups]
+* [-k certificate_dir] [-j]
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Standard C++ header files. */
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* POSIX header files. */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* OpenSSL header files. */
+#include <openssl/err.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Length of the fixed-size messages of the TCP client (see app_protocol.h). */
+#define ACK_COMPACT_LEN                       (2u)
+#define STATE_REPORT_LEN                      (8u)
+#define PING_REPLY_LEN                        (21u)
+#define HEARTBEAT_LEN                         (5u)
+#define DOWNLOAD_STATUS_LEN                   (46u)
+#define FRAME_HEADER_LEN                      (3u)
+
+/* Log2 buckets of the latency histograms, in microseconds. */
+#define HISTOGRAM_BUCKETS                     (33u)
+
+/* Size of the session ticket keys: name, HMAC secret and AES key. */
+#define TICKET_KEYS_LEN                       (80u)
+
+/* Longest wait of a worker for events, so that it notices the stop. */
+#define WORKER_MAX_WAIT_MS                    (100)
+
+#define EPOLL_MAX_EVENTS                      (256)
+#define READ_CHUNK_LEN                        (16384u)
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+typedef struct
+{
+    uint16_t port = 50007u;
+    std::string bind_address;
+    unsigned threads = 0u;
+    uint32_t command_interval_ms = 1000u;
+    uint32_t report_interval_s = 1u;
+    uint32_t duration_s = 0u;
+    std::string tls_version = "1.3";
+    std::string ciphers;
+    std::string groups;
+    std::string certificate_dir = "python-secure-tcp-server";
+    bool json = false;
+} server_config_t;
+
+/* Log2 histogram, updated by one worker and read by the reporter. */
+struct histogram_t
+{
+    std::atomic<uint64_t> buckets[HISTOGRAM_BUCKETS] = {};
+    std::atomic<uint64_t> max{0u};
+
+    void add(uint64_t value)
+    {
+        unsigned bucket = 0u;
+
+        while((bucket < (HISTOGRAM_BUCKETS - 1u)) && ((value >> bucket) != 0u))
+        {
+            bucket++;
+        }
+        buckets[bucket].fetch_add(1u, std::memory_order_relaxed);
+        if(value > max.load(std::memory_order_relaxed))
+        {
+            max.store(value, std::memory_order_relaxed);
+        }
+    }
+};
+
+/* Counters of one worker. Cache-line aligned so that the workers do not
+ * share lines.
+ */
+struct alignas(64) worker_stats_t
+{
+    std::atomic<uint64_t> handshakes{0u};
+    std::atomic<uint64_t> resumed{0u};
+    std::atomic<uint64_t> handshake_failures{0u};
+    std::atomic<uint64_t> sessions{0u};
+    std::atomic<uint64_t> messages{0u};
+    std::atomic<uint64_t> bytes_in{0u};
+    std::atomic<uint64_t> bytes_out{0u};
+    std::atomic<uint64_t> heartbeats{0u};
+    std::atomic<uint64_t> telemetry{0u};
+    std::atomic<uint64_t> commands{0u};
+    std::atomic<uint64_t> acks{0u};
+    histogram_t handshake_us;
+    histogram_t ack_us;
+};
+
+/* Sum of the counters of all workers at one time. */
+typedef struct
+{
+    uint64_t handshakes;
+    uint64_t resumed;
+    uint64_t handshake_failures;
+    uint64_t sessions;
+    uint64_t messages;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    uint64_t heartbeats;
+    uint64_t telemetry;
+    uint64_t commands;
+    uint64_t acks;
+    uint64_t handshake_us[HISTOGRAM_BUCKETS];
+    uint64_t handshake_us_max;
+    uint64_t ack_us[HISTOGRAM_BUCKETS];
+    uint64_t ack_us_max;
+} stats_snapshot_t;
+
+typedef struct
+{
+    uint64_t id;
+    int fd;
+    SSL *ssl;
+    bool established;
+    bool want_write;
+    uint64_t accepted_ns;
+    std::string rx;
+    std::string tx;
+    uint64_t command_sent_ns;
+    bool led_on;
+} session_t;
+
+/* Next LED command of a session: due time and session identifier. */
+typedef std::pair<uint64_t, uint64_t> command_timer_t;
+
+typedef struct
+{
+    unsigned index;
+    int listener;
+    int epoll_fd;
+    SSL_CTX *context;
+    worker_stats_t *stats;
+    uint64_t next_id;
+    std::unordered_map<uint64_t, session_t *> sessions;
+    std::priority_queue<command_timer_t, std::vector<command_timer_t>,
+                        std::greater<command_timer_t>> timers;
+} worker_t;
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+static server_config_t config;
+static std::atomic<bool> stop_requested{false};
+
+/* ASCII acknowledgements of the TCP client (see app_protocol.h). */
+static const char *const ascii_acks[] = { "LED ON ACK", "LED OFF ACK", "Invalid command" };
+
+/*******************************************************************************
+ * Function Name: now_ns
+ *******************************************************************************
+ * Summary:
+ *  Returns the monotonic clock in nanoseconds.
+ *
+ *******************************************************************************/
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+ * Function Name: on_signal
+ *******************************************************************************
+ * Summary:
+ *  Stops the server on Ctrl+C.
+ *
+ *******************************************************************************/
+static void on_signal(int signal_number)
+{
+    (void)signal_number;
+    stop_requested.store(true);
+}
+
+/*******************************************************************************
+ * Function Name: create_context
+ *******************************************************************************
+ * Summary:
+ *  Creates the TLS context of a worker with the certificates of the Python
+ *  server. Every worker has its own context, so that the handshakes of the
+ *  workers do not contend on it, and all contexts use the same session ticket
+ *  keys. The stateful session cache is off: a session is resumed from its
+ *  ticket by whichever worker the kernel hands the connection to.
+ *
+ * Parameters:
+ *  const unsigned char *ticket_keys: TICKET_KEYS_LEN bytes shared by all workers
+ *
+ * Return:
+ *  SSL_CTX *: Context, or NULL on error
+ *
+ *******************************************************************************/
+static SSL_CTX *create_context(const unsigned char *ticket_keys)
+{
+    static const unsigned char session_id_context[] = "secure-tcp-server";
+    std::string certificate = config.certificate_dir + "/server.crt";
+    std::string key = config.certificate_dir + "/server.key";
+    std::string root_ca = config.certificate_dir + "/root_ca.crt";
+    SSL_CTX *context = SSL_CTX_new(TLS_server_method());
+
+    if(context == NULL)
+    {
+        return NULL;
+    }
+
+    SSL_CTX_set_min_proto_version(context, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(context, (config.tls_version == "1.2") ? TLS1_2_VERSION :
+                                                                          TLS1_3_VERSION);
+    if((SSL_CTX_use_certificate_chain_file(context, certificate.c_str()) != 1) ||
+       (SSL_CTX_use_PrivateKey_file(context, key.c_str(), SSL_FILETYPE_PEM) != 1) ||
+       (SSL_CTX_load_verify_locations(context, root_ca.c_str(), NULL) != 1) ||
+       (!config.ciphers.empty() && (SSL_CTX_set_cipher_list(context, config.ciphers.c_str()) != 1)) ||
+       (!config.groups.empty() && (SSL_CTX_set1_groups_list(context, config.groups.c_str()) != 1)))
+    {
+        SSL_CTX_free(context);
+        return NULL;
+    }
+
+    /* The client certificate is verified against root_ca.crt when the client
+     * presents one, as the TCP client does; load generators without a
+     * certificate are accepted.
+     */
+    SSL_CTX_set_verify(context, SSL_VERIFY_PEER, NULL);
+    SSL_CTX_set_session_id_context(context, session_id_context, sizeof(session_id_context) - 1u);
+    SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_OFF);
+    SSL_CTX_set_tlsext_ticket_keys(context, (void *)ticket_keys, TICKET_KEYS_LEN);
+    SSL_CTX_set_mode(context, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+                              SSL_MODE_RELEASE_BUFFERS);
+
+    return context;
+}
+
+/*******************************************************************************
+ * Function Name: create_listener
+ *******************************************************************************
+ * Summary:
+ *  Creates the listening socket of a worker. With SO_REUSEPORT, every worker
+ *  binds its own socket to the port and the kernel spreads the connections
+ *  over them, so that no accept lock is shared. Without a bind address, the
+ *  socket accepts IPv4 and IPv6.
+ *
+ * Return:
+ *  int: Socket, or -1 on error
+ *
+ *******************************************************************************/
+static int create_listener(void)
+{
+    struct sockaddr_storage address = {};
+    struct sockaddr_in6 *address6 = (struct sockaddr_in6 *)&address;
+    struct sockaddr_in *address4 = (struct sockaddr_in *)&address;
+    socklen_t address_len;
+    int enable = 1;
+    int disable = 0;
+    int listener;
+
+    if(config.bind_address.empty() ||
+       (inet_pton(AF_INET6, config.bind_address.c_str(), &address6->sin6_addr) == 1))
+    {
+        address6->sin6_family = AF_INET6;
+        address6->sin6_port = htons(config.port);
+        address_len = sizeof(*address6);
+    }
+    else if(inet_pton(AF_INET, config.bind_address.c_str(), &address4->sin_addr) == 1)
+    {
+        address4->sin_family = AF_INET;
+        address4->sin_port = htons(config.port);
+        address_len = sizeof(*address4);
+    }
+    else
+    {
+        fprintf(stderr, "Invalid bind address: %s\n", config.bind_address.c_str());
+        return -1;
+    }
+
+    listener = socket(address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listener < 0)
+    {
+        perror("socket");
+        return -1;
+    }
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    setsockopt(listener, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+    setsockopt(listener, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    if(address.ss_family == AF_INET6)
+    {
+        setsockopt(listener, IPPROTO_IPV6, IPV6_V6ONLY, &disable, sizeof(disable));
+    }
+
+    if((bind(listener, (struct sockaddr *)&address, address_len) != 0) ||
+       (listen(listener, SOMAXCONN) != 0))
+    {
+        perror("bind");
+        close(listener);
+        return -1;
+    }
+
+    return listener;
+}
+
+/*******************************************************************************
+ * Function Name: session_update_events
+ *******************************************************************************
+ * Summary:
+ *  Waits for the socket to be writable while TLS data is pending.
+ *
+ *******************************************************************************/
+static void session_update_events(worker_t *worker, session_t *session)
+{
+    struct epoll_event event = {};
+
+    event.events = EPOLLIN | ((session->want_write || !session->tx.empty()) ? EPOLLOUT : 0u);
+    event.data.ptr = session;
+    epoll_ctl(worker->epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+}
+
+/*******************************************************************************
+ * Function Name: session_close
+ *******************************************************************************
+ * Summary:
+ *  Closes a session and frees it. A session closed before the end of its
+ *  handshake counts as a failed handshake.
+ *
+ *******************************************************************************/
+static void session_close(worker_t *worker, session_t *session)
+{
+    if(session->established)
+    {
+        worker->stats->sessions.fetch_sub(1u, std::memory_order_relaxed);
+    }
+    else
+    {
+        worker->stats->handshake_failures.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    /* Errors of a closed session must not be reported for the next one. */
+    ERR_clear_error();
+    epoll_ctl(worker->epoll_fd, EPOLL_CTL_DEL, session->fd, NULL);
+    SSL_free(session->ssl);
+    close(session->fd);
+    worker->sessions.erase(session->id);
+    delete session;
+}
+
+/*******************************************************************************
+ * Function Name: session_flush
+ *******************************************************************************
+ * Summary:
+ *  Writes the pending data of a session.
+ *
+ * Return:
+ *  bool: false if the session failed
+ *
+ *******************************************************************************/
+static bool session_flush(worker_t *worker, session_t *session)
+{
+    while(!session->tx.empty())
+    {
+        int written = SSL_write(session->ssl, session->tx.data(), (int)session->tx.size());
+
+        if(written > 0)
+        {
+            worker->stats->bytes_out.fetch_add((uint64_t)written, std::memory_order_relaxed);
+            session->tx.erase(0u, (size_t)written);
+            continue;
+        }
+
+        int error = SSL_get_error(session->ssl, written);
+        if(error == SSL_ERROR_WANT_WRITE)
+        {
+            session->want_write = true;
+            return true;
+        }
+        if(error == SSL_ERROR_WANT_READ)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: session_send_command
+ *******************************************************************************
+ * Summary:
+ *  Sends the next LED command of a session, toggling the LED.
+ *
+ *******************************************************************************/
+static bool session_send_command(worker_t *worker, session_t *session, uint64_t now)
+{
+    session->led_on = !session->led_on;
+    session->tx.push_back(session->led_on ? '1' : '0');
+    session->command_sent_ns = now;
+    worker->stats->commands.fetch_add(1u, std::memory_order_relaxed);
+
+    return session_flush(worker, session);
+}
+
+/*******************************************************************************
+ * Function Name: session_on_ack
+ *******************************************************************************
+ * Summary:
+ *  Records the latency of the outstanding LED command and schedules the next
+ *  one, one interval after the previous one was sent.
+ *
+ *******************************************************************************/
+static void session_on_ack(worker_t *worker, session_t *session, uint64_t now)
+{
+    uint64_t due;
+
+    worker->stats->acks.fetch_add(1u, std::memory_order_relaxed);
+    if(session->command_sent_ns == 0u)
+    {
+        return;
+    }
+
+    worker->stats->ack_us.add((now - session->command_sent_ns) / 1000u);
+    due = session->command_sent_ns + ((uint64_t)config.command_interval_ms * 1000000u);
+    session->command_sent_ns = 0u;
+    worker->timers.push(command_timer_t((due > now) ? due : now, session->id));
+}
+
+/*******************************************************************************
+ * Function Name: session_parse
+ *******************************************************************************
+ * Summary:
+ *  Splits the received data into the messages of the TCP client, as
+ *  device_link.py does, and answers the heartbeats.
+ *
+ * Return:
+ *  bool: false if the session failed
+ *
+ *******************************************************************************/
+static bool session_parse(worker_t *worker, session_t *session, uint64_t now)
+{
+    const uint8_t *data = (const uint8_t *)session->rx.data();
+    size_t length = session->rx.size();
+    size_t position = 0u;
+
+    while(position < length)
+    {
+        const uint8_t *message = &data[position];
+        size_t available = length - position;
+        size_t message_len = 0u;
+
+        switch(message[0])
+        {
+            case 'A':
+                message_len = ACK_COMPACT_LEN;
+                break;
+            case 'S':
+                message_len = STATE_REPORT_LEN;
+                break;
+            case 'p':
+                message_len = PING_REPLY_LEN;
+                break;
+            case 'H':
+                message_len = HEARTBEAT_LEN;
+                break;
+            case 'd':
+                message_len = DOWNLOAD_STATUS_LEN;
+                break;
+            case 'm':
+            case 'T':
+            case 'k':
+                if(available >= FRAME_HEADER_LEN)
+                {
+                    message_len = FRAME_HEADER_LEN + (size_t)(message[1] | (message[2] << 8));
+                }
+                else
+                {
+                    message_len = FRAME_HEADER_LEN;
+                }
+                break;
+            default:
+                for(const char *ack : ascii_acks)
+                {
+                    size_t ack_len = strlen(ack);
+                    size_t compared = std::min(ack_len, available);
+
+                    if(memcmp(message, ack, compared) == 0)
+                    {
+                        message_len = ack_len;
+                        break;
+                    }
+                }
+                if(message_len == 0u)
+                {
+                    /* Unknown data: dropped, as device_link.py does. */
+                    position = length;
+                    continue;
+                }
+                break;
+        }
+
+        if(available < message_len)
+        {
+            break;
+        }
+
+        worker->stats->messages.fetch_add(1u, std::memory_order_relaxed);
+        if((message[0] == 'A') || (message[0] == 'L') || (message[0] == 'I'))
+        {
+            session_on_ack(worker, session, now);
+        }
+        else if(message[0] == 'H')
+        {
+            worker->stats->heartbeats.fetch_add(1u, std::memory_order_relaxed);
+            session->tx.push_back('h');
+            session->tx.append((const char *)&message[1], HEARTBEAT_LEN - 1u);
+        }
+        else if(message[0] == 'T')
+        {
+            worker->stats->telemetry.fetch_add(1u, std::memory_order_relaxed);
+        }
+        position += message_len;
+    }
+
+    session->rx.erase(0u, position);
+
+    return session_flush(worker, session);
+}
+
+/*******************************************************************************
+ * Function Name: session_handshake
+ *******************************************************************************
+ * Summary:
+ *  Continues the TLS handshake of a session and, once it completes, records
+ *  its time and schedules the first LED command.
+ *
+ * Return:
+ *  bool: false if the handshake failed
+ *
+ *******************************************************************************/
+static bool session_handshake(worker_t *worker, session_t *session)
+{
+    int result = SSL_do_handshake(session->ssl);
+    uint64_t now;
+
+    if(result != 1)
+    {
+        int error = SSL_get_error(session->ssl, result);
+
+        session->want_write = (error == SSL_ERROR_WANT_WRITE);
+        return (error == SSL_ERROR_WANT_READ) || (error == SSL_ERROR_WANT_WRITE);
+    }
+
+    now = now_ns();
+    session->established = true;
+    worker->stats->handshakes.fetch_add(1u, std::memory_order_relaxed);
+    worker->stats->sessions.fetch_add(1u, std::memory_order_relaxed);
+    worker->stats->handshake_us.add((now - session->accepted_ns) / 1000u);
+    if(SSL_session_reused(session->ssl))
+    {
+        worker->stats->resumed.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    if(config.command_interval_ms > 0u)
+    {
+        worker->timers.push(command_timer_t(now + ((uint64_t)config.command_interval_ms * 1000000u),
+                                            session->id));
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: session_on_event
+ *******************************************************************************
+ * Summary:
+ *  Handles the readiness of the socket of a session: continues the handshake,
+ *  or writes the pending data and reads and parses the received data.
+ *
+ *******************************************************************************/
+static void session_on_event(worker_t *worker, session_t *session)
+{
+    char buffer[READ_CHUNK_LEN];
+    bool ok = true;
+
+    session->want_write = false;
+    if(!session->established)
+    {
+        ok = session_handshake(worker, session);
+        if(!ok || !session->established)
+        {
+            if(ok)
+            {
+                session_update_events(worker, session);
+            }
+            else
+            {
+                session_close(worker, session);
+            }
+            return;
+        }
+    }
+
+    ok = session_flush(worker, session);
+    while(ok)
+    {
+        int received = SSL_read(session->ssl, buffer, sizeof(buffer));
+
+        if(received > 0)
+        {
+            worker->stats->bytes_in.fetch_add((uint64_t)received, std::memory_order_relaxed);
+            session->rx.append(buffer, (size_t)received);
+            continue;
+        }
+
+        int error = SSL_get_error(session->ssl, received);
+        if(error == SSL_ERROR_WANT_WRITE)
+        {
+            session->want_write = true;
+        }
+        ok = (error == SSL_ERROR_WANT_READ) || (error == SSL_ERROR_WANT_WRITE);
+        break;
+    }
+
+    if(ok && !session->rx.empty())
+    {
+        ok = session_parse(worker, session, now_ns());
+    }
+
+    if(ok)
+    {
+        session_update_events(worker, session);
+    }
+    else
+    {
+        session_close(worker, session);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: worker_accept
+ *******************************************************************************
+ * Summary:
+ *  Accepts the pending connections of the listening socket of a worker.
+ *
+ *******************************************************************************/
+static void worker_accept(worker_t *worker)
+{
+    for(;;)
+    {
+        int fd = accept4(worker->listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        struct epoll_event event = {};
+        session_t *session;
+
+        if(fd < 0)
+        {
+            if((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR) &&
+               (errno != ECONNABORTED))
+            {
+                perror("accept");
+            }
+            return;
+        }
+
+        session = new session_t();
+        session->id = worker->next_id++;
+        session->fd = fd;
+        session->ssl = SSL_new(worker->context);
+        session->accepted_ns = now_ns();
+        SSL_set_fd(session->ssl, fd);
+        SSL_set_accept_state(session->ssl);
+        worker->sessions[session->id] = session;
+
+        event.events = EPOLLIN;
+        event.data.ptr = session;
+        epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: worker_run_timers
+ *******************************************************************************
+ * Summary:
+ *  Sends the LED commands that are due.
+ *
+ * Return:
+ *  int: Time until the next command in milliseconds, at most
+ *       WORKER_MAX_WAIT_MS
+ *
+ *******************************************************************************/
+static int worker_run_timers(worker_t *worker)
+{
+    uint64_t now = now_ns();
+
+    while(!worker->timers.empty() && (worker->timers.top().first <= now))
+    {
+        auto found = worker->sessions.find(worker->timers.top().second);
+
+        worker->timers.pop();
+        if(found == worker->sessions.end())
+        {
+            continue;
+        }
+
+        session_t *session = found->second;
+        if(session_send_command(worker, session, now))
+        {
+            session_update_events(worker, session);
+        }
+        else
+        {
+            session_close(worker, session);
+        }
+    }
+
+    if(worker->timers.empty())
+    {
+        return WORKER_MAX_WAIT_MS;
+    }
+
+    return (int)std::min<uint64_t>(WORKER_MAX_WAIT_MS,
+                                   ((worker->timers.top().first - now) + 999999u) / 1000000u);
+}
+
+/*******************************************************************************
+ * Function Name: worker_main
+ *******************************************************************************
+ * Summary:
+ *  Event loop of a worker thread.
+ *
+ *******************************************************************************/
+static void worker_main(worker_t *worker)
+{
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+    struct epoll_event listen_event = {};
+
+    listen_event.events = EPOLLIN;
+    listen_event.data.ptr = NULL;
+    epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->listener, &listen_event);
+
+    while(!stop_requested.load(std::memory_order_relaxed))
+    {
+        int timeout_ms = worker_run_timers(worker);
+        int count = epoll_wait(worker->epoll_fd, events, EPOLL_MAX_EVENTS, timeout_ms);
+
+        for(int i = 0; i < count; i++)
+        {
+            if(events[i].data.ptr == NULL)
+            {
+                worker_accept(worker);
+            }
+            else
+            {
+                session_on_event(worker, (session_t *)events[i].data.ptr);
+            }
+        }
+    }
+
+    while(!worker->sessions.empty())
+    {
+        session_t *session = worker->sessions.begin()->second;
+
+        /* Not a failed handshake: the server is stopping. */
+        if(!session->established)
+        {
+            worker->stats->handshake_failures.fetch_sub(1u, std::memory_order_relaxed);
+        }
+        session_close(worker, session);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: take_snapshot
+ *******************************************************************************
+ * Summary:
+ *  Sums the counters of all workers.
+ *
+ *******************************************************************************/
+static void take_snapshot(const std::vector<std::unique_ptr<worker_stats_t>> &stats,
+                          stats_snapshot_t *snapshot)
+{
+    memset(snapshot, 0, sizeof(*snapshot));
+    for(const auto &worker : stats)
+    {
+        snapshot->handshakes += worker->handshakes.load(std::memory_order_relaxed);
+        snapshot->resumed += worker->resumed.load(std::memory_order_relaxed);
+        snapshot->handshake_failures += worker->handshake_failures.load(std::memory_order_relaxed);
+        snapshot->sessions += worker->sessions.load(std::memory_order_relaxed);
+        snapshot->messages += worker->messages.load(std::memory_order_relaxed);
+        snapshot->bytes_in += worker->bytes_in.load(std::memory_order_relaxed);
+        snapshot->bytes_out += worker->bytes_out.load(std::memory_order_relaxed);
+        snapshot->heartbeats += worker->heartbeats.load(std::memory_order_relaxed);
+        snapshot->telemetry += worker->telemetry.load(std::memory_order_relaxed);
+        snapshot->commands += worker->commands.load(std::memory_order_relaxed);
+        snapshot->acks += worker->acks.load(std::memory_order_relaxed);
+        for(unsigned i = 0u; i < HISTOGRAM_BUCKETS; i++)
+        {
+            snapshot->handshake_us[i] += worker->handshake_us.buckets[i].load(std::memory_order_relaxed);
+            snapshot->ack_us[i] += worker->ack_us.buckets[i].load(std::memory_order_relaxed);
+        }
+        snapshot->handshake_us_max = std::max(snapshot->handshake_us_max,
+                                              worker->handshake_us.max.load(std::memory_order_relaxed));
+        snapshot->ack_us_max = std::max(snapshot->ack_us_max,
+                                        worker->ack_us.max.load(std::memory_order_relaxed));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: histogram_percentile
+ *******************************************************************************
+ * Summary:
+ *  Returns the upper bound of the log2 bucket that holds the given fraction of
+ *  the samples, in microseconds, capped at the largest sample, or 0 without
+ *  samples.
+ *
+ *******************************************************************************/
+static uint64_t histogram_percentile(const uint64_t *buckets, uint64_t max, double fraction)
+{
+    uint64_t total = 0u;
+    uint64_t seen = 0u;
+
+    for(unsigned i = 0u; i < HISTOGRAM_BUCKETS; i++)
+    {
+        total += buckets[i];
+    }
+    for(unsigned i = 0u; i < HISTOGRAM_BUCKETS; i++)
+    {
+        seen += buckets[i];
+        if((total > 0u) && (seen >= (uint64_t)(fraction * (double)total + 0.5)) && (seen > 0u))
+        {
+            return (i == 0u) ? 0u : std::min<uint64_t>(max, (1ull << i) - 1u);
+        }
+    }
+
+    return 0u;
+}
+
+/*******************************************************************************
+ * Function Name: print_report
+ *******************************************************************************
+ * Summary:
+ *  Prints the rates and the latency of one report interval.
+ *
+ *******************************************************************************/
+static void print_report(double elapsed_s, double interval_s, const stats_snapshot_t *now,
+                         const stats_snapshot_t *before)
+{
+    uint64_t handshakes = now->handshakes - before->handshakes;
+    uint64_t ack_us[HISTOGRAM_BUCKETS];
+
+    for(unsigned i = 0u; i < HISTOGRAM_BUCKETS; i++)
+    {
+        ack_us[i] = now->ack_us[i] - before->ack_us[i];
+    }
+
+    printf("[%7.1f s] handshakes %7.0f/s (%3.0f%% resumed, %" PRIu64 " failed) | sessions %6" PRIu64
+           " | messages %8.0f/s | acks %7.0f/s p50 <= %" PRIu64 " us p99 <= %" PRIu64 " us\n",
+           elapsed_s, handshakes / interval_s,
+           (handshakes > 0u) ? (100.0 * (now->resumed - before->resumed) / handshakes) : 0.0,
+           now->handshake_failures - before->handshake_failures, now->sessions,
+           (now->messages - before->messages) / interval_s, (now->acks - before->acks) / interval_s,
+           histogram_percentile(ack_us, now->ack_us_max, 0.50),
+           histogram_percentile(ack_us, now->ack_us_max, 0.99));
+    fflush(stdout);
+}
+
+/*******************************************************************************
+ * Function Name: print_summary
+ *******************************************************************************
+ * Summary:
+ *  Prints the totals of the run, as text or as JSON.
+ *
+ *******************************************************************************/
+static void print_summary(double elapsed_s, uint64_t peak_sessions, const stats_snapshot_t *total)
+{
+    if(config.json)
+    {
+        printf("{\"threads\": %u, \"duration_s\": %.3f, \"handshakes\": %" PRIu64 ", "
+               "\"handshakes_per_s\": %.1f, \"resumed\": %" PRIu64 ", \"handshake_failures\": %" PRIu64 ", "
+               "\"peak_sessions\": %" PRIu64 ", \"messages\": %" PRIu64 ", \"bytes_in\": %" PRIu64 ", "
+               "\"bytes_out\": %" PRIu64 ", \"heartbeats\": %" PRIu64 ", \"telemetry\": %" PRIu64 ", "
+               "\"commands\": %" PRIu64 ", \"acks\": %" PRIu64 ", "
+               "\"handshake_us\": {\"p50\": %" PRIu64 ", \"p99\": %" PRIu64 ", \"max\": %" PRIu64 "}, "
+               "\"ack_us\": {\"p50\": %" PRIu64 ", \"p99\": %" PRIu64 ", \"p999\": %" PRIu64 ", "
+               "\"max\": %" PRIu64 "}}\n",
+               config.threads, elapsed_s, total->handshakes, total->handshakes / elapsed_s,
+               total->resumed, total->handshake_failures, peak_sessions, total->messages,
+               total->bytes_in, total->bytes_out, total->heartbeats, total->telemetry,
+               total->commands, total->acks,
+               histogram_percentile(total->handshake_us, total->handshake_us_max, 0.50),
+               histogram_percentile(total->handshake_us, total->handshake_us_max, 0.99),
+               total->handshake_us_max,
+               histogram_percentile(total->ack_us, total->ack_us_max, 0.50),
+               histogram_percentile(total->ack_us, total->ack_us_max, 0.99),
+               histogram_percentile(total->ack_us, total->ack_us_max, 0.999), total->ack_us_max);
+        return;
+    }
+
+    printf("\nSummary over %.1f s with %u threads\n", elapsed_s, config.threads);
+    printf("  handshakes : %" PRIu64 " (%.0f/s), %" PRIu64 " resumed, %" PRIu64 " failed\n",
+           total->handshakes, total->handshakes / elapsed_s, total->resumed,
+           total->handshake_failures);
+    printf("  handshake  : p50 <= %" PRIu64 " us, p99 <= %" PRIu64 " us, max %" PRIu64 " us\n",
+           histogram_percentile(total->handshake_us, total->handshake_us_max, 0.50),
+           histogram_percentile(total->handshake_us, total->handshake_us_max, 0.99),
+           total->handshake_us_max);
+    printf("  sessions   : peak %" PRIu64 "\n", peak_sessions);
+    printf("  traffic    : %" PRIu64 " messages, %" PRIu64 " B in, %" PRIu64 " B out, "
+           "%" PRIu64 " heartbeats, %" PRIu64 " telemetry batches\n",
+           total->messages, total->bytes_in, total->bytes_out, total->heartbeats,
+           total->telemetry);
+    printf("  commands   : %" PRIu64 " sent, %" PRIu64 " acknowledged\n", total->commands, total->acks);
+    printf("  ack        : p50 <= %" PRIu64 " us, p99 <= %" PRIu64 " us, p99.9 <= %" PRIu64 " us, "
+           "max %" PRIu64 " us\n",
+           histogram_percentile(total->ack_us, total->ack_us_max, 0.50),
+           histogram_percentile(total->ack_us, total->ack_us_max, 0.99),
+           histogram_percentile(total->ack_us, total->ack_us_max, 0.999), total->ack_us_max);
+}
+
+/*******************************************************************************
+ * Function Name: print_usage
+ *******************************************************************************/
+static void print_usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage: %s [-p port] [-b address] [-t threads] [-i command_ms] [-r report_s]\n"
+            "       [-d duration_s] [-v 1.2|1.3] [-c ciphers] [-g groups] [-k certificate_dir] [-j]\n"
+            "  -i  LED command interval of each session in ms, 0 to send none (default 1000)\n"
+            "  -t  worker threads (default: one per CPU)\n"
+            "  -d  stop after this many seconds (default: at Ctrl+C)\n"
+            "  -j  print the summary as JSON\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::unique_ptr<worker_stats_t>> stats;
+    std::vector<std::unique_ptr<worker_t>> workers;
+    std::vector<std::thread> threads;
+    unsigned char ticket_keys[TICKET_KEYS_LEN];
+    stats_snapshot_t before;
+    stats_snapshot_t current;
+    uint64_t peak_sessions = 0u;
+    uint64_t start_ns;
+    uint64_t report_ns;
+    int option;
+
+    while((option = getopt(argc, argv, "p:b:t:i:r:d:v:c:g:k:j")) != -1)
+    {
+        switch(option)
+        {
+            case 'p': config.port = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 'b': config.bind_address = optarg; break;
+            case 't': config.threads = (unsigned)strtoul(optarg, NULL, 0); break;
+            case 'i': config.command_interval_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': config.report_interval_s = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'd': config.duration_s = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'v': config.tls_version = optarg; break;
+            case 'c': config.ciphers = optarg; break;
+            case 'g': config.groups = optarg; break;
+            case 'k': config.certificate_dir = optarg; break;
+            case 'j': config.json = true; break;
+            default:
+                print_usage(argv[0]);
+                return 2;
+        }
+    }
+    if((config.tls_version != "1.2") && (config.tls_version != "1.3"))
+    {
+        print_usage(argv[0]);
+        return 2;
+    }
+    if(config.threads == 0u)
+    {
+        config.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if(config.report_interval_s == 0u)
+    {
+        config.report_interval_s = 1u;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    if(RAND_bytes(ticket_keys, sizeof(ticket_keys)) != 1)
+    {
+        fprintf(stderr, "No random session ticket keys\n");
+        return 1;
+    }
+
+    for(unsigned i = 0u; i < config.threads; i++)
+    {
+        std::unique_ptr<worker_t> worker(new worker_t());
+
+        stats.emplace_back(new worker_stats_t());
+        worker->index = i;
+        worker->stats = stats.back().get();
+        worker->context = create_context(ticket_keys);
+        worker->listener = create_listener();
+        worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if((worker->context == NULL) || (worker->listener < 0) || (worker->epoll_fd < 0))
+        {
+            ERR_print_errors_fp(stderr);
+            fprintf(stderr, "Worker %u could not be started\n", i);
+            return 1;
+        }
+        workers.push_back(std::move(worker));
+    }
+    OPENSSL_cleanse(ticket_keys, sizeof(ticket_keys));
+
+    fprintf(config.json ? stderr : stdout,
+            "Reference server on port %u: %u threads, TLS %s, LED command every %" PRIu32 " ms (%s)\n",
+            config.port, config.threads, config.tls_version.c_str(), config.command_interval_ms,
+            OpenSSL_version(OPENSSL_VERSION));
+    fflush(stdout);
+
+    for(auto &worker : workers)
+    {
+        threads.emplace_back(worker_main, worker.get());
+    }
+
+    start_ns = now_ns();
+    report_ns = start_ns;
+    take_snapshot(stats, &before);
+    while(!stop_requested.load())
+    {
+        uint64_t next_report_ns = report_ns + ((uint64_t)config.report_interval_s * 1000000000u);
+        uint64_t now;
+
+        while(!stop_requested.load() && ((now = now_ns()) < next_report_ns))
+        {
+            usleep((useconds_t)std::min<uint64_t>(100000u, (next_report_ns - now) / 1000u + 1u));
+        }
+        now = now_ns();
+        take_snapshot(stats, &current);
+        peak_sessions = std::max(peak_sessions, current.sessions);
+        if(!config.json)
+        {
+            print_report((now - start_ns) / 1e9, (now - report_ns) / 1e9, &current, &before);
+        }
+        before = current;
+        report_ns = now;
+
+        if((config.duration_s > 0u) && ((now - start_ns) >= ((uint64_t)config.duration_s * 1000000000u)))
+        {
+            stop_requested.store(true);
+        }
+    }
+
+    for(auto &thread : threads)
+    {
+        thread.join();
+    }
+    take_snapshot(stats, &current);
+    print_summary((report_ns - start_ns) / 1e9, peak_sessions, &current);
+
+    for(auto &worker : workers)
+    {
+        close(worker->epoll_fd);
+        close(worker->listener);
+        SSL_CTX_free(worker->context);
+    }
+
+    return 0;
+}
+
+/* [] END OF FILE */
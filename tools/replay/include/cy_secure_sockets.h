@@ -0,0 +1,74 @@
+/******************************************************************************
+* File Name:   cy_secure_sockets.h
+*
+* Description: Host replacement of the secure sockets header for the replay
+* tool. cy_socket_recv() and cy_socket_send() are implemented by the replay
+* tool on top of the capture file.
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CY_SECURE_SOCKETS_H_
+#define CY_SECURE_SOCKETS_H_
+
+#include <stdint.h>
+
+typedef uint32_t cy_rslt_t;
+typedef void *cy_socket_t;
+
+typedef enum
+{
+    CY_SOCKET_IP_VER_V4 = 4,
+    CY_SOCKET_IP_VER_V6 = 6
+} cy_socket_ip_version_t;
+
+typedef struct
+{
+    cy_socket_ip_version_t version;
+    union
+    {
+        uint32_t v4;
+        uint32_t v6[4];
+    } ip;
+} cy_socket_ip_address_t;
+
+#define CY_RSLT_SUCCESS                       ((cy_rslt_t)0u)
+#define CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT ((cy_rslt_t)0x01000005u)
+#define CY_SOCKET_FLAGS_NONE                  (0)
+
+cy_rslt_t cy_socket_send(cy_socket_t handle, const void *buffer, uint32_t length,
+                         int flags, uint32_t *bytes_sent);
+cy_rslt_t cy_socket_recv(cy_socket_t handle, void *buffer, uint32_t length,
+                         int flags, uint32_t *bytes_received);
+
+#endif /* CY_SECURE_SOCKETS_H_ */
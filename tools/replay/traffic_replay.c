@@ -0,0 +1,465 @@
+/******************************************************************************
+* File Name:   traffic_replay.c
+*
+* Description: Host replay tool for traffic captures of the secure TCP client
+* (CAPTURE=1). Feeds the data the client received from the server back
+* through tcp_client_recv_handler() of source/command_handler.c, at the
+* original pace of the capture or as fast as possible, and reports the
+* throughput and the latency of the handler.
+*
+* Build and run from the root of the application:
+* gcc -O2 -DENABLE_FLASH_DOWNLOAD=0 -DENABLE_APP_PARAMS=0 -Itools/replay/include -Isource
+* -o traffic_replay tools/replay/traffic_replay.c source/command_handler.c source/metrics.c
+* source/compact_codec.c
+* ./traffic_replay [-f] [-n repeat] capture.tcap
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Standard C header files. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Host replacements of the platform header files. */
+#include "cyhal.h"
+#include "task.h"
+#include "cy_secure_sockets.h"
+
+/* Application header files. */
+#include "command_handler.h"
+#include "connection_events.h"
+#include "traffic_capture.h"
+#include "app_time.h"
+
+/******************************************************************************
+* Data structure
+******************************************************************************/
+typedef struct
+{
+    uint64_t time_us;    /* Since the first record of the capture. */
+    uint32_t offset;     /* Offset of the data in the received stream. */
+} replay_record_t;
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Data received by the client, in order, and the records it came in. */
+static uint8_t *replay_in;
+static uint32_t replay_in_len;
+static uint32_t replay_in_pos;
+static replay_record_t *replay_records;
+static uint32_t replay_record_count;
+
+/* Data sent by the client in the capture. */
+static uint32_t replay_captured_out_records;
+static uint32_t replay_captured_out_bytes;
+
+/* Data sent by the handler during the replay. */
+static uint32_t replay_out_records;
+static uint32_t replay_out_bytes;
+static uint64_t replay_first_send_ns;
+
+static bool replay_led_state;
+static uint32_t replay_heartbeats;
+
+/*******************************************************************************
+ * Function Name: replay_now_ns
+ *******************************************************************************
+ * Summary:
+ *  Returns the monotonic clock in nanoseconds.
+ *
+ *******************************************************************************/
+static uint64_t replay_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+}
+
+/* Timestamps of the command handler: the cycle counter runs at 1 GHz. */
+uint32_t app_time_cycles(void)
+{
+    return (uint32_t)replay_now_ns();
+}
+
+uint32_t app_time_cycles_to_us(uint32_t cycles)
+{
+    return cycles / 1000u;
+}
+
+uint64_t app_time_us(void)
+{
+    return replay_now_ns() / 1000u;
+}
+
+/* Secure sockets on top of the capture. */
+cy_rslt_t cy_socket_recv(cy_socket_t handle, void *buffer, uint32_t length,
+                         int flags, uint32_t *bytes_received)
+{
+    uint32_t available = replay_in_len - replay_in_pos;
+
+    *bytes_received = (length < available) ? length : available;
+    if(*bytes_received == 0u)
+    {
+        return CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT;
+    }
+
+    memcpy(buffer, &replay_in[replay_in_pos], *bytes_received);
+    replay_in_pos += *bytes_received;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_send(cy_socket_t handle, const void *buffer, uint32_t length,
+                         int flags, uint32_t *bytes_sent)
+{
+    if(replay_first_send_ns == 0u)
+    {
+        replay_first_send_ns = replay_now_ns();
+    }
+    replay_out_records++;
+    replay_out_bytes += length;
+    *bytes_sent = length;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* LED GPIO. */
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value)
+{
+    replay_led_state = value;
+}
+
+bool cyhal_gpio_read(cyhal_gpio_t pin)
+{
+    return replay_led_state;
+}
+
+/* Heartbeat replies are posted to the network task, which is not replayed. */
+void connection_event_post(const connection_event_t *event)
+{
+    replay_heartbeats++;
+}
+
+/* Logging and heap statistics are not part of the replay. */
+void app_log_write(uint8_t level, const char *fmt, uint32_t nargs, ...)
+{
+}
+
+void print_heap_usage(char *msg)
+{
+}
+
+void get_heap_usage(uint32_t *heap_in_use, uint32_t *heap_max_used)
+{
+    *heap_in_use = 0u;
+    *heap_max_used = 0u;
+}
+
+/* Task statistics of the metrics snapshot. */
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(replay_now_ns() / 1000000u);
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    return 0u;
+}
+
+/*******************************************************************************
+ * Function Name: replay_get_varint
+ *******************************************************************************
+ * Summary:
+ *  Decodes a varint of the capture file.
+ *
+ * Return:
+ *  bool: false if the varint runs past the end of the file
+ *
+ *******************************************************************************/
+static bool replay_get_varint(const uint8_t *data, uint32_t length, uint32_t *pos, uint32_t *value)
+{
+    *value = 0u;
+    for(uint32_t shift = 0u; (shift < 35u) && (*pos < length); shift += 7u)
+    {
+        uint8_t byte = data[(*pos)++];
+
+        *value |= (uint32_t)(byte & 0x7Fu) << shift;
+        if(byte < 0x80u)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: replay_load
+ *******************************************************************************
+ * Summary:
+ *  Reads a capture file and splits it into the received stream, with the
+ *  time of each record, and the statistics of the sent data.
+ *
+ * Return:
+ *  bool: false if the file cannot be read or is not a capture
+ *
+ *******************************************************************************/
+static bool replay_load(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data;
+    long file_len;
+    uint32_t length;
+    uint32_t pos = sizeof(TRAFFIC_CAPTURE_MAGIC);   /* Magic and version byte. */
+    uint32_t delta_us;
+    uint32_t field;
+    uint64_t time_us = 0u;
+
+    if(file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    file_len = ftell(file);
+    rewind(file);
+    data = malloc((size_t)file_len + 1u);
+    length = (uint32_t)fread(data, 1, (size_t)file_len, file);
+    fclose(file);
+
+    if((length < pos) || (memcmp(data, TRAFFIC_CAPTURE_MAGIC, pos - 1u) != 0) ||
+       (data[pos - 1u] != TRAFFIC_CAPTURE_VERSION))
+    {
+        fprintf(stderr, "%s: not a version %u capture file\n", path, TRAFFIC_CAPTURE_VERSION);
+        return false;
+    }
+
+    /* The received stream and the records are never larger than the file. */
+    replay_in = malloc(length);
+    replay_records = malloc(length * sizeof(replay_record_t));
+
+    while(pos < length)
+    {
+        if(!replay_get_varint(data, length, &pos, &delta_us) ||
+           !replay_get_varint(data, length, &pos, &field) ||
+           ((field >> 1) > (length - pos)))
+        {
+            fprintf(stderr, "%s: truncated record at offset %"PRIu32"\n", path, pos);
+            break;
+        }
+        time_us += delta_us;
+
+        if((field & 1u) == TRAFFIC_CAPTURE_DIR_IN)
+        {
+            replay_records[replay_record_count].time_us = time_us;
+            replay_records[replay_record_count].offset = replay_in_len;
+            replay_record_count++;
+            memcpy(&replay_in[replay_in_len], &data[pos], field >> 1);
+            replay_in_len += field >> 1;
+        }
+        else
+        {
+            replay_captured_out_records++;
+            replay_captured_out_bytes += field >> 1;
+        }
+        pos += field >> 1;
+    }
+
+    free(data);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: replay_compare
+ *******************************************************************************
+ * Summary:
+ *  qsort() comparison of latencies.
+ *
+ *******************************************************************************/
+static int replay_compare(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+ * Function Name: replay_print_latency
+ *******************************************************************************
+ * Summary:
+ *  Prints the distribution of latencies in ns as min/p50/p90/p99/max in us.
+ *
+ *******************************************************************************/
+static void replay_print_latency(const char *title, uint64_t *values, uint32_t count)
+{
+    if(count == 0u)
+    {
+        return;
+    }
+    qsort(values, count, sizeof(values[0]), replay_compare);
+    printf("%-22s min %8.2f  p50 %8.2f  p90 %8.2f  p99 %8.2f  max %8.2f\n", title,
+           values[0] / 1e3, values[count / 2u] / 1e3, values[(count * 9u) / 10u] / 1e3,
+           values[(count * 99u) / 100u] / 1e3, values[count - 1u] / 1e3);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *  Replays a capture through the command handler. Usage:
+ *  traffic_replay [-f] [-n repeat] capture.tcap
+ *  -f: as fast as possible instead of at the pace of the capture
+ *  -n: number of times the capture is replayed
+ *
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+    bool fast = false;
+    uint32_t repeat = 1u;
+    uint32_t record = 0u;
+    uint32_t calls = 0u;
+    uint32_t latency_count = 0u;
+    uint32_t total_calls;
+    uint64_t *handler_ns;
+    uint64_t *response_ns;
+    uint64_t start_ns;
+    uint64_t call_ns;
+    uint64_t elapsed_ns;
+    uint64_t due_ns;
+    int option;
+
+    while((option = getopt(argc, argv, "fn:")) != -1)
+    {
+        if(option == 'f')
+        {
+            fast = true;
+        }
+        else if(option == 'n')
+        {
+            repeat = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-f] [-n repeat] capture.tcap\n", argv[0]);
+            return 2;
+        }
+    }
+    if((optind >= argc) || !replay_load(argv[optind]))
+    {
+        fprintf(stderr, "Usage: %s [-f] [-n repeat] capture.tcap\n", argv[0]);
+        return 2;
+    }
+    if(replay_record_count == 0u)
+    {
+        fprintf(stderr, "No received data in the capture\n");
+        return 1;
+    }
+
+    printf("Capture: %"PRIu32" bytes received in %"PRIu32" records, %"PRIu32" bytes sent in "
+           "%"PRIu32" records, over %.3f s\n", replay_in_len, replay_record_count,
+           replay_captured_out_bytes, replay_captured_out_records,
+           (replay_records[replay_record_count - 1u].time_us - replay_records[0].time_us) / 1e6);
+
+    /* Every call consumes at least one byte. */
+    handler_ns = malloc((size_t)replay_in_len * repeat * sizeof(uint64_t));
+    response_ns = malloc((size_t)replay_in_len * repeat * sizeof(uint64_t));
+
+    start_ns = replay_now_ns();
+    for(uint32_t pass = 0u; pass < repeat; pass++)
+    {
+        uint64_t pass_start_ns = replay_now_ns();
+
+        replay_in_pos = 0u;
+        record = 0u;
+        while(replay_in_pos < replay_in_len)
+        {
+            uint32_t previous_pos = replay_in_pos;
+
+            /* Record the next message starts in. */
+            while(((record + 1u) < replay_record_count) &&
+                  (replay_records[record + 1u].offset <= replay_in_pos))
+            {
+                record++;
+            }
+
+            if(!fast)
+            {
+                due_ns = pass_start_ns + (replay_records[record].time_us - replay_records[0].time_us) * 1000u;
+                while(replay_now_ns() < due_ns)
+                {
+                    uint64_t wait_ns = due_ns - replay_now_ns();
+
+                    usleep((useconds_t)((wait_ns > 2000000u) ? 1000u : wait_ns / 2000u));
+                }
+            }
+
+            replay_first_send_ns = 0u;
+            call_ns = replay_now_ns();
+            tcp_client_recv_handler(NULL, NULL);
+            handler_ns[calls++] = replay_now_ns() - call_ns;
+            if(replay_first_send_ns != 0u)
+            {
+                response_ns[latency_count++] = replay_first_send_ns - call_ns;
+            }
+
+            if(replay_in_pos == previous_pos)
+            {
+                break;
+            }
+        }
+    }
+    elapsed_ns = replay_now_ns() - start_ns;
+    total_calls = calls;
+
+    printf("Replayed %"PRIu32" messages (%"PRIu32" bytes) %s in %.3f s: %.0f messages/s, "
+           "%.1f KB/s\n", total_calls, replay_in_len * repeat,
+           fast ? "as fast as possible" : "at the original pace", elapsed_ns / 1e9,
+           total_calls / (elapsed_ns / 1e9), (replay_in_len * repeat) / (elapsed_ns / 1e9) / 1024.0);
+    printf("Handler sent %"PRIu32" bytes in %"PRIu32" records, %"PRIu32" heartbeat replies\n\n",
+           replay_out_bytes, replay_out_records, replay_heartbeats);
+    printf("Latency (us)\n");
+    replay_print_latency("Handler", handler_ns, total_calls);
+    replay_print_latency("Call to response sent", response_ns, latency_count);
+
+    return 0;
+}
+
+/* [] END OF FILE */
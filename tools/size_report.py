@@ -0,0 +1,186 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   size_report.py
+#
+# Description: Breaks down the .text, .data and .bss usage of the application
+#              by component (application, each library, toolchain runtime) from
+#              the GNU linker map file. Use --baseline to compare two builds,
+#              e.g. the default and the minimal build profile.
+#              Usage: python size_report.py <app.map> [--baseline <other.map>] [--json]
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import json
+import re
+import sys
+
+# Input section line: name, address, size and object file, possibly with the
+# name on a line of its own.
+SECTION_LINE = re.compile(r'^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+SECTION_NAME_ONLY = re.compile(r'^ (\S+)$')
+SECTION_CONT = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+
+TEXT_PREFIXES = ('.text', '.rodata', '.ARM', '.glue', '.vfp11', '.init', '.fini',
+                 '.ctors', '.dtors', '.eh_frame', '.isr_vector', '.vectors',
+                 '.cy_')
+DATA_PREFIXES = ('.data', '.ramfunc', '.cy_ramfunc')
+BSS_PREFIXES = ('.bss', 'COMMON', '.noinit', '.heap', '.stack')
+
+
+def classify(section):
+    if section.startswith(DATA_PREFIXES):
+        return 'data'
+    if section.startswith(BSS_PREFIXES):
+        return 'bss'
+    if section.startswith(TEXT_PREFIXES):
+        return 'text'
+    return None
+
+
+def component_of(path):
+    path = path.replace('\\', '/')
+    for marker in ('/mtb_shared/', '/libs/'):
+        if marker in path:
+            return path.split(marker, 1)[1].split('/', 1)[0]
+    if '/bsps/' in path or '/TARGET_' in path:
+        return 'bsp'
+    archive = re.search(r'([^/]+)\.a\(', path)
+    if archive:
+        name = archive.group(1)
+        if name.startswith(('libc', 'libm', 'libg', 'libgcc', 'libnosys', 'libstdc')):
+            return 'toolchain:' + name
+        return name
+    if 'arm-none-eabi' in path or '/lib/gcc/' in path:
+        return 'toolchain'
+    return 'app'
+
+
+def parse_map(path):
+    sizes = {}
+    in_memory_map = False
+    pending = None
+    with open(path, errors='replace') as f:
+        for line in f:
+            line = line.rstrip('\n')
+            if not in_memory_map:
+                in_memory_map = line.startswith('Linker script and memory map')
+                continue
+            if line.startswith('/DISCARD/'):
+                break
+
+            match = SECTION_LINE.match(line)
+            if match:
+                section, _, size, obj = match.groups()
+            elif pending and SECTION_CONT.match(line):
+                section = pending
+                _, size, obj = SECTION_CONT.match(line).groups()
+            else:
+                name = SECTION_NAME_ONLY.match(line)
+                pending = name.group(1) if name else None
+                continue
+            pending = None
+
+            category = classify(section)
+            size = int(size, 16)
+            if category is None or size == 0 or obj.startswith('*'):
+                continue
+            entry = sizes.setdefault(component_of(obj), {'text': 0, 'data': 0, 'bss': 0})
+            entry[category] += size
+    return sizes
+
+
+def print_table(sizes, baseline=None):
+    header = '%-40s %10s %10s %10s %10s %10s' % ('Component', '.text', '.data', '.bss',
+                                                  'Flash', 'RAM')
+    if baseline is not None:
+        header += ' %10s %10s' % ('dFlash', 'dRAM')
+    print(header)
+    print('-' * len(header))
+
+    totals = {'text': 0, 'data': 0, 'bss': 0}
+    base_totals = {'text': 0, 'data': 0, 'bss': 0}
+    names = set(sizes) | set(baseline or {})
+    empty = {'text': 0, 'data': 0, 'bss': 0}
+
+    def flash(e):
+        return e['text'] + e['data']
+
+    def ram(e):
+        return e['data'] + e['bss']
+
+    for name in sorted(names, key=lambda n: -flash(sizes.get(n, empty))):
+        entry = sizes.get(name, empty)
+        line = '%-40s %10d %10d %10d %10d %10d' % (name, entry['text'], entry['data'],
+                                                   entry['bss'], flash(entry), ram(entry))
+        if baseline is not None:
+            base = baseline.get(name, empty)
+            line += ' %+10d %+10d' % (flash(entry) - flash(base), ram(entry) - ram(base))
+            for key in base_totals:
+                base_totals[key] += base[key]
+        for key in totals:
+            totals[key] += entry[key]
+        print(line)
+
+    print('-' * len(header))
+    line = '%-40s %10d %10d %10d %10d %10d' % ('Total', totals['text'], totals['data'],
+                                               totals['bss'], flash(totals), ram(totals))
+    if baseline is not None:
+        line += ' %+10d %+10d' % (flash(totals) - flash(base_totals),
+                                  ram(totals) - ram(base_totals))
+    print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Per-component size report from a linker map file')
+    parser.add_argument('map', help='Linker map file of the build')
+    parser.add_argument('--baseline', help='Linker map file of the build to compare against')
+    parser.add_argument('--json', action='store_true', help='Print the report as JSON')
+    args = parser.parse_args()
+
+    sizes = parse_map(args.map)
+    baseline = parse_map(args.baseline) if args.baseline else None
+
+    if args.json:
+        json.dump({'components': sizes, 'baseline': baseline}, sys.stdout, indent=2)
+        print()
+    else:
+        print_table(sizes, baseline)
+
+
+if __name__ == '__main__':
+    main()
+
+# [] END OF FILE
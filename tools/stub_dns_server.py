@@ -0,0 +1,147 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   stub_dns_server.py
+#
+# Description: Minimal DNS server for testing the DNS cache of the secure TCP client
+#              (source/dns_cache.c) on the host or on the device. Answers A and AAAA queries
+#              for the configured names with a fixed TTL and an optional delay, returns
+#              NXDOMAIN for other names (no data for a missing address type), optionally
+#              with an SOA record carrying the negative TTL, and prints every query it
+#              receives.
+#              Usage: python stub_dns_server.py --record <name>=<address> [--record ...]
+#                     [--port 5353] [--ttl 5] [--delay-ms 200] [--negative-ttl 30]
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import ipaddress
+import socket
+import struct
+import sys
+import time
+
+TYPE_A = 1
+TYPE_SOA = 6
+TYPE_AAAA = 28
+CLASS_IN = 1
+FLAGS_QR_AA_RA = 0x8480
+RCODE_NXDOMAIN = 3
+
+
+def parse_question(msg):
+    """Returns (name, qtype, end offset) of the first question of a query."""
+    labels = []
+    pos = 12
+    while msg[pos] != 0:
+        length = msg[pos]
+        labels.append(msg[pos + 1:pos + 1 + length].decode('ascii'))
+        pos += 1 + length
+    qtype, _ = struct.unpack_from('!HH', msg, pos + 1)
+    return '.'.join(labels).lower(), qtype, pos + 5
+
+
+def build_soa(negative_ttl):
+    """Builds the SOA record of the authority section of a negative answer."""
+    # Owner is the root; MNAME and RNAME are the root too.
+    rdata = b'\x00\x00' + struct.pack('!IIIII', 1, 3600, 600, 86400, negative_ttl)
+    return b'\x00' + struct.pack('!HHIH', TYPE_SOA, CLASS_IN, negative_ttl, len(rdata)) + rdata
+
+
+def build_response(query, records, ttl, negative_ttl=None):
+    """Builds the response to a query from the configured records."""
+    query_id, = struct.unpack_from('!H', query, 0)
+    name, qtype, question_end = parse_question(query)
+    addresses = [a for a in records.get(name, []) if (a.version == 4) == (qtype == TYPE_A)]
+    authority = build_soa(negative_ttl) if (negative_ttl is not None and not addresses) else b''
+    nscount = 1 if authority else 0
+    if name not in records:
+        header = struct.pack('!HHHHHH', query_id, FLAGS_QR_AA_RA | RCODE_NXDOMAIN, 1, 0, nscount, 0)
+        return header + query[12:question_end] + authority, name, qtype, 'NXDOMAIN'
+
+    header = struct.pack('!HHHHHH', query_id, FLAGS_QR_AA_RA, 1, len(addresses), nscount, 0)
+    answers = b''
+    for address in addresses:
+        # Name as a compression pointer to the question.
+        answers += struct.pack('!HHHIH', 0xC00C, qtype, CLASS_IN, ttl, len(address.packed))
+        answers += address.packed
+    return header + query[12:question_end] + answers + authority, name, qtype, \
+        ', '.join(str(a) for a in addresses) or 'no data'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Stub DNS server for the DNS cache tests.')
+    parser.add_argument('--record', action='append', default=[], metavar='NAME=ADDRESS',
+                        help='Host name and address to answer (repeat for more)')
+    parser.add_argument('--bind', default='0.0.0.0', help='Address to listen on')
+    parser.add_argument('--port', type=int, default=5353, help='UDP port to listen on')
+    parser.add_argument('--ttl', type=int, default=5, help='TTL of the answers in seconds')
+    parser.add_argument('--delay-ms', type=int, default=0,
+                        help='Delay before each answer, to make cache misses visible')
+    parser.add_argument('--negative-ttl', type=int, default=None,
+                        help='Negative TTL in seconds, sent in an SOA record with NXDOMAIN and '
+                             'no-data answers (no SOA record by default)')
+    args = parser.parse_args()
+
+    records = {}
+    for record in args.record:
+        name, _, address = record.partition('=')
+        records.setdefault(name.lower(), []).append(ipaddress.ip_address(address))
+    if not records:
+        parser.error('at least one --record is required')
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    print('Stub DNS server on %s:%d, TTL %d s, delay %d ms' % (args.bind, args.port, args.ttl, args.delay_ms))
+    sys.stdout.flush()
+
+    count = 0
+    while True:
+        query, peer = sock.recvfrom(512)
+        try:
+            response, name, qtype, answer = build_response(query, records, args.ttl,
+                                                           args.negative_ttl)
+        except (IndexError, struct.error, UnicodeDecodeError):
+            continue
+        count += 1
+        print('%s query %d from %s: %s %s -> %s' % (time.strftime('%H:%M:%S'), count, peer[0], name,
+                                                    'AAAA' if qtype == TYPE_AAAA else 'A', answer))
+        sys.stdout.flush()
+        if args.delay_ms:
+            time.sleep(args.delay_ms / 1000.0)
+        sock.sendto(response, peer)
+
+
+if __name__ == '__main__':
+    main()
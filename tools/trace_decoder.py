@@ -0,0 +1,125 @@
+#!/usr/bin/env python
+
+#******************************************************************************
+# File Name:   trace_decoder.py
+#
+# Description: Decoder for the command trace of the secure TCP client (CMD_TRACE=1).
+#              Reads the "[trace]" records from a captured debug UART log or from
+#              stdin, groups them by correlation ID and prints the latency distribution
+#              of every stage of the command path and of the whole path from the radio
+#              to the GPIO write.
+#              Usage: python trace_decoder.py [log file] [--clock-hz HZ]
+#
+#******************************************************************************
+# Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#******************************************************************************/
+
+import argparse
+import re
+import sys
+
+POINTS = ['radio_rx', 'callback', 'decrypted', 'gpio_write', 'actuated', 'ack_sent']
+
+# Stages reported, as pairs of trace points.
+STAGES = [
+    ('Radio RX -> callback', 'radio_rx', 'callback'),
+    ('Callback -> decrypted', 'callback', 'decrypted'),
+    ('Decrypted -> GPIO write', 'decrypted', 'gpio_write'),
+    ('GPIO write -> actuated', 'gpio_write', 'actuated'),
+    ('Actuated -> ACK sent', 'actuated', 'ack_sent'),
+    ('Radio RX -> actuated', 'radio_rx', 'actuated'),
+]
+
+RECORD = re.compile(r'\[trace\] (\d+) (\d+) (\d+)')
+CLOCK = re.compile(r'\[trace\] clock (\d+)')
+DROPPED = re.compile(r'\[trace\] dropped (\d+)')
+
+
+def parse(lines):
+    clock_hz = None
+    dropped = 0
+    commands = {}
+    for line in lines:
+        match = CLOCK.search(line)
+        if match:
+            clock_hz = int(match.group(1))
+            continue
+        match = DROPPED.search(line)
+        if match:
+            dropped = int(match.group(1))
+            continue
+        match = RECORD.search(line)
+        if match:
+            trace_id, point, cycles = (int(g) for g in match.groups())
+            if point < len(POINTS):
+                commands.setdefault(trace_id, {})[POINTS[point]] = cycles
+    return clock_hz, dropped, commands
+
+
+def percentile(values, fraction):
+    return values[min(len(values) - 1, int(fraction * len(values)))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decoder for the command trace.')
+    parser.add_argument('log', nargs='?', help='Captured debug UART log (default: stdin)')
+    parser.add_argument('--clock-hz', type=int,
+                        help='Clock rate of the timestamps (default: from the log)')
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log, errors='replace') as log:
+            clock_hz, dropped, commands = parse(log)
+    else:
+        clock_hz, dropped, commands = parse(sys.stdin)
+
+    clock_hz = args.clock_hz or clock_hz
+    if not clock_hz:
+        sys.exit('The clock rate is not in the log; pass --clock-hz')
+    if not commands:
+        sys.exit('No trace records found')
+
+    print('%d commands, %d records dropped, clock %d Hz\n' % (len(commands), dropped, clock_hz))
+    print('%-26s %7s %9s %9s %9s %9s %9s' % ('Stage (us)', 'count', 'min', 'p50', 'p90', 'p99', 'max'))
+    for name, begin, end in STAGES:
+        # Timestamps are 32-bit counters, so the deltas are taken modulo 2^32.
+        values = sorted(((points[end] - points[begin]) & 0xFFFFFFFF) * 1e6 / clock_hz
+                        for points in commands.values() if begin in points and end in points)
+        if not values:
+            continue
+        print('%-26s %7d %9.1f %9.1f %9.1f %9.1f %9.1f' %
+              (name, len(values), values[0], percentile(values, 0.5), percentile(values, 0.9),
+               percentile(values, 0.99), values[-1]))
+
+
+if __name__ == '__main__':
+    main()